@@ -0,0 +1,114 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+
+
+// run-time target selection of the fat library (TARGET=X64_FAT): the public functions are
+// trampolines jumping through blasfeo_fat_table, which is filled once at load time with the
+// functions of the best target supported by the processor
+
+
+
+#include <stdlib.h>
+#include <stdio.h>
+#include "../include/blasfeo_processor_features.h"
+
+
+
+// generated in the build directory (cmake/fat_library/dispatch.cmake)
+extern __attribute__ ((visibility ("hidden"))) void *blasfeo_fat_table[];
+extern __attribute__ ((visibility ("hidden"))) void * const blasfeo_fat_table_X64_INTEL_CORE[];
+extern __attribute__ ((visibility ("hidden"))) void * const blasfeo_fat_table_X64_INTEL_SANDY_BRIDGE[];
+extern __attribute__ ((visibility ("hidden"))) void * const blasfeo_fat_table_X64_INTEL_HASWELL[];
+extern __attribute__ ((visibility ("hidden"))) const int blasfeo_fat_table_size;
+
+
+
+static const char *blasfeo_fat_target = "X64_INTEL_CORE";
+static int blasfeo_fat_s_ps_target = 4;
+
+
+
+// runs at load time, before main; until then (e.g. in the constructors of other libraries)
+// the table holds the X64_INTEL_CORE functions, that run on any x86_64 processor;
+// registered in .init_array by the trampolines, so that static linking pulls in this object too
+__attribute__ ((visibility ("hidden"))) void blasfeo_fat_init(void)
+	{
+	int features = 0;
+	void * const *table = blasfeo_fat_table_X64_INTEL_CORE;
+	int ii;
+
+	blasfeo_processor_cpu_features(&features);
+
+	if((features & BLASFEO_PROCESSOR_FEATURE_AVX2) && (features & BLASFEO_PROCESSOR_FEATURE_FMA) && (features & BLASFEO_PROCESSOR_FEATURE_F16C))
+		{
+		table = blasfeo_fat_table_X64_INTEL_HASWELL;
+		blasfeo_fat_target = "X64_INTEL_HASWELL";
+		blasfeo_fat_s_ps_target = 8;
+		}
+	else if(features & BLASFEO_PROCESSOR_FEATURE_AVX)
+		{
+		table = blasfeo_fat_table_X64_INTEL_SANDY_BRIDGE;
+		blasfeo_fat_target = "X64_INTEL_SANDY_BRIDGE";
+		blasfeo_fat_s_ps_target = 8;
+		}
+
+	for(ii=0; ii<blasfeo_fat_table_size; ii++)
+		blasfeo_fat_table[ii] = table[ii];
+
+	return;
+	}
+
+
+
+void blasfeo_processor_target_string(char *targetString)
+	{
+	int idx = 0;
+	while(blasfeo_fat_target[idx])
+		{
+		targetString[idx] = blasfeo_fat_target[idx];
+		idx++;
+		}
+	targetString[idx] = 0;
+	return;
+	}
+
+
+
+int blasfeo_fat_s_ps()
+	{
+	return blasfeo_fat_s_ps_target;
+	}
@@ -0,0 +1,540 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "../include/blasfeo_common.h"
+#include "../include/blasfeo_jit.h"
+
+#if defined(JIT) & defined(OS_LINUX) & defined(__x86_64__) & defined(LA_HIGH_PERFORMANCE)
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+
+
+#define PS 4
+#define JIT_PANELS ((BLASFEO_JIT_MAX_SIZE+PS-1)/PS)
+
+// size of the kernel cache (open addressing), twice the number of entries it can hold
+#define JIT_TABLE_SIZE 1024
+#define JIT_MAX_ENTRIES 512
+
+// arguments of the generated kernels: scalars and pointers to the row panels of the operands
+struct jit_args
+	{
+	double alpha;
+	double beta;
+	double *pA[JIT_PANELS];
+	double *pB[JIT_PANELS];
+	double *pC[JIT_PANELS];
+	double *pD[JIT_PANELS];
+	};
+
+#define JIT_ARG_ALPHA 0
+#define JIT_ARG_BETA 8
+#define JIT_ARG_A 16
+#define JIT_ARG_B (JIT_ARG_A+8*JIT_PANELS)
+#define JIT_ARG_C (JIT_ARG_B+8*JIT_PANELS)
+#define JIT_ARG_D (JIT_ARG_C+8*JIT_PANELS)
+
+typedef void (*jit_kernel)(struct jit_args *args);
+
+struct jit_entry
+	{
+	uint64_t key; // 0 if empty
+	jit_kernel kernel; // NULL if the kernel could not be generated
+	size_t size; // size of the pages of the kernel
+	};
+
+static struct jit_entry jit_table[JIT_TABLE_SIZE];
+static int jit_count = 0;
+static int jit_entries = 0;
+static char jit_lock = 0;
+// 0 not initialized, 1 enabled, -1 disabled
+static volatile int jit_state = 0;
+
+// masks of the lanes l0 to l1-1, for vmaskmovpd
+static const int64_t jit_mask[PS][PS+1][PS] =
+	{
+	{{0, 0, 0, 0}, {-1, 0, 0, 0}, {-1, -1, 0, 0}, {-1, -1, -1, 0}, {-1, -1, -1, -1}},
+	{{0, 0, 0, 0}, {0, 0, 0, 0}, {0, -1, 0, 0}, {0, -1, -1, 0}, {0, -1, -1, -1}},
+	{{0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, -1, 0}, {0, 0, -1, -1}},
+	{{0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, -1}},
+	};
+
+
+
+/************************************************
+* x86_64 code emitter
+************************************************/
+
+// general purpose registers
+#define RAX 0
+#define RCX 1
+#define RDX 2
+#define RSI 6
+#define RDI 7
+#define R8 8
+
+// code buffer; with buf==NULL only the size is counted
+struct jit_code
+	{
+	unsigned char *buf;
+	int size;
+	};
+
+static void emit(struct jit_code *c, int byte)
+	{
+	if(c->buf!=NULL)
+		c->buf[c->size] = (unsigned char) byte;
+	c->size++;
+	}
+
+static void emit_32(struct jit_code *c, int v)
+	{
+	emit(c, v & 0xff);
+	emit(c, (v >> 8) & 0xff);
+	emit(c, (v >> 16) & 0xff);
+	emit(c, (v >> 24) & 0xff);
+	}
+
+// 3-byte VEX prefix (map 1: 0F, map 2: 0F38), 256-bit, 66 prefix
+static void emit_vex(struct jit_code *c, int reg, int rm, int map, int w, int vvvv)
+	{
+	emit(c, 0xc4);
+	emit(c, (((reg>>3)&1)^1)<<7 | 1<<6 | (((rm>>3)&1)^1)<<5 | map);
+	emit(c, w<<7 | ((~vvvv)&15)<<3 | 1<<2 | 1);
+	}
+
+// ModRM for [base+disp32] (base not rsp, rbp, r12 or r13)
+static void emit_mem(struct jit_code *c, int reg, int base, int disp)
+	{
+	emit(c, 0x80 | (reg&7)<<3 | (base&7));
+	emit_32(c, disp);
+	}
+
+// ModRM for register-register
+static void emit_reg(struct jit_code *c, int reg, int rm)
+	{
+	emit(c, 0xc0 | (reg&7)<<3 | (rm&7));
+	}
+
+// vmovupd ymm, [base+disp]
+static void emit_vmovupd_load(struct jit_code *c, int y, int base, int disp)
+	{
+	emit_vex(c, y, base, 1, 0, 0);
+	emit(c, 0x10);
+	emit_mem(c, y, base, disp);
+	}
+
+// vmovupd [base+disp], ymm
+static void emit_vmovupd_store(struct jit_code *c, int y, int base, int disp)
+	{
+	emit_vex(c, y, base, 1, 0, 0);
+	emit(c, 0x11);
+	emit_mem(c, y, base, disp);
+	}
+
+// vmaskmovpd [base+disp], ymm_mask, ymm
+static void emit_vmaskmovpd_store(struct jit_code *c, int y_mask, int y, int base, int disp)
+	{
+	emit_vex(c, y, base, 2, 0, y_mask);
+	emit(c, 0x2f);
+	emit_mem(c, y, base, disp);
+	}
+
+// vbroadcastsd ymm, [base+disp]
+static void emit_vbroadcastsd(struct jit_code *c, int y, int base, int disp)
+	{
+	emit_vex(c, y, base, 2, 0, 0);
+	emit(c, 0x19);
+	emit_mem(c, y, base, disp);
+	}
+
+// vfmadd231pd ymm_d, ymm_s1, ymm_s2 (d += s1*s2)
+static void emit_vfmadd231pd(struct jit_code *c, int y_d, int y_s1, int y_s2)
+	{
+	emit_vex(c, y_d, y_s2, 2, 1, y_s1);
+	emit(c, 0xb8);
+	emit_reg(c, y_d, y_s2);
+	}
+
+// vmulpd ymm_d, ymm_s1, ymm_s2
+static void emit_vmulpd(struct jit_code *c, int y_d, int y_s1, int y_s2)
+	{
+	emit_vex(c, y_d, y_s2, 1, 0, y_s1);
+	emit(c, 0x59);
+	emit_reg(c, y_d, y_s2);
+	}
+
+// vxorpd ymm, ymm, ymm
+static void emit_vzero(struct jit_code *c, int y)
+	{
+	emit_vex(c, y, y, 1, 0, y);
+	emit(c, 0x57);
+	emit_reg(c, y, y);
+	}
+
+// mov r64, [base+disp]
+static void emit_mov_load(struct jit_code *c, int r, int base, int disp)
+	{
+	emit(c, 0x48 | ((r>>3)&1)<<2 | ((base>>3)&1));
+	emit(c, 0x8b);
+	emit_mem(c, r, base, disp);
+	}
+
+// mov r64, imm64
+static void emit_mov_imm(struct jit_code *c, int r, const void *imm)
+	{
+	uint64_t v = (uint64_t) imm;
+	emit(c, 0x48 | ((r>>3)&1));
+	emit(c, 0xb8 + (r&7));
+	emit_32(c, (int) (v & 0xffffffff));
+	emit_32(c, (int) (v >> 32));
+	}
+
+static void emit_ret(struct jit_code *c)
+	{
+	// vzeroupper
+	emit(c, 0xc5);
+	emit(c, 0xf8);
+	emit(c, 0x77);
+	emit(c, 0xc3);
+	}
+
+
+
+/************************************************
+* kernel generator
+************************************************/
+
+// D = beta*C + alpha*A*B(^T) on register tiles of up to 3 row panels times 4 columns, fully unrolled in k;
+// ymm0-11 accumulators, ymm12-14 A, ymm15 B; A panels in r8-r10, B panel in rsi, C in rax, D in rcx
+static void jit_gen_dgemm(struct jit_code *c, int type, int m, int n, int k, int beta_zero)
+	{
+	const int tile_panels = 3;
+	int np = (m+PS-1)/PS;
+	int lower = type==BLASFEO_JIT_DSYRK_LN;
+	int jb, nj, p0, p1, t, jj, kk, r0, l0, l1, disp, y;
+
+	for(jb=0; jb<n; jb+=PS)
+		{
+		nj = n-jb<PS ? n-jb : PS;
+		// skip the row panels above the diagonal
+		p0 = lower ? jb/PS : 0;
+		for(; p0<np; p0+=tile_panels)
+			{
+			p1 = p0+tile_panels<np ? p0+tile_panels : np;
+			for(t=0; t<p1-p0; t++)
+				emit_mov_load(c, R8+t, RDI, JIT_ARG_A+8*(p0+t));
+			if(type!=BLASFEO_JIT_DGEMM_NN)
+				emit_mov_load(c, RSI, RDI, JIT_ARG_B+8*(jb/PS));
+			for(t=0; t<p1-p0; t++)
+				for(jj=0; jj<nj; jj++)
+					emit_vzero(c, 4*t+jj);
+			for(kk=0; kk<k; kk++)
+				{
+				if(type==BLASFEO_JIT_DGEMM_NN & kk%PS==0)
+					emit_mov_load(c, RSI, RDI, JIT_ARG_B+8*(kk/PS));
+				for(t=0; t<p1-p0; t++)
+					emit_vmovupd_load(c, 12+t, R8+t, 8*PS*kk);
+				for(jj=0; jj<nj; jj++)
+					{
+					if(type==BLASFEO_JIT_DGEMM_NN)
+						emit_vbroadcastsd(c, 15, RSI, 8*(PS*(jb+jj)+kk%PS));
+					else
+						emit_vbroadcastsd(c, 15, RSI, 8*(PS*kk+jj));
+					for(t=0; t<p1-p0; t++)
+						emit_vfmadd231pd(c, 4*t+jj, 12+t, 15);
+					}
+				}
+			// scale and store
+			emit_vbroadcastsd(c, 12, RDI, JIT_ARG_ALPHA);
+			if(!beta_zero)
+				emit_vbroadcastsd(c, 14, RDI, JIT_ARG_BETA);
+			for(t=0; t<p1-p0; t++)
+				{
+				emit_mov_load(c, RCX, RDI, JIT_ARG_D+8*(p0+t));
+				if(!beta_zero)
+					emit_mov_load(c, RAX, RDI, JIT_ARG_C+8*(p0+t));
+				for(jj=0; jj<nj; jj++)
+					{
+					y = 4*t+jj;
+					disp = 8*PS*(jb+jj);
+					emit_vmulpd(c, y, 12, y);
+					if(!beta_zero)
+						{
+						emit_vmovupd_load(c, 13, RAX, disp);
+						emit_vfmadd231pd(c, y, 14, 13);
+						}
+					r0 = lower ? jb+jj : 0;
+					l0 = r0-PS*(p0+t)>0 ? r0-PS*(p0+t) : 0;
+					l1 = m-PS*(p0+t)<PS ? m-PS*(p0+t) : PS;
+					if(l0>=l1)
+						continue;
+					if(l0==0 & l1==PS)
+						{
+						emit_vmovupd_store(c, y, RCX, disp);
+						}
+					else
+						{
+						emit_mov_imm(c, RDX, jit_mask[l0][l1]);
+						emit_vmovupd_load(c, 15, RDX, 0);
+						emit_vmaskmovpd_store(c, 15, y, RCX, disp);
+						}
+					}
+				}
+			}
+		}
+	emit_ret(c);
+	}
+
+
+
+// generate the kernel in its own pages, written and then made executable
+static jit_kernel jit_generate(int type, int m, int n, int k, int beta_zero, size_t *psize)
+	{
+	struct jit_code c;
+	c.buf = NULL;
+	c.size = 0;
+	jit_gen_dgemm(&c, type, m, n, k, beta_zero);
+
+	long page = sysconf(_SC_PAGESIZE);
+	size_t size = (c.size+page-1)/page*page;
+	void *mem = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if(mem==MAP_FAILED)
+		return NULL;
+	c.buf = mem;
+	c.size = 0;
+	jit_gen_dgemm(&c, type, m, n, k, beta_zero);
+	if(mprotect(mem, size, PROT_READ | PROT_EXEC)!=0)
+		{
+		munmap(mem, size);
+		return NULL;
+		}
+	*psize = size;
+	return (jit_kernel) mem;
+	}
+
+
+
+static jit_kernel jit_lookup(int type, int m, int n, int k, int beta_zero)
+	{
+	uint64_t key = 1ull<<40 | (uint64_t) beta_zero<<32 | (uint64_t) type<<24 | (uint64_t) m<<16 | (uint64_t) n<<8 | (uint64_t) k;
+	unsigned int h = (unsigned int) ((key * 0x9e3779b97f4a7c15ull) >> 54) & (JIT_TABLE_SIZE-1);
+	unsigned int ii;
+	uint64_t key_ii;
+	jit_kernel kernel;
+
+	// lock-free lookup, the key is published after the kernel
+	for(ii=h; ; ii=(ii+1)&(JIT_TABLE_SIZE-1))
+		{
+		key_ii = __atomic_load_n(&jit_table[ii].key, __ATOMIC_ACQUIRE);
+		if(key_ii==key)
+			return jit_table[ii].kernel;
+		if(key_ii==0)
+			break;
+		}
+
+	// cache full: other sizes use the generic routines
+	if(__atomic_load_n(&jit_entries, __ATOMIC_RELAXED)>=JIT_MAX_ENTRIES)
+		return NULL;
+
+	// generate and insert
+	while(__atomic_test_and_set(&jit_lock, __ATOMIC_ACQUIRE))
+		;
+	for(ii=h; ; ii=(ii+1)&(JIT_TABLE_SIZE-1))
+		{
+		key_ii = jit_table[ii].key;
+		if(key_ii==key)
+			{
+			// inserted meanwhile by another thread
+			kernel = jit_table[ii].kernel;
+			break;
+			}
+		if(key_ii==0)
+			{
+			kernel = NULL;
+			if(jit_entries>=JIT_MAX_ENTRIES)
+				break;
+			kernel = jit_generate(type, m, n, k, beta_zero, &jit_table[ii].size);
+			if(kernel!=NULL)
+				jit_count++;
+			jit_table[ii].kernel = kernel;
+			__atomic_store_n(&jit_table[ii].key, key, __ATOMIC_RELEASE);
+			__atomic_store_n(&jit_entries, jit_entries+1, __ATOMIC_RELAXED);
+			break;
+			}
+		}
+	__atomic_clear(&jit_lock, __ATOMIC_RELEASE);
+	return kernel;
+	}
+
+
+
+void *blasfeo_jit_dgemm_kernel(int type, int m, int n, int k, double beta)
+	{
+	if(m>BLASFEO_JIT_MAX_SIZE | n>BLASFEO_JIT_MAX_SIZE | k>BLASFEO_JIT_MAX_SIZE | m<=0 | n<=0 | k<=0 | m*n*k>BLASFEO_JIT_MAX_MNK)
+		return NULL;
+
+	if(jit_state==0)
+		{
+		char *env = getenv("BLASFEO_JIT");
+		jit_state = env!=NULL && env[0]=='0' ? -1 : 1;
+		}
+	if(jit_state<0)
+		return NULL;
+
+	return (void *) jit_lookup(type, m, n, k, beta==0.0);
+	}
+
+
+
+void blasfeo_jit_dgemm_run(void *kernel, int type, int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	struct jit_args args;
+	int sda = sA->cn;
+	int sdb = sB->cn;
+	int sdc = sC->cn;
+	int sdd = sD->cn;
+	int nb = type==BLASFEO_JIT_DGEMM_NN ? k : n;
+	int ii;
+
+	args.alpha = alpha;
+	args.beta = beta;
+	for(ii=0; ii<(m+PS-1)/PS; ii++)
+		{
+		args.pA[ii] = sA->pA + (ai+PS*ii)*sda + aj*PS;
+		args.pC[ii] = sC->pA + (ci+PS*ii)*sdc + cj*PS;
+		args.pD[ii] = sD->pA + (di+PS*ii)*sdd + dj*PS;
+		}
+	for(ii=0; ii<(nb+PS-1)/PS; ii++)
+		args.pB[ii] = sB->pA + (bi+PS*ii)*sdb + bj*PS;
+
+	// invalidate stored inverse diagonal of result matrix
+	sD->use_dA = 0;
+
+	((jit_kernel) kernel)(&args);
+
+	return;
+	}
+
+
+
+int blasfeo_jit_dgemm(int type, int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	if(((ai | bi | ci | di) & (PS-1))!=0)
+		return 0;
+
+	void *kernel = blasfeo_jit_dgemm_kernel(type, m, n, k, beta);
+	if(kernel==NULL)
+		return 0;
+
+	blasfeo_jit_dgemm_run(kernel, type, m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+
+	return 1;
+	}
+
+
+
+int blasfeo_jit_kernel_count()
+	{
+	return __atomic_load_n(&jit_count, __ATOMIC_RELAXED);
+	}
+
+
+
+void blasfeo_jit_free()
+	{
+	int ii;
+	while(__atomic_test_and_set(&jit_lock, __ATOMIC_ACQUIRE))
+		;
+	for(ii=0; ii<JIT_TABLE_SIZE; ii++)
+		{
+		if(jit_table[ii].kernel!=NULL)
+			munmap((void *) jit_table[ii].kernel, jit_table[ii].size);
+		jit_table[ii].kernel = NULL;
+		__atomic_store_n(&jit_table[ii].key, 0, __ATOMIC_RELEASE);
+		}
+	__atomic_store_n(&jit_entries, 0, __ATOMIC_RELAXED);
+	__atomic_store_n(&jit_count, 0, __ATOMIC_RELAXED);
+	__atomic_clear(&jit_lock, __ATOMIC_RELEASE);
+	return;
+	}
+
+
+
+#else // JIT
+
+
+
+void *blasfeo_jit_dgemm_kernel(int type, int m, int n, int k, double beta)
+	{
+	return NULL;
+	}
+
+
+
+void blasfeo_jit_dgemm_run(void *kernel, int type, int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	return;
+	}
+
+
+
+int blasfeo_jit_dgemm(int type, int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	return 0;
+	}
+
+
+
+int blasfeo_jit_kernel_count()
+	{
+	return 0;
+	}
+
+
+
+void blasfeo_jit_free()
+	{
+	return;
+	}
+
+
+
+#endif // JIT
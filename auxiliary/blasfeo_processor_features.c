@@ -33,6 +33,8 @@
 *                                                                                                 *
 **************************************************************************************************/
 
+#include <stdio.h>
+
 #include "../include/blasfeo_processor_features.h"
 #include "../include/blasfeo_target.h"
 
@@ -41,13 +43,17 @@
     || defined(TARGET_X64_INTEL_CORE) \
     || defined(TARGET_X64_AMD_BULLDOZER) \
     || defined(TARGET_X86_AMD_JAGUAR) \
-    || defined(TARGET_X86_AMD_BARCELONA)
+    || defined(TARGET_X86_AMD_BARCELONA) \
+    || defined(TARGET_X64_FAT)
 #if defined(__GNUC__) || defined(__clang__)
 #include <cpuid.h>
 // define missing bit_AVX2 (e.g. in case of clang compiler)
 #ifndef bit_AVX2
 #define bit_AVX2 (1 << 5)
 #endif
+#ifndef bit_F16C
+#define bit_F16C (1 << 29)
+#endif
 #endif
 #endif
 
@@ -89,6 +95,15 @@ void blasfeo_processor_feature_string( int features, char* featureString )
         featureString[idx++] = '3';
     }
 
+    if( features & BLASFEO_PROCESSOR_FEATURE_F16C )
+    {
+        featureString[idx++] = ' ';
+        featureString[idx++] = 'F';
+        featureString[idx++] = '1';
+        featureString[idx++] = '6';
+        featureString[idx++] = 'C';
+    }
+
     featureString[idx] = 0;
 }
 
@@ -101,6 +116,46 @@ void blasfeo_processor_library_string( char* featureString )
 }
 
 
+// the fat library defines it in blasfeo_fat.c, based on the target selected at run-time
+#if !defined(TARGET_X64_FAT)
+void blasfeo_processor_target_string( char* targetString )
+{
+#if defined(TARGET_X64_INTEL_HASWELL)
+    const char *target = "X64_INTEL_HASWELL";
+#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
+    const char *target = "X64_INTEL_SANDY_BRIDGE";
+#elif defined(TARGET_X64_INTEL_CORE)
+    const char *target = "X64_INTEL_CORE";
+#elif defined(TARGET_X64_AMD_BULLDOZER)
+    const char *target = "X64_AMD_BULLDOZER";
+#elif defined(TARGET_X86_AMD_JAGUAR)
+    const char *target = "X86_AMD_JAGUAR";
+#elif defined(TARGET_X86_AMD_BARCELONA)
+    const char *target = "X86_AMD_BARCELONA";
+#elif defined(TARGET_ARMV8A_ARM_CORTEX_A57)
+    const char *target = "ARMV8A_ARM_CORTEX_A57";
+#elif defined(TARGET_ARMV8A_ARM_CORTEX_A53)
+    const char *target = "ARMV8A_ARM_CORTEX_A53";
+#elif defined(TARGET_ARMV7A_ARM_CORTEX_A15)
+    const char *target = "ARMV7A_ARM_CORTEX_A15";
+#elif defined(TARGET_ARMV7A_ARM_CORTEX_A9)
+    const char *target = "ARMV7A_ARM_CORTEX_A9";
+#elif defined(TARGET_ARMV7A_ARM_CORTEX_A7)
+    const char *target = "ARMV7A_ARM_CORTEX_A7";
+#else
+    const char *target = "GENERIC";
+#endif
+    int idx = 0;
+    while( target[idx] )
+    {
+        targetString[idx] = target[idx];
+        idx++;
+    }
+    targetString[idx] = 0;
+}
+#endif
+
+
 void blasfeo_processor_library_features( int* features )
 {
     *features = 0;
@@ -120,6 +175,10 @@ void blasfeo_processor_library_features( int* features )
     #if defined(TARGET_NEED_FEATURE_SSE3)
     *features |= BLASFEO_PROCESSOR_FEATURE_SSE3;
     #endif
+
+    #if defined(TARGET_NEED_FEATURE_F16C)
+    *features |= BLASFEO_PROCESSOR_FEATURE_F16C;
+    #endif
 }
 
 
@@ -132,7 +191,8 @@ int blasfeo_processor_cpu_features( int* features )
     || defined(TARGET_X64_INTEL_CORE) \
     || defined(TARGET_X64_AMD_BULLDOZER) \
     || defined(TARGET_X86_AMD_JAGUAR) \
-    || defined(TARGET_X86_AMD_BARCELONA)
+    || defined(TARGET_X86_AMD_BARCELONA) \
+    || defined(TARGET_X64_FAT)
 
 // GCC and clang provide the __get_cpuid function
 #if defined(__GNUC__) || defined(__clang__)
@@ -153,6 +213,10 @@ int blasfeo_processor_cpu_features( int* features )
     if( reg_ecx & bit_SSE3 )
         *features |= BLASFEO_PROCESSOR_FEATURE_SSE3;
 
+    // F16C is in the ECX register of leaf 1
+    if( reg_ecx & bit_F16C )
+        *features |= BLASFEO_PROCESSOR_FEATURE_F16C;
+
     // Test for extended features next in leaf 7 (subleaf 0)
 #if __GNUC__>5
     __get_cpuid_count( 7, 0, &reg_eax, &reg_ebx, &reg_ecx, &reg_edx );
@@ -179,3 +243,283 @@ int blasfeo_processor_cpu_features( int* features )
 
     return ( libraryFeatures == ( *features & libraryFeatures ) ) ? 1 : 0;
 }
+
+
+// typical sizes (per core for L1 and L2) of the processors of the target; 0 means no such cache
+static void blasfeo_processor_cache_size_default( int* l1, int* l2, int* l3 )
+{
+#if defined(TARGET_X64_INTEL_HASWELL) \
+    || defined(TARGET_X64_INTEL_SANDY_BRIDGE) \
+    || defined(TARGET_X64_FAT)
+    *l1 = 32*1024;
+    *l2 = 256*1024;
+    *l3 = 8*1024*1024;
+#elif defined(TARGET_X64_INTEL_CORE)
+    *l1 = 32*1024;
+    *l2 = 256*1024;
+    *l3 = 4*1024*1024;
+#elif defined(TARGET_X64_AMD_BULLDOZER)
+    *l1 = 16*1024;
+    *l2 = 2*1024*1024;
+    *l3 = 8*1024*1024;
+#elif defined(TARGET_X86_AMD_JAGUAR)
+    *l1 = 32*1024;
+    *l2 = 2*1024*1024;
+    *l3 = 0;
+#elif defined(TARGET_X86_AMD_BARCELONA)
+    *l1 = 64*1024;
+    *l2 = 512*1024;
+    *l3 = 2*1024*1024;
+#elif defined(TARGET_ARMV8A_ARM_CORTEX_A57) \
+    || defined(TARGET_ARMV7A_ARM_CORTEX_A15)
+    *l1 = 32*1024;
+    *l2 = 2*1024*1024;
+    *l3 = 0;
+#elif defined(TARGET_ARMV8A_ARM_CORTEX_A53) \
+    || defined(TARGET_ARMV7A_ARM_CORTEX_A9) \
+    || defined(TARGET_ARMV7A_ARM_CORTEX_A7)
+    *l1 = 32*1024;
+    *l2 = 512*1024;
+    *l3 = 0;
+#else
+    *l1 = 32*1024;
+    *l2 = 256*1024;
+    *l3 = 0;
+#endif
+}
+
+
+#if defined(TARGET_X64_INTEL_HASWELL) \
+    || defined(TARGET_X64_INTEL_SANDY_BRIDGE) \
+    || defined(TARGET_X64_INTEL_CORE) \
+    || defined(TARGET_X64_AMD_BULLDOZER) \
+    || defined(TARGET_X86_AMD_JAGUAR) \
+    || defined(TARGET_X86_AMD_BARCELONA) \
+    || defined(TARGET_X64_FAT)
+#if defined(__GNUC__) || defined(__clang__)
+// read the deterministic cache parameters, in leaf 4 (intel) or leaf 0x8000001d (amd);
+// return 0 if the processor does not report them
+static int blasfeo_processor_cache_size_cpuid( int* l1, int* l2, int* l3, int* line )
+{
+    unsigned int reg_eax, reg_ebx, reg_ecx, reg_edx;
+    unsigned int leaf = 4;
+
+    if( __get_cpuid_max( 0, 0 ) < 4 )
+        leaf = 0;
+    else
+    {
+        __cpuid_count( 4, 0, reg_eax, reg_ebx, reg_ecx, reg_edx );
+        if( ( reg_eax & 0x1f ) == 0 )
+            leaf = 0;
+    }
+    if( leaf == 0 )
+    {
+        if( __get_cpuid_max( 0x80000000, 0 ) < 0x8000001d )
+            return 0;
+        leaf = 0x8000001d;
+    }
+
+    int found = 0;
+    unsigned int idx;
+    for( idx = 0; idx < 16; idx++ )
+    {
+        __cpuid_count( leaf, idx, reg_eax, reg_ebx, reg_ecx, reg_edx );
+
+        // cache type in EAX[4:0]: 0 no more caches, 1 data, 2 instruction, 3 unified
+        int type = reg_eax & 0x1f;
+        if( type == 0 )
+            break;
+        if( type == 2 )
+            continue;
+
+        int level = ( reg_eax >> 5 ) & 0x7;
+        int line_size = ( reg_ebx & 0xfff ) + 1;
+        int partitions = ( ( reg_ebx >> 12 ) & 0x3ff ) + 1;
+        int ways = ( ( reg_ebx >> 22 ) & 0x3ff ) + 1;
+        int sets = reg_ecx + 1;
+        long long size = (long long) ways * partitions * line_size * sets;
+        int size_int = size < 0x7fffffff ? (int) size : 0x7fffffff;
+
+        if( level == 1 )
+        {
+            *l1 = size_int;
+            *line = line_size;
+            found = 1;
+        }
+        else if( level == 2 )
+            *l2 = size_int;
+        else if( level == 3 )
+            *l3 = size_int;
+    }
+
+    return found;
+}
+#endif
+#endif
+
+
+#if defined(OS_LINUX)
+// read an integer from a sysfs file, with an optional K or M suffix; return 0 on failure
+static int blasfeo_processor_sysfs_read( const char* path, int* value, char* type )
+{
+    FILE *file = fopen( path, "r" );
+    if( file == NULL )
+        return 0;
+
+    int ret;
+    if( type != NULL )
+    {
+        ret = fscanf( file, "%15s", type ) == 1;
+    }
+    else
+    {
+        char suffix = 0;
+        ret = fscanf( file, "%d%c", value, &suffix ) >= 1;
+        if( suffix == 'K' )
+            *value *= 1024;
+        else if( suffix == 'M' )
+            *value *= 1024*1024;
+    }
+
+    fclose( file );
+    return ret;
+}
+
+
+// read the caches of cpu0 from /sys/devices/system/cpu; return 0 if they are not found
+static int blasfeo_processor_cache_size_sysfs( int* l1, int* l2, int* l3, int* line )
+{
+    char path[128];
+    char type[16];
+    int found = 0;
+    int idx;
+    for( idx = 0; idx < 16; idx++ )
+    {
+        int level, size, line_size;
+
+        snprintf( path, sizeof( path ), "/sys/devices/system/cpu/cpu0/cache/index%d/level", idx );
+        if( !blasfeo_processor_sysfs_read( path, &level, NULL ) )
+            break;
+        snprintf( path, sizeof( path ), "/sys/devices/system/cpu/cpu0/cache/index%d/type", idx );
+        if( !blasfeo_processor_sysfs_read( path, NULL, type ) || type[0] == 'I' )
+            continue;
+        snprintf( path, sizeof( path ), "/sys/devices/system/cpu/cpu0/cache/index%d/size", idx );
+        if( !blasfeo_processor_sysfs_read( path, &size, NULL ) )
+            continue;
+
+        if( level == 1 )
+        {
+            *l1 = size;
+            snprintf( path, sizeof( path ), "/sys/devices/system/cpu/cpu0/cache/index%d/coherency_line_size", idx );
+            if( blasfeo_processor_sysfs_read( path, &line_size, NULL ) && line_size > 0 )
+                *line = line_size;
+            found = 1;
+        }
+        else if( level == 2 )
+            *l2 = size;
+        else if( level == 3 )
+            *l3 = size;
+    }
+
+    return found;
+}
+#endif
+
+
+// cache sizes detected on the first call (all the threads detect the same values)
+static volatile int cache_detected = 0;
+static volatile int cache_l1, cache_l2, cache_l3, cache_line;
+
+
+static void blasfeo_processor_cache_detect( void )
+{
+    int l1, l2, l3;
+    int line = 64;
+    blasfeo_processor_cache_size_default( &l1, &l2, &l3 );
+
+    int found = 0;
+#if defined(TARGET_X64_INTEL_HASWELL) \
+    || defined(TARGET_X64_INTEL_SANDY_BRIDGE) \
+    || defined(TARGET_X64_INTEL_CORE) \
+    || defined(TARGET_X64_AMD_BULLDOZER) \
+    || defined(TARGET_X86_AMD_JAGUAR) \
+    || defined(TARGET_X86_AMD_BARCELONA) \
+    || defined(TARGET_X64_FAT)
+#if defined(__GNUC__) || defined(__clang__)
+    int l1_tmp = 0, l2_tmp = 0, l3_tmp = 0, line_tmp = line;
+    found = blasfeo_processor_cache_size_cpuid( &l1_tmp, &l2_tmp, &l3_tmp, &line_tmp );
+    if( found )
+    {
+        l1 = l1_tmp;
+        l2 = l2_tmp;
+        l3 = l3_tmp;
+        line = line_tmp;
+    }
+#endif
+#endif
+
+#if defined(OS_LINUX)
+    if( !found )
+    {
+        int l1_tmp = 0, l2_tmp = 0, l3_tmp = 0, line_tmp = line;
+        found = blasfeo_processor_cache_size_sysfs( &l1_tmp, &l2_tmp, &l3_tmp, &line_tmp );
+        if( found )
+        {
+            l1 = l1_tmp;
+            l2 = l2_tmp;
+            l3 = l3_tmp;
+            line = line_tmp;
+        }
+    }
+#endif
+
+    cache_l1 = l1;
+    cache_l2 = l2;
+    cache_l3 = l3;
+    cache_line = line;
+    cache_detected = 1;
+}
+
+
+void blasfeo_processor_cache_size( int* l1, int* l2, int* l3 )
+{
+    if( !cache_detected )
+        blasfeo_processor_cache_detect();
+
+    *l1 = cache_l1;
+    *l2 = cache_l2;
+    *l3 = cache_l3;
+}
+
+
+void blasfeo_processor_cache_line_size( int* line )
+{
+    if( !cache_detected )
+        blasfeo_processor_cache_detect();
+
+    *line = cache_line;
+}
+
+
+void blasfeo_processor_gemm_block_size( int m_kernel, int n_kernel, int size_el, int* kc, int* mc, int* nc )
+{
+    int l1, l2, l3;
+    blasfeo_processor_cache_size( &l1, &l2, &l3 );
+
+    // a m_kernel x kc panel of A and a kc x n_kernel panel of B fill L1
+    int k_block = l1 / ( (m_kernel+n_kernel) * size_el ) / 8 * 8;
+    k_block = k_block<64 ? 64 : k_block;
+
+    // a mc x kc block of A fills half L2
+    int m_block = l2 / 2 / ( k_block * size_el ) / m_kernel * m_kernel;
+    m_block = m_block<m_kernel ? m_kernel : m_block;
+
+    // a kc x nc block of B fills half L3 (half the last level cache if there is no L3)
+    int l_last = l3>l2 ? l3 : l2;
+    int n_block = l_last / 2 / ( k_block * size_el ) / n_kernel * n_kernel;
+    n_block = n_block<m_block ? m_block : n_block;
+
+    *kc = k_block;
+    *mc = m_block;
+    *nc = n_block;
+}
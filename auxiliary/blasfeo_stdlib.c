@@ -90,3 +90,72 @@ void blasfeo_free_align(void *ptr)
 	return;
 
 	}
+
+
+
+#if defined(_MSC_VER)
+#define BLASFEO_THREAD_LOCAL __declspec(thread)
+#elif defined(__GNUC__) || defined(__clang__)
+#define BLASFEO_THREAD_LOCAL __thread
+#else
+#define BLASFEO_THREAD_LOCAL
+#endif
+
+// workspace arena of the calling thread, used as a stack
+static BLASFEO_THREAD_LOCAL char *ws_mem = NULL;
+static BLASFEO_THREAD_LOCAL size_t ws_size = 0;
+static BLASFEO_THREAD_LOCAL size_t ws_used = 0;
+static BLASFEO_THREAD_LOCAL size_t ws_peak = 0;
+
+
+
+void blasfeo_blas_workspace_set(void *work, size_t size)
+	{
+	ws_mem = work;
+	ws_size = work!=NULL ? size : 0;
+	ws_used = 0;
+	ws_peak = 0;
+	return;
+	}
+
+
+
+void *blasfeo_blas_workspace_malloc(size_t size)
+	{
+	// keep the following allocation on a cache line boundary
+	size_t size_align = (size+63)/64*64;
+	// count also the allocations that do not fit
+	if(ws_mem!=NULL && ws_used+size_align>ws_peak)
+		ws_peak = ws_used+size_align;
+	if(ws_mem!=NULL && ws_size-ws_used>=size_align)
+		{
+		void *ptr = ws_mem+ws_used;
+		ws_used += size_align;
+		return ptr;
+		}
+	return malloc(size);
+	}
+
+
+
+void blasfeo_blas_workspace_free(void *ptr)
+	{
+	if(ptr==NULL)
+		return;
+	if(ws_mem!=NULL && (char *) ptr>=ws_mem && (char *) ptr<ws_mem+ws_size)
+		{
+		// release also the later allocations, so that the buffers of a routine can be freed in any order
+		if((size_t) ((char *) ptr - ws_mem) < ws_used)
+			ws_used = (char *) ptr - ws_mem;
+		return;
+		}
+	free(ptr);
+	return;
+	}
+
+
+
+size_t blasfeo_blas_workspace_peak()
+	{
+	return ws_peak;
+	}
@@ -0,0 +1,460 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+
+#include <stdlib.h>
+#include <stdio.h>
+#if defined(MULTI_THREAD)
+#include <pthread.h>
+#endif
+#include "../include/blasfeo_thread.h"
+
+
+
+#if defined(MULTI_THREAD)
+
+
+
+// persistent pool of worker threads, started at the first parallel region
+struct blasfeo_thread_pool
+	{
+	pthread_t thread[BLASFEO_MAX_THREADS];
+	pthread_mutex_t mutex; // protects all the fields below
+	pthread_cond_t work_cond; // signals a new job (or quit) to the workers
+	pthread_cond_t done_cond; // signals the end of the job to the calling thread
+	void (*fun)(void *arg, int task_id);
+	void *arg;
+	int n_task; // number of tasks in the current job
+	int next_task; // next task to be picked up
+	int n_busy; // number of workers not yet done with the current job
+	int generation; // job counter
+	int start_generation; // job counter at the time the workers are started
+	int n_worker; // number of running worker threads
+	int quit;
+	};
+
+
+
+static struct blasfeo_thread_pool pool = {.mutex=PTHREAD_MUTEX_INITIALIZER, .work_cond=PTHREAD_COND_INITIALIZER, .done_cond=PTHREAD_COND_INITIALIZER};
+// held for the whole duration of a parallel region
+static pthread_mutex_t region_mutex = PTHREAD_MUTEX_INITIALIZER;
+// set in the threads running a parallel region (workers included), to run nested calls serially
+static __thread int in_parallel = 0;
+static int num_threads = 1;
+
+
+
+static void *blasfeo_thread_worker(void *ptr)
+	{
+	int generation;
+	int task_id;
+	void (*fun)(void *arg, int task_id);
+	void *arg;
+
+	// workers only run inside parallel regions
+	in_parallel = 1;
+
+	pthread_mutex_lock(&pool.mutex);
+	generation = pool.start_generation;
+	while(1)
+		{
+		while(pool.generation==generation & pool.quit==0)
+			pthread_cond_wait(&pool.work_cond, &pool.mutex);
+		if(pool.quit)
+			break;
+		generation = pool.generation;
+		fun = pool.fun;
+		arg = pool.arg;
+		while(pool.next_task<pool.n_task)
+			{
+			task_id = pool.next_task++;
+			pthread_mutex_unlock(&pool.mutex);
+			fun(arg, task_id);
+			pthread_mutex_lock(&pool.mutex);
+			}
+		pool.n_busy--;
+		if(pool.n_busy==0)
+			pthread_cond_signal(&pool.done_cond);
+		}
+	pthread_mutex_unlock(&pool.mutex);
+
+	return NULL;
+	}
+
+
+
+// to be called with region_mutex locked
+static void blasfeo_thread_pool_stop()
+	{
+	int ii;
+	pthread_mutex_lock(&pool.mutex);
+	pool.quit = 1;
+	pthread_cond_broadcast(&pool.work_cond);
+	pthread_mutex_unlock(&pool.mutex);
+	for(ii=0; ii<pool.n_worker; ii++)
+		pthread_join(pool.thread[ii], NULL);
+	pool.n_worker = 0;
+	pool.quit = 0;
+	return;
+	}
+
+
+
+// to be called with region_mutex locked
+static void blasfeo_thread_pool_start(int n_worker)
+	{
+	pthread_mutex_lock(&pool.mutex);
+	// new workers must not pick up an old job
+	pool.start_generation = pool.generation;
+	pthread_mutex_unlock(&pool.mutex);
+	while(pool.n_worker<n_worker)
+		{
+		if(pthread_create(&pool.thread[pool.n_worker], NULL, blasfeo_thread_worker, NULL)!=0)
+			break;
+		pool.n_worker++;
+		}
+	return;
+	}
+
+
+
+void blasfeo_set_num_threads(int nt)
+	{
+	nt = nt<1 ? 1 : nt;
+	nt = nt>BLASFEO_MAX_THREADS ? BLASFEO_MAX_THREADS : nt;
+	pthread_mutex_lock(&region_mutex);
+	// workers are started lazily at the next parallel region
+	if(pool.n_worker>nt-1)
+		blasfeo_thread_pool_stop();
+	num_threads = nt;
+	pthread_mutex_unlock(&region_mutex);
+	return;
+	}
+
+
+
+int blasfeo_get_num_threads()
+	{
+	return num_threads;
+	}
+
+
+
+int blasfeo_thread_pool_num_threads()
+	{
+	return in_parallel ? 1 : num_threads;
+	}
+
+
+
+void blasfeo_thread_pool_run(int n_task, void (*fun)(void *arg, int task_id), void *arg)
+	{
+	int ii;
+	int task_id;
+
+	// serial execution if single-threaded, nested, or if the pool is busy in another thread
+	// (short-circuit: the lock must be taken only if the region runs in parallel)
+	if(num_threads<=1 || n_task<=1 || pthread_mutex_trylock(&region_mutex)!=0)
+		{
+		for(ii=0; ii<n_task; ii++)
+			fun(arg, ii);
+		return;
+		}
+
+	in_parallel = 1;
+
+	if(pool.n_worker<num_threads-1)
+		blasfeo_thread_pool_start(num_threads-1);
+
+	pthread_mutex_lock(&pool.mutex);
+	pool.fun = fun;
+	pool.arg = arg;
+	pool.n_task = n_task;
+	pool.next_task = 0;
+	pool.n_busy = pool.n_worker;
+	pool.generation++;
+	pthread_cond_broadcast(&pool.work_cond);
+	// the calling thread takes part in the job
+	while(pool.next_task<pool.n_task)
+		{
+		task_id = pool.next_task++;
+		pthread_mutex_unlock(&pool.mutex);
+		fun(arg, task_id);
+		pthread_mutex_lock(&pool.mutex);
+		}
+	while(pool.n_busy>0)
+		pthread_cond_wait(&pool.done_cond, &pool.mutex);
+	pthread_mutex_unlock(&pool.mutex);
+
+	in_parallel = 0;
+
+	pthread_mutex_unlock(&region_mutex);
+
+	return;
+	}
+
+
+
+#else // single-threaded
+
+
+
+void blasfeo_set_num_threads(int nt)
+	{
+	return;
+	}
+
+
+
+int blasfeo_get_num_threads()
+	{
+	return 1;
+	}
+
+
+
+int blasfeo_thread_pool_num_threads()
+	{
+	return 1;
+	}
+
+
+
+void blasfeo_thread_pool_run(int n_task, void (*fun)(void *arg, int task_id), void *arg)
+	{
+	int ii;
+	for(ii=0; ii<n_task; ii++)
+		fun(arg, ii);
+	return;
+	}
+
+
+
+#endif // MULTI_THREAD
+
+
+
+// task graph state, shared by the threads running it
+struct blasfeo_thread_dag
+	{
+#if defined(MULTI_THREAD)
+	pthread_mutex_t mutex; // protects all the fields below
+	pthread_cond_t cond; // signals new ready tasks (or the end of the graph)
+#endif
+	void (*fun)(void *arg, int task_id);
+	void *arg;
+	int *prio;
+	int *n_pred; // number of predecessors not done yet
+	int *succ_idx;
+	int *succ;
+	int *heap; // ready tasks, min-heap on the priority
+	int n_heap;
+	int n_task;
+	int n_done;
+	};
+
+
+
+static int blasfeo_thread_dag_less(struct blasfeo_thread_dag *dag, int t0, int t1)
+	{
+	if(dag->prio!=NULL && dag->prio[t0]!=dag->prio[t1])
+		return dag->prio[t0]<dag->prio[t1];
+	return t0<t1;
+	}
+
+
+
+static void blasfeo_thread_dag_push(struct blasfeo_thread_dag *dag, int task_id)
+	{
+	int *heap = dag->heap;
+	int ii = dag->n_heap++;
+	int jj;
+	while(ii>0)
+		{
+		jj = (ii-1)/2;
+		if(!blasfeo_thread_dag_less(dag, task_id, heap[jj]))
+			break;
+		heap[ii] = heap[jj];
+		ii = jj;
+		}
+	heap[ii] = task_id;
+	return;
+	}
+
+
+
+static int blasfeo_thread_dag_pop(struct blasfeo_thread_dag *dag)
+	{
+	int *heap = dag->heap;
+	int task_id = heap[0];
+	int last = heap[--dag->n_heap];
+	int n_heap = dag->n_heap;
+	int ii = 0;
+	int jj;
+	while(2*ii+1<n_heap)
+		{
+		jj = 2*ii+1;
+		if(jj+1<n_heap && blasfeo_thread_dag_less(dag, heap[jj+1], heap[jj]))
+			jj++;
+		if(!blasfeo_thread_dag_less(dag, heap[jj], last))
+			break;
+		heap[ii] = heap[jj];
+		ii = jj;
+		}
+	heap[ii] = last;
+	return task_id;
+	}
+
+
+
+// mark the task as done and release its successors
+static void blasfeo_thread_dag_done(struct blasfeo_thread_dag *dag, int task_id)
+	{
+	int ii, s;
+	dag->n_done++;
+	for(ii=dag->succ_idx[task_id]; ii<dag->succ_idx[task_id+1]; ii++)
+		{
+		s = dag->succ[ii];
+		dag->n_pred[s]--;
+		if(dag->n_pred[s]==0)
+			blasfeo_thread_dag_push(dag, s);
+		}
+	return;
+	}
+
+
+
+// each thread of the pool picks ready tasks until the whole graph is done
+static void blasfeo_thread_dag_worker(void *ptr, int id)
+	{
+	struct blasfeo_thread_dag *dag = ptr;
+	int task_id;
+#if defined(MULTI_THREAD)
+	pthread_mutex_lock(&dag->mutex);
+	while(dag->n_done<dag->n_task)
+		{
+		if(dag->n_heap==0)
+			{
+			pthread_cond_wait(&dag->cond, &dag->mutex);
+			continue;
+			}
+		task_id = blasfeo_thread_dag_pop(dag);
+		pthread_mutex_unlock(&dag->mutex);
+		dag->fun(dag->arg, task_id);
+		pthread_mutex_lock(&dag->mutex);
+		blasfeo_thread_dag_done(dag, task_id);
+		if(dag->n_heap>0 | dag->n_done==dag->n_task)
+			pthread_cond_broadcast(&dag->cond);
+		}
+	pthread_mutex_unlock(&dag->mutex);
+#else
+	while(dag->n_heap>0)
+		{
+		task_id = blasfeo_thread_dag_pop(dag);
+		dag->fun(dag->arg, task_id);
+		blasfeo_thread_dag_done(dag, task_id);
+		}
+#endif
+	return;
+	}
+
+
+
+size_t blasfeo_thread_dag_memsize(int n_task, int n_edge)
+	{
+	n_task = n_task>0 ? n_task : 0;
+	n_edge = n_edge>0 ? n_edge : 0;
+	return (3*n_task+1+n_edge)*sizeof(int);
+	}
+
+
+
+void blasfeo_thread_dag_run(int n_task, int *pred_idx, int *pred, int *prio, void (*fun)(void *arg, int task_id), void *arg, void *work)
+	{
+	if(n_task<=0)
+		return;
+
+	int n_edge = pred_idx[n_task];
+	int ii, jj;
+
+	struct blasfeo_thread_dag dag;
+	dag.n_pred = work;
+	dag.heap = dag.n_pred+n_task;
+	dag.succ_idx = dag.heap+n_task;
+	dag.succ = dag.succ_idx+n_task+1;
+	dag.fun = fun;
+	dag.arg = arg;
+	dag.prio = prio;
+	dag.n_heap = 0;
+	dag.n_task = n_task;
+	dag.n_done = 0;
+
+	// successor lists (transpose of the predecessor lists)
+	for(ii=0; ii<=n_task; ii++)
+		dag.succ_idx[ii] = 0;
+	for(ii=0; ii<n_edge; ii++)
+		dag.succ_idx[pred[ii]+1]++;
+	for(ii=0; ii<n_task; ii++)
+		dag.succ_idx[ii+1] += dag.succ_idx[ii];
+	// use n_pred as insertion counter
+	for(ii=0; ii<n_task; ii++)
+		dag.n_pred[ii] = dag.succ_idx[ii];
+	for(ii=0; ii<n_task; ii++)
+		{
+		for(jj=pred_idx[ii]; jj<pred_idx[ii+1]; jj++)
+			{
+			dag.succ[dag.n_pred[pred[jj]]++] = ii;
+			}
+		}
+	for(ii=0; ii<n_task; ii++)
+		{
+		dag.n_pred[ii] = pred_idx[ii+1]-pred_idx[ii];
+		if(dag.n_pred[ii]==0)
+			blasfeo_thread_dag_push(&dag, ii);
+		}
+
+#if defined(MULTI_THREAD)
+	pthread_mutex_init(&dag.mutex, NULL);
+	pthread_cond_init(&dag.cond, NULL);
+	blasfeo_thread_pool_run(blasfeo_thread_pool_num_threads(), &blasfeo_thread_dag_worker, &dag);
+	pthread_cond_destroy(&dag.cond);
+	pthread_mutex_destroy(&dag.mutex);
+#else
+	blasfeo_thread_dag_worker(&dag, 0);
+#endif
+
+	return;
+	}
@@ -0,0 +1,230 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include "../include/blasfeo_tuning.h"
+
+
+
+// names of the entries in the tuning file
+#define TUNING_ENTRY(name) { #name, offsetof(struct blasfeo_tuning, name) }
+
+static const struct
+	{
+	const char *name;
+	size_t offset;
+	} tuning_entries[] =
+	{
+	TUNING_ENTRY(dgemm_nn_small_mn),
+	TUNING_ENTRY(dgemm_nn_pack_one_mn),
+	TUNING_ENTRY(dgemm_nn_pack_one_k),
+	TUNING_ENTRY(dgemm_nt_small_mn),
+	TUNING_ENTRY(dgemm_nt_pack_one_mn),
+	TUNING_ENTRY(dgemm_nt_pack_one_k),
+	TUNING_ENTRY(dgemm_tn_pack_one_mn),
+	TUNING_ENTRY(dgemm_tn_pack_one_k),
+	TUNING_ENTRY(dgemm_tt_small_mn),
+	TUNING_ENTRY(dgemm_tt_pack_one_mn),
+	TUNING_ENTRY(dgemm_tt_pack_one_k),
+	TUNING_ENTRY(dtrsm_lln_pack_mn),
+	TUNING_ENTRY(dtrsm_llt_pack_mn),
+	TUNING_ENTRY(dtrsm_lun_pack_mn),
+	TUNING_ENTRY(dtrsm_lut_pack_mn),
+	TUNING_ENTRY(dtrsm_rln_pack_mn),
+	TUNING_ENTRY(dtrsm_rlt_pack_mn),
+	TUNING_ENTRY(dtrsm_run_pack_mn),
+	TUNING_ENTRY(dtrsm_rut_pack_mn),
+	TUNING_ENTRY(dgetrf_pack_mn),
+	};
+
+#define TUNING_N_ENTRIES ((int) (sizeof(tuning_entries)/sizeof(tuning_entries[0])))
+
+#define TUNING_ENTRY_PTR(tun, ii) ((int *) ((char *) (tun) + tuning_entries[ii].offset))
+
+
+
+static struct blasfeo_tuning tuning;
+// the environment variable is read on the first call to blasfeo_tuning_table, unless a table is set before;
+// 0: not read yet, 1: being read by a thread, 2: table ready
+static volatile int tuning_init = 0;
+
+
+
+void blasfeo_tuning_default(struct blasfeo_tuning *tun)
+	{
+	int ii;
+	for(ii=0; ii<TUNING_N_ENTRIES; ii++)
+		*TUNING_ENTRY_PTR(tun, ii) = -1;
+	return;
+	}
+
+
+
+void blasfeo_tuning_get(struct blasfeo_tuning *tun)
+	{
+	*tun = *blasfeo_tuning_table();
+	return;
+	}
+
+
+
+void blasfeo_tuning_set(struct blasfeo_tuning *tun)
+	{
+	tuning = *tun;
+	tuning_init = 2;
+	return;
+	}
+
+
+
+// parse the file into tun, starting from the built-in values
+static int tuning_read(char *file_name, struct blasfeo_tuning *tun)
+	{
+	FILE *file = fopen(file_name, "r");
+	if(file==NULL)
+		return -1;
+
+	blasfeo_tuning_default(tun);
+
+	char line[256];
+	char name[64];
+	int value, ii, n_read;
+	int line_num = 0;
+	int ret = 0;
+	while(fgets(line, sizeof(line), file)!=NULL)
+		{
+		line_num++;
+		// strip comments
+		char *comment = strchr(line, '#');
+		if(comment!=NULL)
+			*comment = '\0';
+		n_read = sscanf(line, "%63s %d", name, &value);
+		if(n_read<=0)
+			continue; // blank line
+		for(ii=0; ii<TUNING_N_ENTRIES; ii++)
+			{
+			if(strcmp(name, tuning_entries[ii].name)==0)
+				break;
+			}
+		if(n_read!=2 | ii==TUNING_N_ENTRIES)
+			{
+			ret = line_num;
+			break;
+			}
+		*TUNING_ENTRY_PTR(tun, ii) = value;
+		}
+	fclose(file);
+
+	return ret;
+	}
+
+
+
+int blasfeo_tuning_load(char *file_name)
+	{
+	struct blasfeo_tuning tun;
+	int ret = tuning_read(file_name, &tun);
+	if(ret==0)
+		blasfeo_tuning_set(&tun);
+	return ret;
+	}
+
+
+
+int blasfeo_tuning_save(struct blasfeo_tuning *tun, char *file_name)
+	{
+	FILE *file = fopen(file_name, "w");
+	if(file==NULL)
+		return -1;
+
+	fprintf(file, "# BLASFEO tuning table, -1 selects the built-in value of the target\n");
+	int ii;
+	for(ii=0; ii<TUNING_N_ENTRIES; ii++)
+		fprintf(file, "%s %d\n", tuning_entries[ii].name, *TUNING_ENTRY_PTR(tun, ii));
+
+	return fclose(file)==0 ? 0 : -1;
+	}
+
+
+
+// built-in values, replaced by the file in the BLASFEO_TUNING_FILE environment variable if any
+static void tuning_init_env()
+	{
+	struct blasfeo_tuning tun;
+	blasfeo_tuning_default(&tuning);
+	char *file_name = getenv("BLASFEO_TUNING_FILE");
+	if(file_name!=NULL && file_name[0]!='\0')
+		{
+		if(tuning_read(file_name, &tun)==0)
+			tuning = tun;
+		else
+			printf("\nBLASFEO: tuning: can not read %s, using the built-in values\n", file_name);
+		}
+	return;
+	}
+
+
+
+struct blasfeo_tuning *blasfeo_tuning_table()
+	{
+#if defined(__GNUC__) || defined(__clang__)
+	// the first caller reads the environment, the concurrent ones wait for the table to be ready
+	if(__atomic_load_n(&tuning_init, __ATOMIC_ACQUIRE)!=2)
+		{
+		int expected = 0;
+		if(__atomic_compare_exchange_n(&tuning_init, &expected, 1, 0, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE))
+			{
+			tuning_init_env();
+			__atomic_store_n(&tuning_init, 2, __ATOMIC_RELEASE);
+			}
+		else
+			{
+			while(__atomic_load_n(&tuning_init, __ATOMIC_ACQUIRE)!=2)
+				;
+			}
+		}
+#else
+	// no atomics: the first call must not race with other calls
+	if(tuning_init!=2)
+		{
+		tuning_init_env();
+		tuning_init = 2;
+		}
+#endif
+	return &tuning;
+	}
@@ -0,0 +1,123 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "../include/blasfeo_common.h"
+#include "../include/blasfeo_d_aux.h"
+
+
+
+#define D_BATCH_IDX(x, ii) ((x)==NULL ? 0 : (x)[ii])
+
+
+
+// return the memory size (in bytes) needed for a dmat_batch
+int blasfeo_memsize_dmat_batch(int m, int n)
+	{
+	const int nl = BLASFEO_DMAT_BATCH_LANES;
+	int memsize = (m*n*nl*sizeof(double)+63)/64*64;
+	return memsize;
+	}
+
+
+
+// create a dmat_batch structure for a batch of matrices of size m*n by using memory passed by a pointer
+void blasfeo_create_dmat_batch(int m, int n, struct blasfeo_dmat_batch *sA, void *memory)
+	{
+	sA->m = m;
+	sA->n = n;
+	sA->pA = (double *) memory;
+	sA->memsize = blasfeo_memsize_dmat_batch(m, n);
+	return;
+	}
+
+
+
+// pack the submatrices of the dmat sA[0],...,sA[lanes-1] into the lanes of a dmat_batch
+void blasfeo_pack_dmat_batch(int m, int n, struct blasfeo_dmat **sA, int *ai, int *aj, struct blasfeo_dmat_batch *sB, int bi, int bj)
+	{
+	const int nl = BLASFEO_DMAT_BATCH_LANES;
+	int ii, jj, ll;
+	int ai0, aj0;
+	int ldb = sB->m;
+	double *pB;
+	for(ll=0; ll<nl; ll++)
+		{
+		ai0 = D_BATCH_IDX(ai, ll);
+		aj0 = D_BATCH_IDX(aj, ll);
+		for(jj=0; jj<n; jj++)
+			{
+			pB = sB->pA + nl*(bi+(bj+jj)*ldb) + ll;
+			for(ii=0; ii<m; ii++)
+				{
+				pB[nl*ii] = BLASFEO_DMATEL(sA[ll], ai0+ii, aj0+jj);
+				}
+			}
+		}
+	return;
+	}
+
+
+
+// unpack the lanes of a dmat_batch into the submatrices of the dmat sB[0],...,sB[lanes-1]
+void blasfeo_unpack_dmat_batch(int m, int n, struct blasfeo_dmat_batch *sA, int ai, int aj, struct blasfeo_dmat **sB, int *bi, int *bj)
+	{
+	const int nl = BLASFEO_DMAT_BATCH_LANES;
+	int ii, jj, ll;
+	int bi0, bj0;
+	int lda = sA->m;
+	double *pA;
+	for(ll=0; ll<nl; ll++)
+		{
+		bi0 = D_BATCH_IDX(bi, ll);
+		bj0 = D_BATCH_IDX(bj, ll);
+		// the stored inverse diagonal is invalidated
+		sB[ll]->use_dA = 0;
+		for(jj=0; jj<n; jj++)
+			{
+			pA = sA->pA + nl*(ai+(aj+jj)*lda) + ll;
+			for(ii=0; ii<m; ii++)
+				{
+				BLASFEO_DMATEL(sB[ll], bi0+ii, bj0+jj) = pA[nl*ii];
+				}
+			}
+		}
+	return;
+	}
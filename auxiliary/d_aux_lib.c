@@ -329,6 +329,23 @@ void blasfeo_dcolad(int kmax, double alpha, struct blasfeo_dvec *sx, int xi, str
 
 
 
+// add a scaled vector to a column, sparse formulation
+void blasfeo_dcolad_sp(int kmax, double alpha, struct blasfeo_dvec *sx, int xi, int *idx, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	// invalidate stored inverse diagonal
+	sD->use_dA = 0;
+
+	double *x = sx->pa + xi;
+	int ldd = sD->m;
+	double *pD = sD->pA + di + dj*ldd;
+	int jj;
+	for(jj=0; jj<kmax; jj++)
+		pD[idx[jj]] += alpha * x[jj];
+	return;
+	}
+
+
+
 // scale a column
 void blasfeo_dcolsc(int kmax, double alpha, struct blasfeo_dmat *sA, int ai, int aj)
 	{
@@ -2887,6 +2887,28 @@ void blasfeo_dcolad(int kmax, double alpha, struct blasfeo_dvec *sx, int xi, str
 
 
 
+// add scaled vector to column, sparse formulation
+void blasfeo_dcolad_sp(int kmax, double alpha, struct blasfeo_dvec *sx, int xi, int *idx, struct blasfeo_dmat *sD, int di, int dj)
+	{
+
+	// invalidate stored inverse diagonal
+	sD->use_dA = 0;
+
+	const int bs = 4;
+	double *x = sx->pa + xi;
+	int sdd = sD->cn;
+	double *pD = sD->pA + dj*bs;
+	int ii, jj;
+	for(jj=0; jj<kmax; jj++)
+		{
+		ii = di + idx[jj];
+		pD[ii/bs*bs*sdd+ii%bs] += alpha * x[jj];
+		}
+	return;
+	}
+
+
+
 // scale a column
 void blasfeo_dcolsc(int kmax, double alpha, struct blasfeo_dmat *sA, int ai, int aj)
 	{
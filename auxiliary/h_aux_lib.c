@@ -0,0 +1,212 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#if defined(TARGET_X64_INTEL_HASWELL)
+#include <immintrin.h>  // F16C
+#endif
+
+#include "../include/blasfeo_common.h"
+#include "../include/blasfeo_h_aux.h"
+
+
+
+unsigned short blasfeo_s2h(float a)
+	{
+#if defined(TARGET_X64_INTEL_HASWELL)
+	return _cvtss_sh(a, _MM_FROUND_TO_NEAREST_INT);
+#else
+	union
+		{
+		float f;
+		unsigned int i;
+		} u;
+	u.f = a;
+	unsigned int sign = (u.i>>16) & 0x8000;
+	unsigned int absa = u.i & 0x7fffffff;
+	unsigned int mant, rem, half, r;
+	int shift;
+	// inf or nan (quieted, keeping the leading payload bits)
+	if(absa>=0x7f800000)
+		return sign | 0x7c00 | (absa>0x7f800000 ? 0x200 | (absa & 0x7fffff)>>13 : 0);
+	// |a| >= 2^16 overflows
+	if(absa>=0x47800000)
+		return sign | 0x7c00;
+	// |a| >= 2^-14 is normal in half precision; a carry from the rounding correctly propagates into the exponent
+	if(absa>=0x38800000)
+		{
+		r = ((absa>>23)-112)<<10 | (absa & 0x7fffff)>>13;
+		rem = absa & 0x1fff;
+		if(rem>0x1000 | (rem==0x1000 & (r&1)))
+			r++;
+		return sign | r;
+		}
+	// subnormal in half precision: round |a|*2^24 to the nearest even integer
+	shift = 126 - (int) (absa>>23);
+	if(shift>24)
+		return sign;
+	mant = (absa & 0x7fffff) | 0x800000;
+	r = mant>>shift;
+	rem = mant & ((1u<<shift)-1);
+	half = 1u<<(shift-1);
+	if(rem>half | (rem==half & (r&1)))
+		r++;
+	return sign | r;
+#endif
+	}
+
+
+
+float blasfeo_h2s(unsigned short a)
+	{
+#if defined(TARGET_X64_INTEL_HASWELL)
+	return _cvtsh_ss(a);
+#else
+	union
+		{
+		float f;
+		unsigned int i;
+		} u;
+	unsigned int sign = ((unsigned int) a & 0x8000)<<16;
+	unsigned int expo = (a>>10) & 0x1f;
+	unsigned int mant = a & 0x3ff;
+	if(expo==0x1f) // inf or nan
+		{
+		u.i = sign | 0x7f800000 | mant<<13;
+		}
+	else if(expo==0) // zero or subnormal
+		{
+		u.f = (float) mant * 5.9604644775390625e-8f; // 2^-24
+		u.i |= sign;
+		}
+	else
+		{
+		u.i = sign | (expo+112)<<23 | mant<<13;
+		}
+	return u.f;
+#endif
+	}
+
+
+
+// return the memory size (in bytes) needed for a hmat
+int blasfeo_memsize_hmat(int m, int n)
+	{
+	const int bs = BLASFEO_HMAT_PS;
+	const int nc = 4;
+	int pm = (m+bs-1)/bs*bs;
+	int cn = (n+nc-1)/nc*nc;
+	int memsize = (pm*cn*sizeof(unsigned short)+63)/64*64;
+	return memsize;
+	}
+
+
+
+// create a hmat structure for a matrix of size m*n by using memory passed by a pointer
+void blasfeo_create_hmat(int m, int n, struct blasfeo_hmat *sA, void *memory)
+	{
+	const int bs = BLASFEO_HMAT_PS;
+	const int nc = 4;
+	sA->m = m;
+	sA->n = n;
+	sA->pm = (m+bs-1)/bs*bs;
+	sA->cn = (n+nc-1)/nc*nc; // keeps the panels aligned to 64 bytes
+	sA->pA = (unsigned short *) memory;
+	sA->memsize = blasfeo_memsize_hmat(m, n);
+	return;
+	}
+
+
+
+void blasfeo_hgein1(float a, struct blasfeo_hmat *sA, int ai, int aj)
+	{
+	BLASFEO_HMATEL(sA, ai, aj) = blasfeo_s2h(a);
+	return;
+	}
+
+
+
+float blasfeo_hgeex1(struct blasfeo_hmat *sA, int ai, int aj)
+	{
+	return blasfeo_h2s(BLASFEO_HMATEL(sA, ai, aj));
+	}
+
+
+
+void blasfeo_pack_hmat(int m, int n, float *A, int lda, struct blasfeo_hmat *sB, int bi, int bj)
+	{
+	int ii, jj;
+	for(jj=0; jj<n; jj++)
+		for(ii=0; ii<m; ii++)
+			BLASFEO_HMATEL(sB, bi+ii, bj+jj) = blasfeo_s2h(A[ii+lda*jj]);
+	return;
+	}
+
+
+
+void blasfeo_unpack_hmat(int m, int n, struct blasfeo_hmat *sA, int ai, int aj, float *B, int ldb)
+	{
+	int ii, jj;
+	for(jj=0; jj<n; jj++)
+		for(ii=0; ii<m; ii++)
+			B[ii+ldb*jj] = blasfeo_h2s(BLASFEO_HMATEL(sA, ai+ii, aj+jj));
+	return;
+	}
+
+
+
+void blasfeo_cvt_s2h_mat(int m, int n, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_hmat *sB, int bi, int bj)
+	{
+	int ii, jj;
+	for(jj=0; jj<n; jj++)
+		for(ii=0; ii<m; ii++)
+			BLASFEO_HMATEL(sB, bi+ii, bj+jj) = blasfeo_s2h(BLASFEO_SMATEL(sA, ai+ii, aj+jj));
+	return;
+	}
+
+
+
+void blasfeo_cvt_h2s_mat(int m, int n, struct blasfeo_hmat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj)
+	{
+	int ii, jj;
+	// the stored inverse diagonal is invalidated
+	sB->use_dA = 0;
+	for(jj=0; jj<n; jj++)
+		for(ii=0; ii<m; ii++)
+			BLASFEO_SMATEL(sB, bi+ii, bj+jj) = blasfeo_h2s(BLASFEO_HMATEL(sA, ai+ii, aj+jj));
+	return;
+	}
@@ -76,19 +76,29 @@ void blasfeo_cvt_s2d_vec(int m, struct blasfeo_svec *vs, int vsi, struct blasfeo
 
 void blasfeo_cvt_d2s_mat(int m, int n, struct blasfeo_dmat *Md, int mid, int nid, struct blasfeo_smat *Ms, int mis, int nis)
 	{
-	if(mid!=0 | mis!=0)
-		{
-		printf("\nblasfeo_cvt_d2s_mat: feature not implmeneted yet: mid=%d, mis=%d\n\n", mid, mis);
-		exit(1);
-		}
 	const int psd = 4;
 	const int pss = 4;
 	const int sdd = Md->cn;
+	const int sds = Ms->cn;
+	int ii, jj, ll;
+	// row offsets: convert element-wise
+	if(mid!=0 | mis!=0)
+		{
+		int id, is;
+		for(jj=0; jj<n; jj++)
+			{
+			for(ii=0; ii<m; ii++)
+				{
+				id = mid+ii;
+				is = mis+ii;
+				Ms->pA[is/pss*pss*sds+is%pss+(nis+jj)*pss] = (float) Md->pA[id/psd*psd*sdd+id%psd+(nid+jj)*psd];
+				}
+			}
+		return;
+		}
 	double *D0 = Md->pA + nid*psd;
 	double *D1;
-	const int sds = Ms->cn;
 	float *S = Ms->pA + nis*pss;
-	int ii, jj, ll;
 	for(ii=0; ii<m-3; ii+=4)
 		{
 		D1 = D0 + psd*sdd;
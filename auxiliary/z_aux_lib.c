@@ -0,0 +1,225 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "../include/blasfeo_common.h"
+#include "../include/blasfeo_z_aux.h"
+
+
+
+// return the memory size (in bytes) needed for a zmat
+int blasfeo_memsize_zmat(int m, int n)
+	{
+	const int bs = BLASFEO_ZMAT_PS;
+	int pm = (m+bs-1)/bs*bs;
+	int memsize = (pm*n*sizeof(double _Complex)+63)/64*64;
+	return memsize;
+	}
+
+
+
+// return the memory size (in bytes) needed for a zvec
+int blasfeo_memsize_zvec(int m)
+	{
+	const int bs = BLASFEO_ZMAT_PS;
+	int pm = (m+bs-1)/bs*bs;
+	int memsize = (pm*sizeof(double _Complex)+63)/64*64;
+	return memsize;
+	}
+
+
+
+// create a zmat structure for a matrix of size m*n by using memory passed by a pointer
+void blasfeo_create_zmat(int m, int n, struct blasfeo_zmat *sA, void *memory)
+	{
+	const int bs = BLASFEO_ZMAT_PS;
+	sA->m = m;
+	sA->n = n;
+	sA->pm = (m+bs-1)/bs*bs;
+	sA->cn = n; // a panel column is already a cache line
+	sA->pA = (double _Complex *) memory;
+	sA->memsize = blasfeo_memsize_zmat(m, n);
+	return;
+	}
+
+
+
+// create a zvec structure for a vector of size m by using memory passed by a pointer
+void blasfeo_create_zvec(int m, struct blasfeo_zvec *sa, void *memory)
+	{
+	const int bs = BLASFEO_ZMAT_PS;
+	sa->m = m;
+	sa->pm = (m+bs-1)/bs*bs;
+	sa->pa = (double _Complex *) memory;
+	sa->memsize = blasfeo_memsize_zvec(m);
+	return;
+	}
+
+
+
+void blasfeo_pack_zmat(int m, int n, double _Complex *A, int lda, struct blasfeo_zmat *sB, int bi, int bj)
+	{
+	int ii, jj;
+	for(jj=0; jj<n; jj++)
+		for(ii=0; ii<m; ii++)
+			BLASFEO_ZMATEL(sB, bi+ii, bj+jj) = A[ii+lda*jj];
+	return;
+	}
+
+
+
+void blasfeo_pack_zvec(int m, double _Complex *x, struct blasfeo_zvec *sy, int yi)
+	{
+	int ii;
+	for(ii=0; ii<m; ii++)
+		sy->pa[yi+ii] = x[ii];
+	return;
+	}
+
+
+
+void blasfeo_unpack_zmat(int m, int n, struct blasfeo_zmat *sA, int ai, int aj, double _Complex *B, int ldb)
+	{
+	int ii, jj;
+	for(jj=0; jj<n; jj++)
+		for(ii=0; ii<m; ii++)
+			B[ii+ldb*jj] = BLASFEO_ZMATEL(sA, ai+ii, aj+jj);
+	return;
+	}
+
+
+
+void blasfeo_unpack_zvec(int m, struct blasfeo_zvec *sx, int xi, double _Complex *y)
+	{
+	int ii;
+	for(ii=0; ii<m; ii++)
+		y[ii] = sx->pa[xi+ii];
+	return;
+	}
+
+
+
+void blasfeo_zgein1(double _Complex a, struct blasfeo_zmat *sA, int ai, int aj)
+	{
+	BLASFEO_ZMATEL(sA, ai, aj) = a;
+	return;
+	}
+
+
+
+double _Complex blasfeo_zgeex1(struct blasfeo_zmat *sA, int ai, int aj)
+	{
+	return BLASFEO_ZMATEL(sA, ai, aj);
+	}
+
+
+
+void blasfeo_zvecin1(double _Complex a, struct blasfeo_zvec *sx, int xi)
+	{
+	sx->pa[xi] = a;
+	return;
+	}
+
+
+
+double _Complex blasfeo_zvecex1(struct blasfeo_zvec *sx, int xi)
+	{
+	return sx->pa[xi];
+	}
+
+
+
+void blasfeo_zgecp(int m, int n, struct blasfeo_zmat *sA, int ai, int aj, struct blasfeo_zmat *sB, int bi, int bj)
+	{
+	if(sA==sB & ai==bi & aj==bj)
+		return;
+	int ii, jj;
+	for(jj=0; jj<n; jj++)
+		for(ii=0; ii<m; ii++)
+			BLASFEO_ZMATEL(sB, bi+ii, bj+jj) = BLASFEO_ZMATEL(sA, ai+ii, aj+jj);
+	return;
+	}
+
+
+
+void blasfeo_zrowsw(int kmax, struct blasfeo_zmat *sA, int ai, int aj, struct blasfeo_zmat *sC, int ci, int cj)
+	{
+	const int bs = BLASFEO_ZMAT_PS;
+	double _Complex *pA = sA->pA + (ai-ai%bs)*sA->cn + ai%bs + aj*bs;
+	double _Complex *pC = sC->pA + (ci-ci%bs)*sC->cn + ci%bs + cj*bs;
+	double _Complex tmp;
+	int jj;
+	for(jj=0; jj<kmax; jj++)
+		{
+		tmp = pA[jj*bs];
+		pA[jj*bs] = pC[jj*bs];
+		pC[jj*bs] = tmp;
+		}
+	return;
+	}
+
+
+
+void blasfeo_zrowpe(int kmax, int *ipiv, struct blasfeo_zmat *sA)
+	{
+	int ii;
+	for(ii=0; ii<kmax; ii++)
+		{
+		if(ipiv[ii]!=ii)
+			blasfeo_zrowsw(sA->n, sA, ii, 0, sA, ipiv[ii], 0);
+		}
+	return;
+	}
+
+
+
+void blasfeo_zvecpe(int kmax, int *ipiv, struct blasfeo_zvec *sx, int xi)
+	{
+	double _Complex *x = sx->pa + xi;
+	double _Complex tmp;
+	int ii;
+	for(ii=0; ii<kmax; ii++)
+		{
+		if(ipiv[ii]!=ii)
+			{
+			tmp = x[ipiv[ii]];
+			x[ipiv[ii]] = x[ii];
+			x[ii] = tmp;
+			}
+		}
+	return;
+	}
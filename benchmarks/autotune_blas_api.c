@@ -0,0 +1,275 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+
+
+
+#include "../include/blasfeo.h"
+#include "../include/blasfeo_d_blas_api.h"
+
+
+
+#ifndef K_MAX_STACK
+#define K_MAX_STACK 300
+#endif
+
+// value of the thresholds always selecting the algorithm for small matrices
+#define T_INF 1000000
+
+// largest matrix size in the sweeps
+#define N_MAX 512
+
+
+
+// buffers shared by all the sweeps
+static double *A, *A0, *B, *C;
+static int lda = N_MAX;
+static int *ipiv;
+
+
+
+// minimum time per call of a routine, over a few repetitions of batches of calls lasting at least 5 ms
+static double time_call(void (*routine)(int m, int n, int k, char *arg), int m, int n, int k, char *arg)
+	{
+	blasfeo_timer timer;
+	double time, time_min = 1e30;
+	int n_call, ii, rep;
+
+	// estimate the number of calls in a batch
+	routine(m, n, k, arg);
+	blasfeo_tic(&timer);
+	routine(m, n, k, arg);
+	time = blasfeo_toc(&timer);
+	n_call = time>0 ? 5e-3/time : 1000;
+	n_call = n_call<1 ? 1 : n_call;
+	n_call = n_call>1000 ? 1000 : n_call;
+
+	for(rep=0; rep<5; rep++)
+		{
+		blasfeo_tic(&timer);
+		for(ii=0; ii<n_call; ii++)
+			routine(m, n, k, arg);
+		time = blasfeo_toc(&timer) / n_call;
+		time_min = time<time_min ? time : time_min;
+		}
+	return time_min;
+	}
+
+
+
+static void run_dgemm(int m, int n, int k, char *arg)
+	{
+	double alpha = 1.0;
+	double beta = 0.0;
+	blasfeo_dgemm(&arg[0], &arg[1], &m, &n, &k, &alpha, A, &lda, B, &lda, &beta, C, &lda);
+	}
+
+
+
+static void run_dtrsm(int m, int n, int k, char *arg)
+	{
+	double alpha = 1.0;
+	char diag = 'n';
+	blasfeo_dtrsm(&arg[0], &arg[1], &arg[2], &diag, &m, &n, &alpha, A, &lda, C, &lda);
+	}
+
+
+
+// the copy of the matrix is part of the timing, but it is the same for both algorithms
+static void run_dgetrf(int m, int n, int k, char *arg)
+	{
+	int info;
+	int i1 = 1;
+	int jj;
+	for(jj=0; jj<n; jj++)
+		blasfeo_dcopy(&m, A0+jj*lda, &i1, A+jj*lda, &i1);
+	blasfeo_dgetrf(&m, &n, A, &lda, ipiv, &info);
+	}
+
+
+
+// sweep the sizes in the list: the threshold is the first size from which the algorithm for big matrices
+// is always faster (or the size after the last one if that never happens)
+static int sweep(void (*routine)(int m, int n, int k, char *arg), char *arg, int n_size, int *size, int *entry, int small_value, int big_value, int mode, int dim)
+	{
+	double time_small[64];
+	double time_big[64];
+	int ii, m, n, k;
+	// mode 0: square matrices of size size[ii] (m=n=k), mode 1: m=n=size[ii] and k=dim, mode 2: m=n=dim and k=size[ii]
+	for(ii=0; ii<n_size; ii++)
+		{
+		m = mode==2 ? dim : size[ii];
+		n = m;
+		k = mode==0 ? size[ii] : mode==1 ? dim : size[ii];
+		*entry = small_value;
+		time_small[ii] = time_call(routine, m, n, k, arg);
+		*entry = big_value;
+		time_big[ii] = time_call(routine, m, n, k, arg);
+		}
+	*entry = -1;
+
+	int threshold = n_size;
+	for(ii=n_size-1; ii>=0; ii--)
+		{
+		if(time_big[ii]>=time_small[ii])
+			break;
+		threshold = ii;
+		}
+	return threshold<n_size ? size[threshold] : size[n_size-1]+1;
+	}
+
+
+
+int main(int argc, char **argv)
+	{
+
+#if !defined(BLAS_API)
+	printf("\nRecompile with BLAS_API=1 to run the autotuning!\n\n");
+	return 0;
+#endif
+
+	char *file_name = argc>1 ? argv[1] : "blasfeo_tuning.txt";
+
+	printf("\nBLASFEO autotuning - BLAS API - dispatch thresholds\n\n");
+
+	char target[64];
+	blasfeo_processor_target_string(target);
+	int l1, l2, l3;
+	blasfeo_processor_cache_size(&l1, &l2, &l3);
+	printf("target %s, caches L1 %d kB, L2 %d kB, L3 %d kB\n\n", target, l1/1024, l2/1024, l3/1024);
+
+	A = malloc(N_MAX*N_MAX*sizeof(double));
+	A0 = malloc(N_MAX*N_MAX*sizeof(double));
+	B = malloc(N_MAX*N_MAX*sizeof(double));
+	C = malloc(N_MAX*N_MAX*sizeof(double));
+	ipiv = malloc(N_MAX*sizeof(int));
+	int ii, jj;
+	for(jj=0; jj<N_MAX; jj++)
+		{
+		for(ii=0; ii<N_MAX; ii++)
+			{
+			// diagonally dominant, for the triangular solves and the factorization
+			A0[ii+jj*lda] = ii==jj ? N_MAX : 1.0/(1.0+ii+jj);
+			A[ii+jj*lda] = A0[ii+jj*lda];
+			B[ii+jj*lda] = 1.0/(1.0+ii+2*jj);
+			C[ii+jj*lda] = 0.0;
+			}
+		}
+
+	// the thresholds gate the single-threaded algorithms: keep the multi-threaded paths (taken first for big
+	// enough matrices) out of the sweeps
+	blasfeo_set_num_threads(1);
+
+	struct blasfeo_tuning tun;
+	blasfeo_tuning_default(&tun);
+	blasfeo_tuning_set(&tun);
+	struct blasfeo_tuning *table = blasfeo_tuning_table();
+	struct blasfeo_tuning result = tun;
+
+	int size_small[64], size_big[64], size_k[64];
+	int n_small = 0, n_big = 0, n_k = 0;
+	for(ii=1; ii<=64; ii+=ii<16 ? 1 : 4)
+		size_small[n_small++] = ii;
+	for(ii=4; (ii<=K_MAX_STACK) & (ii<=N_MAX) & (n_big<64); ii+=ii<64 ? 4 : 16)
+		size_big[n_big++] = ii;
+	for(ii=8; (ii<=K_MAX_STACK) & (ii<=N_MAX) & (n_k<64); ii+=8)
+		size_k[n_k++] = ii;
+
+	// dgemm: the small matrix algorithm first (compared with the default for bigger matrices),
+	// then packing both operands (cache blocked for the sizes where op(B) does not fit in L2) against a single one,
+	// along m=n and along k
+	const char *gemm_name[] = {"nn", "nt", "tn", "tt"};
+	char *gemm_arg[] = {"nn", "nt", "tn", "tt"};
+	int *gemm_small[] = {&table->dgemm_nn_small_mn, &table->dgemm_nt_small_mn, NULL, &table->dgemm_tt_small_mn};
+	int *gemm_small_res[] = {&result.dgemm_nn_small_mn, &result.dgemm_nt_small_mn, NULL, &result.dgemm_tt_small_mn};
+	int *gemm_mn[] = {&table->dgemm_nn_pack_one_mn, &table->dgemm_nt_pack_one_mn, &table->dgemm_tn_pack_one_mn, &table->dgemm_tt_pack_one_mn};
+	int *gemm_mn_res[] = {&result.dgemm_nn_pack_one_mn, &result.dgemm_nt_pack_one_mn, &result.dgemm_tn_pack_one_mn, &result.dgemm_tt_pack_one_mn};
+	int *gemm_k[] = {&table->dgemm_nn_pack_one_k, &table->dgemm_nt_pack_one_k, &table->dgemm_tn_pack_one_k, &table->dgemm_tt_pack_one_k};
+	int *gemm_k_res[] = {&result.dgemm_nn_pack_one_k, &result.dgemm_nt_pack_one_k, &result.dgemm_tn_pack_one_k, &result.dgemm_tt_pack_one_k};
+	int kk = K_MAX_STACK<256 ? K_MAX_STACK : 256;
+	for(ii=0; ii<4; ii++)
+		{
+		if(gemm_small[ii]!=NULL)
+			{
+			// the threshold is the last size of the small matrix algorithm
+			*gemm_small_res[ii] = sweep(&run_dgemm, gemm_arg[ii], n_small, size_small, gemm_small[ii], T_INF, 0, 0, 0) - 1;
+			printf("dgemm_%s_small_mn %d\n", gemm_name[ii], *gemm_small_res[ii]);
+			}
+		// pack both operands along m=n (with k large enough), and along k (with m=n large enough)
+		*gemm_k[ii] = 0;
+		*gemm_mn_res[ii] = sweep(&run_dgemm, gemm_arg[ii], n_big, size_big, gemm_mn[ii], T_INF, 0, 1, kk) - 1;
+		*gemm_k[ii] = -1;
+		*gemm_mn[ii] = 0;
+		*gemm_k_res[ii] = sweep(&run_dgemm, gemm_arg[ii], n_k, size_k, gemm_k[ii], T_INF, 0, 2, 128);
+		*gemm_mn[ii] = -1;
+		printf("dgemm_%s_pack_one_mn %d\n", gemm_name[ii], *gemm_mn_res[ii]);
+		printf("dgemm_%s_pack_one_k %d\n", gemm_name[ii], *gemm_k_res[ii]);
+		}
+
+	// dtrsm: pack the operands against the unpacked algorithm, with non-unit diagonal
+	// (zero right-hand side, as the repeated in-place solves would otherwise reach denormal numbers)
+	for(ii=0; ii<N_MAX*N_MAX; ii++)
+		C[ii] = 0.0;
+	const char *trsm_name[] = {"lln", "llt", "lun", "lut", "rln", "rlt", "run", "rut"};
+	int *trsm_mn[] = {&table->dtrsm_lln_pack_mn, &table->dtrsm_llt_pack_mn, &table->dtrsm_lun_pack_mn, &table->dtrsm_lut_pack_mn, &table->dtrsm_rln_pack_mn, &table->dtrsm_rlt_pack_mn, &table->dtrsm_run_pack_mn, &table->dtrsm_rut_pack_mn};
+	int *trsm_mn_res[] = {&result.dtrsm_lln_pack_mn, &result.dtrsm_llt_pack_mn, &result.dtrsm_lun_pack_mn, &result.dtrsm_lut_pack_mn, &result.dtrsm_rln_pack_mn, &result.dtrsm_rlt_pack_mn, &result.dtrsm_run_pack_mn, &result.dtrsm_rut_pack_mn};
+	for(ii=0; ii<8; ii++)
+		{
+		*trsm_mn_res[ii] = sweep(&run_dtrsm, (char *) trsm_name[ii], n_big, size_big, trsm_mn[ii], T_INF, 0, 0, 0);
+		printf("dtrsm_%s_pack_mn %d\n", trsm_name[ii], *trsm_mn_res[ii]);
+		}
+
+	// dgetrf: pack the matrix against the unpacked algorithm
+	result.dgetrf_pack_mn = sweep(&run_dgetrf, NULL, n_big, size_big, &table->dgetrf_pack_mn, T_INF, 0, 0, 0);
+	printf("dgetrf_pack_mn %d\n", result.dgetrf_pack_mn);
+
+	if(blasfeo_tuning_save(&result, file_name)!=0)
+		{
+		printf("\nerror: can not write %s\n\n", file_name);
+		return 1;
+		}
+	printf("\ntuning table written to %s, load it with blasfeo_tuning_load or the BLASFEO_TUNING_FILE environment variable\n\n", file_name);
+
+	free(A);
+	free(A0);
+	free(B);
+	free(C);
+	free(ipiv);
+
+	return 0;
+
+	}
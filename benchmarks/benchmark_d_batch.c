@@ -0,0 +1,149 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+
+
+
+#include "../include/blasfeo.h"
+
+
+
+// entries in the batch
+#define BATCH 1000
+
+
+
+// time per batch entry of the batched dgemm_nn, dgemm_nt and dsyrk_ln, against a loop of calls to the single-matrix
+// routines on the same entries; square matrices at the top of a panel (no external BLAS nor GHZ_MAX needed)
+int main()
+	{
+
+	int ns[] = {2, 4, 6, 8, 12, 16, 24, 32};
+	int nn = sizeof(ns)/sizeof(ns[0]);
+
+	int ii, in, bb, op, rep, n_rep;
+	int n;
+	double time, time_loop, time_batch;
+	blasfeo_timer timer;
+
+	struct blasfeo_dmat *sA = malloc(BATCH*sizeof(struct blasfeo_dmat));
+	struct blasfeo_dmat *sB = malloc(BATCH*sizeof(struct blasfeo_dmat));
+	struct blasfeo_dmat *sD = malloc(BATCH*sizeof(struct blasfeo_dmat));
+	struct blasfeo_dmat **pA = malloc(BATCH*sizeof(struct blasfeo_dmat *));
+	struct blasfeo_dmat **pB = malloc(BATCH*sizeof(struct blasfeo_dmat *));
+	struct blasfeo_dmat **pD = malloc(BATCH*sizeof(struct blasfeo_dmat *));
+
+	char *op_name[] = {"dgemm_nn", "dgemm_nt", "dsyrk_ln"};
+
+	printf("\nbatch of %d entries, time per entry [ns]\n\n", BATCH);
+	printf("routine\t\tn\tloop\t\tbatch\t\tspeed-up\n");
+
+	for(op=0; op<3; op++)
+	for(in=0; in<nn; in++)
+		{
+		n = ns[in];
+		for(bb=0; bb<BATCH; bb++)
+			{
+			blasfeo_allocate_dmat(n, n, &sA[bb]);
+			blasfeo_allocate_dmat(n, n, &sB[bb]);
+			blasfeo_allocate_dmat(n, n, &sD[bb]);
+			blasfeo_dgese(n, n, 0.01*bb, &sA[bb], 0, 0);
+			blasfeo_dgese(n, n, 0.02, &sB[bb], 0, 0);
+			blasfeo_dgese(n, n, 0.0, &sD[bb], 0, 0);
+			pA[bb] = &sA[bb];
+			pB[bb] = &sB[bb];
+			pD[bb] = &sD[bb];
+			}
+
+		// about 0.1 s per measure
+		n_rep = 1e8 / ((double) BATCH*n*n*n + 1e4*BATCH);
+		n_rep = n_rep<1 ? 1 : n_rep;
+
+		time_loop = 1e30;
+		time_batch = 1e30;
+		for(rep=0; rep<3; rep++)
+			{
+			blasfeo_tic(&timer);
+			for(ii=0; ii<n_rep; ii++)
+				for(bb=0; bb<BATCH; bb++)
+					{
+					if(op==0)
+						blasfeo_dgemm_nn(n, n, n, 1.0, pA[bb], 0, 0, pB[bb], 0, 0, 1.0, pD[bb], 0, 0, pD[bb], 0, 0);
+					else if(op==1)
+						blasfeo_dgemm_nt(n, n, n, 1.0, pA[bb], 0, 0, pB[bb], 0, 0, 1.0, pD[bb], 0, 0, pD[bb], 0, 0);
+					else
+						blasfeo_dsyrk_ln(n, n, 1.0, pA[bb], 0, 0, pB[bb], 0, 0, 1.0, pD[bb], 0, 0, pD[bb], 0, 0);
+					}
+			time = blasfeo_toc(&timer) / n_rep / BATCH;
+			time_loop = time<time_loop ? time : time_loop;
+
+			blasfeo_tic(&timer);
+			for(ii=0; ii<n_rep; ii++)
+				{
+				if(op==0)
+					blasfeo_dgemm_nn_batch(BATCH, n, n, n, 1.0, pA, NULL, NULL, pB, NULL, NULL, 1.0, pD, NULL, NULL, pD, NULL, NULL);
+				else if(op==1)
+					blasfeo_dgemm_nt_batch(BATCH, n, n, n, 1.0, pA, NULL, NULL, pB, NULL, NULL, 1.0, pD, NULL, NULL, pD, NULL, NULL);
+				else
+					blasfeo_dsyrk_ln_batch(BATCH, n, n, 1.0, pA, NULL, NULL, pB, NULL, NULL, 1.0, pD, NULL, NULL, pD, NULL, NULL);
+				}
+			time = blasfeo_toc(&timer) / n_rep / BATCH;
+			time_batch = time<time_batch ? time : time_batch;
+			}
+
+		printf("%s\t%d\t%e\t%e\t%.2f\n", op_name[op], n, 1e9*time_loop, 1e9*time_batch, time_loop/time_batch);
+
+		for(bb=0; bb<BATCH; bb++)
+			{
+			blasfeo_free_dmat(&sA[bb]);
+			blasfeo_free_dmat(&sB[bb]);
+			blasfeo_free_dmat(&sD[bb]);
+			}
+		}
+
+	printf("\n");
+
+	free(sA);
+	free(sB);
+	free(sD);
+	free(pA);
+	free(pB);
+	free(pD);
+
+	return 0;
+
+	}
@@ -0,0 +1,103 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS for embedded optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "../include/blasfeo_target.h"
+#include "../include/blasfeo_common.h"
+#include "../include/blasfeo_block_size.h"
+#include "../include/blasfeo_d_aux.h"
+#include "../include/blasfeo_s_aux.h"
+#include "../include/blasfeo_d_blasfeo_api.h"
+#include "../include/blasfeo_processor_features.h"
+#include "../include/blasfeo_thread.h"
+#include "../include/blasfeo_d_blas_api.h"
+
+
+
+// rows of the largest gemm kernel of any target, packed in a buffer of op(A)
+#define D_M_KERNEL_MAX (3*D_PS)
+#define S_M_KERNEL_MAX (3*S_PS)
+
+
+
+size_t blasfeo_blas_workspace_size(int m, int n, int k)
+	{
+#if defined(LA_HIGH_PERFORMANCE)
+	m = m>0 ? m : 0;
+	n = n>0 ? n : 0;
+	k = k>0 ? k : 0;
+	// dimensions are rounded as in the BLAS API routines
+	size_t m1 = (m+128-1)/128*128;
+	size_t n1 = (n+128-1)/128*128;
+	size_t k1 = (k+128-1)/128*128;
+	size_t p1 = m1>n1 ? m1 : n1;
+	size_t size, tmp;
+	// dgemm (also with 'P' operands); dgetrf, dsyrk, dpotrf, dtrmm, dtrsm
+	size = blasfeo_memsize_dmat(D_M_KERNEL_MAX, k1) + blasfeo_memsize_dmat(n1, k1);
+	tmp = blasfeo_memsize_dmat(m1, n1) + D_M_KERNEL_MAX*m1*sizeof(double);
+	size = tmp>size ? tmp : size;
+	tmp = blasfeo_memsize_dmat(p1, k1);
+	size = tmp>size ? tmp : size;
+	tmp = blasfeo_memsize_dmat(D_M_KERNEL_MAX, p1) + blasfeo_memsize_dmat(p1, p1);
+	size = tmp>size ? tmp : size;
+	// dgemm cache blocked: packed blocks of A and B, bounded by the block sizes
+	int kc, mc, nc;
+	blasfeo_processor_gemm_block_size(D_M_KERNEL_MAX, D_PS, sizeof(double), &kc, &mc, &nc);
+	size_t kb = k<kc ? k : kc;
+	size_t mb = m<mc ? m : mc;
+	size_t nb = n<nc ? n : nc;
+	tmp = ((mb+D_M_KERNEL_MAX-1)/D_M_KERNEL_MAX*D_M_KERNEL_MAX + (nb+D_PS-1)/D_PS*D_PS) * ((kb+D_PS-1)/D_PS*D_PS) * sizeof(double) + 2*64;
+	size = tmp>size ? tmp : size;
+	// sgemm, strsm
+	tmp = blasfeo_memsize_smat(S_M_KERNEL_MAX, k1) + blasfeo_memsize_smat(n1, k1);
+	size = tmp>size ? tmp : size;
+	tmp = blasfeo_memsize_smat_ps(4, 4, p1) + blasfeo_memsize_smat_ps(4, p1, p1);
+	size = tmp>size ? tmp : size;
+#if defined(MULTI_THREAD)
+	// dgemm: shared packed B, plus one packed block of A per thread, for as many threads as the pool can have
+	tmp = blasfeo_memsize_dmat(n1, k1)+63 + BLASFEO_MAX_THREADS*(blasfeo_memsize_dmat(D_M_KERNEL_MAX, k1)+63);
+	size = tmp>size ? tmp : size;
+	// dgetrf: packed matrix, plus the task scheduler work space of blasfeo_dgetrf_rp_mt
+	tmp = blasfeo_memsize_dmat(m1, n1)+63 + blasfeo_dgetrf_rp_mt_worksize(m1, n1);
+	size = tmp>size ? tmp : size;
+#endif
+	// alignment of the 64-byte aligned buffers
+	return size + 64 + 64;
+#else
+	return 0;
+#endif
+	}
@@ -38,13 +38,428 @@
 
 #include "../include/blasfeo_target.h"
 #include "../include/blasfeo_common.h"
+#include "../include/blasfeo_stdlib.h"
 #include "../include/blasfeo_d_aux.h"
 #include "../include/blasfeo_d_kernel.h"
+#include "../include/blasfeo_thread.h"
+#include "../include/blasfeo_processor_features.h"
+#include "../include/blasfeo_tuning.h"
 
 
 
 #if defined(FORTRAN_BLAS_API)
 #define blasfeo_dgemm dgemm_
+#define blasfeo_dgemm_pack_get_size dgemm_pack_get_size_
+#define blasfeo_dgemm_pack dgemm_pack_
+#define blasfeo_dgemm_compute dgemm_compute_
+#endif
+
+
+
+#if defined(TARGET_X64_INTEL_HASWELL) | defined(TARGET_ARMV8A_ARM_CORTEX_A53)
+#define DGEMM_M_KERNEL 12
+#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE) | defined(TARGET_ARMV8A_ARM_CORTEX_A57)
+#define DGEMM_M_KERNEL 8
+#else
+#define DGEMM_M_KERNEL 4
+#endif
+
+
+
+// pack m1<=DGEMM_M_KERNEL rows of op(A)
+static void dgemm_pack_a(int tran_a, int m1, int k, double *A, int lda, double *pA, int sda)
+	{
+	int ii;
+	if(tran_a)
+		{
+		for(ii=0; ii<m1-3; ii+=4)
+			{
+			kernel_dpack_tn_4_lib4(k, A+ii*lda, lda, pA+ii*sda);
+			}
+		if(ii<m1)
+			{
+			kernel_dpack_tn_4_vs_lib4(k, A+ii*lda, lda, pA+ii*sda, m1-ii);
+			}
+		return;
+		}
+#if defined(TARGET_X64_INTEL_HASWELL) | defined(TARGET_ARMV8A_ARM_CORTEX_A53)
+	if(m1>=12)
+		{
+		kernel_dpack_nn_12_lib4(k, A, lda, pA, sda);
+		}
+	else if(m1>8)
+		{
+		kernel_dpack_nn_12_vs_lib4(k, A, lda, pA, sda, m1);
+		}
+	else if(m1>4)
+		{
+		kernel_dpack_nn_8_vs_lib4(k, A, lda, pA, sda, m1);
+		}
+	else
+		{
+		kernel_dpack_nn_4_vs_lib4(k, A, lda, pA, m1);
+		}
+#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE) | defined(TARGET_ARMV8A_ARM_CORTEX_A57)
+	if(m1>=8)
+		{
+		kernel_dpack_nn_8_lib4(k, A, lda, pA, sda);
+		}
+	else if(m1>4)
+		{
+		kernel_dpack_nn_8_vs_lib4(k, A, lda, pA, sda, m1);
+		}
+	else
+		{
+		kernel_dpack_nn_4_vs_lib4(k, A, lda, pA, m1);
+		}
+#else
+	if(m1>=4)
+		{
+		kernel_dpack_nn_4_lib4(k, A, lda, pA);
+		}
+	else
+		{
+		kernel_dpack_nn_4_vs_lib4(k, A, lda, pA, m1);
+		}
+#endif
+	return;
+	}
+
+
+
+// m1<=DGEMM_M_KERNEL rows of C, columns from j0 to j1
+static void dgemm_kernel(int m1, int j0, int j1, int k, double *alpha, double *pA, int sda, double *pB, int sdb, double *beta, double *C, int ldc)
+	{
+	int jj = j0;
+#if defined(TARGET_X64_INTEL_HASWELL) | defined(TARGET_ARMV8A_ARM_CORTEX_A53)
+	if(m1>=12)
+		{
+		for(; jj<j1-3; jj+=4)
+			{
+			kernel_dgemm_nt_12x4_lib44cc(k, alpha, pA, sda, pB+jj*sdb, beta, C+jj*ldc, ldc, C+jj*ldc, ldc);
+			}
+		}
+	for(; jj<j1; jj+=4)
+		{
+		if(m1>8)
+			kernel_dgemm_nt_12x4_vs_lib44cc(k, alpha, pA, sda, pB+jj*sdb, beta, C+jj*ldc, ldc, C+jj*ldc, ldc, m1, j1-jj);
+		else if(m1>4)
+			kernel_dgemm_nt_8x4_vs_lib44cc(k, alpha, pA, sda, pB+jj*sdb, beta, C+jj*ldc, ldc, C+jj*ldc, ldc, m1, j1-jj);
+		else
+			kernel_dgemm_nt_4x4_vs_lib44cc(k, alpha, pA, pB+jj*sdb, beta, C+jj*ldc, ldc, C+jj*ldc, ldc, m1, j1-jj);
+		}
+#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE) | defined(TARGET_ARMV8A_ARM_CORTEX_A57)
+	if(m1>=8)
+		{
+		for(; jj<j1-3; jj+=4)
+			{
+			kernel_dgemm_nt_8x4_lib44cc(k, alpha, pA, sda, pB+jj*sdb, beta, C+jj*ldc, ldc, C+jj*ldc, ldc);
+			}
+		}
+	for(; jj<j1; jj+=4)
+		{
+		if(m1>4)
+			kernel_dgemm_nt_8x4_vs_lib44cc(k, alpha, pA, sda, pB+jj*sdb, beta, C+jj*ldc, ldc, C+jj*ldc, ldc, m1, j1-jj);
+		else
+			kernel_dgemm_nt_4x4_vs_lib44cc(k, alpha, pA, pB+jj*sdb, beta, C+jj*ldc, ldc, C+jj*ldc, ldc, m1, j1-jj);
+		}
+#else
+	if(m1>=4)
+		{
+		for(; jj<j1-3; jj+=4)
+			{
+			kernel_dgemm_nt_4x4_lib44cc(k, alpha, pA, pB+jj*sdb, beta, C+jj*ldc, ldc, C+jj*ldc, ldc);
+			}
+		}
+	for(; jj<j1; jj+=4)
+		{
+		kernel_dgemm_nt_4x4_vs_lib44cc(k, alpha, pA, pB+jj*sdb, beta, C+jj*ldc, ldc, C+jj*ldc, ldc, m1, j1-jj);
+		}
+#endif
+	return;
+	}
+
+
+
+// pack the columns from j0 to j1 of op(B), as rows of a panel-major matrix
+static void dgemm_pack_b(int tran_b, int j0, int j1, int k, double *B, int ldb, double *pB, int sdb)
+	{
+	int jj;
+	if(tran_b)
+		{
+		for(jj=j0; jj<j1-3; jj+=4)
+			{
+			kernel_dpack_nn_4_lib4(k, B+jj, ldb, pB+jj*sdb);
+			}
+		if(jj<j1)
+			{
+			kernel_dpack_nn_4_vs_lib4(k, B+jj, ldb, pB+jj*sdb, j1-jj);
+			}
+		}
+	else
+		{
+		for(jj=j0; jj<j1-3; jj+=4)
+			{
+			kernel_dpack_tn_4_lib4(k, B+jj*ldb, ldb, pB+jj*sdb);
+			}
+		if(jj<j1)
+			{
+			kernel_dpack_tn_4_vs_lib4(k, B+jj*ldb, ldb, pB+jj*sdb, j1-jj);
+			}
+		}
+	return;
+	}
+
+
+
+// cache blocking of dgemm_blocked, computed once from the detected cache sizes
+// (all the threads compute the same values, so a racing first call is harmless)
+static volatile int dgemm_kc = 0;
+static volatile int dgemm_mc = 0;
+static volatile int dgemm_nc = 0;
+
+
+
+// cache blocking (GotoBLAS-style) around the packed kernels: a kc x nc block of op(B) is packed once
+// for all row blocks, a mc x kc block of op(A) is packed for each of them, and the kernels sweep
+// the rows of the A block for each col panel of the B block, so that the B panel stays in L1;
+// return 0 (and do nothing) if op(B) is small enough to stay in L2 as a whole
+static int dgemm_blocked(int tran_a, int tran_b, int m, int n, int k, double *alpha, double *A, int lda, double *B, int ldb, double *beta, double *C, int ldc)
+	{
+	const int mu = DGEMM_M_KERNEL;
+	int kc = dgemm_kc;
+	int mc = dgemm_mc;
+	int nc = dgemm_nc;
+	if(kc==0 | mc==0 | nc==0)
+		{
+		blasfeo_processor_gemm_block_size(mu, 4, sizeof(double), &kc, &mc, &nc);
+		dgemm_mc = mc;
+		dgemm_nc = nc;
+		dgemm_kc = kc;
+		}
+	if(m<2*mu | (k<=kc & (double) n*k<=(double) mc*kc))
+		return 0;
+
+	int k_max = k<kc ? k : kc;
+	int m_max = m<mc ? m : mc;
+	int n_max = n<nc ? n : nc;
+	int sda = (k_max+3)/4*4;
+	int sdb = sda;
+	int pA_size = ((m_max+mu-1)/mu*mu*sda*sizeof(double)+63)/64*64;
+	int pB_size = ((n_max+3)/4*4*sdb*sizeof(double)+63)/64*64;
+	void *mem = blasfeo_blas_workspace_malloc(pA_size+pB_size+64);
+	char *mem_align;
+	blasfeo_align_64_byte(mem, (void **) &mem_align);
+	double *pA = (double *) mem_align;
+	double *pB = (double *) (mem_align+pA_size);
+
+	double d_1 = 1.0;
+	double *beta1;
+	int ic, jc, pc, ii, jj, m0, n0, k0, m1;
+	for(jc=0; jc<n; jc+=nc)
+		{
+		n0 = n-jc<nc ? n-jc : nc;
+		for(pc=0; pc<k; pc+=kc)
+			{
+			k0 = k-pc<kc ? k-pc : kc;
+			beta1 = pc==0 ? beta : &d_1;
+			if(tran_b)
+				dgemm_pack_b(1, 0, n0, k0, B+jc+pc*ldb, ldb, pB, sdb);
+			else
+				dgemm_pack_b(0, 0, n0, k0, B+pc+jc*ldb, ldb, pB, sdb);
+			for(ic=0; ic<m; ic+=mc)
+				{
+				m0 = m-ic<mc ? m-ic : mc;
+				for(ii=0; ii<m0; ii+=mu)
+					{
+					m1 = m0-ii<mu ? m0-ii : mu;
+					if(tran_a)
+						dgemm_pack_a(1, m1, k0, A+pc+(ic+ii)*lda, lda, pA+ii*sda, sda);
+					else
+						dgemm_pack_a(0, m1, k0, A+ic+ii+pc*lda, lda, pA+ii*sda, sda);
+					}
+				for(jj=0; jj<n0; jj+=4)
+					{
+					for(ii=0; ii<m0; ii+=mu)
+						{
+						m1 = m0-ii<mu ? m0-ii : mu;
+						dgemm_kernel(m1, jj, n0-jj<4 ? n0 : jj+4, k0, alpha, pA+ii*sda, sda, pB, sdb, beta1, C+ic+ii+jc*ldc, ldc);
+						}
+					}
+				}
+			}
+		}
+
+	blasfeo_blas_workspace_free(mem);
+	return 1;
+	}
+
+
+
+#if defined(MULTI_THREAD)
+
+// minimum number of multiply-add per thread
+#define DGEMM_MT_MIN_WORK (64*64*64)
+
+struct dgemm_mt_arg
+	{
+	double *alpha;
+	double *A;
+	double *B;
+	double *beta;
+	double *C;
+	double *pA; // packed A, one buffer per task
+	double *pB; // packed B, shared
+	int m;
+	int n;
+	int k;
+	int lda;
+	int ldb;
+	int ldc;
+	int tran_a;
+	int tran_b;
+	int sda;
+	int sdb;
+	int pA_size; // doubles between two packed A buffers
+	int n_task_b; // tasks packing B
+	int pr; // task grid rows
+	int pc; // task grid cols
+	};
+
+
+
+// pack the B columns of the task
+static void dgemm_mt_pack_b(void *ptr, int task_id)
+	{
+	struct dgemm_mt_arg *arg = ptr;
+	int n = arg->n;
+	int k = arg->k;
+	int ldb = arg->ldb;
+	int sdb = arg->sdb;
+	double *B = arg->B;
+	double *pB = arg->pB;
+	int nb = (n+3)/4;
+	int j0 = task_id*nb/arg->n_task_b*4;
+	int j1 = (task_id+1)*nb/arg->n_task_b*4;
+	j1 = j1<n ? j1 : n;
+	dgemm_pack_b(arg->tran_b, j0, j1, k, B, ldb, pB, sdb);
+	return;
+	}
+
+
+
+// compute the block of C of the task, packing its rows of A in the task buffer
+static void dgemm_mt_task(void *ptr, int task_id)
+	{
+	struct dgemm_mt_arg *arg = ptr;
+	const int mu = DGEMM_M_KERNEL;
+	int m = arg->m;
+	int n = arg->n;
+	int k = arg->k;
+	int lda = arg->lda;
+	int ldc = arg->ldc;
+	double *pA = arg->pA + task_id*arg->pA_size;
+	int mb = (m+mu-1)/mu;
+	int nb = (n+3)/4;
+	int ir = task_id%arg->pr;
+	int jc = task_id/arg->pr;
+	int i0 = ir*mb/arg->pr*mu;
+	int i1 = (ir+1)*mb/arg->pr*mu;
+	int j0 = jc*nb/arg->pc*4;
+	int j1 = (jc+1)*nb/arg->pc*4;
+	i1 = i1<m ? i1 : m;
+	j1 = j1<n ? j1 : n;
+	int ii, m1;
+	for(ii=i0; ii<i1; ii+=mu)
+		{
+		m1 = i1-ii<mu ? i1-ii : mu;
+		if(arg->tran_a)
+			dgemm_pack_a(1, m1, k, arg->A+ii*lda, lda, pA, arg->sda);
+		else
+			dgemm_pack_a(0, m1, k, arg->A+ii, lda, pA, arg->sda);
+		dgemm_kernel(m1, j0, j1, k, arg->alpha, pA, arg->sda, arg->pB, arg->sdb, arg->beta, arg->C+ii, ldc);
+		}
+	return;
+	}
+
+
+
+// pack B once in a shared buffer and compute row and col blocks of C in parallel;
+// return 0 (and do nothing) if the matrix is too small to be worth it
+static int dgemm_mt(char ta, char tb, int m, int n, int k, double *alpha, double *A, int lda, double *B, int ldb, double *beta, double *C, int ldc)
+	{
+	const int mu = DGEMM_M_KERNEL;
+	int n_thread = blasfeo_thread_pool_num_threads();
+	if(n_thread<=1)
+		return 0;
+	int tran_a, tran_b;
+	if(ta=='n' | ta=='N')
+		tran_a = 0;
+	else if(ta=='t' | ta=='T' | ta=='c' | ta=='C')
+		tran_a = 1;
+	else
+		return 0;
+	if(tb=='n' | tb=='N')
+		tran_b = 0;
+	else if(tb=='t' | tb=='T' | tb=='c' | tb=='C')
+		tran_b = 1;
+	else
+		return 0;
+	double work = (double) m * (double) n * (double) k;
+	if(work<2.0*DGEMM_MT_MIN_WORK)
+		return 0;
+	if(work<n_thread*(double) DGEMM_MT_MIN_WORK)
+		n_thread = work/DGEMM_MT_MIN_WORK;
+	// task grid: split rows first, since each col block packs its own copy of A
+	int mb = (m+mu-1)/mu;
+	int nb = (n+3)/4;
+	int pr = n_thread<mb ? n_thread : mb;
+	int pc = n_thread/pr;
+	pc = pc<nb ? pc : nb;
+	if(pr*pc<=1)
+		return 0;
+
+	struct blasfeo_dmat sA, sB;
+	int k1 = (k+128-1)/128*128;
+	int n1 = (n+128-1)/128*128;
+	int sA_size = (blasfeo_memsize_dmat(mu, k1)+63)/64*64;
+	int sB_size = (blasfeo_memsize_dmat(n1, k1)+63)/64*64;
+	void *mem = blasfeo_blas_workspace_malloc(sB_size+pr*pc*sA_size+64);
+	char *mem_align;
+	blasfeo_align_64_byte(mem, (void **) &mem_align);
+	blasfeo_create_dmat(n, k, &sB, (void *) mem_align);
+	blasfeo_create_dmat(mu, k, &sA, (void *) (mem_align+sB_size));
+
+	struct dgemm_mt_arg arg;
+	arg.alpha = alpha;
+	arg.A = A;
+	arg.B = B;
+	arg.beta = beta;
+	arg.C = C;
+	arg.pA = sA.pA;
+	arg.pB = sB.pA;
+	arg.m = m;
+	arg.n = n;
+	arg.k = k;
+	arg.lda = lda;
+	arg.ldb = ldb;
+	arg.ldc = ldc;
+	arg.tran_a = tran_a;
+	arg.tran_b = tran_b;
+	arg.sda = sA.cn;
+	arg.sdb = sB.cn;
+	arg.pA_size = sA_size/sizeof(double);
+	arg.n_task_b = n_thread<nb ? n_thread : nb;
+	arg.pr = pr;
+	arg.pc = pc;
+
+	blasfeo_thread_pool_run(arg.n_task_b, &dgemm_mt_pack_b, &arg);
+	blasfeo_thread_pool_run(pr*pc, &dgemm_mt_task, &arg);
+
+	blasfeo_blas_workspace_free(mem);
+	return 1;
+	}
+
 #endif
 
 
@@ -91,27 +506,48 @@ void blasfeo_dgemm(char *ta, char *tb, int *pm, int *pn, int *pk, double *alpha,
 	int m1, n1, k1;
 	int pack_B;
 
-	// TODO move to a header file to reuse across routines
-#if defined(TARGET_X64_INTEL_HASWELL) | defined(TARGET_ARMV8A_ARM_CORTEX_A53)
-	const int m_kernel = 12;
-	// L1 data cache size: 32 kB
-	const int l1_cache_el = 32*1024/8;
-	// data cache size: 64 bytes
-	const int reals_per_cache_line = 8;
-#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE) | defined(TARGET_ARMV8A_ARM_CORTEX_A57)
-	const int m_kernel = 8;
-	// L1 data cache size: 32 kB
-	const int l1_cache_el = 32*1024/8;
-	// data cache size: 64 bytes
-	const int reals_per_cache_line = 8;
-#else // assume generic target
-	const int m_kernel = 4;
-	// L1 data cache size: 32 kB
-	const int l1_cache_el = 32*1024/8;
-	// data cache size: 64 bytes
-	const int reals_per_cache_line = 8;
-	// TODO 32-bytes for cortex A9
+	const int m_kernel = DGEMM_M_KERNEL;
+	// L1 data cache and cache line sizes, detected at run-time
+	int l1_cache, l2_cache, l3_cache, cache_line;
+	blasfeo_processor_cache_size(&l1_cache, &l2_cache, &l3_cache);
+	blasfeo_processor_cache_line_size(&cache_line);
+	const int l1_cache_el = l1_cache/8;
+	const int reals_per_cache_line = cache_line>=8 ? cache_line/8 : 1;
+	// built-in dispatch thresholds of the target (see blasfeo_tuning.h), the ones tuned for a 32 kB L1 data cache
+	// scale with its size
+#if defined(TARGET_X64_INTEL_HASWELL)
+	const int small_mn_default = m_kernel;
+	const int pack_one_mn_default = 2*m_kernel;
+	const int pack_one_k_default = 448*l1_cache_el/(32*1024/8);
+	const int pack_one_k_nt_default = 200*l1_cache_el/(32*1024/8);
+#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
+	const int small_mn_default = (48*l1_cache_el/(32*1024/8)+m_kernel-1)/m_kernel*m_kernel;
+	const int pack_one_mn_default = 2*8;
+	const int pack_one_k_default = 56;
+	const int pack_one_k_nt_default = 56;
+#elif defined(TARGET_X64_INTEL_CORE)
+	const int small_mn_default = 8;
+	const int pack_one_mn_default = 1*4;
+	const int pack_one_k_default = 8;
+	const int pack_one_k_nt_default = 8;
+#elif defined(TARGET_ARMV8A_ARM_CORTEX_A57)
+	const int small_mn_default = 24;
+	const int pack_one_mn_default = 2*8;
+	const int pack_one_k_default = 64;
+	const int pack_one_k_nt_default = 64;
+#elif defined(TARGET_ARMV8A_ARM_CORTEX_A53)
+	const int small_mn_default = 8;
+	const int pack_one_mn_default = 1*12;
+	const int pack_one_k_default = 16;
+	const int pack_one_k_nt_default = 16;
+#else
+	const int small_mn_default = 8;
+	const int pack_one_mn_default = 1*m_kernel;
+	const int pack_one_k_default = 12;
+	const int pack_one_k_nt_default = 12;
 #endif
+	struct blasfeo_tuning *tuning = blasfeo_tuning_table();
+	int small_mn, pack_one_mn, pack_one_k;
 	const int m_cache = (m+reals_per_cache_line-1)/reals_per_cache_line*reals_per_cache_line;
 	const int n_cache = (n+reals_per_cache_line-1)/reals_per_cache_line*reals_per_cache_line;
 	const int k_cache = (k+reals_per_cache_line-1)/reals_per_cache_line*reals_per_cache_line;
@@ -119,6 +555,12 @@ void blasfeo_dgemm(char *ta, char *tb, int *pm, int *pn, int *pk, double *alpha,
 	int m_min = m_cache<m_kernel_cache ? m_cache : m_kernel_cache;
 //	int n_min = n_cache<m_kernel_cache ? n_cache : m_kernel_cache;
 
+#if defined(MULTI_THREAD)
+	// big matrix: pack B once and compute in parallel
+	if(dgemm_mt(*ta, *tb, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc))
+		return;
+#endif
+
 	if(*ta=='n' | *ta=='N')
 		{
 		if(*tb=='n' | *tb=='N')
@@ -129,42 +571,33 @@ void blasfeo_dgemm(char *ta, char *tb, int *pm, int *pn, int *pk, double *alpha,
 //			goto nn_1; // pack A and B
 			if( k<=K_MAX_STACK )
 				{
+				small_mn = tuning->dgemm_nn_small_mn>=0 ? tuning->dgemm_nn_small_mn : small_mn_default;
+				pack_one_mn = tuning->dgemm_nn_pack_one_mn>=0 ? tuning->dgemm_nn_pack_one_mn : pack_one_mn_default;
+				pack_one_k = tuning->dgemm_nn_pack_one_k>=0 ? tuning->dgemm_nn_pack_one_k : pack_one_k_default;
 #if defined(TARGET_X64_INTEL_HASWELL)
 //				if( m<=48 & n<=48 )
 //				if( (m<=12 & n<=12) | (m_min*k_cache + n_cache*k_cache <= l1_cache_el) )
-				if( (m<=m_kernel & n<=m_kernel) | (m_kernel_cache*k_cache + n_cache*k_cache <= l1_cache_el) | (m<m_kernel & (m_cache*k_cache + m_kernel_cache*k_cache <= l1_cache_el) ) )
+				if( (m<=small_mn & n<=small_mn) | (m_kernel_cache*k_cache + n_cache*k_cache <= l1_cache_el) | (m<m_kernel & (m_cache*k_cache + m_kernel_cache*k_cache <= l1_cache_el) ) )
 					{
 					goto nn_2; // small matrix: no pack
 					}
 #elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
-				if( m<=48 & n<=48 )
+				if( m<=small_mn & n<=small_mn )
 					{
 					goto nn_m0; // small matrix: pack A
 					}
 #elif defined(TARGET_ARMV8A_ARM_CORTEX_A57)
-				if( m<=24 & n<=24 )
+				if( m<=small_mn & n<=small_mn )
 					{
 					goto nn_m0; // small matrix: pack A
 					}
 #else
-				if( m<=8 & n<=8 )
+				if( m<=small_mn & n<=small_mn )
 					{
 					goto nn_2; // small matrix: no pack
 					}
 #endif
-#if defined(TARGET_X64_INTEL_HASWELL)
-				if( m<=2*m_kernel | n<=2*m_kernel | k<448 )
-#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
-				if( m<=2*8 | n<=2*8 | k<56 )
-#elif defined(TARGET_X64_INTEL_CORE)
-				if( m<=1*4 | n<=1*4 | k<8 )
-#elif defined(TARGET_ARMV8A_ARM_CORTEX_A57)
-				if( m<=2*8 | n<=2*8 | k<64 )
-#elif defined(TARGET_ARMV8A_ARM_CORTEX_A53)
-				if( m<=1*12 | n<=1*12 | k<16 )
-#else
-				if( m<=1*m_kernel | n<=1*m_kernel | k<12 )
-#endif
+				if( m<=pack_one_mn | n<=pack_one_mn | k<pack_one_k )
 					{
 					if( m<=n*4 )
 						{
@@ -176,6 +609,9 @@ void blasfeo_dgemm(char *ta, char *tb, int *pm, int *pn, int *pk, double *alpha,
 						}
 					}
 				}
+			// big matrix: block for the cache hierarchy if op(B) does not fit in L2
+			if(dgemm_blocked(0, 0, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc))
+				return;
 			goto nn_1; // big matrix: pack A and B
 			}
 		else if(*tb=='t' | *tb=='T' | *tb=='c' | *tb=='C')
@@ -186,42 +622,33 @@ void blasfeo_dgemm(char *ta, char *tb, int *pm, int *pn, int *pk, double *alpha,
 //			goto nt_1; // pack A and B
 			if( k<=K_MAX_STACK )
 				{
+				small_mn = tuning->dgemm_nt_small_mn>=0 ? tuning->dgemm_nt_small_mn : small_mn_default;
+				pack_one_mn = tuning->dgemm_nt_pack_one_mn>=0 ? tuning->dgemm_nt_pack_one_mn : pack_one_mn_default;
+				pack_one_k = tuning->dgemm_nt_pack_one_k>=0 ? tuning->dgemm_nt_pack_one_k : pack_one_k_nt_default;
 #if defined(TARGET_X64_INTEL_HASWELL)
 //				if( m<=48 & n<=48 )
-				if( (m<=m_kernel & n<=m_kernel) | (m_kernel_cache*k_cache + n_cache*k_cache <= l1_cache_el) | (m<m_kernel & (m_cache*k_cache + m_kernel_cache*k_cache <= l1_cache_el) ) )
+				if( (m<=small_mn & n<=small_mn) | (m_kernel_cache*k_cache + n_cache*k_cache <= l1_cache_el) | (m<m_kernel & (m_cache*k_cache + m_kernel_cache*k_cache <= l1_cache_el) ) )
 					{
 //					printf("%d %d %d\n", m, n, k);
 					goto nt_2; // small matrix: no pack
 					}
 #elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
-				if( m<=48 & n<=48 )
+				if( m<=small_mn & n<=small_mn )
 					{
 					goto nt_m0; // small matrix: pack A
 					}
 #elif defined(TARGET_ARMV8A_ARM_CORTEX_A57)
-				if( m<=24 & n<=24 )
+				if( m<=small_mn & n<=small_mn )
 					{
 					goto nt_m0; // small matrix: pack A
 					}
 #else
-				if( m<=8 & n<=8 )
+				if( m<=small_mn & n<=small_mn )
 					{
 					goto nt_2; // small matrix: no pack
 					}
 #endif
-#if defined(TARGET_X64_INTEL_HASWELL)
-				if( m<=2*12 | n<=2*12 | k<200 )
-#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
-				if( m<=2*8 | n<=2*8 | k<56 )
-#elif defined(TARGET_X64_INTEL_CORE)
-				if( m<=1*4 | n<=1*4 | k<8 )
-#elif defined(TARGET_ARMV8A_ARM_CORTEX_A57)
-				if( m<=2*8 | n<=2*8 | k<64 )
-#elif defined(TARGET_ARMV8A_ARM_CORTEX_A53)
-				if( m<=1*12 | n<=1*12 | k<16 )
-#else
-				if( m<=1*4 | n<=1*4 | k<12 )
-#endif
+				if( m<=pack_one_mn | n<=pack_one_mn | k<pack_one_k )
 					{
 					if( m<=n )
 						{
@@ -233,6 +660,9 @@ void blasfeo_dgemm(char *ta, char *tb, int *pm, int *pn, int *pk, double *alpha,
 						}
 					}
 				}
+			// big matrix: block for the cache hierarchy if op(B) does not fit in L2
+			if(dgemm_blocked(0, 1, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc))
+				return;
 			goto nt_1; // big matrix: pack A and B
 			}
 		else
@@ -250,6 +680,8 @@ void blasfeo_dgemm(char *ta, char *tb, int *pm, int *pn, int *pk, double *alpha,
 //			goto tn_1; // pack A and B
 			if( k<=K_MAX_STACK )
 				{
+				pack_one_mn = tuning->dgemm_tn_pack_one_mn>=0 ? tuning->dgemm_tn_pack_one_mn : pack_one_mn_default;
+				pack_one_k = tuning->dgemm_tn_pack_one_k>=0 ? tuning->dgemm_tn_pack_one_k : pack_one_k_default;
 				// no algorithm for small matrix
 //#if defined(TARGET_X64_INTEL_HASWELL) | defined(TARGET_X64_INTEL_SANDY_BRIDGE)
 //				if( m<=48 & n<=48 )
@@ -261,19 +693,7 @@ void blasfeo_dgemm(char *ta, char *tb, int *pm, int *pn, int *pk, double *alpha,
 //					{
 //					goto tn_m0; // small matrix: pack A
 //					}
-#if defined(TARGET_X64_INTEL_HASWELL)
-				if( m<=2*12 | n<=2*12 | k<448 )
-#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
-				if( m<=2*8 | n<=2*8 | k<56 )
-#elif defined(TARGET_X64_INTEL_CORE)
-				if( m<=1*4 | n<=1*4 | k<8 )
-#elif defined(TARGET_ARMV8A_ARM_CORTEX_A57)
-				if( m<=2*8 | n<=2*8 | k<64 )
-#elif defined(TARGET_ARMV8A_ARM_CORTEX_A53)
-				if( m<=1*12 | n<=1*12 | k<16 )
-#else
-				if( m<=1*4 | n<=1*4 | k<12 )
-#endif
+				if( m<=pack_one_mn | n<=pack_one_mn | k<pack_one_k )
 					{
 					if( m<=n )
 						{
@@ -285,6 +705,9 @@ void blasfeo_dgemm(char *ta, char *tb, int *pm, int *pn, int *pk, double *alpha,
 						}
 					}
 				}
+			// big matrix: block for the cache hierarchy if op(B) does not fit in L2
+			if(dgemm_blocked(1, 0, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc))
+				return;
 			goto tn_1; // big matrix: pack A and B
 			}
 		else if(*tb=='t' | *tb=='T' | *tb=='c' | *tb=='C')
@@ -295,41 +718,32 @@ void blasfeo_dgemm(char *ta, char *tb, int *pm, int *pn, int *pk, double *alpha,
 //			goto tt_1; // pack A and B
 			if( k<=K_MAX_STACK )
 				{
+				small_mn = tuning->dgemm_tt_small_mn>=0 ? tuning->dgemm_tt_small_mn : small_mn_default;
+				pack_one_mn = tuning->dgemm_tt_pack_one_mn>=0 ? tuning->dgemm_tt_pack_one_mn : pack_one_mn_default;
+				pack_one_k = tuning->dgemm_tt_pack_one_k>=0 ? tuning->dgemm_tt_pack_one_k : pack_one_k_default;
 #if defined(TARGET_X64_INTEL_HASWELL)
 //				if( m<=48 & n<=48 )
-				if( (m<=m_kernel & n<=m_kernel) | (m_cache*k_cache + m_kernel_cache*k_cache <= l1_cache_el) | (n<m_kernel & (m_kernel_cache*k_cache + n_cache*k_cache <= l1_cache_el) ) )
+				if( (m<=small_mn & n<=small_mn) | (m_cache*k_cache + m_kernel_cache*k_cache <= l1_cache_el) | (n<m_kernel & (m_kernel_cache*k_cache + n_cache*k_cache <= l1_cache_el) ) )
 					{
 					goto tt_2; // small matrix: no pack
 					}
 #elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
-				if( m<=48 & n<=48 )
+				if( m<=small_mn & n<=small_mn )
 					{
 					goto tt_m0; // small matrix: pack A
 					}
 #elif defined(TARGET_ARMV8A_ARM_CORTEX_A57)
-				if( m<=24 & n<=24 )
+				if( m<=small_mn & n<=small_mn )
 					{
 					goto tt_m0; // small matrix: pack A
 					}
 #else
-				if( m<=8 & n<=8 )
+				if( m<=small_mn & n<=small_mn )
 					{
 					goto tt_2; // small matrix: no pack
 					}
 #endif
-#if defined(TARGET_X64_INTEL_HASWELL)
-				if( m<=2*12 | n<=2*12 | k<448 )
-#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
-				if( m<=2*8 | n<=2*8 | k<56 )
-#elif defined(TARGET_X64_INTEL_CORE)
-				if( m<=1*4 | n<=1*4 | k<8 )
-#elif defined(TARGET_ARMV8A_ARM_CORTEX_A57)
-				if( m<=2*8 | n<=2*8 | k<64 )
-#elif defined(TARGET_ARMV8A_ARM_CORTEX_A53)
-				if( m<=1*12 | n<=1*12 | k<16 )
-#else
-				if( m<=1*4 | n<=1*4 | k<12 )
-#endif
+				if( m<=pack_one_mn | n<=pack_one_mn | k<pack_one_k )
 					{
 					if( m*4<=n | k<=4 ) // XXX k too !!!
 						{
@@ -341,6 +755,9 @@ void blasfeo_dgemm(char *ta, char *tb, int *pm, int *pn, int *pk, double *alpha,
 						}
 					}
 				}
+			// big matrix: block for the cache hierarchy if op(B) does not fit in L2
+			if(dgemm_blocked(1, 1, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc))
+				return;
 			goto tt_1; // big matrix: pack A and B
 			}
 		}
@@ -623,7 +1040,7 @@ nn_1:
 	n1 = (n+128-1)/128*128;
 	sA_size = blasfeo_memsize_dmat(m_kernel, k1);
 	sB_size = blasfeo_memsize_dmat(n1, k1);
-	mem = malloc(sA_size+sB_size+64);
+	mem = blasfeo_blas_workspace_malloc(sA_size+sB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	// TODO smaller for non-haswell !!!
 	blasfeo_create_dmat(m_kernel, k, &sA, (void *) mem_align);
@@ -758,7 +1175,7 @@ nn_1_left_4:
 	goto nn_1_return;
 
 nn_1_return:
-	free(mem);
+	blasfeo_blas_workspace_free(mem);
 	return;
 
 
@@ -1121,7 +1538,7 @@ nt_1:
 	n1 = (n+128-1)/128*128;
 	sA_size = blasfeo_memsize_dmat(m_kernel, k1);
 	sB_size = blasfeo_memsize_dmat(n1, k1);
-	mem = malloc(sA_size+sB_size+64);
+	mem = blasfeo_blas_workspace_malloc(sA_size+sB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_create_dmat(m_kernel, k, &sA, (void *) mem_align);
 	blasfeo_create_dmat(n, k, &sB, (void *) (mem_align+sA_size));
@@ -1241,7 +1658,7 @@ nt_1_left_4:
 	goto nt_1_return;
 
 nt_1_return:
-	free(mem);
+	blasfeo_blas_workspace_free(mem);
 	return;
 
 
@@ -1616,7 +2033,7 @@ tn_1:
 	n1 = (n+128-1)/128*128;
 	sA_size = blasfeo_memsize_dmat(m_kernel, k1);
 	sB_size = blasfeo_memsize_dmat(n1, k1);
-	mem = malloc(sA_size+sB_size+64);
+	mem = blasfeo_blas_workspace_malloc(sA_size+sB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_create_dmat(m_kernel, k, &sA, (void *) mem_align);
 	blasfeo_create_dmat(n, k, &sB, (void *) (mem_align+sA_size));
@@ -1756,7 +2173,7 @@ tn_1_left_4:
 	goto tn_1_return;
 
 tn_1_return:
-free(mem);
+blasfeo_blas_workspace_free(mem);
 	return;
 
 
@@ -2030,7 +2447,7 @@ tt_1:
 	n1 = (n+128-1)/128*128;
 	sA_size = blasfeo_memsize_dmat(m_kernel, k1);
 	sB_size = blasfeo_memsize_dmat(n1, k1);
-	mem = malloc(sA_size+sB_size+64);
+	mem = blasfeo_blas_workspace_malloc(sA_size+sB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_create_dmat(m_kernel, k, &sA, (void *) mem_align);
 	blasfeo_create_dmat(n, k, &sB, (void *) (mem_align+sA_size));
@@ -2156,7 +2573,7 @@ tt_1_left_4:
 	goto tt_1_return;
 
 tt_1_return:
-	free(mem);
+	blasfeo_blas_workspace_free(mem);
 	return;
 
 
@@ -2260,3 +2677,274 @@ tt_2_return:
 
 	}
 
+
+
+
+// packed operand handle: header, followed (at the first 64-byte aligned address) by
+// op(A) as a m x k panel-major matrix, or by op(B)^T as a n x k panel-major matrix
+struct dgemm_packed
+	{
+	double alpha; // scaling of the packed operand
+	int id; // 'A' or 'B'
+	int m; // rows of the packed matrix
+	int k;
+	int sd; // panel stride
+	int offset; // bytes from the handle to the packed matrix
+	};
+
+
+
+static int dgemm_packed_identifier(char *identifier)
+	{
+	if(*identifier=='a' | *identifier=='A')
+		return 'A';
+	if(*identifier=='b' | *identifier=='B')
+		return 'B';
+	return 0;
+	}
+
+
+
+// size in bytes of the handle packing A (m x k) or B (k x n)
+int blasfeo_dgemm_pack_get_size(char *identifier, int *pm, int *pn, int *pk)
+	{
+	int id = dgemm_packed_identifier(identifier);
+	int rows;
+	if(id=='A')
+		rows = *pm;
+	else if(id=='B')
+		rows = *pn;
+	else
+		{
+		printf("\nBLASFEO: dgemm_pack_get_size: wrong value for identifier\n");
+		return 0;
+		}
+	rows = rows>0 ? rows : 0;
+	int k = *pk>0 ? *pk : 0;
+	int rows_pad = (rows+3)/4*4;
+	int sd = (k+3)/4*4;
+	return 64 + 64 + rows_pad*sd*sizeof(double);
+	}
+
+
+
+// pack alpha*op(A) or alpha*op(B) in the handle dest (of size blasfeo_dgemm_pack_get_size)
+void blasfeo_dgemm_pack(char *identifier, char *trans, int *pm, int *pn, int *pk, double *alpha, double *src, int *pld, void *dest)
+	{
+
+#if defined(PRINT_NAME)
+	printf("\nblasfeo_dgemm_pack %c %c %d %d %d %f %p %d %p\n", *identifier, *trans, *pm, *pn, *pk, *alpha, src, *pld, dest);
+#endif
+
+	int id = dgemm_packed_identifier(identifier);
+	if(id==0)
+		{
+		printf("\nBLASFEO: dgemm_pack: wrong value for identifier\n");
+		return;
+		}
+	int tran;
+	if(*trans=='n' | *trans=='N')
+		tran = 0;
+	else if(*trans=='t' | *trans=='T' | *trans=='c' | *trans=='C')
+		tran = 1;
+	else
+		{
+		printf("\nBLASFEO: dgemm_pack: wrong value for trans\n");
+		return;
+		}
+
+	struct dgemm_packed *hdr = dest;
+	int rows = id=='A' ? *pm : *pn;
+	rows = rows>0 ? rows : 0;
+	int k = *pk>0 ? *pk : 0;
+	int sd = (k+3)/4*4;
+	char *mem_align;
+	blasfeo_align_64_byte((char *) dest+64, (void **) &mem_align);
+	double *pM = (double *) mem_align;
+
+	hdr->alpha = *alpha;
+	hdr->id = id;
+	hdr->m = rows;
+	hdr->k = k;
+	hdr->sd = sd;
+	hdr->offset = mem_align - (char *) dest;
+
+	if(rows==0 | k==0)
+		return;
+
+	int ld = *pld;
+	int ii, m1;
+	if(id=='A')
+		{
+		for(ii=0; ii<rows; ii+=DGEMM_M_KERNEL)
+			{
+			m1 = rows-ii<DGEMM_M_KERNEL ? rows-ii : DGEMM_M_KERNEL;
+			if(tran)
+				dgemm_pack_a(1, m1, k, src+ii*ld, ld, pM+ii*sd, sd);
+			else
+				dgemm_pack_a(0, m1, k, src+ii, ld, pM+ii*sd, sd);
+			}
+		}
+	else
+		{
+		dgemm_pack_b(tran, 0, rows, k, src, ld, pM, sd);
+		}
+
+	return;
+
+	}
+
+
+
+// C = op(A) * op(B) + beta * C, where at least one of A and B is a handle
+// from blasfeo_dgemm_pack (ta or tb equal to 'P'), the other one is column-major
+void blasfeo_dgemm_compute(char *ta, char *tb, int *pm, int *pn, int *pk, double *A, int *plda, double *B, int *pldb, double *beta, double *C, int *pldc)
+	{
+
+#if defined(PRINT_NAME)
+	printf("\nblasfeo_dgemm_compute %c %c %d %d %d %p %d %p %d %f %p %d\n", *ta, *tb, *pm, *pn, *pk, A, *plda, B, *pldb, *beta, C, *pldc);
+#endif
+
+	int m = *pm;
+	int n = *pn;
+	int k = *pk;
+	int ldc = *pldc;
+
+	if(m<=0 | n<=0)
+		return;
+
+	int packed_a = *ta=='p' | *ta=='P';
+	int packed_b = *tb=='p' | *tb=='P';
+
+	double d_1 = 1.0;
+
+	if(!packed_a & !packed_b)
+		{
+		blasfeo_dgemm(ta, tb, pm, pn, pk, &d_1, A, plda, B, pldb, beta, C, pldc);
+		return;
+		}
+
+	int tran_a = 0;
+	int tran_b = 0;
+	if(!packed_a)
+		{
+		if(*ta=='t' | *ta=='T' | *ta=='c' | *ta=='C')
+			tran_a = 1;
+		else if(!(*ta=='n' | *ta=='N'))
+			{
+			printf("\nBLASFEO: dgemm_compute: wrong value for ta\n");
+			return;
+			}
+		}
+	if(!packed_b)
+		{
+		if(*tb=='t' | *tb=='T' | *tb=='c' | *tb=='C')
+			tran_b = 1;
+		else if(!(*tb=='n' | *tb=='N'))
+			{
+			printf("\nBLASFEO: dgemm_compute: wrong value for tb\n");
+			return;
+			}
+		}
+
+	struct dgemm_packed *hdr_a = (struct dgemm_packed *) A;
+	struct dgemm_packed *hdr_b = (struct dgemm_packed *) B;
+	if(packed_a && (hdr_a->id!='A' | hdr_a->m!=m | hdr_a->k!=k))
+		{
+		printf("\nBLASFEO: dgemm_compute: packed A does not match m and k\n");
+		return;
+		}
+	if(packed_b && (hdr_b->id!='B' | hdr_b->m!=n | hdr_b->k!=k))
+		{
+		printf("\nBLASFEO: dgemm_compute: packed B does not match n and k\n");
+		return;
+		}
+
+	double alpha = 1.0;
+	double *pA = NULL;
+	double *pB = NULL;
+	int sda = 0;
+	int sdb = 0;
+	if(packed_a)
+		{
+		alpha *= hdr_a->alpha;
+		pA = (double *) ((char *) A + hdr_a->offset);
+		sda = hdr_a->sd;
+		}
+	if(packed_b)
+		{
+		alpha *= hdr_b->alpha;
+		pB = (double *) ((char *) B + hdr_b->offset);
+		sdb = hdr_b->sd;
+		}
+
+	const int mu = DGEMM_M_KERNEL;
+	int ii, jj, m1, n1;
+
+	if(packed_a & packed_b)
+		{
+		for(ii=0; ii<m; ii+=mu)
+			{
+			m1 = m-ii<mu ? m-ii : mu;
+			dgemm_kernel(m1, 0, n, k, &alpha, pA+ii*sda, sda, pB, sdb, beta, C+ii, ldc);
+			}
+		return;
+		}
+
+	// pack the other operand in blocks, on the stack for small k
+// TODO visual studio alignment
+#if defined(TARGET_GENERIC)
+	double pU[DGEMM_M_KERNEL*K_MAX_STACK];
+#else
+	ALIGNED( double pU[DGEMM_M_KERNEL*K_MAX_STACK], 64 );
+#endif
+	int sdu = (k+3)/4*4;
+	double *pW = pU;
+	void *mem = NULL;
+	char *mem_align;
+	if(sdu>K_MAX_STACK)
+		{
+		mem = blasfeo_blas_workspace_malloc(mu*sdu*sizeof(double)+64);
+		blasfeo_align_64_byte(mem, (void **) &mem_align);
+		pW = (double *) mem_align;
+		}
+
+	if(packed_b)
+		{
+		// rows of op(A) in blocks of the kernel size, swept against all of the packed B
+		int lda = *plda;
+		for(ii=0; ii<m; ii+=mu)
+			{
+			m1 = m-ii<mu ? m-ii : mu;
+			if(tran_a)
+				dgemm_pack_a(1, m1, k, A+ii*lda, lda, pW, sdu);
+			else
+				dgemm_pack_a(0, m1, k, A+ii, lda, pW, sdu);
+			dgemm_kernel(m1, 0, n, k, &alpha, pW, sdu, pB, sdb, beta, C+ii, ldc);
+			}
+		}
+	else
+		{
+		// cols of op(B) in blocks of 4, swept against all of the packed A
+		int ldb = *pldb;
+		for(jj=0; jj<n; jj+=4)
+			{
+			n1 = n-jj<4 ? n-jj : 4;
+			if(tran_b)
+				dgemm_pack_b(1, 0, n1, k, B+jj, ldb, pW, sdu);
+			else
+				dgemm_pack_b(0, 0, n1, k, B+jj*ldb, ldb, pW, sdu);
+			for(ii=0; ii<m; ii+=mu)
+				{
+				m1 = m-ii<mu ? m-ii : mu;
+				dgemm_kernel(m1, 0, n1, k, &alpha, pA+ii*sda, sda, pW, sdu, beta, C+ii+jj*ldc, ldc);
+				}
+			}
+		}
+
+	if(mem!=NULL)
+		blasfeo_blas_workspace_free(mem);
+
+	return;
+
+	}
@@ -39,9 +39,13 @@
 
 #include "../include/blasfeo_target.h"
 #include "../include/blasfeo_common.h"
+#include "../include/blasfeo_stdlib.h"
 #include "../include/blasfeo_d_aux.h"
 #include "../include/blasfeo_d_kernel.h"
 #include "../include/blasfeo_d_blas.h"
+#include "../include/blasfeo_d_blasfeo_api.h"
+#include "../include/blasfeo_thread.h"
+#include "../include/blasfeo_tuning.h"
 
 
 
@@ -113,25 +117,36 @@ void blasfeo_dgetrf(int *pm, int *pn, double *C, int *pldc, int *ipiv, int *info
 	double dm1 = -1.0;
 
 	int ii, jj;
+	int pack_mn;
 
 	int arg0, arg1, arg2;
 
 	double *dummy = NULL;
 
 	int ipiv_tmp[4];
-	ipiv[0] = 0;
-	ipiv[1] = 0;
-	ipiv[2] = 0;
-	ipiv[3] = 0;
+	// ipiv has only min(m,n) entries
+	for(ii=0; ii<p & ii<4; ii++)
+		ipiv[ii] = 0;
 
 
+#if defined(MULTI_THREAD)
+	// big matrix on more threads: multi-threaded factorization of a panel-major copy
+	if(blasfeo_thread_pool_num_threads()>1 & p>=192)
+		{
+		goto alg_mt;
+		}
+#endif
+
 #if defined(TARGET_X64_INTEL_HASWELL)
-	if(m>300 | n>300 | m>K_MAX_STACK)
+	pack_mn = 301;
 #elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
-	if(m>240 | n>240 | m>K_MAX_STACK)
+	pack_mn = 241;
 #else
-	if(m>=12 | n>=12 | m>K_MAX_STACK)
+	pack_mn = 12;
 #endif
+	struct blasfeo_tuning *tuning = blasfeo_tuning_table();
+	pack_mn = tuning->dgetrf_pack_mn>=0 ? tuning->dgetrf_pack_mn : pack_mn;
+	if(m>=pack_mn | n>=pack_mn | m>K_MAX_STACK)
 		{
 		goto alg1;
 		}
@@ -609,7 +624,7 @@ alg1:
 	sC_size = blasfeo_memsize_dmat(m1, n1) + 12*m1*sizeof(double);
 //	sC_size = blasfeo_memsize_dmat(m, m);
 	stot_size = sC_size;
-	mem = malloc(stot_size+64);
+	mem = blasfeo_blas_workspace_malloc(stot_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	pU = (double *) mem_align;
 	sdu = (m+3)/4*4;
@@ -1177,11 +1192,32 @@ end_1:
 	// TODO clean loops
 
 end_m_1:
-	free(mem);
+	blasfeo_blas_workspace_free(mem);
+	// from 0-index to 1-index
+	for(ii=0; ii<p; ii++)
+		ipiv[ii] += 1;
+	return;
+
+
+
+#if defined(MULTI_THREAD)
+alg_mt:
+
+	sC_size = blasfeo_memsize_dmat(m, n);
+	mem = blasfeo_blas_workspace_malloc(sC_size+64+blasfeo_dgetrf_rp_mt_worksize(m, n));
+	blasfeo_align_64_byte(mem, (void **) &mem_align);
+	blasfeo_create_dmat(m, n, &sC, mem_align);
+
+	blasfeo_pack_dmat(m, n, C, ldc, &sC, 0, 0);
+	blasfeo_dgetrf_rp_mt(m, n, &sC, 0, 0, &sC, 0, 0, ipiv, mem_align+sC_size);
+	blasfeo_unpack_dmat(m, n, &sC, 0, 0, C, ldc);
+
+	blasfeo_blas_workspace_free(mem);
 	// from 0-index to 1-index
 	for(ii=0; ii<p; ii++)
 		ipiv[ii] += 1;
 	return;
+#endif
 
 	}
 
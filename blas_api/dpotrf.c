@@ -39,6 +39,7 @@
 
 #include "../include/blasfeo_target.h"
 #include "../include/blasfeo_common.h"
+#include "../include/blasfeo_stdlib.h"
 #include "../include/blasfeo_d_aux.h"
 #include "../include/blasfeo_d_kernel.h"
 #include "../include/blasfeo_d_blas.h"
@@ -270,7 +271,7 @@ l_1:
 	sC_size = blasfeo_memsize_dmat(m1, m1);
 //	sC_size = blasfeo_memsize_dmat(m, m);
 	stot_size = sC_size;
-	mem = malloc(stot_size+64);
+	mem = blasfeo_blas_workspace_malloc(stot_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_create_dmat(m, m, &sC, (void *) mem_align);
 	sdc = sC.cn;
@@ -402,11 +403,11 @@ l_1_return:
 		if(pc[ii]==0.0)
 			{
 			*info = ii+1;
-			free(mem);
+			blasfeo_blas_workspace_free(mem);
 			return;
 			}
 		}
-	free(mem);
+	blasfeo_blas_workspace_free(mem);
 	return;
 
 
@@ -635,7 +636,7 @@ u_1:
 	sC_size = blasfeo_memsize_dmat(m1, m1);
 //	sC_size = blasfeo_memsize_dmat(m, m);
 	stot_size = sC_size;
-	mem = malloc(stot_size+64);
+	mem = blasfeo_blas_workspace_malloc(stot_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_create_dmat(m, m, &sC, (void *) mem_align);
 	sdc = sC.cn;
@@ -822,11 +823,11 @@ u_1_return:
 		if(pc[ii]==0.0)
 			{
 			*info = ii+1;
-			free(mem);
+			blasfeo_blas_workspace_free(mem);
 			return;
 			}
 		}
-	free(mem);
+	blasfeo_blas_workspace_free(mem);
 	return;
 
 	}
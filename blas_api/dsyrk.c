@@ -39,6 +39,7 @@
 
 #include "../include/blasfeo_target.h"
 #include "../include/blasfeo_common.h"
+#include "../include/blasfeo_stdlib.h"
 #include "../include/blasfeo_d_aux.h"
 #include "../include/blasfeo_d_kernel.h"
 #include "../include/blasfeo_d_blas.h"
@@ -719,7 +720,7 @@ lx_1:
 	k1 = (k+128-1)/128*128;
 	m1 = (m+128-1)/128*128;
 	sA_size = blasfeo_memsize_dmat(m1, k1);
-	mem = malloc(sA_size+64);
+	mem = blasfeo_blas_workspace_malloc(sA_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_create_dmat(m, k, &sA, (void *) mem_align);
 
@@ -839,7 +840,7 @@ lx_1_left_4:
 	goto lx_1_return;
 
 lx_1_return:
-	free(mem);
+	blasfeo_blas_workspace_free(mem);
 	return;
 
 
@@ -847,7 +848,7 @@ ux_1:
 	k1 = (k+128-1)/128*128;
 	m1 = (m+128-1)/128*128;
 	sA_size = blasfeo_memsize_dmat(m1, k1);
-	mem = malloc(sA_size+64);
+	mem = blasfeo_blas_workspace_malloc(sA_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_create_dmat(m, k, &sA, (void *) mem_align);
 
@@ -967,7 +968,7 @@ ux_1_left_4:
 	goto ux_1_return;
 
 ux_1_return:
-	free(mem);
+	blasfeo_blas_workspace_free(mem);
 	return;
 
 	}
@@ -38,6 +38,7 @@
 
 #include "../include/blasfeo_target.h"
 #include "../include/blasfeo_common.h"
+#include "../include/blasfeo_stdlib.h"
 #include "../include/blasfeo_d_aux.h"
 #include "../include/blasfeo_d_kernel.h"
 
@@ -412,7 +413,7 @@ llnn_1:
 	m1 = (m+128-1)/128*128;
 	sA_size = blasfeo_memsize_dmat(12, m1);
 	sB_size = blasfeo_memsize_dmat(m1, m1);
-	mem = malloc(sA_size+sB_size+64);
+	mem = blasfeo_blas_workspace_malloc(sA_size+sB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_create_dmat(12, m, &sA, (void *) mem_align);
 	blasfeo_create_dmat(m, m, &sB, (void *) (mem_align+sA_size));
@@ -564,7 +565,7 @@ llnn_1_left_4:
 goto llnn_1_return;
 
 llnn_1_return:
-	free(mem);
+	blasfeo_blas_workspace_free(mem);
 	return;
 
 
@@ -709,7 +710,7 @@ llnu_1:
 	m1 = (m+128-1)/128*128;
 	sA_size = blasfeo_memsize_dmat(12, m1);
 	sB_size = blasfeo_memsize_dmat(m1, m1);
-	mem = malloc(sA_size+sB_size+64);
+	mem = blasfeo_blas_workspace_malloc(sA_size+sB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_create_dmat(12, m, &sA, (void *) mem_align);
 	blasfeo_create_dmat(m, m, &sB, (void *) (mem_align+sA_size));
@@ -861,7 +862,7 @@ llnu_1_left_4:
 goto llnu_1_return;
 
 llnu_1_return:
-	free(mem);
+	blasfeo_blas_workspace_free(mem);
 	return;
 
 
@@ -1278,7 +1279,7 @@ lunn_1:
 	m1 = (m+128-1)/128*128;
 	sA_size = blasfeo_memsize_dmat(12, m1);
 	sB_size = blasfeo_memsize_dmat(m1, m1);
-	mem = malloc(sA_size+sB_size+64);
+	mem = blasfeo_blas_workspace_malloc(sA_size+sB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_create_dmat(12, m, &sA, (void *) mem_align);
 	blasfeo_create_dmat(m, m, &sB, (void *) (mem_align+sA_size));
@@ -1430,7 +1431,7 @@ lunn_1_left_4:
 goto lunn_1_return;
 
 lunn_1_return:
-	free(mem);
+	blasfeo_blas_workspace_free(mem);
 	return;
 
 
@@ -1575,7 +1576,7 @@ lunu_1:
 	m1 = (m+128-1)/128*128;
 	sA_size = blasfeo_memsize_dmat(12, m1);
 	sB_size = blasfeo_memsize_dmat(m1, m1);
-	mem = malloc(sA_size+sB_size+64);
+	mem = blasfeo_blas_workspace_malloc(sA_size+sB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_create_dmat(12, m, &sA, (void *) mem_align);
 	blasfeo_create_dmat(m, m, &sB, (void *) (mem_align+sA_size));
@@ -1727,7 +1728,7 @@ lunu_1_left_4:
 goto lunu_1_return;
 
 lunu_1_return:
-	free(mem);
+	blasfeo_blas_workspace_free(mem);
 	return;
 
 
@@ -2398,7 +2399,7 @@ rltn_1:
 	n1 = (n+128-1)/128*128;
 	sA_size = blasfeo_memsize_dmat(12, n1);
 	sB_size = blasfeo_memsize_dmat(n1, n1);
-	mem = malloc(sA_size+sB_size+64);
+	mem = blasfeo_blas_workspace_malloc(sA_size+sB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_create_dmat(12, n, &sA, (void *) mem_align);
 	blasfeo_create_dmat(n, n, &sB, (void *) (mem_align+sA_size));
@@ -2544,7 +2545,7 @@ rltn_1_left_4:
 goto rltn_1_return;
 
 rltn_1_return:
-	free(mem);
+	blasfeo_blas_workspace_free(mem);
 	return;
 
 
@@ -2683,7 +2684,7 @@ rltu_1:
 	n1 = (n+128-1)/128*128;
 	sA_size = blasfeo_memsize_dmat(12, n1);
 	sB_size = blasfeo_memsize_dmat(n1, n1);
-	mem = malloc(sA_size+sB_size+64);
+	mem = blasfeo_blas_workspace_malloc(sA_size+sB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_create_dmat(12, n, &sA, (void *) mem_align);
 	blasfeo_create_dmat(n, n, &sB, (void *) (mem_align+sA_size));
@@ -2829,7 +2830,7 @@ rltu_1_left_4:
 goto rltu_1_return;
 
 rltu_1_return:
-	free(mem);
+	blasfeo_blas_workspace_free(mem);
 	return;
 
 
@@ -3228,7 +3229,7 @@ rutn_1:
 	n1 = (n+128-1)/128*128;
 	sA_size = blasfeo_memsize_dmat(12, n1);
 	sB_size = blasfeo_memsize_dmat(n1, n1);
-	mem = malloc(sA_size+sB_size+64);
+	mem = blasfeo_blas_workspace_malloc(sA_size+sB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_create_dmat(12, n, &sA, (void *) mem_align);
 	blasfeo_create_dmat(n, n, &sB, (void *) (mem_align+sA_size));
@@ -3374,7 +3375,7 @@ rutn_1_left_4:
 goto rutn_1_return;
 
 rutn_1_return:
-	free(mem);
+	blasfeo_blas_workspace_free(mem);
 	return;
 
 
@@ -3513,7 +3514,7 @@ rutu_1:
 	n1 = (n+128-1)/128*128;
 	sA_size = blasfeo_memsize_dmat(12, n1);
 	sB_size = blasfeo_memsize_dmat(n1, n1);
-	mem = malloc(sA_size+sB_size+64);
+	mem = blasfeo_blas_workspace_malloc(sA_size+sB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_create_dmat(12, n, &sA, (void *) mem_align);
 	blasfeo_create_dmat(n, n, &sB, (void *) (mem_align+sA_size));
@@ -3659,7 +3660,7 @@ rutu_1_left_4:
 goto rutu_1_return;
 
 rutu_1_return:
-	free(mem);
+	blasfeo_blas_workspace_free(mem);
 	return;
 
 	}
@@ -38,8 +38,10 @@
 
 #include "../include/blasfeo_target.h"
 #include "../include/blasfeo_common.h"
+#include "../include/blasfeo_stdlib.h"
 #include "../include/blasfeo_d_aux.h"
 #include "../include/blasfeo_d_kernel.h"
+#include "../include/blasfeo_tuning.h"
 
 
 
@@ -169,6 +171,8 @@ void blasfeo_dtrsm(char *side, char *uplo, char *transa, char *diag, int *pm, in
 	int m1, n1;
 	int idx, m4, mn4, n4, nn4;
 	int pack_tran = 0;
+	struct blasfeo_tuning *tuning = blasfeo_tuning_table();
+	int pack_mn;
 
 
 
@@ -285,12 +289,14 @@ void blasfeo_dtrsm(char *side, char *uplo, char *transa, char *diag, int *pm, in
 ************************************************/
 llnn:
 #if defined(TARGET_X64_INTEL_HASWELL)
-	if(m>=200 | n>=200 | m>K_MAX_STACK)
+	pack_mn = 200;
 #elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
-	if(m>=64 | n>=64 | m>K_MAX_STACK)
+	pack_mn = 64;
 #else
-	if(m>=12 | n>=12 | m>K_MAX_STACK)
+	pack_mn = 12;
 #endif
+	pack_mn = tuning->dtrsm_lln_pack_mn>=0 ? tuning->dtrsm_lln_pack_mn : pack_mn;
+	if(m>=pack_mn | n>=pack_mn | m>K_MAX_STACK)
 		{
 		pack_tran = 0;
 		goto llnn_1;
@@ -437,7 +443,7 @@ llnn_1:
 	m1 = (m+128-1)/128*128;
 	sA_size = blasfeo_memsize_dmat(12, m1);
 	sB_size = blasfeo_memsize_dmat(m1, m1);
-	mem = malloc(sA_size+sB_size+64);
+	mem = blasfeo_blas_workspace_malloc(sA_size+sB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_create_dmat(12, m, &sA, (void *) mem_align);
 	blasfeo_create_dmat(m, m, &sB, (void *) (mem_align+sA_size));
@@ -595,7 +601,7 @@ llnn_1_left_4:
 goto llnn_1_return;
 
 llnn_1_return:
-	free(mem);
+	blasfeo_blas_workspace_free(mem);
 	return;
 
 
@@ -605,12 +611,14 @@ llnn_1_return:
 ************************************************/
 llnu:
 #if defined(TARGET_X64_INTEL_HASWELL)
-	if(m>=200 | n>=200 | m>K_MAX_STACK)
+	pack_mn = 200;
 #elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
-	if(m>=64 | n>=64 | m>K_MAX_STACK)
+	pack_mn = 64;
 #else
-	if(m>=12 | n>=12 | m>K_MAX_STACK)
+	pack_mn = 12;
 #endif
+	pack_mn = tuning->dtrsm_lln_pack_mn>=0 ? tuning->dtrsm_lln_pack_mn : pack_mn;
+	if(m>=pack_mn | n>=pack_mn | m>K_MAX_STACK)
 		{
 		pack_tran = 0;
 		goto llnu_1;
@@ -753,7 +761,7 @@ llnu_1:
 	m1 = (m+128-1)/128*128;
 	sA_size = blasfeo_memsize_dmat(12, m1);
 	sB_size = blasfeo_memsize_dmat(m1, m1);
-	mem = malloc(sA_size+sB_size+64);
+	mem = blasfeo_blas_workspace_malloc(sA_size+sB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_create_dmat(12, m, &sA, (void *) mem_align);
 	blasfeo_create_dmat(m, m, &sB, (void *) (mem_align+sA_size));
@@ -906,7 +914,7 @@ llnu_1_left_4:
 goto llnu_1_return;
 
 llnu_1_return:
-	free(mem);
+	blasfeo_blas_workspace_free(mem);
 	return;
 
 
@@ -916,12 +924,14 @@ llnu_1_return:
 ***********************/
 lltn:
 #if defined(TARGET_X64_INTEL_HASWELL)
-	if(m>=300 | n>=300 | m>K_MAX_STACK)
+	pack_mn = 300;
 #elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
-	if(m>=64 | n>=64 | m>K_MAX_STACK)
+	pack_mn = 64;
 #else
-	if(m>=12 | n>=12 | m>K_MAX_STACK)
+	pack_mn = 12;
 #endif
+	pack_mn = tuning->dtrsm_llt_pack_mn>=0 ? tuning->dtrsm_llt_pack_mn : pack_mn;
+	if(m>=pack_mn | n>=pack_mn | m>K_MAX_STACK)
 		{
 		pack_tran = 1;
 		goto lunn_1;
@@ -1097,12 +1107,14 @@ lltn_0_return:
 ***********************/
 lltu:
 #if defined(TARGET_X64_INTEL_HASWELL)
-	if(m>=300 | n>=300 | m>K_MAX_STACK)
+	pack_mn = 300;
 #elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
-	if(m>=64 | n>=64 | m>K_MAX_STACK)
+	pack_mn = 64;
 #else
-	if(m>=12 | n>=12 | m>K_MAX_STACK)
+	pack_mn = 12;
 #endif
+	pack_mn = tuning->dtrsm_llt_pack_mn>=0 ? tuning->dtrsm_llt_pack_mn : pack_mn;
+	if(m>=pack_mn | n>=pack_mn | m>K_MAX_STACK)
 		{
 		pack_tran = 1;
 		goto lunu_1;
@@ -1274,12 +1286,14 @@ lltu_0_return:
 ************************************************/
 lunu:
 #if defined(TARGET_X64_INTEL_HASWELL)
-	if(m>=200 | n>=200 | m>K_MAX_STACK)
+	pack_mn = 200;
 #elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
-	if(m>=64 | n>=64 | m>K_MAX_STACK)
+	pack_mn = 64;
 #else
-	if(m>=12 | n>=12 | m>K_MAX_STACK)
+	pack_mn = 12;
 #endif
+	pack_mn = tuning->dtrsm_lun_pack_mn>=0 ? tuning->dtrsm_lun_pack_mn : pack_mn;
+	if(m>=pack_mn | n>=pack_mn | m>K_MAX_STACK)
 		{
 		pack_tran = 0;
 		goto lunu_1;
@@ -1450,7 +1464,7 @@ lunu_1:
 	m1 = (m+128-1)/128*128;
 	sA_size = blasfeo_memsize_dmat(12, m1);
 	sB_size = blasfeo_memsize_dmat(m1, m1);
-	mem = malloc(sA_size+sB_size+64);
+	mem = blasfeo_blas_workspace_malloc(sA_size+sB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_create_dmat(12, m, &sA, (void *) mem_align);
 	blasfeo_create_dmat(m, m, &sB, (void *) (mem_align+sA_size));
@@ -1630,7 +1644,7 @@ lunu_1_left_4:
 	goto lunu_1_return;
 
 lunu_1_return:
-	free(mem);
+	blasfeo_blas_workspace_free(mem);
 	return;
 
 
@@ -1640,12 +1654,14 @@ lunu_1_return:
 ************************************************/
 lunn:
 #if defined(TARGET_X64_INTEL_HASWELL)
-	if(m>=200 | n>=200 | m>K_MAX_STACK)
+	pack_mn = 200;
 #elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
-	if(m>=64 | n>=64 | m>K_MAX_STACK)
+	pack_mn = 64;
 #else
-	if(m>=12 | n>=12 | m>K_MAX_STACK)
+	pack_mn = 12;
 #endif
+	pack_mn = tuning->dtrsm_lun_pack_mn>=0 ? tuning->dtrsm_lun_pack_mn : pack_mn;
+	if(m>=pack_mn | n>=pack_mn | m>K_MAX_STACK)
 		{
 		pack_tran = 0;
 		goto lunn_1;
@@ -1820,7 +1836,7 @@ lunn_1:
 	m1 = (m+128-1)/128*128;
 	sA_size = blasfeo_memsize_dmat(12, m1);
 	sB_size = blasfeo_memsize_dmat(m1, m1);
-	mem = malloc(sA_size+sB_size+64);
+	mem = blasfeo_blas_workspace_malloc(sA_size+sB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_create_dmat(12, m, &sA, (void *) mem_align);
 	blasfeo_create_dmat(m, m, &sB, (void *) (mem_align+sA_size));
@@ -2004,7 +2020,7 @@ lunn_1_left_4:
 	goto lunn_1_return;
 
 lunn_1_return:
-	free(mem);
+	blasfeo_blas_workspace_free(mem);
 	return;
 
 
@@ -2014,12 +2030,14 @@ lunn_1_return:
 ************************************************/
 lutn:
 #if defined(TARGET_X64_INTEL_HASWELL)
-	if(m>=300 | n>=300 | m>K_MAX_STACK)
+	pack_mn = 300;
 #elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
-	if(m>=64 | n>=64 | m>K_MAX_STACK)
+	pack_mn = 64;
 #else
-	if(m>=12 | n>=12 | m>K_MAX_STACK)
+	pack_mn = 12;
 #endif
+	pack_mn = tuning->dtrsm_lut_pack_mn>=0 ? tuning->dtrsm_lut_pack_mn : pack_mn;
+	if(m>=pack_mn | n>=pack_mn | m>K_MAX_STACK)
 		{
 		pack_tran = 1;
 		goto llnn_1;
@@ -2167,12 +2185,14 @@ lutn_0_return:
 ************************************************/
 lutu:
 #if defined(TARGET_X64_INTEL_HASWELL)
-	if(m>=300 | n>=300 | m>K_MAX_STACK)
+	pack_mn = 300;
 #elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
-	if(m>=64 | n>=64 | m>K_MAX_STACK)
+	pack_mn = 64;
 #else
-	if(m>=12 | n>=12 | m>K_MAX_STACK)
+	pack_mn = 12;
 #endif
+	pack_mn = tuning->dtrsm_lut_pack_mn>=0 ? tuning->dtrsm_lut_pack_mn : pack_mn;
+	if(m>=pack_mn | n>=pack_mn | m>K_MAX_STACK)
 		{
 		pack_tran = 1;
 		goto llnu_1;
@@ -2317,12 +2337,14 @@ lutu_0_return:
 ************************************************/
 rlnn:
 #if defined(TARGET_X64_INTEL_HASWELL)
-	if(m>300 | n>300 | n>K_MAX_STACK)
+	pack_mn = 301;
 #elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
-	if(m>=64 | n>=64 | n>K_MAX_STACK)
+	pack_mn = 64;
 #else
-	if(m>=12 | n>=12 | n>K_MAX_STACK)
+	pack_mn = 12;
 #endif
+	pack_mn = tuning->dtrsm_rln_pack_mn>=0 ? tuning->dtrsm_rln_pack_mn : pack_mn;
+	if(m>=pack_mn | n>=pack_mn | n>K_MAX_STACK)
 		{
 		pack_tran = 1;
 		goto rutn_1;
@@ -2484,12 +2506,14 @@ rlnn_0_return:
 ************************************************/
 rlnu:
 #if defined(TARGET_X64_INTEL_HASWELL)
-	if(m>300 | n>300 | n>K_MAX_STACK)
+	pack_mn = 301;
 #elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
-	if(m>=64 | n>=64 | n>K_MAX_STACK)
+	pack_mn = 64;
 #else
-	if(m>=12 | n>=12 | n>K_MAX_STACK)
+	pack_mn = 12;
 #endif
+	pack_mn = tuning->dtrsm_rln_pack_mn>=0 ? tuning->dtrsm_rln_pack_mn : pack_mn;
+	if(m>=pack_mn | n>=pack_mn | n>K_MAX_STACK)
 		{
 		pack_tran = 1;
 		goto rutu_1;
@@ -2647,12 +2671,14 @@ rlnu_0_return:
 ************************************************/
 rltn:
 #if defined(TARGET_X64_INTEL_HASWELL)
-	if(m>=200 | n>=200 | n>K_MAX_STACK)
+	pack_mn = 200;
 #elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
-	if(m>=64 | n>=64 | n>K_MAX_STACK)
+	pack_mn = 64;
 #else
-	if(m>=12 | n>=12 | n>K_MAX_STACK)
+	pack_mn = 12;
 #endif
+	pack_mn = tuning->dtrsm_rlt_pack_mn>=0 ? tuning->dtrsm_rlt_pack_mn : pack_mn;
+	if(m>=pack_mn | n>=pack_mn | n>K_MAX_STACK)
 		{
 		pack_tran = 0;
 		goto rltn_1;
@@ -2783,7 +2809,7 @@ rltn_1:
 	n1 = (n+128-1)/128*128;
 	sA_size = blasfeo_memsize_dmat(12, n1);
 	sB_size = blasfeo_memsize_dmat(n1, n1);
-	mem = malloc(sA_size+sB_size+64);
+	mem = blasfeo_blas_workspace_malloc(sA_size+sB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_create_dmat(12, n, &sA, (void *) mem_align);
 	blasfeo_create_dmat(n, n, &sB, (void *) (mem_align+sA_size));
@@ -2938,7 +2964,7 @@ rltn_1_left_4:
 goto rltn_1_return;
 
 rltn_1_return:
-	free(mem);
+	blasfeo_blas_workspace_free(mem);
 	return;
 
 
@@ -2948,12 +2974,14 @@ rltn_1_return:
 ************************************************/
 rltu:
 #if defined(TARGET_X64_INTEL_HASWELL)
-	if(m>=200 | n>=200 | n>K_MAX_STACK)
+	pack_mn = 200;
 #elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
-	if(m>=64 | n>=64 | n>K_MAX_STACK)
+	pack_mn = 64;
 #else
-	if(m>=12 | n>=12 | n>K_MAX_STACK)
+	pack_mn = 12;
 #endif
+	pack_mn = tuning->dtrsm_rlt_pack_mn>=0 ? tuning->dtrsm_rlt_pack_mn : pack_mn;
+	if(m>=pack_mn | n>=pack_mn | n>K_MAX_STACK)
 		{
 		pack_tran = 0;
 		goto rltu_1;
@@ -3080,7 +3108,7 @@ rltu_1:
 	n1 = (n+128-1)/128*128;
 	sA_size = blasfeo_memsize_dmat(12, n1);
 	sB_size = blasfeo_memsize_dmat(n1, n1);
-	mem = malloc(sA_size+sB_size+64);
+	mem = blasfeo_blas_workspace_malloc(sA_size+sB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_create_dmat(12, n, &sA, (void *) mem_align);
 	blasfeo_create_dmat(n, n, &sB, (void *) (mem_align+sA_size));
@@ -3231,7 +3259,7 @@ rltu_1_left_4:
 goto rltu_1_return;
 
 rltu_1_return:
-	free(mem);
+	blasfeo_blas_workspace_free(mem);
 	return;
 
 
@@ -3241,12 +3269,14 @@ rltu_1_return:
 ************************************************/
 runn:
 #if defined(TARGET_X64_INTEL_HASWELL)
-	if(m>=300 | n>=300 | n>K_MAX_STACK)
+	pack_mn = 300;
 #elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
-	if(m>=64 | n>=64 | n>K_MAX_STACK)
+	pack_mn = 64;
 #else
-	if(m>=12 | n>=12 | n>K_MAX_STACK)
+	pack_mn = 12;
 #endif
+	pack_mn = tuning->dtrsm_run_pack_mn>=0 ? tuning->dtrsm_run_pack_mn : pack_mn;
+	if(m>=pack_mn | n>=pack_mn | n>K_MAX_STACK)
 		{
 		pack_tran = 1;
 		goto rltn_1;
@@ -3383,12 +3413,14 @@ runn_0_return:
 ************************************************/
 runu:
 #if defined(TARGET_X64_INTEL_HASWELL)
-	if(m>=300 | n>=300 | n>K_MAX_STACK)
+	pack_mn = 300;
 #elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
-	if(m>=64 | n>=64 | n>K_MAX_STACK)
+	pack_mn = 64;
 #else
-	if(m>=12 | n>=12 | n>K_MAX_STACK)
+	pack_mn = 12;
 #endif
+	pack_mn = tuning->dtrsm_run_pack_mn>=0 ? tuning->dtrsm_run_pack_mn : pack_mn;
+	if(m>=pack_mn | n>=pack_mn | n>K_MAX_STACK)
 		{
 		pack_tran = 1;
 		goto rltu_1;
@@ -3521,12 +3553,14 @@ runu_0_return:
 ************************************************/
 rutn:
 #if defined(TARGET_X64_INTEL_HASWELL)
-	if(m>=200 | n>=200 | n>K_MAX_STACK)
+	pack_mn = 200;
 #elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
-	if(m>=64 | n>=64 | n>K_MAX_STACK)
+	pack_mn = 64;
 #else
-	if(m>=12 | n>=12 | n>K_MAX_STACK)
+	pack_mn = 12;
 #endif
+	pack_mn = tuning->dtrsm_rut_pack_mn>=0 ? tuning->dtrsm_rut_pack_mn : pack_mn;
+	if(m>=pack_mn | n>=pack_mn | n>K_MAX_STACK)
 		{
 		pack_tran = 0;
 		goto rutn_1;
@@ -3689,7 +3723,7 @@ rutn_1:
 	n1 = (n+128-1)/128*128;
 	sA_size = blasfeo_memsize_dmat(12, n1);
 	sB_size = blasfeo_memsize_dmat(n1, n1);
-	mem = malloc(sA_size+sB_size+64);
+	mem = blasfeo_blas_workspace_malloc(sA_size+sB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_create_dmat(12, n, &sA, (void *) mem_align);
 	blasfeo_create_dmat(n, n, &sB, (void *) (mem_align+sA_size));
@@ -3861,7 +3895,7 @@ rutn_1_left_4:
 	goto rutn_1_return;
 
 rutn_1_return:
-	free(mem);
+	blasfeo_blas_workspace_free(mem);
 	return;
 
 
@@ -3871,12 +3905,14 @@ rutn_1_return:
 ************************************************/
 rutu:
 #if defined(TARGET_X64_INTEL_HASWELL)
-	if(m>=200 | n>=200 | n>K_MAX_STACK)
+	pack_mn = 200;
 #elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
-	if(m>=64 | n>=64 | n>K_MAX_STACK)
+	pack_mn = 64;
 #else
-	if(m>=12 | n>=12 | n>K_MAX_STACK)
+	pack_mn = 12;
 #endif
+	pack_mn = tuning->dtrsm_rut_pack_mn>=0 ? tuning->dtrsm_rut_pack_mn : pack_mn;
+	if(m>=pack_mn | n>=pack_mn | n>K_MAX_STACK)
 		{
 		pack_tran = 0;
 		goto rutu_1;
@@ -4035,7 +4071,7 @@ rutu_1:
 	n1 = (n+128-1)/128*128;
 	sA_size = blasfeo_memsize_dmat(12, n1);
 	sB_size = blasfeo_memsize_dmat(n1, n1);
-	mem = malloc(sA_size+sB_size+64);
+	mem = blasfeo_blas_workspace_malloc(sA_size+sB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_create_dmat(12, n, &sA, (void *) mem_align);
 	blasfeo_create_dmat(n, n, &sB, (void *) (mem_align+sA_size));
@@ -4203,7 +4239,7 @@ rutu_1_left_4:
 	goto rutu_1_return;
 
 rutu_1_return:
-	free(mem);
+	blasfeo_blas_workspace_free(mem);
 	return;
 
 
@@ -38,6 +38,7 @@
 
 #include "../include/blasfeo_target.h"
 #include "../include/blasfeo_common.h"
+#include "../include/blasfeo_stdlib.h"
 #include "../include/blasfeo_s_aux.h"
 #include "../include/blasfeo_s_kernel.h"
 
@@ -584,7 +585,7 @@ nn_1:
 	n1 = (n+128-1)/128*128;
 	sA_size = blasfeo_memsize_smat(m_kernel, k1);
 	sB_size = blasfeo_memsize_smat(n1, k1);
-	mem = malloc(sA_size+sB_size+64);
+	mem = blasfeo_blas_workspace_malloc(sA_size+sB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_create_smat(m_kernel, k, &sA, (void *) mem_align);
 	blasfeo_create_smat(n, k, &sB, (void *) (mem_align+sA_size));
@@ -866,7 +867,7 @@ nn_1_left_4:
 	goto nn_1_return;
 
 nn_1_return:
-	free(mem);
+	blasfeo_blas_workspace_free(mem);
 	return;
 
 
@@ -1229,7 +1230,7 @@ nt_1:
 	n1 = (n+128-1)/128*128;
 	sA_size = blasfeo_memsize_smat(m_kernel, k1);
 	sB_size = blasfeo_memsize_smat(n1, k1);
-	mem = malloc(sA_size+sB_size+64);
+	mem = blasfeo_blas_workspace_malloc(sA_size+sB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_create_smat(m_kernel, k, &sA, (void *) mem_align);
 	blasfeo_create_smat(n, k, &sB, (void *) (mem_align+sA_size));
@@ -1477,7 +1478,7 @@ nt_1_left_4:
 	goto nt_1_return;
 
 nt_1_return:
-	free(mem);
+	blasfeo_blas_workspace_free(mem);
 	return;
 
 
@@ -1852,7 +1853,7 @@ tn_1:
 	n1 = (n+128-1)/128*128;
 	sA_size = blasfeo_memsize_smat(m_kernel, k1);
 	sB_size = blasfeo_memsize_smat(n1, k1);
-	mem = malloc(sA_size+sB_size+64);
+	mem = blasfeo_blas_workspace_malloc(sA_size+sB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_create_smat(m_kernel, k, &sA, (void *) mem_align);
 	blasfeo_create_smat(n, k, &sB, (void *) (mem_align+sA_size));
@@ -2135,7 +2136,7 @@ tn_1_left_4:
 	goto tn_1_return;
 
 tn_1_return:
-free(mem);
+blasfeo_blas_workspace_free(mem);
 	return;
 
 
@@ -2409,7 +2410,7 @@ tt_1:
 	n1 = (n+128-1)/128*128;
 	sA_size = blasfeo_memsize_smat(m_kernel, k1);
 	sB_size = blasfeo_memsize_smat(n1, k1);
-	mem = malloc(sA_size+sB_size+64);
+	mem = blasfeo_blas_workspace_malloc(sA_size+sB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_create_smat(m_kernel, k, &sA, (void *) mem_align);
 	blasfeo_create_smat(n, k, &sB, (void *) (mem_align+sA_size));
@@ -2667,7 +2668,7 @@ tt_1_left_4:
 	goto tt_1_return;
 
 tt_1_return:
-	free(mem);
+	blasfeo_blas_workspace_free(mem);
 	return;
 
 
@@ -38,6 +38,7 @@
 
 #include "../include/blasfeo_target.h"
 #include "../include/blasfeo_common.h"
+#include "../include/blasfeo_stdlib.h"
 #include "../include/blasfeo_s_aux.h"
 #include "../include/blasfeo_s_kernel.h"
 
@@ -343,7 +344,7 @@ llnn_1:
 //	sB_size = blasfeo_memsize_smat(m1, m1);
 	sA_size = blasfeo_memsize_smat_ps(ps_4, m_kernel, m1);
 	sB_size = blasfeo_memsize_smat_ps(ps_4, m1, m1);
-	mem = malloc(sA_size+sB_size+64);
+	mem = blasfeo_blas_workspace_malloc(sA_size+sB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 //	blasfeo_create_smat(12, m, &sA, (void *) mem_align);
 //	blasfeo_create_smat(m, m, &sB, (void *) (mem_align+sA_size));
@@ -413,7 +414,7 @@ llnn_1_left_4:
 goto llnn_1_return;
 
 llnn_1_return:
-	free(mem);
+	blasfeo_blas_workspace_free(mem);
 	return;
 
 
@@ -477,7 +478,7 @@ llnu_1:
 //	sB_size = blasfeo_memsize_smat(m1, m1);
 	sA_size = blasfeo_memsize_smat_ps(ps_4, m_kernel, m1);
 	sB_size = blasfeo_memsize_smat_ps(ps_4, m1, m1);
-	mem = malloc(sA_size+sB_size+64);
+	mem = blasfeo_blas_workspace_malloc(sA_size+sB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 //	blasfeo_create_smat(12, m, &sA, (void *) mem_align);
 //	blasfeo_create_smat(m, m, &sB, (void *) (mem_align+sA_size));
@@ -542,7 +543,7 @@ llnu_1_left_4:
 goto llnu_1_return;
 
 llnu_1_return:
-	free(mem);
+	blasfeo_blas_workspace_free(mem);
 	return;
 
 
@@ -755,7 +756,7 @@ lunu_1:
 //	sB_size = blasfeo_memsize_smat(m1, m1);
 	sA_size = blasfeo_memsize_smat_ps(ps_4, m_kernel, m1);
 	sB_size = blasfeo_memsize_smat_ps(ps_4, m1, m1);
-	mem = malloc(sA_size+sB_size+64);
+	mem = blasfeo_blas_workspace_malloc(sA_size+sB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 //	blasfeo_create_smat(12, m, &sA, (void *) mem_align);
 //	blasfeo_create_smat(m, m, &sB, (void *) (mem_align+sA_size));
@@ -832,7 +833,7 @@ lunu_1_left_4:
 	goto lunu_1_return;
 
 lunu_1_return:
-	free(mem);
+	blasfeo_blas_workspace_free(mem);
 	return;
 
 
@@ -913,7 +914,7 @@ lunn_1:
 //	sB_size = blasfeo_memsize_smat(m1, m1);
 	sA_size = blasfeo_memsize_smat_ps(ps_4, m_kernel, m1);
 	sB_size = blasfeo_memsize_smat_ps(ps_4, m1, m1);
-	mem = malloc(sA_size+sB_size+64);
+	mem = blasfeo_blas_workspace_malloc(sA_size+sB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 //	blasfeo_create_smat(12, m, &sA, (void *) mem_align);
 //	blasfeo_create_smat(m, m, &sB, (void *) (mem_align+sA_size));
@@ -994,7 +995,7 @@ lunn_1_left_4:
 	goto lunn_1_return;
 
 lunn_1_return:
-	free(mem);
+	blasfeo_blas_workspace_free(mem);
 	return;
 
 
@@ -1302,7 +1303,7 @@ rltn_1:
 //	sB_size = blasfeo_memsize_smat(n1, n1);
 	sA_size = blasfeo_memsize_smat_ps(ps_4, m_kernel, n1);
 	sB_size = blasfeo_memsize_smat_ps(ps_4, n1, n1);
-	mem = malloc(sA_size+sB_size+64);
+	mem = blasfeo_blas_workspace_malloc(sA_size+sB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 //	blasfeo_create_smat(12, n, &sA, (void *) mem_align);
 //	blasfeo_create_smat(n, n, &sB, (void *) (mem_align+sA_size));
@@ -1370,7 +1371,7 @@ rltn_1_left_4:
 goto rltn_1_return;
 
 rltn_1_return:
-	free(mem);
+	blasfeo_blas_workspace_free(mem);
 	return;
 
 
@@ -1432,7 +1433,7 @@ rltu_1:
 //	sB_size = blasfeo_memsize_smat(n1, n1);
 	sA_size = blasfeo_memsize_smat_ps(ps_4, m_kernel, n1);
 	sB_size = blasfeo_memsize_smat_ps(ps_4, n1, n1);
-	mem = malloc(sA_size+sB_size+64);
+	mem = blasfeo_blas_workspace_malloc(sA_size+sB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 //	blasfeo_create_smat(12, n, &sA, (void *) mem_align);
 //	blasfeo_create_smat(n, n, &sB, (void *) (mem_align+sA_size));
@@ -1496,7 +1497,7 @@ rltu_1_left_4:
 goto rltu_1_return;
 
 rltu_1_return:
-	free(mem);
+	blasfeo_blas_workspace_free(mem);
 	return;
 
 
@@ -1693,7 +1694,7 @@ rutn_1:
 //	sB_size = blasfeo_memsize_smat(n1, n1);
 	sA_size = blasfeo_memsize_smat_ps(ps_4, m_kernel, n1);
 	sB_size = blasfeo_memsize_smat_ps(ps_4, n1, n1);
-	mem = malloc(sA_size+sB_size+64);
+	mem = blasfeo_blas_workspace_malloc(sA_size+sB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 //	blasfeo_create_smat(12, n, &sA, (void *) mem_align);
 //	blasfeo_create_smat(n, n, &sB, (void *) (mem_align+sA_size));
@@ -1774,7 +1775,7 @@ rutn_1_left_4:
 	goto rutn_1_return;
 
 rutn_1_return:
-	free(mem);
+	blasfeo_blas_workspace_free(mem);
 	return;
 
 
@@ -1851,7 +1852,7 @@ rutu_1:
 //	sB_size = blasfeo_memsize_smat(n1, n1);
 	sA_size = blasfeo_memsize_smat_ps(ps_4, m_kernel, n1);
 	sB_size = blasfeo_memsize_smat_ps(ps_4, n1, n1);
-	mem = malloc(sA_size+sB_size+64);
+	mem = blasfeo_blas_workspace_malloc(sA_size+sB_size+64);
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 //	blasfeo_create_smat(12, n, &sA, (void *) mem_align);
 //	blasfeo_create_smat(n, n, &sB, (void *) (mem_align+sA_size));
@@ -1928,7 +1929,7 @@ rutu_1_left_4:
 	goto rutu_1_return;
 
 rutu_1_return:
-	free(mem);
+	blasfeo_blas_workspace_free(mem);
 	return;
 
 
@@ -40,6 +40,9 @@
 #include "../include/blasfeo_d_kernel.h"
 #include "../include/blasfeo_d_aux.h"
 #include "../include/blasfeo_d_blasfeo_api.h"
+#include "../include/blasfeo_processor_features.h"
+#include "../include/blasfeo_thread.h"
+#include "../include/blasfeo_jit.h"
 
 
 
@@ -311,12 +314,177 @@ void dlauum_blk_nt_l_lib(int m, int n, int nv, int *rv, int *cv, double *pA, int
 
 
 
+#if defined(TARGET_X64_INTEL_HASWELL) | defined(TARGET_ARMV8A_ARM_CORTEX_A53)
+#define D_GEMM_M_KERNEL 12
+#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE) | defined(TARGET_ARMV8A_ARM_CORTEX_A57)
+#define D_GEMM_M_KERNEL 8
+#else
+#define D_GEMM_M_KERNEL 4
+#endif
+
+
+
+#if defined(MULTI_THREAD)
+
+// minimum size of the work per thread (as m*n*k) in multi-threaded dgemm, smaller calls stay single-threaded
+#define D_GEMM_MT_MIN_WORK (64*64*64)
+
+struct d_gemm_mt_arg
+	{
+	void (*gemm)(int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
+	int ta;
+	int tb;
+	int m;
+	int n;
+	int k;
+	double alpha;
+	struct blasfeo_dmat *sA;
+	int ai;
+	int aj;
+	struct blasfeo_dmat *sB;
+	int bi;
+	int bj;
+	double beta;
+	struct blasfeo_dmat *sC;
+	int ci;
+	int cj;
+	struct blasfeo_dmat *sD;
+	int di;
+	int dj;
+	int mb; // rows per block
+	int nb; // cols per block
+	int n_row_block;
+	};
+
+
+
+// compute one (mb)x(nb) block of D
+static void d_gemm_mt_task(void *ptr, int task_id)
+	{
+	struct d_gemm_mt_arg *arg = (struct d_gemm_mt_arg *) ptr;
+	int i0 = (task_id%arg->n_row_block)*arg->mb;
+	int j0 = (task_id/arg->n_row_block)*arg->nb;
+	int m0 = arg->m-i0<arg->mb ? arg->m-i0 : arg->mb;
+	int n0 = arg->n-j0<arg->nb ? arg->n-j0 : arg->nb;
+	// rows of D are rows of A (columns if transposed), cols of D are cols of B (rows if transposed)
+	int ai = arg->ta ? arg->ai : arg->ai+i0;
+	int aj = arg->ta ? arg->aj+i0 : arg->aj;
+	int bi = arg->tb ? arg->bi+j0 : arg->bi;
+	int bj = arg->tb ? arg->bj : arg->bj+j0;
+	arg->gemm(m0, n0, arg->k, arg->alpha, arg->sA, ai, aj, arg->sB, bi, bj, arg->beta, arg->sC, arg->ci+i0, arg->cj+j0, arg->sD, arg->di+i0, arg->dj+j0);
+	return;
+	}
+
+
+
+// split D in a 2D grid of blocks and compute them on the thread pool;
+// return 0 (and do nothing) if the call is too small or no thread is available
+static int d_gemm_mt(int ta, int tb, int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+
+	int nt = blasfeo_thread_pool_num_threads();
+	if(nt<=1)
+		return 0;
+
+	double work = (double) m * n * (k>1 ? k : 1);
+	if(work<2.0*D_GEMM_MT_MIN_WORK)
+		return 0;
+	if(work<(double) nt*D_GEMM_MT_MIN_WORK)
+		nt = work/D_GEMM_MT_MIN_WORK;
+
+	const int ps = 4;
+	const int mu = D_GEMM_M_KERNEL;
+
+	// number of kernel-sized row and col blocks
+	int m_unit = (m+mu-1)/mu;
+	int n_unit = (n+ps-1)/ps;
+	if(m_unit*n_unit<2)
+		return 0;
+
+	// choose the grid closest to square blocks
+	int pr, pc, pr_best, pc_best;
+	double cost, cost_best;
+	pr_best = 1;
+	pc_best = nt;
+	cost_best = -1.0;
+	for(pr=1; pr<=nt; pr++)
+		{
+		pc = nt/pr;
+		if(pr>m_unit | pc>n_unit)
+			continue;
+		cost = (double) m/pr - (double) n/pc;
+		cost = cost>0 ? cost : -cost;
+		// penalize idle threads
+		cost += (double) (nt-pr*pc)*(m+n)/nt;
+		if(cost_best<0 | cost<cost_best)
+			{
+			pr_best = pr;
+			pc_best = pc;
+			cost_best = cost;
+			}
+		}
+	if(cost_best<0)
+		{
+		pr_best = m_unit<nt ? m_unit : nt;
+		pc_best = n_unit<nt/pr_best ? n_unit : nt/pr_best;
+		}
+
+	struct d_gemm_mt_arg arg;
+	if(ta==0)
+		arg.gemm = tb==0 ? &blasfeo_dgemm_nn : &blasfeo_dgemm_nt;
+	else
+		arg.gemm = tb==0 ? &blasfeo_dgemm_tn : &blasfeo_dgemm_tt;
+	arg.ta = ta;
+	arg.tb = tb;
+	arg.m = m;
+	arg.n = n;
+	arg.k = k;
+	arg.alpha = alpha;
+	arg.sA = sA;
+	arg.ai = ai;
+	arg.aj = aj;
+	arg.sB = sB;
+	arg.bi = bi;
+	arg.bj = bj;
+	arg.beta = beta;
+	arg.sC = sC;
+	arg.ci = ci;
+	arg.cj = cj;
+	arg.sD = sD;
+	arg.di = di;
+	arg.dj = dj;
+	// block sizes multiple of the kernel size, to keep the panel alignment of the original call
+	arg.mb = (m_unit+pr_best-1)/pr_best*mu;
+	arg.nb = (n_unit+pc_best-1)/pc_best*ps;
+	arg.n_row_block = (m+arg.mb-1)/arg.mb;
+	int n_col_block = (n+arg.nb-1)/arg.nb;
+
+	blasfeo_thread_pool_run(arg.n_row_block*n_col_block, &d_gemm_mt_task, (void *) &arg);
+
+	return 1;
+
+	}
+
+#endif // MULTI_THREAD
+
+
+
 // dgemm nn
 void blasfeo_dgemm_nn(int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
 	{
 	if(m<=0 || n<=0)
 		return;
 
+#if defined(JIT) & defined(TARGET_X64_INTEL_HASWELL)
+	if(blasfeo_jit_dgemm(BLASFEO_JIT_DGEMM_NN, m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj))
+		return;
+#endif
+
+#if defined(MULTI_THREAD)
+	if(d_gemm_mt(0, 0, m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj))
+		return;
+#endif
+
 	// invalidate stored inverse diagonal of result matrix
 	sD->use_dA = 0;
 
@@ -729,6 +897,16 @@ void blasfeo_dgemm_nt(int m, int n, int k, double alpha, struct blasfeo_dmat *sA
 	if(m<=0 | n<=0)
 		return;
 
+#if defined(JIT) & defined(TARGET_X64_INTEL_HASWELL)
+	if(blasfeo_jit_dgemm(BLASFEO_JIT_DGEMM_NT, m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj))
+		return;
+#endif
+
+#if defined(MULTI_THREAD)
+	if(d_gemm_mt(0, 1, m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj))
+		return;
+#endif
+
 	// invalidate stored inverse diagonal of result matrix
 	sD->use_dA = 0;
 
@@ -1384,6 +1562,11 @@ void blasfeo_dgemm_tn(int m, int n, int k, double alpha, struct blasfeo_dmat *sA
 	if(m<=0 || n<=0)
 		return;
 
+#if defined(MULTI_THREAD)
+	if(d_gemm_mt(1, 0, m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj))
+		return;
+#endif
+
 	// invalidate stored inverse diagonal of result matrix
 	sD->use_dA = 0;
 
@@ -1862,6 +2045,11 @@ void blasfeo_dgemm_tt(int m, int n, int k, double alpha, struct blasfeo_dmat *sA
 	if(m<=0 || n<=0)
 		return;
 
+#if defined(MULTI_THREAD)
+	if(d_gemm_mt(1, 1, m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj))
+		return;
+#endif
+
 	// invalidate stored inverse diagonal of result matrix
 	sD->use_dA = 0;
 
@@ -2221,7 +2409,7 @@ loop_CD:
 	i = 0;
 	for(; i<m-8; i+=12)
 		{
-		kernel_dgemm_tt_12x4_vs_lib4(k, &alpha, offsetA, &pA[i*ps], sda, &pB[j*sda], &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, m-i, n-j);
+		kernel_dgemm_tt_12x4_vs_lib4(k, &alpha, offsetA, &pA[i*ps], sda, &pB[j*sdb], &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, m-i, n-j);
 		}
 	if(i<m-4)
 		{
@@ -2229,7 +2417,7 @@ loop_CD:
 		}
 	else if(i<m)
 		{
-		kernel_dgemm_tt_4x4_vs_lib4(k, &alpha, offsetA, &pA[i*ps], sda, &pB[j*sda], &beta, &pC[j*ps+i*sdc], &pD[j*ps+i*sdd], m-i, n-j);
+		kernel_dgemm_tt_4x4_vs_lib4(k, &alpha, offsetA, &pA[i*ps], sda, &pB[j*sdb], &beta, &pC[j*ps+i*sdc], &pD[j*ps+i*sdd], m-i, n-j);
 		}
 	return;
 #elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
@@ -2237,11 +2425,11 @@ loop_CD:
 	i = 0;
 	for(; i<m-4; i+=8)
 		{
-		kernel_dgemm_tt_8x4_vs_lib4(k, &alpha, offsetA, &pA[i*ps], sda, &pB[j*sda], &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, m-i, n-j);
+		kernel_dgemm_tt_8x4_vs_lib4(k, &alpha, offsetA, &pA[i*ps], sda, &pB[j*sdb], &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, m-i, n-j);
 		}
 	if(i<m)
 		{
-		kernel_dgemm_tt_4x4_vs_lib4(k, &alpha, offsetA, &pA[i*ps], sda, &pB[j*sda], &beta, &pC[j*ps+i*sdc], &pD[j*ps+i*sdd], m-i, n-j);
+		kernel_dgemm_tt_4x4_vs_lib4(k, &alpha, offsetA, &pA[i*ps], sda, &pB[j*sdb], &beta, &pC[j*ps+i*sdc], &pD[j*ps+i*sdd], m-i, n-j);
 		}
 	return;
 #elif 0//defined(TARGET_X86_AMD_BARCELONA)
@@ -2272,6 +2460,11 @@ void blasfeo_dgemm_tt(int m, int n, int k, double alpha, struct blasfeo_dmat *sA
 	if(m<=0 || n<=0)
 		return;
 
+#if defined(MULTI_THREAD)
+	if(d_gemm_mt(1, 1, m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj))
+		return;
+#endif
+
 	// invalidate stored inverse diagonal of result matrix
 	sD->use_dA = 0;
 
@@ -4890,6 +5083,11 @@ void blasfeo_dsyrk_ln(int m, int k, double alpha, struct blasfeo_dmat *sA, int a
 	if(m<=0)
 		return;
 
+#if defined(JIT) & defined(TARGET_X64_INTEL_HASWELL)
+	if(blasfeo_jit_dgemm(BLASFEO_JIT_DSYRK_LN, m, m, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj))
+		return;
+#endif
+
 	// invalidate stored inverse diagonal of result matrix
 	sD->use_dA = 0;
 
@@ -5027,13 +5225,13 @@ loop_000:
 		// main loop
 		for(; j<i; j+=4)
 			{
-			kernel_dgemm_nt_12x4_lib4(k, &alpha, pA2, sda, &pB[j*sdb], &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd);
+			kernel_dgemm_nt_12x4_lib4(k, &alpha, pA2, sda2, &pB[j*sdb], &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd);
 			}
-		kernel_dsyrk_nt_l_12x4_lib4(k, &alpha, pA2, sda, &pB[j*sdb], &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd);
+		kernel_dsyrk_nt_l_12x4_lib4(k, &alpha, pA2, sda2, &pB[j*sdb], &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd);
 #if defined(TARGET_X64_INTEL_HASWELL)
-		kernel_dsyrk_nt_l_8x8_lib4(k, &alpha, pA2+4*sda2, sda, &pB[(j+4)*sdb], sdb, &beta, &pC[(j+4)*ps+(i+4)*sdc], sdc, &pD[(j+4)*ps+(i+4)*sdd], sdd);
+		kernel_dsyrk_nt_l_8x8_lib4(k, &alpha, pA2+4*sda2, sda2, &pB[(j+4)*sdb], sdb, &beta, &pC[(j+4)*ps+(i+4)*sdc], sdc, &pD[(j+4)*ps+(i+4)*sdd], sdd);
 #else
-		kernel_dsyrk_nt_l_8x4_lib4(k, &alpha, pA2+4*sda2, sda, &pB[(j+4)*sdb], &beta, &pC[(j+4)*ps+(i+4)*sdc], sdc, &pD[(j+4)*ps+(i+4)*sdd], sdd);
+		kernel_dsyrk_nt_l_8x4_lib4(k, &alpha, pA2+4*sda2, sda2, &pB[(j+4)*sdb], &beta, &pC[(j+4)*ps+(i+4)*sdc], sdc, &pD[(j+4)*ps+(i+4)*sdd], sdd);
 		kernel_dsyrk_nt_l_4x4_lib4(k, &alpha, pA2+8*sda2, &pB[(j+8)*sdb], &beta, &pC[(j+8)*ps+(i+8)*sdc], &pD[(j+8)*ps+(i+8)*sdd]);
 #endif
 		}
@@ -5075,9 +5273,9 @@ loop_000:
 		// main loop
 		for(; j<i; j+=4)
 			{
-			kernel_dgemm_nt_8x4_lib4(k, &alpha, pA2, sda, &pB[j*sdb], &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd);
+			kernel_dgemm_nt_8x4_lib4(k, &alpha, pA2, sda2, &pB[j*sdb], &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd);
 			}
-		kernel_dsyrk_nt_l_8x4_lib4(k, &alpha, pA2, sda, &pB[j*sdb], &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd);
+		kernel_dsyrk_nt_l_8x4_lib4(k, &alpha, pA2, sda2, &pB[j*sdb], &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd);
 		kernel_dsyrk_nt_l_4x4_lib4(k, &alpha, pA2+4*sda2, &pB[(j+4)*sdb], &beta, &pC[(j+4)*ps+(i+4)*sdc], &pD[(j+4)*ps+(i+4)*sdd]);
 		}
 	if(m>i)
@@ -5233,10 +5431,10 @@ loop_0CD:
 		// main loop
 		for(; j<i; j+=4)
 			{
-			kernel_dgemm_nt_12x4_gen_lib4(k, &alpha, pA2, sda, &pB[j*sdb], &beta, offsetC, &pC[j*ps+i*sdc], sdc, offsetD, &pD[j*ps+i*sdd], sdd, 0, m-i, 0, m-j);
+			kernel_dgemm_nt_12x4_gen_lib4(k, &alpha, pA2, sda2, &pB[j*sdb], &beta, offsetC, &pC[j*ps+i*sdc], sdc, offsetD, &pD[j*ps+i*sdd], sdd, 0, m-i, 0, m-j);
 			}
-		kernel_dsyrk_nt_l_12x4_gen_lib4(k, &alpha, pA2, sda, &pB[j*sdb], &beta, offsetC, &pC[j*ps+i*sdc], sdc, offsetD, &pD[j*ps+i*sdd], sdd, 0, m-i, 0, m-j);
-		kernel_dsyrk_nt_l_8x8_gen_lib4(k, &alpha, pA2+4*sda2, sda, &pB[(j+4)*sdb], sdb, &beta, offsetC, &pC[(j+4)*ps+(i+4)*sdc], sdc, offsetD, &pD[(j+4)*ps+(i+4)*sdd], sdd, 0, m-i-4, 0, m-j-4);
+		kernel_dsyrk_nt_l_12x4_gen_lib4(k, &alpha, pA2, sda2, &pB[j*sdb], &beta, offsetC, &pC[j*ps+i*sdc], sdc, offsetD, &pD[j*ps+i*sdd], sdd, 0, m-i, 0, m-j);
+		kernel_dsyrk_nt_l_8x8_gen_lib4(k, &alpha, pA2+4*sda2, sda2, &pB[(j+4)*sdb], sdb, &beta, offsetC, &pC[(j+4)*ps+(i+4)*sdc], sdc, offsetD, &pD[(j+4)*ps+(i+4)*sdd], sdd, 0, m-i-4, 0, m-j-4);
 		}
 	if(m>i)
 		{
@@ -5407,13 +5605,13 @@ loop_BCD:
 	// main loop
 	for(; j<i; j+=4)
 		{
-		kernel_dgemm_nt_12x4_vs_lib4(k, &alpha, pA2, sda, &pB[j*sdb], &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, m-i, m-j);
+		kernel_dgemm_nt_12x4_vs_lib4(k, &alpha, pA2, sda2, &pB[j*sdb], &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, m-i, m-j);
 		}
-	kernel_dsyrk_nt_l_12x4_vs_lib4(k, &alpha, pA2, sda, &pB[j*sdb], &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, m-i, m-j);
+	kernel_dsyrk_nt_l_12x4_vs_lib4(k, &alpha, pA2, sda2, &pB[j*sdb], &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, m-i, m-j);
 #if defined(TARGET_X64_INTEL_HASWELL)
-	kernel_dsyrk_nt_l_8x8_vs_lib4(k, &alpha, pA2+4*sda2, sda, &pB[(j+4)*sdb], sdb, &beta, &pC[(j+4)*ps+(i+4)*sdc], sdc, &pD[(j+4)*ps+(i+4)*sdd], sdd, m-i-4, m-j-4);
+	kernel_dsyrk_nt_l_8x8_vs_lib4(k, &alpha, pA2+4*sda2, sda2, &pB[(j+4)*sdb], sdb, &beta, &pC[(j+4)*ps+(i+4)*sdc], sdc, &pD[(j+4)*ps+(i+4)*sdd], sdd, m-i-4, m-j-4);
 #else
-	kernel_dsyrk_nt_l_8x4_vs_lib4(k, &alpha, pA2+4*sda2, sda, &pB[(j+4)*sdb], &beta, &pC[(j+4)*ps+(i+4)*sdc], sdc, &pD[(j+4)*ps+(i+4)*sdd], sdd, m-i-4, m-j-4);
+	kernel_dsyrk_nt_l_8x4_vs_lib4(k, &alpha, pA2+4*sda2, sda2, &pB[(j+4)*sdb], &beta, &pC[(j+4)*ps+(i+4)*sdc], sdc, &pD[(j+4)*ps+(i+4)*sdd], sdd, m-i-4, m-j-4);
 	kernel_dsyrk_nt_l_4x4_vs_lib4(k, &alpha, pA2+8*sda2, &pB[(j+8)*sdb], &beta, &pC[(j+8)*ps+(i+8)*sdc], &pD[(j+8)*ps+(i+8)*sdd], m-i-8, m-j-8);
 #endif
 	goto end;
@@ -5438,21 +5636,21 @@ loop_BCD:
 	// main loop
 	for(; j<i-8; j+=12)
 		{
-		kernel_dgemm_nt_8x8l_vs_lib4(k, &alpha, pA2, sda, &pB[j*sdb], sdb, &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, m-i, m-j);
-		kernel_dgemm_nt_8x8u_vs_lib4(k, &alpha, pA2, sda, &pB[(j+4)*sdb], sdb, &beta, &pC[(j+4)*ps+i*sdc], sdc, &pD[(j+4)*ps+i*sdd], sdd, m-i, m-(j+4));
+		kernel_dgemm_nt_8x8l_vs_lib4(k, &alpha, pA2, sda2, &pB[j*sdb], sdb, &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, m-i, m-j);
+		kernel_dgemm_nt_8x8u_vs_lib4(k, &alpha, pA2, sda2, &pB[(j+4)*sdb], sdb, &beta, &pC[(j+4)*ps+i*sdc], sdc, &pD[(j+4)*ps+i*sdd], sdd, m-i, m-(j+4));
 		}
 	if(j<i-4)
 		{
-		kernel_dgemm_nt_8x8l_vs_lib4(k, &alpha, pA2, sda, &pB[j*sdb], sdb, &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, m-i, m-j);
+		kernel_dgemm_nt_8x8l_vs_lib4(k, &alpha, pA2, sda2, &pB[j*sdb], sdb, &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, m-i, m-j);
 		kernel_dgemm_nt_4x4_vs_lib4(k, &alpha, pA2, &pB[(j+4)*sdb], &beta, &pC[(j+4)*ps+i*sdc], &pD[(j+4)*ps+i*sdd], m-i, m-(j+4));
 		j += 8;
 		}
 	else if(j<i)
 		{
-		kernel_dgemm_nt_8x4_vs_lib4(k, &alpha, pA2, sda, &pB[j*sdb], &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, m-i, m-j);
+		kernel_dgemm_nt_8x4_vs_lib4(k, &alpha, pA2, sda2, &pB[j*sdb], &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, m-i, m-j);
 		j += 4;
 		}
-	kernel_dsyrk_nt_l_8x8_vs_lib4(k, &alpha, pA2, sda, &pB[j*sdb], sdb, &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, m-i, m-j);
+	kernel_dsyrk_nt_l_8x8_vs_lib4(k, &alpha, pA2, sda2, &pB[j*sdb], sdb, &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, m-i, m-j);
 	goto end;
 #elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
 	left_8:
@@ -5471,9 +5669,9 @@ loop_BCD:
 	// main loop
 	for(; j<i; j+=4)
 		{
-		kernel_dgemm_nt_8x4_vs_lib4(k, &alpha, pA2, sda, &pB[j*sdb], &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, m-i, m-j);
+		kernel_dgemm_nt_8x4_vs_lib4(k, &alpha, pA2, sda2, &pB[j*sdb], &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, m-i, m-j);
 		}
-	kernel_dsyrk_nt_l_8x4_vs_lib4(k, &alpha, pA2, sda, &pB[j*sdb], &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, m-i, m-j);
+	kernel_dsyrk_nt_l_8x4_vs_lib4(k, &alpha, pA2, sda2, &pB[j*sdb], &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, m-i, m-j);
 	kernel_dsyrk_nt_l_4x4_vs_lib4(k, &alpha, pA2+4*sda2, &pB[(j+4)*sdb], &beta, &pC[(j+4)*ps+(i+4)*sdc], &pD[(j+4)*ps+(i+4)*sdd], m-i-4, m-j-4);
 	goto end;
 #elif defined(TARGET_ARMV8A_ARM_CORTEX_A57) || defined(TARGET_ARMV8A_ARM_CORTEX_A53)
@@ -5494,9 +5692,9 @@ loop_BCD:
 	// main loop
 	for(; j<i; j+=4)
 		{
-		kernel_dgemm_nt_8x4_vs_lib4(k, &alpha, pA2, sda, &pB[j*sdb], &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, m-i, m-j);
+		kernel_dgemm_nt_8x4_vs_lib4(k, &alpha, pA2, sda2, &pB[j*sdb], &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, m-i, m-j);
 		}
-	kernel_dsyrk_nt_l_8x4_vs_lib4(k, &alpha, pA2, sda, &pB[j*sdb], &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, m-i, m-j);
+	kernel_dsyrk_nt_l_8x4_vs_lib4(k, &alpha, pA2, sda2, &pB[j*sdb], &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, m-i, m-j);
 	kernel_dsyrk_nt_l_4x4_vs_lib4(k, &alpha, pA2+4*sda2, &pB[(j+4)*sdb], &beta, &pC[(j+4)*ps+(i+4)*sdc], &pD[(j+4)*ps+(i+4)*sdd], m-i-4, m-j-4);
 	goto end;
 #endif
@@ -6560,6 +6758,404 @@ end:
 
 
 
+// batched routines: the same operation on arrays of matrices of equal size;
+// the offsets arrays can be NULL, meaning all offsets are zero
+
+// kernel height used in the batched routines
+#if defined(TARGET_X64_INTEL_HASWELL) | defined(TARGET_ARMV8A_ARM_CORTEX_A53)
+#define D_BATCH_M_KERNEL 12
+#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE) | defined(TARGET_ARMV8A_ARM_CORTEX_A57)
+#define D_BATCH_M_KERNEL 8
+#else
+#define D_BATCH_M_KERNEL 4
+#endif
+
+// minimum work (as sum of m*n*k) per thread in the multi-threaded batched routines
+#define D_BATCH_MT_MIN_WORK (32*32*32)
+
+#define D_BATCH_IDX(x, ii) ((x)==NULL ? 0 : (x)[ii])
+
+#define D_BATCH_GEMM_NN 0
+#define D_BATCH_GEMM_NT 1
+#define D_BATCH_SYRK_LN 2
+
+
+
+#if !defined(TARGET_X86_AMD_BARCELONA)
+
+// D <= beta * C + alpha * A * B^T on r<=mk rows with the mk x 4 kernels, all matrices at the top of a panel
+static void d_gemm_nt_batch_rows(int mk, int r, int n, int k, double *alpha, double *pA, int sda, double *pB, int sdb, double *beta, double *pC, int sdc, double *pD, int sdd)
+	{
+	const int ps = 4;
+	int j = 0;
+	switch(mk)
+		{
+#if defined(TARGET_X64_INTEL_HASWELL) | defined(TARGET_ARMV8A_ARM_CORTEX_A53)
+		case 12:
+			if(r==12)
+				for(; j<n-3; j+=4)
+					kernel_dgemm_nt_12x4_lib4(k, alpha, pA, sda, &pB[j*sdb], beta, &pC[j*ps], sdc, &pD[j*ps], sdd);
+			for(; j<n; j+=4)
+				kernel_dgemm_nt_12x4_vs_lib4(k, alpha, pA, sda, &pB[j*sdb], beta, &pC[j*ps], sdc, &pD[j*ps], sdd, r, n-j);
+			break;
+#endif
+#if defined(TARGET_X64_INTEL_HASWELL) | defined(TARGET_ARMV8A_ARM_CORTEX_A53) | defined(TARGET_X64_INTEL_SANDY_BRIDGE) | defined(TARGET_ARMV8A_ARM_CORTEX_A57)
+		case 8:
+			if(r==8)
+				for(; j<n-3; j+=4)
+					kernel_dgemm_nt_8x4_lib4(k, alpha, pA, sda, &pB[j*sdb], beta, &pC[j*ps], sdc, &pD[j*ps], sdd);
+			for(; j<n; j+=4)
+				kernel_dgemm_nt_8x4_vs_lib4(k, alpha, pA, sda, &pB[j*sdb], beta, &pC[j*ps], sdc, &pD[j*ps], sdd, r, n-j);
+			break;
+#endif
+		default:
+			if(r==4)
+				for(; j<n-3; j+=4)
+					kernel_dgemm_nt_4x4_lib4(k, alpha, pA, &pB[j*sdb], beta, &pC[j*ps], &pD[j*ps]);
+			for(; j<n; j+=4)
+				kernel_dgemm_nt_4x4_vs_lib4(k, alpha, pA, &pB[j*sdb], beta, &pC[j*ps], &pD[j*ps], r, n-j);
+		}
+	return;
+	}
+
+
+
+// D <= beta * C + alpha * A * B on r<=mk rows with the mk x 4 kernels, A, C and D at the top of a panel, B at row offsetB of a panel
+static void d_gemm_nn_batch_rows(int mk, int r, int n, int k, double *alpha, double *pA, int sda, int offsetB, double *pB, int sdb, double *beta, double *pC, int sdc, double *pD, int sdd)
+	{
+	const int ps = 4;
+	int j = 0;
+	switch(mk)
+		{
+#if defined(TARGET_X64_INTEL_HASWELL) | defined(TARGET_ARMV8A_ARM_CORTEX_A53)
+		case 12:
+			if(r==12)
+				for(; j<n-3; j+=4)
+					kernel_dgemm_nn_12x4_lib4(k, alpha, pA, sda, offsetB, &pB[j*ps], sdb, beta, &pC[j*ps], sdc, &pD[j*ps], sdd);
+			for(; j<n; j+=4)
+				kernel_dgemm_nn_12x4_vs_lib4(k, alpha, pA, sda, offsetB, &pB[j*ps], sdb, beta, &pC[j*ps], sdc, &pD[j*ps], sdd, r, n-j);
+			break;
+#endif
+#if defined(TARGET_X64_INTEL_HASWELL) | defined(TARGET_ARMV8A_ARM_CORTEX_A53) | defined(TARGET_X64_INTEL_SANDY_BRIDGE) | defined(TARGET_ARMV8A_ARM_CORTEX_A57)
+		case 8:
+			if(r==8)
+				for(; j<n-3; j+=4)
+					kernel_dgemm_nn_8x4_lib4(k, alpha, pA, sda, offsetB, &pB[j*ps], sdb, beta, &pC[j*ps], sdc, &pD[j*ps], sdd);
+			for(; j<n; j+=4)
+				kernel_dgemm_nn_8x4_vs_lib4(k, alpha, pA, sda, offsetB, &pB[j*ps], sdb, beta, &pC[j*ps], sdc, &pD[j*ps], sdd, r, n-j);
+			break;
+#endif
+		default:
+			if(r==4)
+				for(; j<n-3; j+=4)
+					kernel_dgemm_nn_4x4_lib4(k, alpha, pA, offsetB, &pB[j*ps], sdb, beta, &pC[j*ps], &pD[j*ps]);
+			for(; j<n; j+=4)
+				kernel_dgemm_nn_4x4_vs_lib4(k, alpha, pA, offsetB, &pB[j*ps], sdb, beta, &pC[j*ps], &pD[j*ps], r, n-j);
+		}
+	return;
+	}
+
+
+
+// lower triangle of the r x r diagonal block of D <= beta * C + alpha * A * B^T, r<=D_BATCH_M_KERNEL, all matrices at the top of a panel
+static void d_syrk_ln_batch_diag(int r, int k, double *alpha, double *pA, int sda, double *pB, int sdb, double *beta, double *pC, int sdc, double *pD, int sdd)
+	{
+	const int ps = 4;
+#if defined(TARGET_X64_INTEL_HASWELL)
+	if(r>8)
+		{
+		if(r==12)
+			{
+			kernel_dsyrk_nt_l_12x4_lib4(k, alpha, pA, sda, pB, beta, pC, sdc, pD, sdd);
+			kernel_dsyrk_nt_l_8x8_lib4(k, alpha, pA+4*sda, sda, pB+4*sdb, sdb, beta, pC+4*ps+4*sdc, sdc, pD+4*ps+4*sdd, sdd);
+			}
+		else
+			{
+			kernel_dsyrk_nt_l_12x4_vs_lib4(k, alpha, pA, sda, pB, beta, pC, sdc, pD, sdd, r, r);
+			kernel_dsyrk_nt_l_8x8_vs_lib4(k, alpha, pA+4*sda, sda, pB+4*sdb, sdb, beta, pC+4*ps+4*sdc, sdc, pD+4*ps+4*sdd, sdd, r-4, r-4);
+			}
+		}
+	else if(r>4)
+		{
+		if(r==8)
+			kernel_dsyrk_nt_l_8x8_lib4(k, alpha, pA, sda, pB, sdb, beta, pC, sdc, pD, sdd);
+		else
+			kernel_dsyrk_nt_l_8x8_vs_lib4(k, alpha, pA, sda, pB, sdb, beta, pC, sdc, pD, sdd, r, r);
+		}
+	else
+		{
+		if(r==4)
+			kernel_dsyrk_nt_l_4x4_lib4(k, alpha, pA, pB, beta, pC, pD);
+		else
+			kernel_dsyrk_nt_l_4x4_vs_lib4(k, alpha, pA, pB, beta, pC, pD, r, r);
+		}
+#else
+	int j, h;
+	for(j=0; j<r; j+=4)
+		{
+		h = r-j;
+#if defined(TARGET_ARMV8A_ARM_CORTEX_A53)
+		if(h==12)
+			kernel_dsyrk_nt_l_12x4_lib4(k, alpha, pA+j*sda, sda, pB+j*sdb, beta, pC+j*ps+j*sdc, sdc, pD+j*ps+j*sdd, sdd);
+		else if(h>8)
+			kernel_dsyrk_nt_l_12x4_vs_lib4(k, alpha, pA+j*sda, sda, pB+j*sdb, beta, pC+j*ps+j*sdc, sdc, pD+j*ps+j*sdd, sdd, h, h);
+		else
+#endif
+#if defined(TARGET_ARMV8A_ARM_CORTEX_A53) | defined(TARGET_X64_INTEL_SANDY_BRIDGE) | defined(TARGET_ARMV8A_ARM_CORTEX_A57)
+		if(h==8)
+			kernel_dsyrk_nt_l_8x4_lib4(k, alpha, pA+j*sda, sda, pB+j*sdb, beta, pC+j*ps+j*sdc, sdc, pD+j*ps+j*sdd, sdd);
+		else if(h>4)
+			kernel_dsyrk_nt_l_8x4_vs_lib4(k, alpha, pA+j*sda, sda, pB+j*sdb, beta, pC+j*ps+j*sdc, sdc, pD+j*ps+j*sdd, sdd, h, h);
+		else
+#endif
+		if(h==4)
+			kernel_dsyrk_nt_l_4x4_lib4(k, alpha, pA+j*sda, pB+j*sdb, beta, pC+j*ps+j*sdc, pD+j*ps+j*sdd);
+		else
+			kernel_dsyrk_nt_l_4x4_vs_lib4(k, alpha, pA+j*sda, pB+j*sdb, beta, pC+j*ps+j*sdc, pD+j*ps+j*sdd, h, h);
+		}
+#endif
+	return;
+	}
+
+#endif // TARGET_X86_AMD_BARCELONA
+
+
+
+struct d_batch_arg
+	{
+	int op;
+	int batch;
+	int m;
+	int n;
+	int k;
+	double alpha;
+	struct blasfeo_dmat **sA;
+	int *ai;
+	int *aj;
+	struct blasfeo_dmat **sB;
+	int *bi;
+	int *bj;
+	double beta;
+	struct blasfeo_dmat **sC;
+	int *ci;
+	int *cj;
+	struct blasfeo_dmat **sD;
+	int *di;
+	int *dj;
+	int n_task;
+	// row blocks, chosen once for the whole batch: m_full rows with the full mk x 4 kernel,
+	// and the last m-m_full rows with the mk_tail x 4 kernel
+	int mk;
+	int m_full;
+	int mk_tail;
+	// kernel generated at run-time for the sizes of the batch, NULL if not available
+	int jit_type;
+	void *jit_kernel;
+	};
+
+
+
+#if !defined(TARGET_X86_AMD_BARCELONA)
+
+// one batch entry with all the row offsets (except the one of B in gemm_nn) at the top of a panel,
+// calling the kernels directly
+static void d_batch_entry_00(struct d_batch_arg *arg, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	const int ps = 4;
+	int m = arg->m;
+	int n = arg->n;
+	int k = arg->k;
+	int mk = arg->mk;
+	int sda = sA->cn;
+	int sdb = sB->cn;
+	int sdc = sC->cn;
+	int sdd = sD->cn;
+	double *pA = sA->pA + aj*ps + ai*sda;
+	double *pC = sC->pA + cj*ps + ci*sdc;
+	double *pD = sD->pA + dj*ps + di*sdd;
+	double *pB;
+	int i, r;
+
+	// invalidate stored inverse diagonal of result matrix
+	sD->use_dA = 0;
+
+	if(arg->op==D_BATCH_GEMM_NN)
+		{
+		int bir = bi & (ps-1);
+		pB = sB->pA + bj*ps + (bi-bir)*sdb;
+		for(i=0; i<arg->m_full; i+=mk)
+			d_gemm_nn_batch_rows(mk, mk, n, k, &arg->alpha, &pA[i*sda], sda, bir, pB, sdb, &arg->beta, &pC[i*sdc], sdc, &pD[i*sdd], sdd);
+		if(i<m)
+			d_gemm_nn_batch_rows(arg->mk_tail, m-i, n, k, &arg->alpha, &pA[i*sda], sda, bir, pB, sdb, &arg->beta, &pC[i*sdc], sdc, &pD[i*sdd], sdd);
+		}
+	else if(arg->op==D_BATCH_GEMM_NT)
+		{
+		pB = sB->pA + bj*ps + bi*sdb;
+		for(i=0; i<arg->m_full; i+=mk)
+			d_gemm_nt_batch_rows(mk, mk, n, k, &arg->alpha, &pA[i*sda], sda, pB, sdb, &arg->beta, &pC[i*sdc], sdc, &pD[i*sdd], sdd);
+		if(i<m)
+			d_gemm_nt_batch_rows(arg->mk_tail, m-i, n, k, &arg->alpha, &pA[i*sda], sda, pB, sdb, &arg->beta, &pC[i*sdc], sdc, &pD[i*sdd], sdd);
+		}
+	else
+		{
+		pB = sB->pA + bj*ps + bi*sdb;
+		for(i=0; i<m; i+=mk)
+			{
+			r = i<arg->m_full ? mk : m-i;
+			// blocks left of the diagonal
+			if(i>0)
+				d_gemm_nt_batch_rows(i<arg->m_full ? mk : arg->mk_tail, r, i, k, &arg->alpha, &pA[i*sda], sda, pB, sdb, &arg->beta, &pC[i*sdc], sdc, &pD[i*sdd], sdd);
+			// diagonal block
+			d_syrk_ln_batch_diag(r, k, &arg->alpha, &pA[i*sda], sda, &pB[i*sdb], sdb, &arg->beta, &pC[i*ps+i*sdc], sdc, &pD[i*ps+i*sdd], sdd);
+			}
+		}
+	return;
+	}
+
+#endif // TARGET_X86_AMD_BARCELONA
+
+
+
+static void d_batch_range(struct d_batch_arg *arg, int i0, int i1)
+	{
+	const int ps = 4;
+	int m = arg->m;
+	int n = arg->n;
+	int k = arg->k;
+	struct blasfeo_dmat *sA, *sB, *sC, *sD;
+	int ai, aj, bi, bj, ci, cj, di, dj;
+	int ii;
+	for(ii=i0; ii<i1; ii++)
+		{
+		sA = arg->sA[ii];
+		sB = arg->sB[ii];
+		sC = arg->sC[ii];
+		sD = arg->sD[ii];
+		ai = D_BATCH_IDX(arg->ai, ii);
+		aj = D_BATCH_IDX(arg->aj, ii);
+		bi = D_BATCH_IDX(arg->bi, ii);
+		bj = D_BATCH_IDX(arg->bj, ii);
+		ci = D_BATCH_IDX(arg->ci, ii);
+		cj = D_BATCH_IDX(arg->cj, ii);
+		di = D_BATCH_IDX(arg->di, ii);
+		dj = D_BATCH_IDX(arg->dj, ii);
+#if defined(JIT) & defined(TARGET_X64_INTEL_HASWELL)
+		if(arg->jit_kernel!=NULL & ((ai | bi | ci | di) & (ps-1))==0)
+			{
+			blasfeo_jit_dgemm_run(arg->jit_kernel, arg->jit_type, m, n, k, arg->alpha, sA, ai, aj, sB, bi, bj, arg->beta, sC, ci, cj, sD, di, dj);
+			continue;
+			}
+#endif
+#if !defined(TARGET_X86_AMD_BARCELONA)
+		// the gemm_nn kernels take any row offset of B
+		if(((ai | ci | di | (arg->op==D_BATCH_GEMM_NN ? 0 : bi)) & (ps-1))==0)
+			{
+			d_batch_entry_00(arg, sA, ai, aj, sB, bi, bj, sC, ci, cj, sD, di, dj);
+			continue;
+			}
+#endif
+		if(arg->op==D_BATCH_GEMM_NN)
+			blasfeo_dgemm_nn(m, n, k, arg->alpha, sA, ai, aj, sB, bi, bj, arg->beta, sC, ci, cj, sD, di, dj);
+		else if(arg->op==D_BATCH_GEMM_NT)
+			blasfeo_dgemm_nt(m, n, k, arg->alpha, sA, ai, aj, sB, bi, bj, arg->beta, sC, ci, cj, sD, di, dj);
+		else
+			blasfeo_dsyrk_ln(m, k, arg->alpha, sA, ai, aj, sB, bi, bj, arg->beta, sC, ci, cj, sD, di, dj);
+		}
+	return;
+	}
+
+
+
+static void d_batch_task(void *ptr, int task_id)
+	{
+	struct d_batch_arg *arg = (struct d_batch_arg *) ptr;
+	int i0 = (int) ((long long) arg->batch*task_id/arg->n_task);
+	int i1 = (int) ((long long) arg->batch*(task_id+1)/arg->n_task);
+	d_batch_range(arg, i0, i1);
+	return;
+	}
+
+
+
+static void d_batch(int op, int batch, int m, int n, int k, double alpha, struct blasfeo_dmat **sA, int *ai, int *aj, struct blasfeo_dmat **sB, int *bi, int *bj, double beta, struct blasfeo_dmat **sC, int *ci, int *cj, struct blasfeo_dmat **sD, int *di, int *dj)
+	{
+	if(batch<=0 | m<=0 | n<=0)
+		return;
+
+	struct d_batch_arg arg;
+	arg.op = op;
+	arg.batch = batch;
+	arg.m = m;
+	arg.n = n;
+	arg.k = k;
+	arg.alpha = alpha;
+	arg.sA = sA;
+	arg.ai = ai;
+	arg.aj = aj;
+	arg.sB = sB;
+	arg.bi = bi;
+	arg.bj = bj;
+	arg.beta = beta;
+	arg.sC = sC;
+	arg.ci = ci;
+	arg.cj = cj;
+	arg.sD = sD;
+	arg.di = di;
+	arg.dj = dj;
+	arg.mk = D_BATCH_M_KERNEL;
+	arg.m_full = m/arg.mk*arg.mk;
+	arg.mk_tail = m-arg.m_full>8 ? 12 : m-arg.m_full>4 ? 8 : 4;
+	arg.jit_type = op==D_BATCH_GEMM_NN ? BLASFEO_JIT_DGEMM_NN : op==D_BATCH_GEMM_NT ? BLASFEO_JIT_DGEMM_NT : BLASFEO_JIT_DSYRK_LN;
+	arg.jit_kernel = NULL;
+#if defined(JIT) & defined(TARGET_X64_INTEL_HASWELL)
+	arg.jit_kernel = blasfeo_jit_dgemm_kernel(arg.jit_type, m, n, k, beta);
+#endif
+
+	// spread contiguous chunks of the batch over the threads
+	int nt = blasfeo_thread_pool_num_threads();
+	double work = (double) batch * m * n * (k>1 ? k : 1);
+	if(work<(double) nt*D_BATCH_MT_MIN_WORK)
+		nt = work/D_BATCH_MT_MIN_WORK;
+	nt = nt<batch ? nt : batch;
+	if(nt>1)
+		{
+		arg.n_task = nt;
+		blasfeo_thread_pool_run(nt, &d_batch_task, (void *) &arg);
+		}
+	else
+		{
+		d_batch_range(&arg, 0, batch);
+		}
+
+	return;
+	}
+
+
+
+void blasfeo_dgemm_nn_batch(int batch, int m, int n, int k, double alpha, struct blasfeo_dmat **sA, int *ai, int *aj, struct blasfeo_dmat **sB, int *bi, int *bj, double beta, struct blasfeo_dmat **sC, int *ci, int *cj, struct blasfeo_dmat **sD, int *di, int *dj)
+	{
+	d_batch(D_BATCH_GEMM_NN, batch, m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+	return;
+	}
+
+
+
+void blasfeo_dgemm_nt_batch(int batch, int m, int n, int k, double alpha, struct blasfeo_dmat **sA, int *ai, int *aj, struct blasfeo_dmat **sB, int *bi, int *bj, double beta, struct blasfeo_dmat **sC, int *ci, int *cj, struct blasfeo_dmat **sD, int *di, int *dj)
+	{
+	d_batch(D_BATCH_GEMM_NT, batch, m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+	return;
+	}
+
+
+
+void blasfeo_dsyrk_ln_batch(int batch, int m, int k, double alpha, struct blasfeo_dmat **sA, int *ai, int *aj, struct blasfeo_dmat **sB, int *bi, int *bj, double beta, struct blasfeo_dmat **sC, int *ci, int *cj, struct blasfeo_dmat **sD, int *di, int *dj)
+	{
+	d_batch(D_BATCH_SYRK_LN, batch, m, m, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+	return;
+	}
+
+
+
 #else
 
 #error : wrong LA choice
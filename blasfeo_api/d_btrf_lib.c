@@ -0,0 +1,304 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "../include/blasfeo_common.h"
+#include "../include/blasfeo_d_aux.h"
+#include "../include/blasfeo_d_blasfeo_api.h"
+#include "../include/blasfeo_thread.h"
+
+
+
+// Cholesky factorization and solve of symmetric positive definite block tridiagonal matrices
+
+
+
+// minimum amount of work (in flops/2) per thread in cyclic reduction mode
+#define D_BTRF_MT_MIN_WORK (32*32*32)
+
+#define D_BTRF_FACT_ELIM 0
+#define D_BTRF_FACT_KEEP 1
+#define D_BTRF_SOLVE_FWD_ELIM 2
+#define D_BTRF_SOLVE_FWD_KEEP 3
+#define D_BTRF_SOLVE_BWD_ELIM 4
+
+
+
+int blasfeo_dbtrf_worksize(int N, int nx, int mode)
+	{
+	if(mode==BLASFEO_BTRF_CR)
+		return 0;
+	return 64 + blasfeo_memsize_dmat(nx, nx); // alignment
+	}
+
+
+
+static void d_btrf_seq(int N, int nx, struct blasfeo_dmat **sD, struct blasfeo_dmat **sE, struct blasfeo_dmat **sLD, struct blasfeo_dmat **sLE, void *work)
+	{
+	struct blasfeo_dmat sW;
+	blasfeo_create_dmat(nx, nx, &sW, (void *) (((size_t) work + 63) / 64 * 64));
+
+	int ii;
+
+	blasfeo_dpotrf_l(nx, sD[0], 0, 0, sLD[0], 0, 0);
+	for(ii=0; ii<N-1; ii++)
+		{
+		blasfeo_dtrsm_rltn(nx, nx, 1.0, sLD[ii], 0, 0, sE[ii], 0, 0, sLE[ii], 0, 0);
+		// dsyrk_dpotrf adds the product: the Schur complement update takes -LE[ii] as left factor
+		blasfeo_dgecpsc(nx, nx, -1.0, sLE[ii], 0, 0, &sW, 0, 0);
+		blasfeo_dsyrk_dpotrf_ln(nx, nx, &sW, 0, 0, sLE[ii], 0, 0, sD[ii+1], 0, 0, sLD[ii+1], 0, 0);
+		}
+	return;
+	}
+
+
+
+// cyclic reduction: at the level with neighbour distance s, the stages ii with (ii+1)%s==0 form a block tridiagonal
+// reduced system; the ones at even positions (elim) are factorized independently, and the Schur complement of the
+// ones at odd positions (keep) is updated independently, coupling each of them with the next kept stage.
+// The factor of an eliminated stage ii is LD[ii], LE[ii] (coupling with ii+s) and LE[N-2+ii] (coupling with ii-s);
+// while a stage is in the reduced system, LD[ii] holds its diagonal block and LE[ii] its coupling with the next stage.
+struct d_btrf_arg
+	{
+	int N;
+	int nx;
+	int s;
+	int phase;
+	int n_stage;
+	int n_task;
+	struct blasfeo_dmat **sLD;
+	struct blasfeo_dmat **sLE;
+	struct blasfeo_dvec **sx;
+	};
+
+
+
+static void d_btrf_cr_stage(struct d_btrf_arg *arg, int tt)
+	{
+	int N = arg->N;
+	int nx = arg->nx;
+	int s = arg->s;
+	struct blasfeo_dmat **sLD = arg->sLD;
+	struct blasfeo_dmat **sLE = arg->sLE;
+	struct blasfeo_dvec **sx = arg->sx;
+
+	int ii, i0, i1;
+
+	switch(arg->phase)
+		{
+		case D_BTRF_FACT_ELIM:
+			ii = s-1 + 2*s*tt;
+			blasfeo_dpotrf_l(nx, sLD[ii], 0, 0, sLD[ii], 0, 0);
+			if(ii-s>=0)
+				{
+				blasfeo_dgetr(nx, nx, sLE[ii-s], 0, 0, sLE[N-2+ii], 0, 0);
+				blasfeo_dtrsm_rltn(nx, nx, 1.0, sLD[ii], 0, 0, sLE[N-2+ii], 0, 0, sLE[N-2+ii], 0, 0);
+				}
+			if(ii+s<N)
+				blasfeo_dtrsm_rltn(nx, nx, 1.0, sLD[ii], 0, 0, sLE[ii], 0, 0, sLE[ii], 0, 0);
+			break;
+		case D_BTRF_FACT_KEEP:
+			ii = 2*s-1 + 2*s*tt;
+			i0 = ii-s;
+			i1 = ii+s;
+			blasfeo_dsyrk_ln(nx, nx, -1.0, sLE[i0], 0, 0, sLE[i0], 0, 0, 1.0, sLD[ii], 0, 0, sLD[ii], 0, 0);
+			if(i1<N)
+				{
+				blasfeo_dsyrk_ln(nx, nx, -1.0, sLE[N-2+i1], 0, 0, sLE[N-2+i1], 0, 0, 1.0, sLD[ii], 0, 0, sLD[ii], 0, 0);
+				// fill-in coupling with the next kept stage
+				if(i1+s<N)
+					blasfeo_dgemm_nt(nx, nx, nx, -1.0, sLE[i1], 0, 0, sLE[N-2+i1], 0, 0, 0.0, sLE[ii], 0, 0, sLE[ii], 0, 0);
+				}
+			break;
+		case D_BTRF_SOLVE_FWD_ELIM:
+			ii = s-1 + 2*s*tt;
+			blasfeo_dtrsv_lnn(nx, sLD[ii], 0, 0, sx[ii], 0, sx[ii], 0);
+			break;
+		case D_BTRF_SOLVE_FWD_KEEP:
+			ii = 2*s-1 + 2*s*tt;
+			i0 = ii-s;
+			i1 = ii+s;
+			blasfeo_dgemv_n(nx, nx, -1.0, sLE[i0], 0, 0, sx[i0], 0, 1.0, sx[ii], 0, sx[ii], 0);
+			if(i1<N)
+				blasfeo_dgemv_n(nx, nx, -1.0, sLE[N-2+i1], 0, 0, sx[i1], 0, 1.0, sx[ii], 0, sx[ii], 0);
+			break;
+		case D_BTRF_SOLVE_BWD_ELIM:
+			ii = s-1 + 2*s*tt;
+			if(ii+s<N)
+				blasfeo_dgemv_t(nx, nx, -1.0, sLE[ii], 0, 0, sx[ii+s], 0, 1.0, sx[ii], 0, sx[ii], 0);
+			if(ii-s>=0)
+				blasfeo_dgemv_t(nx, nx, -1.0, sLE[N-2+ii], 0, 0, sx[ii-s], 0, 1.0, sx[ii], 0, sx[ii], 0);
+			blasfeo_dtrsv_ltn(nx, sLD[ii], 0, 0, sx[ii], 0, sx[ii], 0);
+			break;
+		}
+	return;
+	}
+
+
+
+static void d_btrf_cr_task(void *ptr, int task_id)
+	{
+	struct d_btrf_arg *arg = (struct d_btrf_arg *) ptr;
+	int t0 = arg->n_stage*task_id/arg->n_task;
+	int t1 = arg->n_stage*(task_id+1)/arg->n_task;
+	int tt;
+	for(tt=t0; tt<t1; tt++)
+		d_btrf_cr_stage(arg, tt);
+	return;
+	}
+
+
+
+// process the n_stage stages of a phase, spread over the threads if there is enough work
+static void d_btrf_cr_run(struct d_btrf_arg *arg, int phase, int n_stage, double stage_work)
+	{
+	if(n_stage<=0)
+		return;
+	arg->phase = phase;
+	arg->n_stage = n_stage;
+	int nt = blasfeo_thread_pool_num_threads();
+	double work = n_stage*stage_work;
+	if(work<(double) nt*D_BTRF_MT_MIN_WORK)
+		nt = work/D_BTRF_MT_MIN_WORK;
+	nt = nt<n_stage ? nt : n_stage;
+	if(nt>1)
+		{
+		arg->n_task = nt;
+		blasfeo_thread_pool_run(nt, &d_btrf_cr_task, (void *) arg);
+		}
+	else
+		{
+		arg->n_task = 1;
+		d_btrf_cr_task((void *) arg, 0);
+		}
+	return;
+	}
+
+
+
+static void d_btrf_cr(int N, int nx, struct blasfeo_dmat **sD, struct blasfeo_dmat **sE, struct blasfeo_dmat **sLD, struct blasfeo_dmat **sLE)
+	{
+	int ii, s;
+
+	for(ii=0; ii<N; ii++)
+		{
+		blasfeo_dtrcp_l(nx, sD[ii], 0, 0, sLD[ii], 0, 0);
+		if(ii<N-1)
+			blasfeo_dgecp(nx, nx, sE[ii], 0, 0, sLE[ii], 0, 0);
+		}
+
+	struct d_btrf_arg arg;
+	arg.N = N;
+	arg.nx = nx;
+	arg.sLD = sLD;
+	arg.sLE = sLE;
+	arg.sx = NULL;
+
+	double nx3 = (double) nx*nx*nx;
+	for(s=1; s<=N; s*=2)
+		{
+		arg.s = s;
+		d_btrf_cr_run(&arg, D_BTRF_FACT_ELIM, (N+s)/(2*s), nx3);
+		d_btrf_cr_run(&arg, D_BTRF_FACT_KEEP, N/(2*s), 2*nx3);
+		}
+	return;
+	}
+
+
+
+void blasfeo_dbtrf(int N, int nx, struct blasfeo_dmat **sD, struct blasfeo_dmat **sE, struct blasfeo_dmat **sLD, struct blasfeo_dmat **sLE, int mode, void *work)
+	{
+	if(N<=0 | nx<=0)
+		return;
+	if(mode==BLASFEO_BTRF_CR)
+		d_btrf_cr(N, nx, sD, sE, sLD, sLE);
+	else
+		d_btrf_seq(N, nx, sD, sE, sLD, sLE, work);
+	return;
+	}
+
+
+
+void blasfeo_dbtrs(int N, int nx, struct blasfeo_dmat **sLD, struct blasfeo_dmat **sLE, struct blasfeo_dvec **sb, struct blasfeo_dvec **sx, int mode)
+	{
+	if(N<=0 | nx<=0)
+		return;
+
+	int ii, s;
+
+	if(mode==BLASFEO_BTRF_CR)
+		{
+		for(ii=0; ii<N; ii++)
+			{
+			if(sb[ii]!=sx[ii])
+				blasfeo_dveccp(nx, sb[ii], 0, sx[ii], 0);
+			}
+		struct d_btrf_arg arg;
+		arg.N = N;
+		arg.nx = nx;
+		arg.sLD = sLD;
+		arg.sLE = sLE;
+		arg.sx = sx;
+		double nx2 = (double) nx*nx;
+		for(s=1; s<=N; s*=2)
+			{
+			arg.s = s;
+			d_btrf_cr_run(&arg, D_BTRF_SOLVE_FWD_ELIM, (N+s)/(2*s), nx2);
+			d_btrf_cr_run(&arg, D_BTRF_SOLVE_FWD_KEEP, N/(2*s), 2*nx2);
+			}
+		for(s/=2; s>=1; s/=2)
+			{
+			arg.s = s;
+			d_btrf_cr_run(&arg, D_BTRF_SOLVE_BWD_ELIM, (N+s)/(2*s), 2*nx2);
+			}
+		return;
+		}
+
+	blasfeo_dtrsv_lnn(nx, sLD[0], 0, 0, sb[0], 0, sx[0], 0);
+	for(ii=0; ii<N-1; ii++)
+		{
+		blasfeo_dgemv_n(nx, nx, -1.0, sLE[ii], 0, 0, sx[ii], 0, 1.0, sb[ii+1], 0, sx[ii+1], 0);
+		blasfeo_dtrsv_lnn(nx, sLD[ii+1], 0, 0, sx[ii+1], 0, sx[ii+1], 0);
+		}
+	blasfeo_dtrsv_ltn(nx, sLD[N-1], 0, 0, sx[N-1], 0, sx[N-1], 0);
+	for(ii=N-2; ii>=0; ii--)
+		{
+		blasfeo_dgemv_t(nx, nx, -1.0, sLE[ii], 0, 0, sx[ii+1], 0, 1.0, sx[ii], 0, sx[ii], 0);
+		blasfeo_dtrsv_ltn(nx, sLD[ii], 0, 0, sx[ii], 0, sx[ii], 0);
+		}
+	return;
+	}
@@ -0,0 +1,470 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#if defined(TARGET_X64_INTEL_HASWELL) || defined(TARGET_X64_INTEL_SANDY_BRIDGE)
+#include <immintrin.h>  // AVX
+#endif
+
+#include "../include/blasfeo_common.h"
+#include "../include/blasfeo_d_blasfeo_api.h"
+#include "../include/blasfeo_d_kernel.h"
+
+
+
+// interleaved ("compact") batch storage: element (i,j) of the matrix in lane l is at pA[nl*(i+j*m)+l],
+// so every operation is performed on all the BLASFEO_DMAT_BATCH_LANES matrices at once, one per SIMD lane
+
+
+
+#if defined(TARGET_X64_INTEL_HASWELL) || defined(TARGET_X64_INTEL_SANDY_BRIDGE)
+
+typedef __m256d d_lane;
+
+static inline d_lane d_lane_load(double *ptr)
+	{
+	return _mm256_loadu_pd(ptr);
+	}
+
+static inline void d_lane_store(double *ptr, d_lane a)
+	{
+	_mm256_storeu_pd(ptr, a);
+	}
+
+static inline d_lane d_lane_set1(double a)
+	{
+	return _mm256_set1_pd(a);
+	}
+
+static inline d_lane d_lane_mul(d_lane a, d_lane b)
+	{
+	return _mm256_mul_pd(a, b);
+	}
+
+// 1 / a
+static inline d_lane d_lane_inv(d_lane a)
+	{
+	return _mm256_div_pd(_mm256_set1_pd(1.0), a);
+	}
+
+// sqrt(a) and 1/sqrt(a) if a>0, zero otherwise
+static inline void d_lane_sqrt_inv(d_lane a, d_lane *sq, d_lane *inv)
+	{
+	d_lane zero = _mm256_setzero_pd();
+	d_lane mask = _mm256_cmp_pd(a, zero, _CMP_GT_OQ);
+	d_lane tmp = _mm256_sqrt_pd(a);
+	*sq = _mm256_and_pd(tmp, mask);
+	*inv = _mm256_and_pd(_mm256_div_pd(_mm256_set1_pd(1.0), tmp), mask);
+	}
+
+#else
+
+typedef struct { double v[BLASFEO_DMAT_BATCH_LANES]; } d_lane;
+
+static inline d_lane d_lane_load(double *ptr)
+	{
+	d_lane a;
+	int ll;
+	for(ll=0; ll<BLASFEO_DMAT_BATCH_LANES; ll++)
+		a.v[ll] = ptr[ll];
+	return a;
+	}
+
+static inline void d_lane_store(double *ptr, d_lane a)
+	{
+	int ll;
+	for(ll=0; ll<BLASFEO_DMAT_BATCH_LANES; ll++)
+		ptr[ll] = a.v[ll];
+	}
+
+static inline d_lane d_lane_set1(double a)
+	{
+	d_lane b;
+	int ll;
+	for(ll=0; ll<BLASFEO_DMAT_BATCH_LANES; ll++)
+		b.v[ll] = a;
+	return b;
+	}
+
+static inline d_lane d_lane_mul(d_lane a, d_lane b)
+	{
+	int ll;
+	for(ll=0; ll<BLASFEO_DMAT_BATCH_LANES; ll++)
+		a.v[ll] *= b.v[ll];
+	return a;
+	}
+
+// 1 / a
+static inline d_lane d_lane_inv(d_lane a)
+	{
+	int ll;
+	for(ll=0; ll<BLASFEO_DMAT_BATCH_LANES; ll++)
+		a.v[ll] = 1.0 / a.v[ll];
+	return a;
+	}
+
+// sqrt(a) and 1/sqrt(a) if a>0, zero otherwise
+static inline void d_lane_sqrt_inv(d_lane a, d_lane *sq, d_lane *inv)
+	{
+	int ll;
+	for(ll=0; ll<BLASFEO_DMAT_BATCH_LANES; ll++)
+		{
+		if(a.v[ll]>0.0)
+			{
+			sq->v[ll] = sqrt(a.v[ll]);
+			inv->v[ll] = 1.0 / sq->v[ll];
+			}
+		else
+			{
+			sq->v[ll] = 0.0;
+			inv->v[ll] = 0.0;
+			}
+		}
+	}
+
+#endif
+
+
+
+// D <= beta * C + alpha * A * B on a m x n block, in tiles of the 4x3 kernel; A(i,l) at pA[i*as0+l*as1], B(l,j) at
+// pB[l*bs0+j*bs1], C(i,j) at pC[i*cs0+j*cs1], D(i,j) at pD[i*ds0+j*ds1] ; alpha and beta are per-lane, beta==NULL means
+// beta=0 (C not accessed)
+static void d_compact_gemm(int m, int n, int k, d_lane *alpha, double *pA, int as0, int as1, double *pB, int bs0, int bs1, d_lane *beta, double *pC, int cs0, int cs1, double *pD, int ds0, int ds1)
+	{
+	double *alpha_p = (double *) alpha;
+	double *beta_p = (double *) beta;
+	int ii, jj;
+	for(jj=0; jj<n; jj+=3)
+		{
+		for(ii=0; ii<m; ii+=4)
+			{
+			if(m-ii>=4 & n-jj>=3)
+				kernel_dgemm_4x3_compact(k, alpha_p, pA+ii*as0, as0, as1, pB+jj*bs1, bs0, bs1, beta_p, pC+ii*cs0+jj*cs1, cs0, cs1, pD+ii*ds0+jj*ds1, ds0, ds1);
+			else
+				kernel_dgemm_4x3_vs_compact(k, alpha_p, pA+ii*as0, as0, as1, pB+jj*bs1, bs0, bs1, beta_p, pC+ii*cs0+jj*cs1, cs0, cs1, pD+ii*ds0+jj*ds1, ds0, ds1, m-ii, n-jj);
+			}
+		}
+	return;
+	}
+
+
+
+// D <= beta * C + alpha * A * B
+void blasfeo_dgemm_nn_compact(int m, int n, int k, double alpha, struct blasfeo_dmat_batch *sA, int ai, int aj, struct blasfeo_dmat_batch *sB, int bi, int bj, double beta, struct blasfeo_dmat_batch *sC, int ci, int cj, struct blasfeo_dmat_batch *sD, int di, int dj)
+	{
+	if(m<=0 | n<=0)
+		return;
+	const int nl = BLASFEO_DMAT_BATCH_LANES;
+	int lda = sA->m;
+	int ldb = sB->m;
+	int ldc = sC->m;
+	int ldd = sD->m;
+	double *pA = sA->pA + nl*(ai+aj*lda);
+	double *pB = sB->pA + nl*(bi+bj*ldb);
+	double *pC = sC->pA + nl*(ci+cj*ldc);
+	double *pD = sD->pA + nl*(di+dj*ldd);
+	d_lane alpha_l = d_lane_set1(alpha);
+	d_lane beta_l = d_lane_set1(beta);
+	d_lane *beta_p = beta==0.0 ? NULL : &beta_l;
+	d_compact_gemm(m, n, k, &alpha_l, pA, nl, nl*lda, pB, nl, nl*ldb, beta_p, pC, nl, nl*ldc, pD, nl, nl*ldd);
+	return;
+	}
+
+
+
+// D <= beta * C + alpha * A * B^T
+void blasfeo_dgemm_nt_compact(int m, int n, int k, double alpha, struct blasfeo_dmat_batch *sA, int ai, int aj, struct blasfeo_dmat_batch *sB, int bi, int bj, double beta, struct blasfeo_dmat_batch *sC, int ci, int cj, struct blasfeo_dmat_batch *sD, int di, int dj)
+	{
+	if(m<=0 | n<=0)
+		return;
+	const int nl = BLASFEO_DMAT_BATCH_LANES;
+	int lda = sA->m;
+	int ldb = sB->m;
+	int ldc = sC->m;
+	int ldd = sD->m;
+	double *pA = sA->pA + nl*(ai+aj*lda);
+	double *pB = sB->pA + nl*(bi+bj*ldb);
+	double *pC = sC->pA + nl*(ci+cj*ldc);
+	double *pD = sD->pA + nl*(di+dj*ldd);
+	d_lane alpha_l = d_lane_set1(alpha);
+	d_lane beta_l = d_lane_set1(beta);
+	d_lane *beta_p = beta==0.0 ? NULL : &beta_l;
+	d_compact_gemm(m, n, k, &alpha_l, pA, nl, nl*lda, pB, nl*ldb, nl, beta_p, pC, nl, nl*ldc, pD, nl, nl*ldd);
+	return;
+	}
+
+
+
+// D <= beta * C + alpha * A * B^T ; C, D lower triangular
+void blasfeo_dsyrk_ln_compact(int m, int k, double alpha, struct blasfeo_dmat_batch *sA, int ai, int aj, struct blasfeo_dmat_batch *sB, int bi, int bj, double beta, struct blasfeo_dmat_batch *sC, int ci, int cj, struct blasfeo_dmat_batch *sD, int di, int dj)
+	{
+	if(m<=0)
+		return;
+	const int nl = BLASFEO_DMAT_BATCH_LANES;
+	int lda = sA->m;
+	int ldb = sB->m;
+	int ldc = sC->m;
+	int ldd = sD->m;
+	double *pA = sA->pA + nl*(ai+aj*lda);
+	double *pB = sB->pA + nl*(bi+bj*ldb);
+	double *pC = sC->pA + nl*(ci+cj*ldc);
+	double *pD = sD->pA + nl*(di+dj*ldd);
+	d_lane alpha_l = d_lane_set1(alpha);
+	d_lane beta_l = d_lane_set1(beta);
+	d_lane *beta_p = beta==0.0 ? NULL : &beta_l;
+	int ii, jj, nb;
+	// blocks of 3 columns: the lower triangle of the diagonal block one column at a time, the rows below it in tiles
+	for(jj=0; jj<m; jj+=3)
+		{
+		nb = m-jj<3 ? m-jj : 3;
+		for(ii=jj; ii<jj+nb; ii++)
+			{
+			d_compact_gemm(jj+nb-ii, 1, k, &alpha_l, pA+nl*ii, nl, nl*lda, pB+nl*ii, nl*ldb, nl, beta_p, pC+nl*(ii+ii*ldc), nl, nl*ldc, pD+nl*(ii+ii*ldd), nl, nl*ldd);
+			}
+		d_compact_gemm(m-jj-nb, nb, k, &alpha_l, pA+nl*(jj+nb), nl, nl*lda, pB+nl*jj, nl*ldb, nl, beta_p, pC+nl*(jj+nb+jj*ldc), nl, nl*ldc, pD+nl*(jj+nb+jj*ldd), nl, nl*ldd);
+		}
+	return;
+	}
+
+
+
+// D <= alpha * A^{-1} * B , with A lower triangular employing explicit inverse of diagonal
+void blasfeo_dtrsm_llnn_compact(int m, int n, double alpha, struct blasfeo_dmat_batch *sA, int ai, int aj, struct blasfeo_dmat_batch *sB, int bi, int bj, struct blasfeo_dmat_batch *sD, int di, int dj)
+	{
+	if(m<=0 | n<=0)
+		return;
+	const int nl = BLASFEO_DMAT_BATCH_LANES;
+	int lda = sA->m;
+	int ldb = sB->m;
+	int ldd = sD->m;
+	double *pA = sA->pA + nl*(ai+aj*lda);
+	double *pB = sB->pA + nl*(bi+bj*ldb);
+	double *pD = sD->pA + nl*(di+dj*ldd);
+	d_lane alpha_l = d_lane_set1(alpha);
+	d_lane inv, mone_inv, alpha_inv;
+	int ii;
+	// row ii of D, for all columns at once
+	for(ii=0; ii<m; ii++)
+		{
+		inv = d_lane_inv(d_lane_load(pA+nl*(ii+ii*lda)));
+		mone_inv = d_lane_mul(d_lane_set1(-1.0), inv);
+		alpha_inv = d_lane_mul(alpha_l, inv);
+		d_compact_gemm(n, 1, ii, &mone_inv, pD, nl*ldd, nl, pA+nl*ii, nl*lda, 0, &alpha_inv, pB+nl*ii, nl*ldb, 0, pD+nl*ii, nl*ldd, 0);
+		}
+	return;
+	}
+
+
+
+// D <= alpha * A^{-1} * B , with A lower triangular with unit diagonal
+void blasfeo_dtrsm_llnu_compact(int m, int n, double alpha, struct blasfeo_dmat_batch *sA, int ai, int aj, struct blasfeo_dmat_batch *sB, int bi, int bj, struct blasfeo_dmat_batch *sD, int di, int dj)
+	{
+	if(m<=0 | n<=0)
+		return;
+	const int nl = BLASFEO_DMAT_BATCH_LANES;
+	int lda = sA->m;
+	int ldb = sB->m;
+	int ldd = sD->m;
+	double *pA = sA->pA + nl*(ai+aj*lda);
+	double *pB = sB->pA + nl*(bi+bj*ldb);
+	double *pD = sD->pA + nl*(di+dj*ldd);
+	d_lane alpha_l = d_lane_set1(alpha);
+	d_lane mone = d_lane_set1(-1.0);
+	int ii;
+	// row ii of D, for all columns at once
+	for(ii=0; ii<m; ii++)
+		{
+		d_compact_gemm(n, 1, ii, &mone, pD, nl*ldd, nl, pA+nl*ii, nl*lda, 0, &alpha_l, pB+nl*ii, nl*ldb, 0, pD+nl*ii, nl*ldd, 0);
+		}
+	return;
+	}
+
+
+
+// D <= alpha * A^{-T} * B , with A lower triangular employing explicit inverse of diagonal
+void blasfeo_dtrsm_lltn_compact(int m, int n, double alpha, struct blasfeo_dmat_batch *sA, int ai, int aj, struct blasfeo_dmat_batch *sB, int bi, int bj, struct blasfeo_dmat_batch *sD, int di, int dj)
+	{
+	if(m<=0 | n<=0)
+		return;
+	const int nl = BLASFEO_DMAT_BATCH_LANES;
+	int lda = sA->m;
+	int ldb = sB->m;
+	int ldd = sD->m;
+	double *pA = sA->pA + nl*(ai+aj*lda);
+	double *pB = sB->pA + nl*(bi+bj*ldb);
+	double *pD = sD->pA + nl*(di+dj*ldd);
+	d_lane alpha_l = d_lane_set1(alpha);
+	d_lane inv, mone_inv, alpha_inv;
+	int ii;
+	// row ii of D, for all columns at once, backward
+	for(ii=m-1; ii>=0; ii--)
+		{
+		inv = d_lane_inv(d_lane_load(pA+nl*(ii+ii*lda)));
+		mone_inv = d_lane_mul(d_lane_set1(-1.0), inv);
+		alpha_inv = d_lane_mul(alpha_l, inv);
+		d_compact_gemm(n, 1, m-ii-1, &mone_inv, pD+nl*(ii+1), nl*ldd, nl, pA+nl*(ii+1+ii*lda), nl, 0, &alpha_inv, pB+nl*ii, nl*ldb, 0, pD+nl*ii, nl*ldd, 0);
+		}
+	return;
+	}
+
+
+
+// D <= alpha * A^{-1} * B , with A upper triangular employing explicit inverse of diagonal
+void blasfeo_dtrsm_lunn_compact(int m, int n, double alpha, struct blasfeo_dmat_batch *sA, int ai, int aj, struct blasfeo_dmat_batch *sB, int bi, int bj, struct blasfeo_dmat_batch *sD, int di, int dj)
+	{
+	if(m<=0 | n<=0)
+		return;
+	const int nl = BLASFEO_DMAT_BATCH_LANES;
+	int lda = sA->m;
+	int ldb = sB->m;
+	int ldd = sD->m;
+	double *pA = sA->pA + nl*(ai+aj*lda);
+	double *pB = sB->pA + nl*(bi+bj*ldb);
+	double *pD = sD->pA + nl*(di+dj*ldd);
+	d_lane alpha_l = d_lane_set1(alpha);
+	d_lane inv, mone_inv, alpha_inv;
+	int ii;
+	// row ii of D, for all columns at once, backward
+	for(ii=m-1; ii>=0; ii--)
+		{
+		inv = d_lane_inv(d_lane_load(pA+nl*(ii+ii*lda)));
+		mone_inv = d_lane_mul(d_lane_set1(-1.0), inv);
+		alpha_inv = d_lane_mul(alpha_l, inv);
+		d_compact_gemm(n, 1, m-ii-1, &mone_inv, pD+nl*(ii+1), nl*ldd, nl, pA+nl*(ii+(ii+1)*lda), nl*lda, 0, &alpha_inv, pB+nl*ii, nl*ldb, 0, pD+nl*ii, nl*ldd, 0);
+		}
+	return;
+	}
+
+
+
+// D <= alpha * B * A^{-T} , with A lower triangular employing explicit inverse of diagonal
+void blasfeo_dtrsm_rltn_compact(int m, int n, double alpha, struct blasfeo_dmat_batch *sA, int ai, int aj, struct blasfeo_dmat_batch *sB, int bi, int bj, struct blasfeo_dmat_batch *sD, int di, int dj)
+	{
+	if(m<=0 | n<=0)
+		return;
+	const int nl = BLASFEO_DMAT_BATCH_LANES;
+	int lda = sA->m;
+	int ldb = sB->m;
+	int ldd = sD->m;
+	double *pA = sA->pA + nl*(ai+aj*lda);
+	double *pB = sB->pA + nl*(bi+bj*ldb);
+	double *pD = sD->pA + nl*(di+dj*ldd);
+	d_lane alpha_l = d_lane_set1(alpha);
+	d_lane inv, mone_inv, alpha_inv;
+	int jj;
+	// column jj of D
+	for(jj=0; jj<n; jj++)
+		{
+		inv = d_lane_inv(d_lane_load(pA+nl*(jj+jj*lda)));
+		mone_inv = d_lane_mul(d_lane_set1(-1.0), inv);
+		alpha_inv = d_lane_mul(alpha_l, inv);
+		d_compact_gemm(m, 1, jj, &mone_inv, pD, nl, nl*ldd, pA+nl*jj, nl*lda, 0, &alpha_inv, pB+nl*jj*ldb, nl, 0, pD+nl*jj*ldd, nl, 0);
+		}
+	return;
+	}
+
+
+
+// D <= chol( C ) ; C, D lower triangular
+void blasfeo_dpotrf_l_compact(int m, struct blasfeo_dmat_batch *sC, int ci, int cj, struct blasfeo_dmat_batch *sD, int di, int dj)
+	{
+	if(m<=0)
+		return;
+	const int nl = BLASFEO_DMAT_BATCH_LANES;
+	int ldc = sC->m;
+	int ldd = sD->m;
+	double *pC = sC->pA + nl*(ci+cj*ldc);
+	double *pD = sD->pA + nl*(di+dj*ldd);
+	d_lane one = d_lane_set1(1.0);
+	d_lane mone = d_lane_set1(-1.0);
+	d_lane sq, inv, mone_inv;
+	int jj;
+	// left-looking, column jj of D
+	for(jj=0; jj<m; jj++)
+		{
+		// diagonal
+		d_compact_gemm(1, 1, jj, &mone, pD+nl*jj, nl, nl*ldd, pD+nl*jj, nl*ldd, 0, &one, pC+nl*(jj+jj*ldc), nl, 0, pD+nl*(jj+jj*ldd), nl, 0);
+		d_lane_sqrt_inv(d_lane_load(pD+nl*(jj+jj*ldd)), &sq, &inv);
+		d_lane_store(pD+nl*(jj+jj*ldd), sq);
+		// below diagonal
+		mone_inv = d_lane_mul(mone, inv);
+		d_compact_gemm(m-jj-1, 1, jj, &mone_inv, pD+nl*(jj+1), nl, nl*ldd, pD+nl*jj, nl*ldd, 0, &inv, pC+nl*(jj+1+jj*ldc), nl, 0, pD+nl*(jj+1+jj*ldd), nl, 0);
+		}
+	return;
+	}
+
+
+
+// D <= lu( C ) ; no pivoting
+void blasfeo_dgetrf_np_compact(int m, int n, struct blasfeo_dmat_batch *sC, int ci, int cj, struct blasfeo_dmat_batch *sD, int di, int dj)
+	{
+	if(m<=0 | n<=0)
+		return;
+	const int nl = BLASFEO_DMAT_BATCH_LANES;
+	int ldc = sC->m;
+	int ldd = sD->m;
+	double *pC = sC->pA + nl*(ci+cj*ldc);
+	double *pD = sD->pA + nl*(di+dj*ldd);
+	d_lane one = d_lane_set1(1.0);
+	d_lane mone = d_lane_set1(-1.0);
+	d_lane inv, mone_inv;
+	int ii, jj;
+	int mmn = m<n ? m : n;
+	// left-looking (Crout), column jj of D
+	for(jj=0; jj<n; jj++)
+		{
+		// upper part: forward substitution with the unit lower factor
+		for(ii=0; ii<jj & ii<m; ii++)
+			{
+			d_compact_gemm(1, 1, ii, &mone, pD+nl*ii, nl, nl*ldd, pD+nl*jj*ldd, nl, 0, &one, pC+nl*(ii+jj*ldc), nl, 0, pD+nl*(ii+jj*ldd), nl, 0);
+			}
+		if(jj<mmn)
+			{
+			// diagonal
+			d_compact_gemm(1, 1, jj, &mone, pD+nl*jj, nl, nl*ldd, pD+nl*jj*ldd, nl, 0, &one, pC+nl*(jj+jj*ldc), nl, 0, pD+nl*(jj+jj*ldd), nl, 0);
+			inv = d_lane_inv(d_lane_load(pD+nl*(jj+jj*ldd)));
+			// below diagonal
+			mone_inv = d_lane_mul(mone, inv);
+			d_compact_gemm(m-jj-1, 1, jj, &mone_inv, pD+nl*(jj+1), nl, nl*ldd, pD+nl*jj*ldd, nl, 0, &inv, pC+nl*(jj+1+jj*ldc), nl, 0, pD+nl*(jj+1+jj*ldd), nl, 0);
+			}
+		}
+	return;
+	}
@@ -0,0 +1,204 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "../include/blasfeo_common.h"
+#include "../include/blasfeo_d_aux.h"
+#include "../include/blasfeo_d_blasfeo_api.h"
+
+
+
+// refactorization of the trailing part of a matrix whose leading rows and columns did not change: the first k columns of L
+// (and the first k rows of U) in D are kept, only the Schur complement of the trailing block is formed and factorized.
+// The high-performance factorizations only support zero row offsets, so the trailing blocks are factorized in the work
+// space and copied back
+
+
+
+static int d_lapack_from_size_align(int size)
+	{
+	return (size+63)/64*64;
+	}
+
+
+
+int blasfeo_dpotrf_l_from_worksize(int m, int k)
+	{
+#if defined(LA_HIGH_PERFORMANCE)
+	if(k<0)
+		k = 0;
+	int m2 = m-k;
+	if(m2<=0)
+		return 0;
+	int size = 64; // alignment
+	size += d_lapack_from_size_align(blasfeo_memsize_dmat(m2, k));
+	size += d_lapack_from_size_align(blasfeo_memsize_dmat(m2, m2));
+	return size;
+#else
+	return 0;
+#endif
+	}
+
+
+
+void blasfeo_dpotrf_l_from(int m, int k, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work)
+	{
+
+	// k==0 is a full factorization, still done in the work space for any row offset
+	if(k<0)
+		k = 0;
+
+	int m2 = m-k;
+	if(m2<=0)
+		return;
+
+#if defined(LA_HIGH_PERFORMANCE)
+
+	struct blasfeo_dmat sL21, sL22;
+	char *c_ptr = (char *) work;
+	c_ptr = (char *) ((((size_t) c_ptr)+63)/64*64);
+	blasfeo_create_dmat(m2, k, &sL21, c_ptr);
+	c_ptr += d_lapack_from_size_align(blasfeo_memsize_dmat(m2, k));
+	blasfeo_create_dmat(m2, m2, &sL22, c_ptr);
+
+	// L22 <= chol( C22 - L21 * L21^T )
+	blasfeo_dtrcp_l(m2, sC, ci+k, cj+k, &sL22, 0, 0);
+	if(k>0)
+		{
+		blasfeo_dgecp(m2, k, sD, di+k, dj, &sL21, 0, 0);
+		blasfeo_dsyrk_ln(m2, k, -1.0, &sL21, 0, 0, &sL21, 0, 0, 1.0, &sL22, 0, 0, &sL22, 0, 0);
+		}
+	blasfeo_dpotrf_l(m2, &sL22, 0, 0, &sL22, 0, 0);
+	blasfeo_dtrcp_l(m2, &sL22, 0, 0, sD, di+k, dj+k);
+
+#else
+
+	// L22 <= chol( C22 - L21 * L21^T )
+	if(k>0)
+		{
+		blasfeo_dsyrk_ln(m2, k, -1.0, sD, di+k, dj, sD, di+k, dj, 1.0, sC, ci+k, cj+k, sD, di+k, dj+k);
+		blasfeo_dpotrf_l(m2, sD, di+k, dj+k, sD, di+k, dj+k);
+		}
+	else
+		blasfeo_dpotrf_l(m2, sC, ci, cj, sD, di, dj);
+
+#endif
+
+	// only part of the stored inverse diagonal would be valid
+	sD->use_dA = 0;
+
+	return;
+
+	}
+
+
+
+int blasfeo_dgetrf_np_from_worksize(int m, int n, int k)
+	{
+#if defined(LA_HIGH_PERFORMANCE)
+	if(k<0)
+		k = 0;
+	int m2 = m-k;
+	int n2 = n-k;
+	if(m2<=0 | n2<=0)
+		return 0;
+	int size = 64; // alignment
+	size += d_lapack_from_size_align(blasfeo_memsize_dmat(m2, k));
+	size += d_lapack_from_size_align(blasfeo_memsize_dmat(k, n2));
+	size += d_lapack_from_size_align(blasfeo_memsize_dmat(m2, n2));
+	return size;
+#else
+	return 0;
+#endif
+	}
+
+
+
+void blasfeo_dgetrf_np_from(int m, int n, int k, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work)
+	{
+
+	// k==0 is a full factorization, still done in the work space for any row offset
+	if(k<0)
+		k = 0;
+
+	int m2 = m-k;
+	int n2 = n-k;
+	if(m2<=0 | n2<=0)
+		return;
+
+#if defined(LA_HIGH_PERFORMANCE)
+
+	struct blasfeo_dmat sL21, sU12, sLU22;
+	char *c_ptr = (char *) work;
+	c_ptr = (char *) ((((size_t) c_ptr)+63)/64*64);
+	blasfeo_create_dmat(m2, k, &sL21, c_ptr);
+	c_ptr += d_lapack_from_size_align(blasfeo_memsize_dmat(m2, k));
+	blasfeo_create_dmat(k, n2, &sU12, c_ptr);
+	c_ptr += d_lapack_from_size_align(blasfeo_memsize_dmat(k, n2));
+	blasfeo_create_dmat(m2, n2, &sLU22, c_ptr);
+
+	// L22 * U22 <= C22 - L21 * U12
+	blasfeo_dgecp(m2, n2, sC, ci+k, cj+k, &sLU22, 0, 0);
+	if(k>0)
+		{
+		blasfeo_dgecp(m2, k, sD, di+k, dj, &sL21, 0, 0);
+		blasfeo_dgecp(k, n2, sD, di, dj+k, &sU12, 0, 0);
+		blasfeo_dgemm_nn(m2, n2, k, -1.0, &sL21, 0, 0, &sU12, 0, 0, 1.0, &sLU22, 0, 0, &sLU22, 0, 0);
+		}
+	blasfeo_dgetrf_np(m2, n2, &sLU22, 0, 0, &sLU22, 0, 0);
+	blasfeo_dgecp(m2, n2, &sLU22, 0, 0, sD, di+k, dj+k);
+
+#else
+
+	// L22 * U22 <= C22 - L21 * U12
+	if(k>0)
+		{
+		blasfeo_dgemm_nn(m2, n2, k, -1.0, sD, di+k, dj, sD, di, dj+k, 1.0, sC, ci+k, cj+k, sD, di+k, dj+k);
+		blasfeo_dgetrf_np(m2, n2, sD, di+k, dj+k, sD, di+k, dj+k);
+		}
+	else
+		blasfeo_dgetrf_np(m2, n2, sC, ci, cj, sD, di, dj);
+
+#endif
+
+	// only part of the stored inverse diagonal would be valid
+	sD->use_dA = 0;
+
+	return;
+
+	}
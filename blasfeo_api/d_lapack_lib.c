@@ -91,3 +91,42 @@
 
 
 #include "x_lapack_lib.c"
+
+
+
+// multi-threaded factorizations: serial in this implementation
+int blasfeo_dpotrf_l_mt_worksize(int m, int n)
+	{
+	return 0;
+	}
+
+
+
+void blasfeo_dpotrf_l_mt(int m, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work)
+	{
+	blasfeo_dpotrf_l(m, sC, ci, cj, sD, di, dj);
+	return;
+	}
+
+
+
+void blasfeo_dpotrf_l_mn_mt(int m, int n, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work)
+	{
+	blasfeo_dpotrf_l_mn(m, n, sC, ci, cj, sD, di, dj);
+	return;
+	}
+
+
+
+int blasfeo_dgetrf_rp_mt_worksize(int m, int n)
+	{
+	return 0;
+	}
+
+
+
+void blasfeo_dgetrf_rp_mt(int m, int n, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, int *ipiv, void *work)
+	{
+	blasfeo_dgetrf_rp(m, n, sC, ci, cj, sD, di, dj, ipiv);
+	return;
+	}
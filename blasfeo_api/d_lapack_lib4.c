@@ -41,6 +41,8 @@
 #include "../include/blasfeo_d_aux.h"
 #include "../include/blasfeo_d_kernel.h"
 #include "../include/blasfeo_d_blasfeo_api.h"
+#include "../include/blasfeo_stdlib.h"
+#include "../include/blasfeo_thread.h"
 
 
 
@@ -911,6 +913,323 @@ void dlauum_dpotrf_blk_nt_l_lib(int m, int n, int nv, int *rv, int *cv, double *
 
 
 
+#if defined(MULTI_THREAD) & !defined(TARGET_X86_AMD_BARCELONA)
+
+// minimum tile size (multiple of 24, i.e. of all kernel heights)
+#define D_POTRF_MT_NB 96
+// maximum number of tiles per side
+#define D_POTRF_MT_MAX_TILE 48
+
+#if defined(TARGET_X64_INTEL_HASWELL) || defined(TARGET_ARMV8A_ARM_CORTEX_A53)
+#define D_POTRF_MT_M_KERNEL 12
+#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE) || defined(TARGET_ARMV8A_ARM_CORTEX_A57)
+#define D_POTRF_MT_M_KERNEL 8
+#else
+#define D_POTRF_MT_M_KERNEL 4
+#endif
+
+struct d_potrf_l_mt_arg
+	{
+	double *pC;
+	double *pD;
+	double *dD;
+	int sdc;
+	int sdd;
+	int m;
+	int n;
+	int nb; // tile size
+	int n_f; // number of final tasks
+	int *task; // tile row, tile col and (for updates) tile col of the inner product of each task
+	};
+
+
+
+// D[i0:i1,j0:j1] = C[i0:i1,j0:j1] - D[i0:i1,k0:k0+nb] * D[j0:j1,k0:k0+nb]^T, lower triangle only if i0==j0
+static void d_potrf_l_mt_update(struct d_potrf_l_mt_arg *arg, int i0, int i1, int j0, int j1, int k0)
+	{
+	const int ps = 4;
+	double alpha = -1.0;
+	double beta = 1.0;
+	int sdd = arg->sdd;
+	int kmax = arg->nb;
+	double *pD = arg->pD;
+	double *pA = pD + k0*ps;
+	// first update of the tile reads from C
+	int sdc = k0==0 ? arg->sdc : sdd;
+	double *pC = k0==0 ? arg->pC : pD;
+	int i, j, r;
+	for(i=i0; i<i1; i+=D_POTRF_MT_M_KERNEL)
+		{
+		r = i1-i;
+		for(j=j0; j<j1 & j<i; j+=4)
+			{
+#if defined(TARGET_X64_INTEL_HASWELL) || defined(TARGET_ARMV8A_ARM_CORTEX_A53)
+			if(r>=12 & j1-j>=4)
+				kernel_dgemm_nt_12x4_lib4(kmax, &alpha, &pA[i*sdd], sdd, &pA[j*sdd], &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd);
+			else if(r>8)
+				kernel_dgemm_nt_12x4_vs_lib4(kmax, &alpha, &pA[i*sdd], sdd, &pA[j*sdd], &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, r, j1-j);
+			else
+#endif
+#if defined(TARGET_X64_INTEL_HASWELL) || defined(TARGET_ARMV8A_ARM_CORTEX_A53) || defined(TARGET_X64_INTEL_SANDY_BRIDGE) || defined(TARGET_ARMV8A_ARM_CORTEX_A57)
+			if(r>=8 & j1-j>=4 & D_POTRF_MT_M_KERNEL==8)
+				kernel_dgemm_nt_8x4_lib4(kmax, &alpha, &pA[i*sdd], sdd, &pA[j*sdd], &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd);
+			else if(r>4)
+				kernel_dgemm_nt_8x4_vs_lib4(kmax, &alpha, &pA[i*sdd], sdd, &pA[j*sdd], &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, r, j1-j);
+			else
+#endif
+			if(r>=4 & j1-j>=4)
+				kernel_dgemm_nt_4x4_lib4(kmax, &alpha, &pA[i*sdd], &pA[j*sdd], &beta, &pC[j*ps+i*sdc], &pD[j*ps+i*sdd]);
+			else
+				kernel_dgemm_nt_4x4_vs_lib4(kmax, &alpha, &pA[i*sdd], &pA[j*sdd], &beta, &pC[j*ps+i*sdc], &pD[j*ps+i*sdd], r, j1-j);
+			}
+		// diagonal blocks of the row panel
+		for(; j<j1 & j<i+D_POTRF_MT_M_KERNEL; j+=4)
+			{
+			r = i1-j;
+#if defined(TARGET_X64_INTEL_HASWELL) || defined(TARGET_ARMV8A_ARM_CORTEX_A53)
+			if(r>8 & j==i)
+				kernel_dsyrk_nt_l_12x4_vs_lib4(kmax, &alpha, &pA[j*sdd], sdd, &pA[j*sdd], &beta, &pC[j*ps+j*sdc], sdc, &pD[j*ps+j*sdd], sdd, r, j1-j);
+			else
+#endif
+#if defined(TARGET_X64_INTEL_HASWELL) || defined(TARGET_ARMV8A_ARM_CORTEX_A53) || defined(TARGET_X64_INTEL_SANDY_BRIDGE) || defined(TARGET_ARMV8A_ARM_CORTEX_A57)
+			if(r>4 & j<i+D_POTRF_MT_M_KERNEL-4)
+				kernel_dsyrk_nt_l_8x4_vs_lib4(kmax, &alpha, &pA[j*sdd], sdd, &pA[j*sdd], &beta, &pC[j*ps+j*sdc], sdc, &pD[j*ps+j*sdd], sdd, r, j1-j);
+			else
+#endif
+				kernel_dsyrk_nt_l_4x4_vs_lib4(kmax, &alpha, &pA[j*sdd], &pA[j*sdd], &beta, &pC[j*ps+j*sdc], &pD[j*ps+j*sdd], r, j1-j);
+			}
+		}
+	return;
+	}
+
+
+
+// final step of the tile D[i0:i1,j0:j1]: fused update with the columns k0:j, followed by
+// dtrsm with the diagonal tile (or dpotrf if the tile is the diagonal one)
+static void d_potrf_l_mt_final(struct d_potrf_l_mt_arg *arg, int i0, int i1, int j0, int j1, int k0)
+	{
+	const int ps = 4;
+	double alpha = 1.0;
+	int sdd = arg->sdd;
+	double *pD = arg->pD;
+	double *dD = arg->dD;
+	double *pA = pD + k0*ps;
+	// tiles without previous updates read from C
+	int sdc = k0==0 ? arg->sdc : sdd;
+	double *pC = k0==0 ? arg->pC : pD;
+	int i, j, r;
+	for(i=i0; i<i1; i+=D_POTRF_MT_M_KERNEL)
+		{
+		r = i1-i;
+		for(j=j0; j<j1 & j<i; j+=4)
+			{
+#if defined(TARGET_X64_INTEL_HASWELL) || defined(TARGET_ARMV8A_ARM_CORTEX_A53)
+			if(r>=12 & j1-j>=4)
+				kernel_dtrsm_nt_rl_inv_12x4_lib4(j-k0, &pA[i*sdd], sdd, &pA[j*sdd], &alpha, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, &pD[j*ps+j*sdd], &dD[j]);
+			else if(r>8)
+				kernel_dtrsm_nt_rl_inv_12x4_vs_lib4(j-k0, &pA[i*sdd], sdd, &pA[j*sdd], &alpha, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, &pD[j*ps+j*sdd], &dD[j], r, j1-j);
+			else
+#endif
+#if defined(TARGET_X64_INTEL_HASWELL) || defined(TARGET_ARMV8A_ARM_CORTEX_A53) || defined(TARGET_X64_INTEL_SANDY_BRIDGE) || defined(TARGET_ARMV8A_ARM_CORTEX_A57)
+			if(r>=8 & j1-j>=4 & D_POTRF_MT_M_KERNEL==8)
+				kernel_dtrsm_nt_rl_inv_8x4_lib4(j-k0, &pA[i*sdd], sdd, &pA[j*sdd], &alpha, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, &pD[j*ps+j*sdd], &dD[j]);
+			else if(r>4)
+				kernel_dtrsm_nt_rl_inv_8x4_vs_lib4(j-k0, &pA[i*sdd], sdd, &pA[j*sdd], &alpha, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, &pD[j*ps+j*sdd], &dD[j], r, j1-j);
+			else
+#endif
+			if(r>=4 & j1-j>=4)
+				kernel_dtrsm_nt_rl_inv_4x4_lib4(j-k0, &pA[i*sdd], &pA[j*sdd], &alpha, &pC[j*ps+i*sdc], &pD[j*ps+i*sdd], &pD[j*ps+j*sdd], &dD[j]);
+			else
+				kernel_dtrsm_nt_rl_inv_4x4_vs_lib4(j-k0, &pA[i*sdd], &pA[j*sdd], &alpha, &pC[j*ps+i*sdc], &pD[j*ps+i*sdd], &pD[j*ps+j*sdd], &dD[j], r, j1-j);
+			}
+		// diagonal blocks of the row panel
+		for(; j<j1 & j<i+D_POTRF_MT_M_KERNEL; j+=4)
+			{
+			r = i1-j;
+#if defined(TARGET_X64_INTEL_HASWELL) || defined(TARGET_ARMV8A_ARM_CORTEX_A53)
+			if(r>8 & j==i)
+				kernel_dpotrf_nt_l_12x4_vs_lib4(j-k0, &pA[j*sdd], sdd, &pA[j*sdd], &pC[j*ps+j*sdc], sdc, &pD[j*ps+j*sdd], sdd, &dD[j], r, j1-j);
+			else
+#endif
+#if defined(TARGET_X64_INTEL_HASWELL) || defined(TARGET_ARMV8A_ARM_CORTEX_A53) || defined(TARGET_X64_INTEL_SANDY_BRIDGE) || defined(TARGET_ARMV8A_ARM_CORTEX_A57)
+			if(r>4 & j<i+D_POTRF_MT_M_KERNEL-4)
+				kernel_dpotrf_nt_l_8x4_vs_lib4(j-k0, &pA[j*sdd], sdd, &pA[j*sdd], &pC[j*ps+j*sdc], sdc, &pD[j*ps+j*sdd], sdd, &dD[j], r, j1-j);
+			else
+#endif
+				kernel_dpotrf_nt_l_4x4_vs_lib4(j-k0, &pA[j*sdd], &pA[j*sdd], &pC[j*ps+j*sdc], &pD[j*ps+j*sdd], &dD[j], r, j1-j);
+			}
+		}
+	return;
+	}
+
+
+
+static void d_potrf_l_mt_task(void *ptr, int task_id)
+	{
+	struct d_potrf_l_mt_arg *arg = ptr;
+	int nb = arg->nb;
+	int ti = arg->task[3*task_id+0];
+	int tj = arg->task[3*task_id+1];
+	int tk = arg->task[3*task_id+2];
+	int i0 = ti*nb;
+	int i1 = i0+nb<arg->m ? i0+nb : arg->m;
+	int j0 = tj*nb;
+	int j1 = j0+nb<arg->n ? j0+nb : arg->n;
+	if(task_id<arg->n_f)
+		// the final step also applies the last update (from the previous tile col)
+		d_potrf_l_mt_final(arg, i0, i1, j0, j1, tj>0 ? j0-nb : 0);
+	else
+		d_potrf_l_mt_update(arg, i0, i1, j0, j1, tk*nb);
+	return;
+	}
+
+
+
+// tile size and number of tasks of the tiled factorization; return 0 if the matrix is too small to be worth it
+static int d_potrf_l_mt_tiles(int m, int n, int *nb_out, int *mt_out, int *nt_out, int *n_f_out, int *n_task_out)
+	{
+	if(n<2*D_POTRF_MT_NB | m<n)
+		return 0;
+
+	// tile size: multiple of all kernel heights, large enough to bound the number of tasks
+	int nb = (n+D_POTRF_MT_MAX_TILE-1)/D_POTRF_MT_MAX_TILE;
+	nb = nb<D_POTRF_MT_NB ? D_POTRF_MT_NB : (nb+23)/24*24;
+	int mt = (m+nb-1)/nb; // tile rows
+	int nt = (n+nb-1)/nb; // tile cols
+
+	// tasks: final step F(i,j) of each tile, and update U(i,j,k) of tile (i,j) with tile col k, for k<j-1
+	int n_f = 0;
+	int n_u = 0;
+	int jj;
+	for(jj=0; jj<nt; jj++)
+		{
+		n_f += mt-jj;
+		n_u += jj>1 ? (mt-jj)*(jj-1) : 0;
+		}
+
+	*nb_out = nb;
+	*mt_out = mt;
+	*nt_out = nt;
+	*n_f_out = n_f;
+	*n_task_out = n_f+n_u;
+	return 1;
+	}
+
+
+
+static int d_potrf_l_mt_memsize(int m, int n)
+	{
+	int nb, mt, nt, n_f, n_task;
+	if(!d_potrf_l_mt_tiles(m, n, &nb, &mt, &nt, &n_f, &n_task))
+		return 0;
+	// tile ids, task graph (at most 4 predecessors per task), and scheduler
+	return (2*mt*nt+9*n_task+1)*sizeof(int) + blasfeo_thread_dag_memsize(n_task, 4*n_task);
+	}
+
+
+
+// tiled right-looking factorization, with tile tasks scheduled over the thread pool according to their dependencies;
+// return 0 (and do nothing) if single-threaded or if the matrix is too small to be worth it
+static int d_potrf_l_mt(int m, int n, double *pC, int sdc, double *pD, int sdd, double *dD, void *work)
+	{
+	int nb, mt, nt, n_f, n_task;
+	if(blasfeo_thread_pool_num_threads()<=1 | work==NULL)
+		return 0;
+	if(!d_potrf_l_mt_tiles(m, n, &nb, &mt, &nt, &n_f, &n_task))
+		return 0;
+
+	int ii, jj, kk;
+
+	int *f_id = work; // id of F(i,j)
+	int *u_id = f_id+mt*nt; // id of U(i,j,0), followed by U(i,j,1), ...
+	int *task = u_id+mt*nt;
+	int *prio = task+3*n_task;
+	int *pred_idx = prio+n_task;
+	int *pred = pred_idx+n_task+1;
+	void *dag_work = pred+4*n_task;
+
+	int id = 0;
+	for(jj=0; jj<nt; jj++)
+		{
+		for(ii=jj; ii<mt; ii++)
+			{
+			f_id[ii+jj*mt] = id;
+			task[3*id+0] = ii;
+			task[3*id+1] = jj;
+			task[3*id+2] = jj;
+			// critical path first: diagonal tile, then the tiles below it
+			prio[id] = ii==jj ? 3*jj : 3*jj+1;
+			id++;
+			}
+		}
+	for(jj=2; jj<nt; jj++)
+		{
+		for(ii=jj; ii<mt; ii++)
+			{
+			u_id[ii+jj*mt] = id;
+			for(kk=0; kk<jj-1; kk++)
+				{
+				task[3*id+0] = ii;
+				task[3*id+1] = jj;
+				task[3*id+2] = kk;
+				prio[id] = 3*kk+2;
+				id++;
+				}
+			}
+		}
+
+	int n_pred = 0;
+	for(id=0; id<n_task; id++)
+		{
+		pred_idx[id] = n_pred;
+		ii = task[3*id+0];
+		jj = task[3*id+1];
+		kk = task[3*id+2];
+		if(id<n_f)
+			{
+			if(ii>jj)
+				pred[n_pred++] = f_id[jj+jj*mt];
+			if(jj>0)
+				{
+				pred[n_pred++] = f_id[ii+(jj-1)*mt];
+				if(ii>jj)
+					pred[n_pred++] = f_id[jj+(jj-1)*mt];
+				}
+			if(jj>1)
+				pred[n_pred++] = u_id[ii+jj*mt]+jj-2;
+			}
+		else
+			{
+			pred[n_pred++] = f_id[ii+kk*mt];
+			if(ii>jj)
+				pred[n_pred++] = f_id[jj+kk*mt];
+			if(kk>0)
+				pred[n_pred++] = id-1;
+			}
+		}
+	pred_idx[n_task] = n_pred;
+
+	struct d_potrf_l_mt_arg arg;
+	arg.pC = pC;
+	arg.pD = pD;
+	arg.dD = dD;
+	arg.sdc = sdc;
+	arg.sdd = sdd;
+	arg.m = m;
+	arg.n = n;
+	arg.nb = nb;
+	arg.n_f = n_f;
+	arg.task = task;
+
+	blasfeo_thread_dag_run(n_task, pred_idx, pred, prio, &d_potrf_l_mt_task, &arg, dag_work);
+
+	return 1;
+	}
+
+#endif
+
+
+
 // dpotrf
 void blasfeo_dpotrf_l(int m, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
 	{
@@ -939,6 +1258,18 @@ void blasfeo_dpotrf_l(int m, struct blasfeo_dmat *sC, int ci, int cj, struct bla
 	else
 		sD->use_dA = 0;
 
+#if defined(MULTI_THREAD) & !defined(TARGET_X86_AMD_BARCELONA) & defined(EXT_DEP)
+	// multi-threaded factorization, with the work space allocated here (see blasfeo_dpotrf_l_mt)
+	int mt_size = blasfeo_thread_pool_num_threads()>1 ? d_potrf_l_mt_memsize(m, m) : 0;
+	if(mt_size>0)
+		{
+		void *mt_mem = malloc(mt_size);
+		d_potrf_l_mt(m, m, pC, sdc, pD, sdd, dD, mt_mem);
+		free(mt_mem);
+		return;
+		}
+#endif
+
 	int i, j, l;
 
 	i = 0;
@@ -1169,6 +1500,18 @@ void blasfeo_dpotrf_l_mn(int m, int n, struct blasfeo_dmat *sC, int ci, int cj,
 	else
 		sD->use_dA = 0;
 
+#if defined(MULTI_THREAD) & !defined(TARGET_X86_AMD_BARCELONA) & defined(EXT_DEP)
+	// multi-threaded factorization, with the work space allocated here (see blasfeo_dpotrf_l_mn_mt)
+	int mt_size = blasfeo_thread_pool_num_threads()>1 ? d_potrf_l_mt_memsize(m, n) : 0;
+	if(mt_size>0)
+		{
+		void *mt_mem = malloc(mt_size);
+		d_potrf_l_mt(m, n, pC, sdc, pD, sdd, dD, mt_mem);
+		free(mt_mem);
+		return;
+		}
+#endif
+
 	int i, j, l;
 
 	i = 0;
@@ -1800,6 +2143,56 @@ void blasfeo_dsyrk_dpotrf_ln_mn(int m, int n, int k, struct blasfeo_dmat *sA, in
 
 
 
+// dpotrf multi-threaded, with the work space of the task scheduler provided by the caller
+int blasfeo_dpotrf_l_mt_worksize(int m, int n)
+	{
+#if defined(MULTI_THREAD) & !defined(TARGET_X86_AMD_BARCELONA)
+	return d_potrf_l_mt_memsize(m, n);
+#else
+	return 0;
+#endif
+	}
+
+
+
+void blasfeo_dpotrf_l_mt(int m, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work)
+	{
+#if defined(MULTI_THREAD) & !defined(TARGET_X86_AMD_BARCELONA)
+	const int ps = 4;
+	if(m>0 & ci==0 & di==0)
+		{
+		if(d_potrf_l_mt(m, m, sC->pA+cj*ps, sC->cn, sD->pA+dj*ps, sD->cn, sD->dA, work))
+			{
+			sD->use_dA = dj==0 ? m : 0;
+			return;
+			}
+		}
+#endif
+	blasfeo_dpotrf_l(m, sC, ci, cj, sD, di, dj);
+	return;
+	}
+
+
+
+void blasfeo_dpotrf_l_mn_mt(int m, int n, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work)
+	{
+#if defined(MULTI_THREAD) & !defined(TARGET_X86_AMD_BARCELONA)
+	const int ps = 4;
+	if(m>0 & n>0 & ci==0 & di==0)
+		{
+		if(d_potrf_l_mt(m, n, sC->pA+cj*ps, sC->cn, sD->pA+dj*ps, sD->cn, sD->dA, work))
+			{
+			sD->use_dA = dj==0 ? 1 : 0;
+			return;
+			}
+		}
+#endif
+	blasfeo_dpotrf_l_mn(m, n, sC, ci, cj, sD, di, dj);
+	return;
+	}
+
+
+
 void blasfeo_dsyrk_dpotrf_ln(int m, int k, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
 	{
 //	blasfeo_dsyrk_dpotrf_ln_mn(m, m, k, sA, ai, aj, sB, bi, bj, sC, ci, cj, sD, di, dj);
@@ -2333,6 +2726,286 @@ void blasfeo_dgetrf_np(int m, int n, struct blasfeo_dmat *sC, int ci, int cj, st
 
 
 
+#if defined(MULTI_THREAD)
+
+// block size (multiple of all kernel heights)
+#define D_GETRF_MT_NB 96
+// maximum number of blocks per side
+#define D_GETRF_MT_MAX_BLOCK 48
+// panel width below which the recursive panel factorization calls the serial code
+#define D_GETRF_MT_NB_LEAF 24
+
+struct d_getrf_mt_arg
+	{
+	struct blasfeo_dmat *sD;
+	int *ipiv;
+	int m;
+	int n;
+	int nb; // block size
+	int n_step; // number of panel factorizations
+	int n_p; // number of panel tasks
+	int n_u; // number of update tasks
+	int *task; // block col and step of each update task
+	};
+
+
+
+// view of the sub-matrix starting at (ai, aj), with ai multiple of ps; the inverse diagonal is shifted by ai
+static void d_getrf_mt_view(struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sV)
+	{
+	const int ps = 4;
+	sV->m = sA->m-ai;
+	sV->n = sA->n-aj;
+	sV->pm = sA->pm-ai;
+	sV->cn = sA->cn;
+	sV->pA = sA->pA + ai*sA->cn + aj*ps;
+	sV->dA = sA->dA + ai;
+	sV->use_dA = 0;
+	sV->memsize = 0;
+	return;
+	}
+
+
+
+// recursive factorization of the m x n panel at the top-left of sD
+static void d_getrf_mt_panel(int m, int n, struct blasfeo_dmat *sD, int *ipiv)
+	{
+	int ii, n1, p1;
+	struct blasfeo_dmat sD1;
+	if(n<=D_GETRF_MT_NB_LEAF | m<n)
+		{
+		blasfeo_dgetrf_rp(m, n, sD, 0, 0, sD, 0, 0, ipiv);
+		return;
+		}
+	n1 = n/2/4*4;
+	// left half
+	d_getrf_mt_panel(m, n1, sD, ipiv);
+	for(ii=0; ii<n1; ii++)
+		{
+		if(ipiv[ii]!=ii)
+			blasfeo_drowsw(n-n1, sD, ii, n1, sD, ipiv[ii], n1);
+		}
+	blasfeo_dtrsm_llnu(n1, n-n1, 1.0, sD, 0, 0, sD, 0, n1, sD, 0, n1);
+	blasfeo_dgemm_nn(m-n1, n-n1, n1, -1.0, sD, n1, 0, sD, 0, n1, 1.0, sD, n1, n1, sD, n1, n1);
+	// right half
+	d_getrf_mt_view(sD, n1, n1, &sD1);
+	d_getrf_mt_panel(m-n1, n-n1, &sD1, ipiv+n1);
+	p1 = n-n1;
+	for(ii=n1; ii<n1+p1; ii++)
+		{
+		ipiv[ii] += n1;
+		if(ipiv[ii]!=ii)
+			blasfeo_drowsw(n1, sD, ii, 0, sD, ipiv[ii], 0);
+		}
+	return;
+	}
+
+
+
+// apply the row exchanges of step k to the cols j0:j1
+static void d_getrf_mt_swap(struct d_getrf_mt_arg *arg, int k, int j0, int j1)
+	{
+	int nb = arg->nb;
+	int *ipiv = arg->ipiv;
+	int i0 = k*nb;
+	int i1 = i0+nb<arg->m ? i0+nb : arg->m;
+	i1 = i1<arg->n ? i1 : arg->n;
+	int ii;
+	for(ii=i0; ii<i1; ii++)
+		{
+		if(ipiv[ii]!=ii)
+			blasfeo_drowsw(j1-j0, arg->sD, ii, j0, arg->sD, ipiv[ii], j0);
+		}
+	return;
+	}
+
+
+
+static void d_getrf_mt_task(void *ptr, int task_id)
+	{
+	struct d_getrf_mt_arg *arg = ptr;
+	struct blasfeo_dmat *sD = arg->sD;
+	struct blasfeo_dmat sV;
+	int m = arg->m;
+	int n = arg->n;
+	int nb = arg->nb;
+	int k, j, k0, k1, j0, j1, ii;
+	if(task_id<arg->n_p)
+		{
+		// panel factorization of the block col k
+		k = task_id;
+		k0 = k*nb;
+		k1 = k0+nb<n ? k0+nb : n;
+		d_getrf_mt_view(sD, k0, k0, &sV);
+		d_getrf_mt_panel(m-k0, k1-k0, &sV, arg->ipiv+k0);
+		k1 = k1<m ? k1 : m;
+		for(ii=k0; ii<k1; ii++)
+			arg->ipiv[ii] += k0;
+		}
+	else if(task_id<arg->n_p+arg->n_u)
+		{
+		// update of the block col j with the panel k
+		j = arg->task[2*(task_id-arg->n_p)+0];
+		k = arg->task[2*(task_id-arg->n_p)+1];
+		k0 = k*nb;
+		k1 = k0+nb; // full block, since the block col j>k exists
+		j0 = j*nb;
+		j1 = j0+nb<n ? j0+nb : n;
+		d_getrf_mt_swap(arg, k, j0, j1);
+		k1 = k1<m ? k1 : m;
+		d_getrf_mt_view(sD, k0, 0, &sV);
+		blasfeo_dtrsm_llnu(k1-k0, j1-j0, 1.0, &sV, 0, k0, &sV, 0, j0, &sV, 0, j0);
+		if(k1<m)
+			blasfeo_dgemm_nn(m-k1, j1-j0, k1-k0, -1.0, sD, k1, k0, sD, k0, j0, 1.0, sD, k1, j0, sD, k1, j0);
+		}
+	else
+		{
+		// row exchanges of the following steps on the block col j of L
+		j = task_id-arg->n_p-arg->n_u;
+		j0 = j*nb;
+		j1 = j0+nb<n ? j0+nb : n;
+		for(k=j+1; k<arg->n_step; k++)
+			d_getrf_mt_swap(arg, k, j0, j1);
+		}
+	return;
+	}
+
+
+
+// block size and number of tasks of the blocked factorization; return 0 if the matrix is too small to be worth it
+static int d_getrf_rp_mt_blocks(int m, int n, int *nb_out, int *n_step_out, int *n_col_out, int *n_u_out)
+	{
+	int p = m<n ? m : n;
+	if(p<2*D_GETRF_MT_NB)
+		return 0;
+
+	int nb = (n+D_GETRF_MT_MAX_BLOCK-1)/D_GETRF_MT_MAX_BLOCK;
+	nb = nb<D_GETRF_MT_NB ? D_GETRF_MT_NB : (nb+23)/24*24;
+	int n_step = (p+nb-1)/nb; // panels
+	int n_col = (n+nb-1)/nb; // block cols
+
+	int n_u = 0;
+	int kk;
+	for(kk=0; kk<n_step; kk++)
+		n_u += n_col-kk-1;
+
+	*nb_out = nb;
+	*n_step_out = n_step;
+	*n_col_out = n_col;
+	*n_u_out = n_u;
+	return 1;
+	}
+
+
+
+static int d_getrf_rp_mt_memsize(int m, int n)
+	{
+	int nb, n_step, n_col, n_u;
+	if(!d_getrf_rp_mt_blocks(m, n, &nb, &n_step, &n_col, &n_u))
+		return 0;
+	int n_task = n_step+n_u+n_step-1;
+	int n_edge = n_step+3*n_u+n_step-1;
+	// update task ids, task graph, and scheduler
+	return (n_col*n_step+2*n_u+2*n_task+1+n_edge)*sizeof(int) + blasfeo_thread_dag_memsize(n_task, n_edge);
+	}
+
+
+
+// right-looking blocked factorization with recursive panels, with tasks scheduled over the thread pool
+// according to their dependencies (the panel of the next step is factorized as soon as it is updated,
+// overlapped with the rest of the trailing update); return 0 (and do nothing) if single-threaded or if
+// the matrix is too small
+static int d_getrf_rp_mt(int m, int n, struct blasfeo_dmat *sD, int dj, int *ipiv, void *work)
+	{
+	int nb, n_step, n_col, n_u;
+	if(blasfeo_thread_pool_num_threads()<=1 | work==NULL)
+		return 0;
+	if(!d_getrf_rp_mt_blocks(m, n, &nb, &n_step, &n_col, &n_u))
+		return 0;
+
+	// tasks: panel P(k), update U(j,k) of block col j>k with panel k, row exchanges S(j) on block col j<n_step-1 of L
+	int n_p = n_step;
+	int n_s = n_step-1;
+	int jj, kk;
+	int n_task = n_p+n_u+n_s;
+
+	int *u_id = work; // id of U(j,k)
+	int *task = u_id+n_col*n_step;
+	int *prio = task+2*n_u;
+	int *pred_idx = prio+n_task;
+	int *pred = pred_idx+n_task+1;
+	void *dag_work = pred+n_p+3*n_u+n_s;
+
+	int id = n_p;
+	for(kk=0; kk<n_step; kk++)
+		{
+		for(jj=kk+1; jj<n_col; jj++)
+			{
+			u_id[jj+kk*n_col] = id;
+			task[2*(id-n_p)+0] = jj;
+			task[2*(id-n_p)+1] = kk;
+			id++;
+			}
+		}
+
+	int n_pred = 0;
+	for(id=0; id<n_task; id++)
+		{
+		pred_idx[id] = n_pred;
+		if(id<n_p)
+			{
+			kk = id;
+			// critical path: panel, then update of the next panel (look-ahead), then the rest
+			prio[id] = 3*kk;
+			if(kk>0)
+				pred[n_pred++] = u_id[kk+(kk-1)*n_col];
+			}
+		else if(id<n_p+n_u)
+			{
+			jj = task[2*(id-n_p)+0];
+			kk = task[2*(id-n_p)+1];
+			prio[id] = jj==kk+1 ? 3*kk+1 : 3*kk+2;
+			pred[n_pred++] = kk;
+			if(kk>0)
+				pred[n_pred++] = u_id[jj+(kk-1)*n_col];
+			}
+		else
+			{
+			// after the last panel (all pivots known) and after the updates reading the block col
+			jj = id-n_p-n_u;
+			prio[id] = 3*n_step;
+			pred[n_pred++] = n_p-1;
+			for(kk=jj+1; kk<n_col; kk++)
+				pred[n_pred++] = u_id[kk+jj*n_col];
+			}
+		}
+	pred_idx[n_task] = n_pred;
+
+	struct blasfeo_dmat sD0;
+	d_getrf_mt_view(sD, 0, dj, &sD0);
+	sD0.m = m;
+	sD0.n = n;
+
+	struct d_getrf_mt_arg arg;
+	arg.sD = &sD0;
+	arg.ipiv = ipiv;
+	arg.m = m;
+	arg.n = n;
+	arg.nb = nb;
+	arg.n_step = n_step;
+	arg.n_p = n_p;
+	arg.n_u = n_u;
+	arg.task = task;
+
+	blasfeo_thread_dag_run(n_task, pred_idx, pred, prio, &d_getrf_mt_task, &arg, dag_work);
+
+	return 1;
+	}
+
+#endif
+
+
+
 // dgetrf row pivoting
 void blasfeo_dgetrf_rp(int m, int n, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, int *ipiv)
 	{
@@ -2368,6 +3041,20 @@ void blasfeo_dgetrf_rp(int m, int n, struct blasfeo_dmat *sC, int ci, int cj, st
 	if(pC!=pD)
 		blasfeo_dgecp(m, n, sC, ci, cj, sD, di, dj);
 
+#if defined(MULTI_THREAD) & defined(EXT_DEP)
+	// multi-threaded factorization, with the work space allocated here (see blasfeo_dgetrf_rp_mt)
+	int mt_size = blasfeo_thread_pool_num_threads()>1 ? d_getrf_rp_mt_memsize(m, n) : 0;
+	if(mt_size>0)
+		{
+		void *mt_mem = malloc(mt_size);
+		d_getrf_rp_mt(m, n, sD, dj, ipiv, mt_mem);
+		free(mt_mem);
+		// the sub-routines on sD invalidate the stored inverse diagonal
+		sD->use_dA = di==0 & dj==0;
+		return;
+		}
+#endif
+
 	// minimum matrix size
 	p = n<m ? n : m; // XXX
 
@@ -3364,6 +4051,43 @@ void blasfeo_dgetrf_rp(int m, int n, struct blasfeo_dmat *sC, int ci, int cj, st
 
 
 
+// dgetrf row pivoting multi-threaded, with the work space of the task scheduler provided by the caller
+int blasfeo_dgetrf_rp_mt_worksize(int m, int n)
+	{
+#if defined(MULTI_THREAD)
+	return d_getrf_rp_mt_memsize(m, n);
+#else
+	return 0;
+#endif
+	}
+
+
+
+void blasfeo_dgetrf_rp_mt(int m, int n, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, int *ipiv, void *work)
+	{
+#if defined(MULTI_THREAD)
+	if(m>0 & n>0 & ci==0 & di==0)
+		{
+		// needs to perform row-excanges on the yet-to-be-factorized matrix too
+		if(&(BLASFEO_DMATEL(sC,ci,cj))!=&(BLASFEO_DMATEL(sD,di,dj)))
+			blasfeo_dgecp(m, n, sC, ci, cj, sD, di, dj);
+		if(d_getrf_rp_mt(m, n, sD, dj, ipiv, work))
+			{
+			// the sub-routines on sD invalidate the stored inverse diagonal
+			sD->use_dA = dj==0;
+			return;
+			}
+		// serial factorization, in place since sD already holds C
+		blasfeo_dgetrf_rp(m, n, sD, di, dj, sD, di, dj, ipiv);
+		return;
+		}
+#endif
+	blasfeo_dgetrf_rp(m, n, sC, ci, cj, sD, di, dj, ipiv);
+	return;
+	}
+
+
+
 int blasfeo_dgeqrf_worksize(int m, int n)
 	{
 	const int ps = 4;
@@ -3452,6 +4176,547 @@ void blasfeo_dgeqrf(int m, int n, struct blasfeo_dmat *sC, int ci, int cj, struc
 
 
 
+// tall-skinny QR (TSQR): the rows are split in blocks factorized independently (in parallel with MULTI_THREAD),
+// and the R factors of the blocks are combined pairwise in a binary tree.
+// The Householder vectors of row block b are stored below the diagonal of its rows (tau in sT at b*n),
+// the ones of the tree node merging block j into block i are upper triangular and are stored
+// in the top (n)x(n) upper triangle of block j, in place of its R factor (tau in sT at (n_blk+j-1)*n).
+
+#define D_TSQR_MB_MIN 1024 // minimum number of rows of a row block
+#define D_TSQR_MB_RATIO 8 // minimum ratio between the number of rows of a row block and the number of cols
+#define D_TSQR_NB 16 // number of reflectors applied at once in the Q application
+
+// workspace for the tau of a row block, in bytes
+#define D_TSQR_TAU_SIZE(n) (((n)+4+7)/8*64)
+
+// element (i,j) of a panel-major matrix
+#define D_TSQR_EL(pA, sda, i, j) (pA)[((i)-((i)&(ps-1)))*(sda)+(j)*ps+((i)&(ps-1))]
+
+
+
+// rows of the row blocks, and number of row blocks; the last block takes the remaining rows
+static void d_tsqr_layout(int m, int n, int *mb, int *n_blk)
+	{
+	const int ps = 4;
+	int mb0 = D_TSQR_MB_RATIO*n;
+	mb0 = mb0<D_TSQR_MB_MIN ? D_TSQR_MB_MIN : (mb0+ps-1)/ps*ps;
+	int n_blk0 = m/mb0;
+	*mb = mb0;
+	*n_blk = n_blk0<1 ? 1 : n_blk0;
+	return;
+	}
+
+
+
+// task graph: leaf task b on row block b, and tree task n_blk+j-1 merging block j into block pair[j];
+// in the forward direction (factorization, Q^T application) each tree task follows the last tasks on its two blocks,
+// in the backward direction (Q application) each task follows the only task depending on it in the forward direction
+static void d_tsqr_dag(int n_blk, int backward, int *pair, int *pred_idx, int *pred, int *iwork)
+	{
+	int n_task = 2*n_blk-1;
+	int *last = iwork; // last task on the R factor of each block
+	int *fwd = iwork+n_blk; // forward predecessors and successor of each task
+	int ii, jj, ss, id;
+	for(ii=0; ii<n_blk; ii++)
+		last[ii] = ii;
+	for(id=0; id<3*n_task; id++)
+		fwd[id] = -1;
+	pair[0] = -1;
+	for(ss=1; ss<n_blk; ss*=2)
+		{
+		for(ii=0; ii+ss<n_blk; ii+=2*ss)
+			{
+			jj = ii+ss;
+			id = n_blk+jj-1;
+			pair[jj] = ii;
+			fwd[3*id+0] = last[ii];
+			fwd[3*id+1] = last[jj];
+			fwd[3*last[ii]+2] = id;
+			fwd[3*last[jj]+2] = id;
+			last[ii] = id;
+			}
+		}
+	int n_pred = 0;
+	for(id=0; id<n_task; id++)
+		{
+		pred_idx[id] = n_pred;
+		if(backward)
+			{
+			if(fwd[3*id+2]>=0)
+				pred[n_pred++] = fwd[3*id+2];
+			}
+		else
+			{
+			if(fwd[3*id+0]>=0)
+				pred[n_pred++] = fwd[3*id+0];
+			if(fwd[3*id+1]>=0)
+				pred[n_pred++] = fwd[3*id+1];
+			}
+		}
+	pred_idx[n_task] = n_pred;
+	return;
+	}
+
+
+
+// task graph arrays (pair, pred_idx, pred, work space of d_tsqr_dag) and task scheduler work space, in bytes
+static int d_tsqr_dag_size(int n_blk)
+	{
+	int n_task = 2*n_blk-1;
+	int size = (n_blk+n_task+1+2*n_task+n_blk+3*n_task)*sizeof(int) + blasfeo_thread_dag_memsize(n_task, 2*n_task);
+	return (size+63)/64*64;
+	}
+
+
+
+// task graph arrays, carved from work
+static void d_tsqr_dag_create(int n_blk, int backward, char *work, int **pair, void **dag_work, int **pred_idx, int **pred)
+	{
+	int n_task = 2*n_blk-1;
+	*dag_work = work;
+	int *iwork = (int *) (work + blasfeo_thread_dag_memsize(n_task, 2*n_task));
+	*pair = iwork;
+	iwork += n_blk;
+	*pred_idx = iwork;
+	iwork += n_task+1;
+	*pred = iwork;
+	iwork += 2*n_task;
+	d_tsqr_dag(n_blk, backward, *pair, *pred_idx, *pred, iwork);
+	return;
+	}
+
+
+
+// work space of the Q application on a row block or tree node: a block of up to D_TSQR_NB reflectors V,
+// its triangular factor T, and W = D^T * V
+struct d_tsqr_apply_work
+	{
+	struct blasfeo_dmat sV; // reflectors, unit diagonal and zeros above it explicit
+	struct blasfeo_dmat sVV; // V^T * V
+	struct blasfeo_dmat sT; // H_l0 * ... * H_{l0+kb-1} = I - V * T * V^T
+	struct blasfeo_dmat sW; // D^T * V
+	struct blasfeo_dmat sW2; // D^T * V * T (trans) or D^T * V * T^T
+	struct blasfeo_dmat sWt; // W2^T
+	};
+
+
+
+// size of the work space of the Q application on a row block of mb rows, in bytes
+static int d_tsqr_apply_work_size(int mb, int n)
+	{
+	int size = blasfeo_memsize_dmat(mb, D_TSQR_NB) + 2*blasfeo_memsize_dmat(D_TSQR_NB, D_TSQR_NB) + 2*blasfeo_memsize_dmat(n, D_TSQR_NB) + blasfeo_memsize_dmat(D_TSQR_NB, n);
+	return (size+63)/64*64;
+	}
+
+
+
+static void d_tsqr_apply_work_create(int mb, int n, char *work, struct d_tsqr_apply_work *w)
+	{
+	blasfeo_create_dmat(mb, D_TSQR_NB, &w->sV, work);
+	work += w->sV.memsize;
+	blasfeo_create_dmat(D_TSQR_NB, D_TSQR_NB, &w->sVV, work);
+	work += w->sVV.memsize;
+	blasfeo_create_dmat(D_TSQR_NB, D_TSQR_NB, &w->sT, work);
+	work += w->sT.memsize;
+	blasfeo_create_dmat(n, D_TSQR_NB, &w->sW, work);
+	work += w->sW.memsize;
+	blasfeo_create_dmat(n, D_TSQR_NB, &w->sW2, work);
+	work += w->sW2.memsize;
+	blasfeo_create_dmat(D_TSQR_NB, n, &w->sWt, work);
+	// the products are computed with beta=0, that does not clear NaN in the output
+	blasfeo_dgese(D_TSQR_NB, D_TSQR_NB, 0.0, &w->sVV, 0, 0);
+	blasfeo_dgese(n, D_TSQR_NB, 0.0, &w->sW2, 0, 0);
+	return;
+	}
+
+
+
+// W2 <= W * T (trans) or W * T^T, with T built from tau and the strictly upper part of V^T * V
+static void d_tsqr_larft(int trans, int n, int kb, double *tau, struct d_tsqr_apply_work *w)
+	{
+	double tmp;
+	int jj, ll, rr;
+	for(jj=0; jj<kb; jj++)
+		{
+		for(ll=jj+1; ll<kb; ll++)
+			BLASFEO_DMATEL(&w->sT, ll, jj) = 0.0;
+		BLASFEO_DMATEL(&w->sT, jj, jj) = tau[jj];
+		for(ll=0; ll<jj; ll++)
+			{
+			tmp = 0.0;
+			for(rr=ll; rr<jj; rr++)
+				tmp += BLASFEO_DMATEL(&w->sT, ll, rr) * BLASFEO_DMATEL(&w->sVV, rr, jj);
+			BLASFEO_DMATEL(&w->sT, ll, jj) = - tau[jj] * tmp;
+			}
+		}
+	if(trans)
+		blasfeo_dgemm_nn(n, kb, kb, 1.0, &w->sW, 0, 0, &w->sT, 0, 0, 0.0, &w->sW2, 0, 0, &w->sW2, 0, 0);
+	else
+		blasfeo_dgemm_nt(n, kb, kb, 1.0, &w->sW, 0, 0, &w->sT, 0, 0, 0.0, &w->sW2, 0, 0, &w->sW2, 0, 0);
+	return;
+	}
+
+
+
+// D <= H^T * D (trans) or H * D, with H = H_0 * ... * H_{k-1} the reflectors stored below the diagonal
+// of the (m)x(k) matrix A, applied in blocks of D_TSQR_NB in the compact WY form
+static void d_tsqr_leaf_apply(int trans, int m, int n, int k, struct blasfeo_dmat *sA, int ai, int aj, double *tau, struct blasfeo_dmat *sD, int di, int dj, struct d_tsqr_apply_work *w)
+	{
+	int ii, jj, ll, l0, kb, mv;
+	int n_kb = (k+D_TSQR_NB-1)/D_TSQR_NB;
+	for(ii=0; ii<n_kb; ii++)
+		{
+		l0 = (trans ? ii : n_kb-1-ii)*D_TSQR_NB;
+		kb = k-l0<D_TSQR_NB ? k-l0 : D_TSQR_NB;
+		mv = m-l0;
+		blasfeo_dgecp(mv, kb, sA, ai+l0, aj+l0, &w->sV, 0, 0);
+		for(jj=0; jj<kb; jj++)
+			{
+			for(ll=0; ll<jj; ll++)
+				BLASFEO_DMATEL(&w->sV, ll, jj) = 0.0;
+			BLASFEO_DMATEL(&w->sV, jj, jj) = 1.0;
+			}
+		blasfeo_dgemm_tn(kb, kb, mv, 1.0, &w->sV, 0, 0, &w->sV, 0, 0, 0.0, &w->sVV, 0, 0, &w->sVV, 0, 0);
+		blasfeo_dgemm_tn(n, kb, mv, 1.0, sD, di+l0, dj, &w->sV, 0, 0, 0.0, &w->sW, 0, 0, &w->sW, 0, 0);
+		d_tsqr_larft(trans, n, kb, tau+l0, w);
+		// D <= D - V * W2^T
+		blasfeo_dgemm_nt(mv, n, kb, -1.0, &w->sV, 0, 0, &w->sW2, 0, 0, 1.0, sD, di+l0, dj, sD, di+l0, dj);
+		}
+	return;
+	}
+
+
+
+// QR of the stacked [R_i; R_j], with R_i and R_j (n)x(n) upper triangular at rows ri and rj of A:
+// R_i <= R, R_j <= Householder vectors (upper triangular, the unit part being on R_i)
+static void d_tsqr_node_qr(int n, struct blasfeo_dmat *sA, int ri, int rj, int aj, double *tau)
+	{
+	const int ps = 4;
+	int sda = sA->cn;
+	double *pA = sA->pA;
+	double alpha, beta, tmp, w0;
+	int ii, jj, ll;
+	for(ii=0; ii<n; ii++)
+		{
+		beta = 0.0;
+		for(ll=0; ll<=ii; ll++)
+			{
+			tmp = D_TSQR_EL(pA, sda, rj+ll, aj+ii);
+			beta += tmp*tmp;
+			}
+		if(beta==0.0)
+			{
+			tau[ii] = 0.0;
+			continue;
+			}
+		alpha = D_TSQR_EL(pA, sda, ri+ii, aj+ii);
+		beta += alpha*alpha;
+		beta = sqrt(beta);
+		if(alpha>0)
+			beta = -beta;
+		tau[ii] = (beta-alpha) / beta;
+		tmp = 1.0 / (alpha-beta);
+		for(ll=0; ll<=ii; ll++)
+			D_TSQR_EL(pA, sda, rj+ll, aj+ii) *= tmp;
+		D_TSQR_EL(pA, sda, ri+ii, aj+ii) = beta;
+		for(jj=ii+1; jj<n; jj++)
+			{
+			w0 = D_TSQR_EL(pA, sda, ri+ii, aj+jj);
+			for(ll=0; ll<=ii; ll++)
+				w0 += D_TSQR_EL(pA, sda, rj+ll, aj+ii) * D_TSQR_EL(pA, sda, rj+ll, aj+jj);
+			w0 *= tau[ii];
+			D_TSQR_EL(pA, sda, ri+ii, aj+jj) -= w0;
+			for(ll=0; ll<=ii; ll++)
+				D_TSQR_EL(pA, sda, rj+ll, aj+jj) -= D_TSQR_EL(pA, sda, rj+ll, aj+ii) * w0;
+			}
+		}
+	return;
+	}
+
+
+
+// D <= H^T * D (trans) or H * D, with H the k reflectors of d_tsqr_node_qr stored at row rj of A,
+// acting on the rows di_i and di_j of D, applied in blocks of D_TSQR_NB in the compact WY form
+static void d_tsqr_node_apply(int trans, int n, int k, struct blasfeo_dmat *sA, int rj, int aj, double *tau, struct blasfeo_dmat *sD, int di_i, int di_j, int dj, struct d_tsqr_apply_work *w)
+	{
+	int ii, jj, ll, l0, kb, mv;
+	int n_kb = (k+D_TSQR_NB-1)/D_TSQR_NB;
+	for(ii=0; ii<n_kb; ii++)
+		{
+		l0 = (trans ? ii : n_kb-1-ii)*D_TSQR_NB;
+		kb = k-l0<D_TSQR_NB ? k-l0 : D_TSQR_NB;
+		mv = l0+kb;
+		// the unit part of the reflectors is on the rows of block i, V holds the upper triangular part on block j
+		blasfeo_dgecp(mv, kb, sA, rj, aj+l0, &w->sV, 0, 0);
+		for(jj=0; jj<kb; jj++)
+			{
+			for(ll=l0+jj+1; ll<mv; ll++)
+				BLASFEO_DMATEL(&w->sV, ll, jj) = 0.0;
+			}
+		blasfeo_dgemm_tn(kb, kb, mv, 1.0, &w->sV, 0, 0, &w->sV, 0, 0, 0.0, &w->sVV, 0, 0, &w->sVV, 0, 0);
+		blasfeo_dgetr(kb, n, sD, di_i+l0, dj, &w->sW, 0, 0);
+		blasfeo_dgemm_tn(n, kb, mv, 1.0, sD, di_j, dj, &w->sV, 0, 0, 1.0, &w->sW, 0, 0, &w->sW, 0, 0);
+		d_tsqr_larft(trans, n, kb, tau+l0, w);
+		// D_i <= D_i - W2^T, D_j <= D_j - V * W2^T
+		blasfeo_dgetr(n, kb, &w->sW2, 0, 0, &w->sWt, 0, 0);
+		blasfeo_dgead(kb, n, -1.0, &w->sWt, 0, 0, sD, di_i+l0, dj);
+		blasfeo_dgemm_nt(mv, n, kb, -1.0, &w->sV, 0, 0, &w->sW2, 0, 0, 1.0, sD, di_j, dj, sD, di_j, dj);
+		}
+	return;
+	}
+
+
+
+struct d_tsqr_arg
+	{
+	struct blasfeo_dmat *sA; // factorization
+	struct blasfeo_dmat *sC; // factorization input
+	struct blasfeo_dmat *sD; // matrix Q is applied to
+	double *tau;
+	char *work;
+	int *pair;
+	int m;
+	int n;
+	int k;
+	int mb;
+	int n_blk;
+	int ai;
+	int aj;
+	int ci;
+	int cj;
+	int di;
+	int dj;
+	int trans;
+	int work_size;
+	};
+
+
+
+static void d_tsqr_qr_task(void *ptr, int id)
+	{
+	const int ps = 4;
+	struct d_tsqr_arg *arg = ptr;
+	int mb = arg->mb;
+	int n_blk = arg->n_blk;
+	int n = arg->n;
+	int i0, j0, m0;
+	if(id<n_blk)
+		{
+		i0 = id*mb;
+		m0 = id==n_blk-1 ? arg->m-i0 : mb;
+		// blasfeo_dgeqrf stores tau in dA, sized for min(m,n) only: use a view starting at the panel of the block,
+		// with dA redirected to the workspace
+		char *work = arg->work+id*arg->work_size;
+		double *dA = (double *) work;
+		work += D_TSQR_TAU_SIZE(n);
+		int r0 = (arg->ai+i0)&(ps-1);
+		struct blasfeo_dmat sA0 = *arg->sA;
+		sA0.pA += (arg->ai+i0-r0)*sA0.cn;
+		sA0.dA = dA;
+		blasfeo_dgeqrf(m0, n, arg->sC, arg->ci+i0, arg->cj, &sA0, r0, arg->aj, work);
+		for(j0=0; j0<n; j0++)
+			arg->tau[id*n+j0] = dA[r0+j0];
+		}
+	else
+		{
+		j0 = id-n_blk+1;
+		i0 = arg->pair[j0];
+		d_tsqr_node_qr(n, arg->sA, arg->ai+i0*mb, arg->ai+j0*mb, arg->aj, arg->tau+id*n);
+		}
+	return;
+	}
+
+
+
+static void d_tsqr_apply_task(void *ptr, int id)
+	{
+	struct d_tsqr_arg *arg = ptr;
+	int mb = arg->mb;
+	int n_blk = arg->n_blk;
+	int k = arg->k;
+	int i0, j0, m0;
+	struct d_tsqr_apply_work w;
+	if(id<n_blk)
+		{
+		// the tasks on the same block are ordered by the graph, and can share its work space
+		d_tsqr_apply_work_create(arg->m-(n_blk-1)*mb, arg->n, arg->work+id*arg->work_size, &w);
+		i0 = id*mb;
+		m0 = id==n_blk-1 ? arg->m-i0 : mb;
+		d_tsqr_leaf_apply(arg->trans, m0, arg->n, m0<k ? m0 : k, arg->sA, arg->ai+i0, arg->aj, arg->tau+id*k, arg->sD, arg->di+i0, arg->dj, &w);
+		}
+	else
+		{
+		j0 = id-n_blk+1;
+		i0 = arg->pair[j0];
+		d_tsqr_apply_work_create(arg->m-(n_blk-1)*mb, arg->n, arg->work+j0*arg->work_size, &w);
+		d_tsqr_node_apply(arg->trans, arg->n, k, arg->sA, arg->ai+j0*mb, arg->aj, arg->tau+id*k, arg->sD, arg->di+i0*mb, arg->di+j0*mb, arg->dj, &w);
+		}
+	return;
+	}
+
+
+
+int blasfeo_dgeqrf_tsqr_tausize(int m, int n)
+	{
+	if(m<=0 | n<=0)
+		return 0;
+	int mb, n_blk;
+	d_tsqr_layout(m, n, &mb, &n_blk);
+	return (2*n_blk-1)*n;
+	}
+
+
+
+// work space of the factorization of a row block, in bytes
+static int d_tsqr_qr_work_size(int m, int n, int mb, int n_blk)
+	{
+	// the last block is the largest one
+	int size = D_TSQR_TAU_SIZE(n) + blasfeo_dgeqrf_worksize(m-(n_blk-1)*mb, n);
+	return (size+63)/64*64;
+	}
+
+
+
+int blasfeo_dgeqrf_tsqr_worksize(int m, int n)
+	{
+	if(m<=0 | n<=0)
+		return 0;
+	int mb, n_blk;
+	d_tsqr_layout(m, n, &mb, &n_blk);
+	// the row block work spaces hold panel-major matrices: room to align work
+	return n_blk*d_tsqr_qr_work_size(m, n, mb, n_blk) + d_tsqr_dag_size(n_blk) + 64;
+	}
+
+
+
+void blasfeo_dgeqrf_tsqr(int m, int n, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, struct blasfeo_dvec *sT, int ti, void *work)
+	{
+	if(m<=0 | n<=0)
+		return;
+
+	// invalidate stored inverse diagonal of result matrix
+	sD->use_dA = 0;
+
+	int mb, n_blk;
+	d_tsqr_layout(m, n, &mb, &n_blk);
+	int n_task = 2*n_blk-1;
+
+	work = (void *) (((size_t) work + 63) / 64 * 64);
+
+	struct d_tsqr_arg arg;
+	arg.work_size = d_tsqr_qr_work_size(m, n, mb, n_blk);
+
+	int *pair, *pred_idx, *pred;
+	void *dag_work;
+	d_tsqr_dag_create(n_blk, 0, (char *) work+n_blk*arg.work_size, &pair, &dag_work, &pred_idx, &pred);
+
+	arg.sA = sD;
+	arg.sC = sC;
+	arg.tau = sT->pa + ti;
+	arg.work = work;
+	arg.pair = pair;
+	arg.m = m;
+	arg.n = n;
+	arg.mb = mb;
+	arg.n_blk = n_blk;
+	arg.ai = di;
+	arg.aj = dj;
+	arg.ci = ci;
+	arg.cj = cj;
+
+	blasfeo_thread_dag_run(n_task, pred_idx, pred, NULL, &d_tsqr_qr_task, &arg, dag_work);
+
+	return;
+	}
+
+
+
+int blasfeo_dormqr_tsqr_worksize(int m, int n, int k)
+	{
+	if(m<=0 | n<=0 | k<=0)
+		return 0;
+	int mb, n_blk;
+	d_tsqr_layout(m, k, &mb, &n_blk);
+	// the last block is the largest one
+	return n_blk*d_tsqr_apply_work_size(m-(n_blk-1)*mb, n) + d_tsqr_dag_size(n_blk) + 64;
+	}
+
+
+
+static void d_tsqr_apply(int trans, int m, int n, int k, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dvec *sT, int ti, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work)
+	{
+	if(m<=0 | n<=0)
+		return;
+
+	// invalidate stored inverse diagonal of result matrix
+	sD->use_dA = 0;
+
+	// copy strmat submatrix
+	if(&(BLASFEO_DMATEL(sC,ci,cj))!=&(BLASFEO_DMATEL(sD,di,dj)))
+		blasfeo_dgecp(m, n, sC, ci, cj, sD, di, dj);
+
+	if(k<=0)
+		return;
+
+	// T holds the tau of the whole factorization: a k larger than the one of the factorization does not fit in it
+	if(ti+blasfeo_dgeqrf_tsqr_tausize(m, k) > sT->m)
+		{
+		printf("\nblasfeo_dormqr_tsqr: k=%d does not match the factorization, tau size %d > %d\n", k, blasfeo_dgeqrf_tsqr_tausize(m, k), sT->m-ti);
+		exit(1);
+		}
+
+	int mb, n_blk;
+	d_tsqr_layout(m, k, &mb, &n_blk);
+	int n_task = 2*n_blk-1;
+
+	work = (void *) (((size_t) work + 63) / 64 * 64);
+
+	struct d_tsqr_arg arg;
+	arg.work_size = d_tsqr_apply_work_size(m-(n_blk-1)*mb, n);
+
+	int *pair, *pred_idx, *pred;
+	void *dag_work;
+	d_tsqr_dag_create(n_blk, !trans, (char *) work+n_blk*arg.work_size, &pair, &dag_work, &pred_idx, &pred);
+
+	arg.sA = sA;
+	arg.sD = sD;
+	arg.tau = sT->pa + ti;
+	arg.work = work;
+	arg.pair = pair;
+	arg.m = m;
+	arg.n = n;
+	arg.k = k;
+	arg.mb = mb;
+	arg.n_blk = n_blk;
+	arg.ai = ai;
+	arg.aj = aj;
+	arg.di = di;
+	arg.dj = dj;
+	arg.trans = trans;
+
+	blasfeo_thread_dag_run(n_task, pred_idx, pred, NULL, &d_tsqr_apply_task, &arg, dag_work);
+
+	return;
+	}
+
+
+
+void blasfeo_dormqr_tsqr_lt(int m, int n, int k, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dvec *sT, int ti, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work)
+	{
+	d_tsqr_apply(1, m, n, k, sA, ai, aj, sT, ti, sC, ci, cj, sD, di, dj, work);
+	return;
+	}
+
+
+
+void blasfeo_dormqr_tsqr_ln(int m, int n, int k, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dvec *sT, int ti, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work)
+	{
+	d_tsqr_apply(0, m, n, k, sA, ai, aj, sT, ti, sC, ci, cj, sD, di, dj, work);
+	return;
+	}
+
+
+
 int blasfeo_dgelqf_worksize(int m, int n)
 	{
 	return 0;
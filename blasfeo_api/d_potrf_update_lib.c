@@ -0,0 +1,326 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "../include/blasfeo_common.h"
+#include "../include/blasfeo_d_aux.h"
+#include "../include/blasfeo_d_kernel.h"
+#include "../include/blasfeo_d_blasfeo_api.h"
+
+
+
+// rank-k update and downdate of a Cholesky factor: L * L^T +- V * V^T = L' * L'^T.
+// Row ii of L and V is swept by the plane (update) or hyperbolic (downdate) rotations of the previous columns, then
+// generates the k rotations of column ii annihilating V(ii,:); the rotations of D_POTRF_UPDATE_NB columns are stored
+// and applied at once to the rows below, 4 rows at a time, so that each panel of rows of L and V is loaded once per block
+
+
+
+// columns of L whose rotations are stored and applied together to the rows below
+#define D_POTRF_UPDATE_NB 16
+
+
+
+static int d_potrf_update_size_align(int size)
+	{
+	return (size+63)/64*64;
+	}
+
+
+
+// pointer to A(ai,aj), and distance between consecutive columns
+static double *d_potrf_update_ptr(struct blasfeo_dmat *sA, int ai, int aj, int *cs)
+	{
+#if defined(LA_HIGH_PERFORMANCE)
+	*cs = D_PS;
+	return sA->pA + ai/D_PS*D_PS*sA->cn + ai%D_PS + aj*D_PS;
+#else
+	*cs = sA->m;
+	return sA->pA + ai + aj*sA->m;
+#endif
+	}
+
+
+
+// row offset of the copy of V, such that its rows are in the same position in the panels as the rows of D
+static int d_potrf_update_offset(int di)
+	{
+#if defined(LA_HIGH_PERFORMANCE)
+	return di%D_PS;
+#else
+	return 0;
+#endif
+	}
+
+
+
+// whether the rows ai,...,ai+3 are contiguous in each column
+static int d_potrf_update_aligned(int ai)
+	{
+#if defined(LA_HIGH_PERFORMANCE)
+	return ai%D_PS==0;
+#else
+	return 1;
+#endif
+	}
+
+
+
+// apply the (nb)x(k) rotations in rot to 1 row of nb columns of D and k columns of V
+static void d_potrf_update_rot_1(int nb, int k, int downdate, double *rot, double *pD, int cd, double *pV, int cv)
+	{
+	int jj, ll;
+	double d, v, d_tmp;
+	for(jj=0; jj<nb; jj++)
+		{
+		d = pD[jj*cd];
+		if(downdate)
+			{
+			for(ll=0; ll<k; ll++)
+				{
+				v = pV[ll*cv];
+				// rot = [ch sh 1/ch t]
+				d = rot[0]*d - rot[1]*v;
+				pV[ll*cv] = rot[2]*v - rot[3]*d;
+				rot += 4;
+				}
+			}
+		else
+			{
+			for(ll=0; ll<k; ll++)
+				{
+				v = pV[ll*cv];
+				// rot = [c s]
+				d_tmp = rot[0]*d + rot[1]*v;
+				pV[ll*cv] = rot[0]*v - rot[1]*d;
+				d = d_tmp;
+				rot += 4;
+				}
+			}
+		pD[jj*cd] = d;
+		}
+	return;
+	}
+
+
+
+// apply the (nb)x(k) rotations in rot to 4 contiguous rows of nb columns of D and k columns of V
+static void d_potrf_update_rot_4(int nb, int k, int downdate, double *rot, double *pD, int cd, double *pV, int cv)
+	{
+#if defined(LA_HIGH_PERFORMANCE) & (defined(TARGET_X64_INTEL_HASWELL) || defined(TARGET_X64_INTEL_SANDY_BRIDGE))
+	kernel_dpotrf_update_rot_4_lib4(nb, k, downdate, rot, pD, cd, pV, cv);
+#else
+	int ii, jj, ll;
+	double d[4], v, d_tmp;
+	for(jj=0; jj<nb; jj++)
+		{
+		for(ii=0; ii<4; ii++)
+			d[ii] = pD[ii+jj*cd];
+		for(ll=0; ll<k; ll++)
+			{
+			if(downdate)
+				{
+				for(ii=0; ii<4; ii++)
+					{
+					v = pV[ii+ll*cv];
+					d[ii] = rot[0]*d[ii] - rot[1]*v;
+					pV[ii+ll*cv] = rot[2]*v - rot[3]*d[ii];
+					}
+				}
+			else
+				{
+				for(ii=0; ii<4; ii++)
+					{
+					v = pV[ii+ll*cv];
+					d_tmp = rot[0]*d[ii] + rot[1]*v;
+					pV[ii+ll*cv] = rot[0]*v - rot[1]*d[ii];
+					d[ii] = d_tmp;
+					}
+				}
+			rot += 4;
+			}
+		for(ii=0; ii<4; ii++)
+			pD[ii+jj*cd] = d[ii];
+		}
+#endif
+	return;
+	}
+
+
+
+int blasfeo_dpotrf_update_l_worksize(int m, int k)
+	{
+	int size = 64; // alignment
+	size += d_potrf_update_size_align(blasfeo_memsize_dmat(m+3, k));
+	size += d_potrf_update_size_align(4*D_POTRF_UPDATE_NB*k*sizeof(double));
+	return size;
+	}
+
+
+
+int blasfeo_dpotrf_downdate_l_worksize(int m, int k)
+	{
+	return blasfeo_dpotrf_update_l_worksize(m, k);
+	}
+
+
+
+// D <= chol( C * C^T + V * V^T ) if downdate==0, D <= chol( C * C^T - V * V^T ) otherwise;
+// return 0, or ii+1 if the downdate breaks down at the row ii (D not updated from that row on)
+static int d_potrf_update(int m, int k, int downdate, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sV, int vi, int vj, struct blasfeo_dmat *sD, int di, int dj, void *work)
+	{
+
+	if(m<=0)
+		return 0;
+
+	if(sC!=sD | ci!=di | cj!=dj)
+		blasfeo_dtrcp_l(m, sC, ci, cj, sD, di, dj);
+
+	// the factor changes, invalidate the inverse of its diagonal
+	sD->use_dA = 0;
+
+	if(k<=0)
+		return 0;
+
+	int ii, ll, j0, nb, cd, cv;
+	double d, v, c, s, t, ich;
+	double *pD, *pV;
+
+	// work space: copy of V, with rows aligned to the ones of D, and rotations of a block of columns
+	char *c_ptr = (char *) work;
+	c_ptr = (char *) ((((size_t) c_ptr)+63)/64*64);
+
+	int voff = d_potrf_update_offset(di);
+	struct blasfeo_dmat sW;
+	blasfeo_create_dmat(voff+m, k, &sW, c_ptr);
+	c_ptr += d_potrf_update_size_align(blasfeo_memsize_dmat(m+3, k));
+	blasfeo_dgecp(m, k, sV, vi, vj, &sW, voff, 0);
+
+	double *rot = (double *) c_ptr;
+
+	for(j0=0; j0<m; j0+=nb)
+		{
+		nb = m-j0<D_POTRF_UPDATE_NB ? m-j0 : D_POTRF_UPDATE_NB;
+		// rows of the diagonal block: apply the rotations of the previous columns of the block, generate the ones of the
+		// column on the diagonal
+		for(ii=0; ii<nb; ii++)
+			{
+			pD = d_potrf_update_ptr(sD, di+j0+ii, dj+j0, &cd);
+			pV = d_potrf_update_ptr(&sW, voff+j0+ii, 0, &cv);
+			d_potrf_update_rot_1(ii, k, downdate, rot, pD, cd, pV, cv);
+			d = pD[ii*cd];
+			for(ll=0; ll<k; ll++)
+				{
+				v = pV[ll*cv];
+				if(downdate)
+					{
+					t = v/d;
+					if(!(fabs(t)<1.0))
+						return j0+ii+1;
+					ich = sqrt((1.0-t)*(1.0+t));
+					rot[4*(ii*k+ll)+0] = 1.0/ich;
+					rot[4*(ii*k+ll)+1] = t/ich;
+					rot[4*(ii*k+ll)+2] = ich;
+					rot[4*(ii*k+ll)+3] = t;
+					d = d*ich;
+					}
+				else
+					{
+					blasfeo_drotg(d, v, &c, &s);
+					// keep the diagonal positive
+					if(c<0.0)
+						{
+						c = -c;
+						s = -s;
+						}
+					rot[4*(ii*k+ll)+0] = c;
+					rot[4*(ii*k+ll)+1] = s;
+					d = c*d + s*v;
+					}
+				pV[ll*cv] = 0.0;
+				}
+			pD[ii*cd] = d;
+			}
+		// rows below the diagonal block
+		ii = j0+nb;
+		for(; ii<m & !d_potrf_update_aligned(di+ii); ii++)
+			{
+			pD = d_potrf_update_ptr(sD, di+ii, dj+j0, &cd);
+			pV = d_potrf_update_ptr(&sW, voff+ii, 0, &cv);
+			d_potrf_update_rot_1(nb, k, downdate, rot, pD, cd, pV, cv);
+			}
+#if defined(LA_HIGH_PERFORMANCE) & (defined(TARGET_X64_INTEL_HASWELL) || defined(TARGET_X64_INTEL_SANDY_BRIDGE))
+		for(; ii<m-7; ii+=8)
+			{
+			pD = d_potrf_update_ptr(sD, di+ii, dj+j0, &cd);
+			pV = d_potrf_update_ptr(&sW, voff+ii, 0, &cv);
+			kernel_dpotrf_update_rot_8_lib4(nb, k, downdate, rot, pD, d_potrf_update_ptr(sD, di+ii+4, dj+j0, &cd), cd, pV, d_potrf_update_ptr(&sW, voff+ii+4, 0, &cv), cv);
+			}
+#endif
+		for(; ii<m-3; ii+=4)
+			{
+			pD = d_potrf_update_ptr(sD, di+ii, dj+j0, &cd);
+			pV = d_potrf_update_ptr(&sW, voff+ii, 0, &cv);
+			d_potrf_update_rot_4(nb, k, downdate, rot, pD, cd, pV, cv);
+			}
+		for(; ii<m; ii++)
+			{
+			pD = d_potrf_update_ptr(sD, di+ii, dj+j0, &cd);
+			pV = d_potrf_update_ptr(&sW, voff+ii, 0, &cv);
+			d_potrf_update_rot_1(nb, k, downdate, rot, pD, cd, pV, cv);
+			}
+		}
+
+	return 0;
+
+	}
+
+
+
+void blasfeo_dpotrf_update_l(int m, int k, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sV, int vi, int vj, struct blasfeo_dmat *sD, int di, int dj, void *work)
+	{
+	d_potrf_update(m, k, 0, sC, ci, cj, sV, vi, vj, sD, di, dj, work);
+	return;
+	}
+
+
+
+int blasfeo_dpotrf_downdate_l(int m, int k, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sV, int vi, int vj, struct blasfeo_dmat *sD, int di, int dj, void *work)
+	{
+	return d_potrf_update(m, k, 1, sC, ci, cj, sV, vi, vj, sD, di, dj, work);
+	}
@@ -0,0 +1,513 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "../include/blasfeo_common.h"
+#include "../include/blasfeo_d_aux.h"
+#include "../include/blasfeo_d_kernel.h"
+#include "../include/blasfeo_d_blasfeo_api.h"
+
+
+
+// update of an explicit QR (A = Q * R) or LQ (A = L * Q) factorization when a row or a column of A is inserted or deleted,
+// restoring the triangular factor with a sequence of Givens rotations; the rotations are generated on the triangular
+// factor and then applied at once to Q, one panel of rows at a time.
+// The LQ factorization of A is the QR factorization of A^T, so all routines work on a QR factorization whose matrices are
+// possibly the transpose of the stored ones
+
+
+
+// matrix seen as the transpose of the stored one if tr!=0
+struct d_qru_mat
+	{
+	struct blasfeo_dmat *sA;
+	int ai;
+	int aj;
+	int tr;
+	};
+
+
+
+static int d_qru_size_align(int size)
+	{
+	return (size+63)/64*64;
+	}
+
+
+
+// pointer to A(ai,aj) of the stored matrix, and distance between consecutive columns
+static double *d_qru_ptr(struct blasfeo_dmat *sA, int ai, int aj, int *cs)
+	{
+#if defined(LA_HIGH_PERFORMANCE)
+	*cs = D_PS;
+	return sA->pA + ai/D_PS*D_PS*sA->cn + ai%D_PS + aj*D_PS;
+#else
+	*cs = sA->m;
+	return sA->pA + ai + aj*sA->m;
+#endif
+	}
+
+
+
+// whether the rows ai,...,ai+3 of the stored matrix are contiguous in each column
+static int d_qru_aligned(int ai)
+	{
+#if defined(LA_HIGH_PERFORMANCE)
+	return ai%D_PS==0;
+#else
+	return 1;
+#endif
+	}
+
+
+
+static double *d_qru_el(struct d_qru_mat *A, int i, int j)
+	{
+	if(A->tr)
+		return &BLASFEO_DMATEL(A->sA, A->ai+j, A->aj+i);
+	return &BLASFEO_DMATEL(A->sA, A->ai+i, A->aj+j);
+	}
+
+
+
+// [a; b] <= [c s; -s c] [a; b], with a and b the rows i0 and i1 of A, n columns starting from j
+static void d_qru_rowrot(int n, struct d_qru_mat *A, int i0, int i1, int j, double c, double s)
+	{
+	if(n<=0)
+		return;
+	if(A->tr)
+		blasfeo_dcolrot(n, A->sA, A->ai+j, A->aj+i0, A->aj+i1, c, s);
+	else
+		blasfeo_drowrot(n, A->sA, A->ai+i0, A->ai+i1, A->aj+j, c, s);
+	return;
+	}
+
+
+
+// swap the rows i0 and i1 of A, n columns
+static void d_qru_rowsw(int n, struct d_qru_mat *A, int i0, int i1)
+	{
+	if(A->tr)
+		blasfeo_dcolsw(n, A->sA, A->ai, A->aj+i0, A->sA, A->ai, A->aj+i1);
+	else
+		blasfeo_drowsw(n, A->sA, A->ai+i0, A->aj, A->sA, A->ai+i1, A->aj);
+	return;
+	}
+
+
+
+// swap the columns j0 and j1 of A, m rows
+static void d_qru_colsw(int m, struct d_qru_mat *A, int j0, int j1)
+	{
+	if(A->tr)
+		blasfeo_drowsw(m, A->sA, A->ai+j0, A->aj, A->sA, A->ai+j1, A->aj);
+	else
+		blasfeo_dcolsw(m, A->sA, A->ai, A->aj+j0, A->sA, A->ai, A->aj+j1);
+	return;
+	}
+
+
+
+// column j of A (m rows) <= x
+static void d_qru_colin(int m, struct blasfeo_dvec *sx, int xi, struct d_qru_mat *A, int j)
+	{
+	if(A->tr)
+		blasfeo_drowin(m, 1.0, sx, xi, A->sA, A->ai+j, A->aj);
+	else
+		blasfeo_dcolin(m, sx, xi, A->sA, A->ai, A->aj+j);
+	return;
+	}
+
+
+
+// row i of A (n columns) <= x
+static void d_qru_rowin(int n, struct blasfeo_dvec *sx, int xi, struct d_qru_mat *A, int i)
+	{
+	if(A->tr)
+		blasfeo_dcolin(n, sx, xi, A->sA, A->ai, A->aj+i);
+	else
+		blasfeo_drowin(n, 1.0, sx, xi, A->sA, A->ai+i, A->aj);
+	return;
+	}
+
+
+
+// x <= row i of A (n columns)
+static void d_qru_rowex(int n, struct d_qru_mat *A, int i, struct blasfeo_dvec *sx, int xi)
+	{
+	if(A->tr)
+		blasfeo_dcolex(n, A->sA, A->ai, A->aj+i, sx, xi);
+	else
+		blasfeo_drowex(n, 1.0, A->sA, A->ai+i, A->aj, sx, xi);
+	return;
+	}
+
+
+
+// apply the nrot rotations [x y] <= [x y] [c -s; s c] in sequence to the pairs of vectors of length len at p+off[2*rr] and
+// p+off[2*rr+1]
+static void d_qru_rot_seq(int len, int nrot, double *p, int *off, double *cs)
+	{
+	int rr, ll;
+	double c, s, d_tmp;
+	double *px, *py;
+	for(rr=0; rr<nrot; rr++)
+		{
+		c = cs[2*rr+0];
+		s = cs[2*rr+1];
+		px = p + off[2*rr+0];
+		py = p + off[2*rr+1];
+		for(ll=0; ll<len; ll++)
+			{
+			d_tmp = c*px[ll] + s*py[ll];
+			py[ll] = c*py[ll] - s*px[ll];
+			px[ll] = d_tmp;
+			}
+		}
+	return;
+	}
+
+
+
+// apply the nrot rotations of the pairs of columns idx[2*rr], idx[2*rr+1] of Q (m rows) in sequence, the whole sequence
+// on a panel of rows (or on a column of the stored matrix if transposed) before moving to the next one
+static void d_qru_colrot_seq(int m, struct d_qru_mat *Q, int nrot, int *idx, double *cs, int *off)
+	{
+	int ii, rr, cq;
+	double *pQ;
+	if(nrot<=0)
+		return;
+	if(Q->tr)
+		{
+		// rows of the stored matrix, one column at a time
+		pQ = d_qru_ptr(Q->sA, Q->ai, Q->aj, &cq);
+		for(rr=0; rr<2*nrot; rr++)
+			off[rr] = d_qru_ptr(Q->sA, Q->ai+idx[rr], Q->aj, &cq) - pQ;
+		for(ii=0; ii<m; ii++)
+			d_qru_rot_seq(1, nrot, pQ+ii*cq, off, cs);
+		return;
+		}
+	// columns of the stored matrix, one panel of rows at a time
+	d_qru_ptr(Q->sA, Q->ai, Q->aj, &cq);
+	for(rr=0; rr<2*nrot; rr++)
+		off[rr] = idx[rr]*cq;
+	ii = 0;
+	for(; ii<m & !d_qru_aligned(Q->ai+ii); ii++)
+		d_qru_rot_seq(1, nrot, d_qru_ptr(Q->sA, Q->ai+ii, Q->aj, &cq), off, cs);
+#if defined(LA_HIGH_PERFORMANCE) & (defined(TARGET_X64_INTEL_HASWELL) || defined(TARGET_X64_INTEL_SANDY_BRIDGE))
+	for(; ii<m-7; ii+=8)
+		kernel_drot_seq_8_lib4(nrot, d_qru_ptr(Q->sA, Q->ai+ii, Q->aj, &cq), d_qru_ptr(Q->sA, Q->ai+ii+4, Q->aj, &cq), off, cs);
+#endif
+	for(; ii<m-3; ii+=4)
+		d_qru_rot_seq(4, nrot, d_qru_ptr(Q->sA, Q->ai+ii, Q->aj, &cq), off, cs);
+	for(; ii<m; ii++)
+		d_qru_rot_seq(1, nrot, d_qru_ptr(Q->sA, Q->ai+ii, Q->aj, &cq), off, cs);
+	return;
+	}
+
+
+
+// work space: vector and rotations
+struct d_qru_work
+	{
+	struct blasfeo_dvec sw;
+	double *cs;
+	int *idx;
+	int *off;
+	};
+
+
+
+static int d_qru_worksize(int m, int n)
+	{
+	int mn = (m>n ? m : n) + 1;
+	int size = 64; // alignment
+	size += d_qru_size_align(blasfeo_memsize_dvec(mn));
+	size += d_qru_size_align(2*mn*sizeof(double));
+	size += 2*d_qru_size_align(2*mn*sizeof(int));
+	return size;
+	}
+
+
+
+static void d_qru_work_create(int m, int n, struct d_qru_work *ws, void *work)
+	{
+	int mn = (m>n ? m : n) + 1;
+	char *c_ptr = (char *) work;
+	c_ptr = (char *) ((((size_t) c_ptr)+63)/64*64);
+	blasfeo_create_dvec(mn, &ws->sw, c_ptr);
+	c_ptr += d_qru_size_align(blasfeo_memsize_dvec(mn));
+	ws->cs = (double *) c_ptr;
+	c_ptr += d_qru_size_align(2*mn*sizeof(double));
+	ws->idx = (int *) c_ptr;
+	c_ptr += d_qru_size_align(2*mn*sizeof(int));
+	ws->off = (int *) c_ptr;
+	return;
+	}
+
+
+
+// rotation annihilating b in [a; b], stored as the rr-th of the sequence on the rows (columns of Q) i0 and i1
+static void d_qru_rotg(double *a, double *b, int i0, int i1, int rr, struct d_qru_work *ws)
+	{
+	double c, s;
+	blasfeo_drotg(*a, *b, &c, &s);
+	*a = c*(*a) + s*(*b);
+	*b = 0.0;
+	ws->cs[2*rr+0] = c;
+	ws->cs[2*rr+1] = s;
+	ws->idx[2*rr+0] = i0;
+	ws->idx[2*rr+1] = i1;
+	return;
+	}
+
+
+
+// column x inserted before column j of A, (m)x(n)
+static void d_qru_insert_col(int m, int n, int j, struct blasfeo_dvec *sx, int xi, struct d_qru_mat *Q, struct d_qru_mat *R, void *work)
+	{
+	int jj, kk, nrot, c0;
+	struct d_qru_work ws;
+	d_qru_work_create(m, n, &ws, work);
+	// w = Q^T * x
+	if(Q->tr)
+		blasfeo_dgemv_n(m, m, 1.0, Q->sA, Q->ai, Q->aj, sx, xi, 0.0, &ws.sw, 0, &ws.sw, 0);
+	else
+		blasfeo_dgemv_t(m, m, 1.0, Q->sA, Q->ai, Q->aj, sx, xi, 0.0, &ws.sw, 0, &ws.sw, 0);
+	// shift the columns j,...,n-1 of R to the right, and R(:,j) = w
+	for(jj=n; jj>j; jj--)
+		d_qru_colsw(m, R, jj-1, jj);
+	d_qru_colin(m, &ws.sw, 0, R, j);
+	// annihilate R(j+1:m,j) from the bottom, filling the diagonal of the shifted columns
+	nrot = 0;
+	for(kk=m-1; kk>j; kk--)
+		{
+		d_qru_rotg(d_qru_el(R, kk-1, j), d_qru_el(R, kk, j), kk-1, kk, nrot, &ws);
+		c0 = kk>j+1 ? kk : j+1;
+		d_qru_rowrot(n+1-c0, R, kk-1, kk, c0, ws.cs[2*nrot+0], ws.cs[2*nrot+1]);
+		nrot++;
+		}
+	d_qru_colrot_seq(m, Q, nrot, ws.idx, ws.cs, ws.off);
+	return;
+	}
+
+
+
+// column j of A, (m)x(n), deleted
+static void d_qru_delete_col(int m, int n, int j, struct d_qru_mat *Q, struct d_qru_mat *R, void *work)
+	{
+	int jj, kk, nrot;
+	struct d_qru_work ws;
+	d_qru_work_create(m, n, &ws, work);
+	// shift the columns j+1,...,n-1 of R to the left: R is upper Hessenberg from column j
+	for(jj=j; jj<n-1; jj++)
+		d_qru_colsw(m, R, jj, jj+1);
+	// annihilate the sub-diagonal
+	nrot = 0;
+	for(kk=j; kk<n-1 & kk<m-1; kk++)
+		{
+		d_qru_rotg(d_qru_el(R, kk, kk), d_qru_el(R, kk+1, kk), kk, kk+1, nrot, &ws);
+		d_qru_rowrot(n-2-kk, R, kk, kk+1, kk+1, ws.cs[2*nrot+0], ws.cs[2*nrot+1]);
+		nrot++;
+		}
+	d_qru_colrot_seq(m, Q, nrot, ws.idx, ws.cs, ws.off);
+	return;
+	}
+
+
+
+// row x^T inserted before row i of A, (m)x(n)
+static void d_qru_insert_row(int m, int n, int i, struct blasfeo_dvec *sx, int xi, struct d_qru_mat *Q, struct d_qru_mat *R, void *work)
+	{
+	int ii, kk, nrot;
+	struct d_qru_work ws;
+	d_qru_work_create(m, n, &ws, work);
+	// Q <= [Q 0; 0 1], R <= [R; x^T]
+	for(ii=0; ii<m; ii++)
+		{
+		*d_qru_el(Q, m, ii) = 0.0;
+		*d_qru_el(Q, ii, m) = 0.0;
+		}
+	*d_qru_el(Q, m, m) = 1.0;
+	d_qru_rowin(n, sx, xi, R, m);
+	// annihilate the last row of R against the diagonal
+	nrot = 0;
+	for(kk=0; kk<n & kk<m; kk++)
+		{
+		d_qru_rotg(d_qru_el(R, kk, kk), d_qru_el(R, m, kk), kk, m, nrot, &ws);
+		d_qru_rowrot(n-1-kk, R, kk, m, kk+1, ws.cs[2*nrot+0], ws.cs[2*nrot+1]);
+		nrot++;
+		}
+	d_qru_colrot_seq(m+1, Q, nrot, ws.idx, ws.cs, ws.off);
+	// move the last row of Q to the position i
+	for(ii=m; ii>i; ii--)
+		d_qru_rowsw(m+1, Q, ii-1, ii);
+	return;
+	}
+
+
+
+// row i of A, (m)x(n), deleted
+static void d_qru_delete_row(int m, int n, int i, struct d_qru_mat *Q, struct d_qru_mat *R, void *work)
+	{
+	int ii, jj, kk, nrot;
+	struct d_qru_work ws;
+	d_qru_work_create(m, n, &ws, work);
+	// rotate the row i of Q into +-e_0^T, making R upper Hessenberg
+	d_qru_rowex(m, Q, i, &ws.sw, 0);
+	double *q = ws.sw.pa;
+	nrot = 0;
+	for(kk=m-1; kk>0; kk--)
+		{
+		d_qru_rotg(q+kk-1, q+kk, kk-1, kk, nrot, &ws);
+		if(kk-1<n)
+			d_qru_rowrot(n+1-kk, R, kk-1, kk, kk-1, ws.cs[2*nrot+0], ws.cs[2*nrot+1]);
+		nrot++;
+		}
+	d_qru_colrot_seq(m, Q, nrot, ws.idx, ws.cs, ws.off);
+	// Q(:,0) is +-e_i: drop the row i and the column 0 of Q, and the row 0 of R
+	for(ii=i; ii<m-1; ii++)
+		d_qru_rowsw(m, Q, ii, ii+1);
+	for(jj=0; jj<m-1; jj++)
+		d_qru_colsw(m-1, Q, jj, jj+1);
+	for(ii=0; ii<m-1; ii++)
+		d_qru_rowsw(n, R, ii, ii+1);
+	return;
+	}
+
+
+
+int blasfeo_dgeqrf_update_worksize(int m, int n)
+	{
+	return d_qru_worksize(m, n);
+	}
+
+
+
+void blasfeo_dgeqrf_insert_col(int m, int n, int j, struct blasfeo_dvec *sx, int xi, struct blasfeo_dmat *sQ, int qi, int qj, struct blasfeo_dmat *sR, int ri, int rj, void *work)
+	{
+	struct d_qru_mat Q = {sQ, qi, qj, 0};
+	struct d_qru_mat R = {sR, ri, rj, 0};
+	d_qru_insert_col(m, n, j, sx, xi, &Q, &R, work);
+	sR->use_dA = 0;
+	return;
+	}
+
+
+
+void blasfeo_dgeqrf_delete_col(int m, int n, int j, struct blasfeo_dmat *sQ, int qi, int qj, struct blasfeo_dmat *sR, int ri, int rj, void *work)
+	{
+	struct d_qru_mat Q = {sQ, qi, qj, 0};
+	struct d_qru_mat R = {sR, ri, rj, 0};
+	d_qru_delete_col(m, n, j, &Q, &R, work);
+	sR->use_dA = 0;
+	return;
+	}
+
+
+
+void blasfeo_dgeqrf_insert_row(int m, int n, int i, struct blasfeo_dvec *sx, int xi, struct blasfeo_dmat *sQ, int qi, int qj, struct blasfeo_dmat *sR, int ri, int rj, void *work)
+	{
+	struct d_qru_mat Q = {sQ, qi, qj, 0};
+	struct d_qru_mat R = {sR, ri, rj, 0};
+	d_qru_insert_row(m, n, i, sx, xi, &Q, &R, work);
+	sR->use_dA = 0;
+	return;
+	}
+
+
+
+void blasfeo_dgeqrf_delete_row(int m, int n, int i, struct blasfeo_dmat *sQ, int qi, int qj, struct blasfeo_dmat *sR, int ri, int rj, void *work)
+	{
+	struct d_qru_mat Q = {sQ, qi, qj, 0};
+	struct d_qru_mat R = {sR, ri, rj, 0};
+	d_qru_delete_row(m, n, i, &Q, &R, work);
+	sR->use_dA = 0;
+	return;
+	}
+
+
+
+int blasfeo_dgelqf_update_worksize(int m, int n)
+	{
+	return d_qru_worksize(n, m);
+	}
+
+
+
+void blasfeo_dgelqf_insert_row(int m, int n, int i, struct blasfeo_dvec *sx, int xi, struct blasfeo_dmat *sL, int li, int lj, struct blasfeo_dmat *sQ, int qi, int qj, void *work)
+	{
+	struct d_qru_mat Q = {sQ, qi, qj, 1};
+	struct d_qru_mat R = {sL, li, lj, 1};
+	d_qru_insert_col(n, m, i, sx, xi, &Q, &R, work);
+	sL->use_dA = 0;
+	return;
+	}
+
+
+
+void blasfeo_dgelqf_delete_row(int m, int n, int i, struct blasfeo_dmat *sL, int li, int lj, struct blasfeo_dmat *sQ, int qi, int qj, void *work)
+	{
+	struct d_qru_mat Q = {sQ, qi, qj, 1};
+	struct d_qru_mat R = {sL, li, lj, 1};
+	d_qru_delete_col(n, m, i, &Q, &R, work);
+	sL->use_dA = 0;
+	return;
+	}
+
+
+
+void blasfeo_dgelqf_insert_col(int m, int n, int j, struct blasfeo_dvec *sx, int xi, struct blasfeo_dmat *sL, int li, int lj, struct blasfeo_dmat *sQ, int qi, int qj, void *work)
+	{
+	struct d_qru_mat Q = {sQ, qi, qj, 1};
+	struct d_qru_mat R = {sL, li, lj, 1};
+	d_qru_insert_row(n, m, j, sx, xi, &Q, &R, work);
+	sL->use_dA = 0;
+	return;
+	}
+
+
+
+void blasfeo_dgelqf_delete_col(int m, int n, int j, struct blasfeo_dmat *sL, int li, int lj, struct blasfeo_dmat *sQ, int qi, int qj, void *work)
+	{
+	struct d_qru_mat Q = {sQ, qi, qj, 1};
+	struct d_qru_mat R = {sL, li, lj, 1};
+	d_qru_delete_row(n, m, j, &Q, &R, work);
+	sL->use_dA = 0;
+	return;
+	}
@@ -0,0 +1,1312 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../include/blasfeo_common.h"
+#include "../include/blasfeo_stdlib.h"
+#include "../include/blasfeo_d_aux.h"
+#include "../include/blasfeo_d_blasfeo_api.h"
+#include "../include/blasfeo_d_spchol.h"
+#include "../include/blasfeo_thread.h"
+
+
+
+// supernodal multifrontal sparse Cholesky factorization: the frontal matrix of a supernode with nc columns and m rows
+// is split in the m x nc panel of L, kept in the factor, and the (m-nc) x (m-nc) update matrix, only needed until the
+// extend-add into the parent: the update matrices live in a stack (sequential) or in memory released by the parent
+// (MULTI_THREAD=1)
+
+
+
+// minimum amount of work (in flops/2) per thread to factorize the supernodes in parallel
+#define D_SPCHOL_MT_MIN_WORK (32*32*32)
+// subgraphs up to this size are ordered by minimum degree in nested dissection
+#define D_SPCHOL_ND_LEAF 64
+// maximum number of breadth first searches to find a pseudo-peripheral vertex
+#define D_SPCHOL_ND_PERIPH_IT 8
+
+
+
+// memory of the update matrix of a supernode with m2 rows past its columns
+static int d_spchol_memsize_u(int m2)
+	{
+	return m2>0 ? (blasfeo_memsize_dmat(m2, m2)+63)/64*64 : 0;
+	}
+
+
+
+static void *d_spchol_malloc(size_t size)
+	{
+	void *ptr = malloc(size>0 ? size : 1);
+	if(ptr==NULL)
+		{
+		printf("\nerror: blasfeo_dspchol: out of memory\n");
+		exit(1);
+		}
+	return ptr;
+	}
+
+
+
+static int d_spchol_cmp_int(const void *a, const void *b)
+	{
+	int ia = *(const int *) a;
+	int ib = *(const int *) b;
+	return (ia>ib) - (ia<ib);
+	}
+
+
+
+// adjacency graph of the lower triangle of A, mirrored, without diagonal and duplicates
+static void d_spchol_graph(int n, int *colptr, int *rowind, int **xadj_out, int **adj_out)
+	{
+	int ii, jj, kk, pp, p0;
+
+	int *xadj = d_spchol_malloc((n+1)*sizeof(int));
+	int *next = d_spchol_malloc(n*sizeof(int));
+
+	for(ii=0; ii<=n; ii++)
+		xadj[ii] = 0;
+	for(jj=0; jj<n; jj++)
+		{
+		for(pp=colptr[jj]; pp<colptr[jj+1]; pp++)
+			{
+			ii = rowind[pp];
+			if(ii>jj)
+				{
+				xadj[ii+1]++;
+				xadj[jj+1]++;
+				}
+			}
+		}
+	for(ii=0; ii<n; ii++)
+		xadj[ii+1] += xadj[ii];
+
+	int *adj = d_spchol_malloc(xadj[n]*sizeof(int));
+	for(ii=0; ii<n; ii++)
+		next[ii] = xadj[ii];
+	for(jj=0; jj<n; jj++)
+		{
+		for(pp=colptr[jj]; pp<colptr[jj+1]; pp++)
+			{
+			ii = rowind[pp];
+			if(ii>jj)
+				{
+				adj[next[ii]++] = jj;
+				adj[next[jj]++] = ii;
+				}
+			}
+		}
+
+	// remove duplicates (next is reused as marker)
+	for(ii=0; ii<n; ii++)
+		next[ii] = -1;
+	kk = 0;
+	for(ii=0; ii<n; ii++)
+		{
+		p0 = xadj[ii];
+		xadj[ii] = kk;
+		for(pp=p0; pp<xadj[ii+1]; pp++)
+			{
+			jj = adj[pp];
+			if(next[jj]!=ii)
+				{
+				next[jj] = ii;
+				adj[kk++] = jj;
+				}
+			}
+		}
+	xadj[n] = kk;
+
+	free(next);
+
+	*xadj_out = xadj;
+	*adj_out = adj;
+	return;
+	}
+
+
+
+//
+// minimum degree ordering
+//
+
+// quotient graph: each eliminated vertex becomes an element, holding the list of the non eliminated vertices it
+// connects; the elements adjacent to the pivot are absorbed in the new one, so that the vertex lists of the elements
+// never contain eliminated vertices. The degrees are the approximate external degrees of AMD, kept in bucket lists.
+struct d_spchol_md_ws
+	{
+	int *deg;
+	int *head;
+	int *next;
+	int *prev;
+	int *mark; // vertices of the new element
+	int *w; // size of an element minus the vertices of the new element
+	int *wmark;
+	int *status; // 0 vertex, 1 element, 2 absorbed element
+	int **el; // elements adjacent to each vertex
+	int *nel;
+	int *cel;
+	int **ev; // vertices adjacent to each element
+	int *nev;
+	};
+
+
+
+static void d_spchol_md_insert(struct d_spchol_md_ws *ws, int vv, int dd)
+	{
+	ws->deg[vv] = dd;
+	ws->prev[vv] = -1;
+	ws->next[vv] = ws->head[dd];
+	if(ws->head[dd]!=-1)
+		ws->prev[ws->head[dd]] = vv;
+	ws->head[dd] = vv;
+	return;
+	}
+
+
+
+static void d_spchol_md_remove(struct d_spchol_md_ws *ws, int vv)
+	{
+	if(ws->prev[vv]!=-1)
+		ws->next[ws->prev[vv]] = ws->next[vv];
+	else
+		ws->head[ws->deg[vv]] = ws->next[vv];
+	if(ws->next[vv]!=-1)
+		ws->prev[ws->next[vv]] = ws->prev[vv];
+	return;
+	}
+
+
+
+// absorb element ee
+static void d_spchol_md_absorb(struct d_spchol_md_ws *ws, int ee)
+	{
+	ws->status[ee] = 2;
+	free(ws->ev[ee]);
+	ws->ev[ee] = NULL;
+	ws->nev[ee] = 0;
+	return;
+	}
+
+
+
+// perm[k] is the k-th vertex to be eliminated
+static void d_spchol_md(int n, int *xadj, int *adj, int *perm)
+	{
+	if(n<=0)
+		return;
+
+	int ii, jj, kk, pp, vv, uu, ee, cnt, mindeg, dd, d1;
+	int *list;
+
+	struct d_spchol_md_ws ws;
+	int *imem = d_spchol_malloc(11*n*sizeof(int));
+	ws.deg = imem;
+	ws.head = ws.deg+n;
+	ws.next = ws.head+n;
+	ws.prev = ws.next+n;
+	ws.mark = ws.prev+n;
+	ws.w = ws.mark+n;
+	ws.wmark = ws.w+n;
+	ws.status = ws.wmark+n;
+	ws.nel = ws.status+n;
+	ws.cel = ws.nel+n;
+	ws.nev = ws.cel+n;
+	ws.el = d_spchol_malloc(2*n*sizeof(int *));
+	ws.ev = ws.el+n;
+
+	for(ii=0; ii<n; ii++)
+		{
+		ws.head[ii] = -1;
+		ws.mark[ii] = -1;
+		ws.wmark[ii] = -1;
+		ws.status[ii] = 0;
+		ws.el[ii] = NULL;
+		ws.nel[ii] = 0;
+		ws.cel[ii] = 0;
+		ws.ev[ii] = NULL;
+		ws.nev[ii] = 0;
+		}
+	// ties are broken in favour of the smallest index
+	for(ii=n-1; ii>=0; ii--)
+		d_spchol_md_insert(&ws, ii, xadj[ii+1]-xadj[ii]);
+
+	mindeg = 0;
+	for(kk=0; kk<n; kk++)
+		{
+		while(ws.head[mindeg]==-1)
+			mindeg++;
+		vv = ws.head[mindeg];
+		d_spchol_md_remove(&ws, vv);
+		perm[kk] = vv;
+		ws.status[vv] = 1;
+
+		// new element: the vertices adjacent to the pivot (the degree is an upper bound of their number)
+		list = d_spchol_malloc((ws.deg[vv]+1)*sizeof(int));
+		cnt = 0;
+		ws.mark[vv] = kk;
+		for(pp=xadj[vv]; pp<xadj[vv+1]; pp++)
+			{
+			uu = adj[pp];
+			if(ws.status[uu]==0 && ws.mark[uu]!=kk)
+				{
+				ws.mark[uu] = kk;
+				list[cnt++] = uu;
+				}
+			}
+		for(ii=0; ii<ws.nel[vv]; ii++)
+			{
+			ee = ws.el[vv][ii];
+			if(ws.status[ee]!=1)
+				continue;
+			for(pp=0; pp<ws.nev[ee]; pp++)
+				{
+				uu = ws.ev[ee][pp];
+				if(ws.mark[uu]!=kk)
+					{
+					ws.mark[uu] = kk;
+					list[cnt++] = uu;
+					}
+				}
+			d_spchol_md_absorb(&ws, ee);
+			}
+		free(ws.el[vv]);
+		ws.el[vv] = NULL;
+		ws.nel[vv] = 0;
+		ws.ev[vv] = list;
+		ws.nev[vv] = cnt;
+
+		// attach the new element to its vertices, dropping the absorbed ones
+		for(ii=0; ii<cnt; ii++)
+			{
+			uu = list[ii];
+			d_spchol_md_remove(&ws, uu);
+			jj = 0;
+			for(pp=0; pp<ws.nel[uu]; pp++)
+				{
+				ee = ws.el[uu][pp];
+				if(ws.status[ee]==1)
+					ws.el[uu][jj++] = ee;
+				}
+			if(jj>=ws.cel[uu])
+				{
+				ws.cel[uu] = 2*jj+4;
+				ws.el[uu] = realloc(ws.el[uu], ws.cel[uu]*sizeof(int));
+				if(ws.el[uu]==NULL)
+					{
+					printf("\nerror: blasfeo_dspchol: out of memory\n");
+					exit(1);
+					}
+				}
+			ws.el[uu][jj++] = vv;
+			ws.nel[uu] = jj;
+			}
+
+		// number of vertices of the other elements outside of the new one
+		for(ii=0; ii<cnt; ii++)
+			{
+			uu = list[ii];
+			for(pp=0; pp<ws.nel[uu]-1; pp++)
+				{
+				ee = ws.el[uu][pp];
+				if(ws.wmark[ee]!=kk)
+					{
+					ws.wmark[ee] = kk;
+					ws.w[ee] = ws.nev[ee];
+					}
+				ws.w[ee]--;
+				}
+			}
+
+		// approximate degrees: bound by the union of the new element, the other elements and the original neighbours;
+		// the elements contained in the new one are absorbed
+		for(ii=0; ii<cnt; ii++)
+			{
+			uu = list[ii];
+			dd = cnt-1;
+			for(pp=xadj[uu]; pp<xadj[uu+1]; pp++)
+				{
+				jj = adj[pp];
+				if(ws.status[jj]==0 && ws.mark[jj]!=kk)
+					dd++;
+				}
+			for(pp=0; pp<ws.nel[uu]-1; pp++)
+				{
+				ee = ws.el[uu][pp];
+				if(ws.status[ee]!=1)
+					continue;
+				if(ws.w[ee]==0)
+					d_spchol_md_absorb(&ws, ee);
+				else
+					dd += ws.w[ee];
+				}
+			d1 = ws.deg[uu]+cnt-1;
+			dd = d1<dd ? d1 : dd;
+			d1 = n-kk-2;
+			dd = d1<dd ? d1 : dd;
+			d_spchol_md_insert(&ws, uu, dd);
+			if(dd<mindeg)
+				mindeg = dd;
+			}
+		}
+
+	for(ii=0; ii<n; ii++)
+		{
+		free(ws.el[ii]);
+		free(ws.ev[ii]);
+		}
+	free(ws.el);
+	free(imem);
+	return;
+	}
+
+
+
+//
+// nested dissection ordering
+//
+
+struct d_spchol_nd_ws
+	{
+	int *xadj;
+	int *adj;
+	int *verts; // vertices of the subgraphs, reordered in place
+	int *label; // subgraph of each vertex
+	int *level; // breadth first search level
+	int *queue;
+	int *tmp;
+	int n_label;
+	};
+
+
+
+// breadth first search from root in the subgraph with label lab: returns the number of reached vertices,
+// listed in queue by increasing level
+static int d_spchol_nd_bfs(struct d_spchol_nd_ws *ws, int lab, int root)
+	{
+	int *xadj = ws->xadj;
+	int *adj = ws->adj;
+	int *label = ws->label;
+	int *level = ws->level;
+	int *queue = ws->queue;
+	int pp, vv, uu;
+	int head = 0;
+	int tail = 1;
+	queue[0] = root;
+	level[root] = 0;
+	while(head<tail)
+		{
+		vv = queue[head++];
+		for(pp=xadj[vv]; pp<xadj[vv+1]; pp++)
+			{
+			uu = adj[pp];
+			if(label[uu]==lab && level[uu]<0)
+				{
+				level[uu] = level[vv]+1;
+				queue[tail++] = uu;
+				}
+			}
+		}
+	return tail;
+	}
+
+
+
+// order the vertices verts[lo],...,verts[hi-1] by minimum degree on their induced subgraph
+static void d_spchol_nd_leaf(struct d_spchol_nd_ws *ws, int lo, int hi)
+	{
+	int nv = hi-lo;
+	if(nv<=1)
+		return;
+
+	int *xadj = ws->xadj;
+	int *adj = ws->adj;
+	int *label = ws->label;
+	int *seg = ws->verts+lo;
+	int *loc = ws->level; // local index
+	int ii, pp, vv, uu, ne;
+
+	int lab = ++ws->n_label;
+	for(ii=0; ii<nv; ii++)
+		{
+		label[seg[ii]] = lab;
+		loc[seg[ii]] = ii;
+		}
+	ne = 0;
+	for(ii=0; ii<nv; ii++)
+		{
+		vv = seg[ii];
+		for(pp=xadj[vv]; pp<xadj[vv+1]; pp++)
+			if(label[adj[pp]]==lab)
+				ne++;
+		}
+
+	int *sxadj = d_spchol_malloc((2*nv+1+ne)*sizeof(int));
+	int *sperm = sxadj+nv+1;
+	int *sadj = sperm+nv;
+	ne = 0;
+	for(ii=0; ii<nv; ii++)
+		{
+		sxadj[ii] = ne;
+		vv = seg[ii];
+		for(pp=xadj[vv]; pp<xadj[vv+1]; pp++)
+			{
+			uu = adj[pp];
+			if(label[uu]==lab)
+				sadj[ne++] = loc[uu];
+			}
+		}
+	sxadj[nv] = ne;
+
+	d_spchol_md(nv, sxadj, sadj, sperm);
+
+	for(ii=0; ii<nv; ii++)
+		ws->tmp[ii] = seg[sperm[ii]];
+	for(ii=0; ii<nv; ii++)
+		seg[ii] = ws->tmp[ii];
+
+	free(sxadj);
+	return;
+	}
+
+
+
+// order the vertices verts[lo],...,verts[hi-1]: the two parts split by a level structure separator first, recursively,
+// then the separator
+static void d_spchol_nd(struct d_spchol_nd_ws *ws, int lo, int hi)
+	{
+	int nv = hi-lo;
+	if(nv<=D_SPCHOL_ND_LEAF)
+		{
+		d_spchol_nd_leaf(ws, lo, hi);
+		return;
+		}
+
+	int *xadj = ws->xadj;
+	int *adj = ws->adj;
+	int *label = ws->label;
+	int *level = ws->level;
+	int *queue = ws->queue;
+	int *tmp = ws->tmp;
+	int *seg = ws->verts+lo;
+	int ii, jj, pp, it, vv, uu, cnt, ecc, cand, sep, acc, nA, nB;
+
+	int lab = ++ws->n_label;
+	for(ii=0; ii<nv; ii++)
+		{
+		label[seg[ii]] = lab;
+		level[seg[ii]] = -1;
+		}
+
+	int root = seg[0];
+	cnt = d_spchol_nd_bfs(ws, lab, root);
+
+	if(cnt<nv)
+		{
+		// not connected: list the components one after the other, and order each of them
+		int n_comp = 0;
+		int *comp = d_spchol_malloc((nv+1)*sizeof(int));
+		comp[0] = 0;
+		jj = 0;
+		for(ii=0; ii<nv; ii++)
+			{
+			vv = seg[ii];
+			if(level[vv]>=0 && ii>0)
+				continue;
+			if(ii>0)
+				cnt = d_spchol_nd_bfs(ws, lab, vv);
+			for(pp=0; pp<cnt; pp++)
+				tmp[jj+pp] = queue[pp];
+			jj += cnt;
+			comp[++n_comp] = jj;
+			}
+		for(ii=0; ii<nv; ii++)
+			seg[ii] = tmp[ii];
+		for(ii=0; ii<n_comp; ii++)
+			d_spchol_nd(ws, lo+comp[ii], lo+comp[ii+1]);
+		free(comp);
+		return;
+		}
+
+	// pseudo-peripheral root: restart from a vertex of minimum degree in the last level while the depth grows
+	ecc = level[queue[cnt-1]];
+	for(it=0; it<D_SPCHOL_ND_PERIPH_IT; it++)
+		{
+		cand = queue[cnt-1];
+		for(ii=cnt-2; ii>=0 && level[queue[ii]]==ecc; ii--)
+			if(xadj[queue[ii]+1]-xadj[queue[ii]] < xadj[cand+1]-xadj[cand])
+				cand = queue[ii];
+		for(ii=0; ii<nv; ii++)
+			level[seg[ii]] = -1;
+		d_spchol_nd_bfs(ws, lab, cand);
+		if(level[queue[cnt-1]]>ecc)
+			{
+			root = cand;
+			ecc = level[queue[cnt-1]];
+			}
+		else
+			{
+			for(ii=0; ii<nv; ii++)
+				level[seg[ii]] = -1;
+			d_spchol_nd_bfs(ws, lab, root);
+			break;
+			}
+		}
+
+	// too few levels for a small separator
+	if(ecc<2)
+		{
+		d_spchol_nd_leaf(ws, lo, hi);
+		return;
+		}
+
+	// separator level: the one splitting the vertices in halves
+	for(ii=0; ii<=ecc; ii++)
+		tmp[ii] = 0;
+	for(ii=0; ii<nv; ii++)
+		tmp[level[seg[ii]]]++;
+	acc = 0;
+	for(sep=0; sep<ecc; sep++)
+		{
+		if(acc+tmp[sep]>nv/2)
+			break;
+		acc += tmp[sep];
+		}
+	sep = sep<1 ? 1 : sep;
+	sep = sep>ecc-1 ? ecc-1 : sep;
+
+	// only the separator level vertices adjacent to the next level are kept in the separator (class 2);
+	// the parts are the lower levels (class 0) and the higher levels (class 1)
+	nA = 0;
+	nB = 0;
+	for(ii=0; ii<nv; ii++)
+		{
+		vv = seg[ii];
+		if(level[vv]<sep)
+			queue[ii] = 0;
+		else if(level[vv]>sep)
+			queue[ii] = 1;
+		else
+			{
+			queue[ii] = 0;
+			for(pp=xadj[vv]; pp<xadj[vv+1]; pp++)
+				{
+				uu = adj[pp];
+				if(label[uu]==lab && level[uu]==sep+1)
+					{
+					queue[ii] = 2;
+					break;
+					}
+				}
+			}
+		nA += queue[ii]==0;
+		nB += queue[ii]==1;
+		}
+	jj = 0;
+	for(ii=0; ii<nv; ii++)
+		{
+		if(queue[ii]==0)
+			tmp[jj++] = seg[ii];
+		}
+	for(ii=0; ii<nv; ii++)
+		{
+		if(queue[ii]==1)
+			tmp[jj++] = seg[ii];
+		}
+	for(ii=0; ii<nv; ii++)
+		{
+		if(queue[ii]==2)
+			tmp[jj++] = seg[ii];
+		}
+	for(ii=0; ii<nv; ii++)
+		seg[ii] = tmp[ii];
+
+	d_spchol_nd(ws, lo, lo+nA);
+	d_spchol_nd(ws, lo+nA, lo+nA+nB);
+	return;
+	}
+
+
+
+static void d_spchol_nd_order(int n, int *xadj, int *adj, int *perm)
+	{
+	int ii;
+	struct d_spchol_nd_ws ws;
+	int *imem = d_spchol_malloc(4*n*sizeof(int));
+	ws.xadj = xadj;
+	ws.adj = adj;
+	ws.verts = perm;
+	ws.label = imem;
+	ws.level = ws.label+n;
+	ws.queue = ws.level+n;
+	ws.tmp = ws.queue+n;
+	ws.n_label = 0;
+	for(ii=0; ii<n; ii++)
+		{
+		perm[ii] = ii;
+		ws.label[ii] = 0;
+		}
+	d_spchol_nd(&ws, 0, n);
+	free(imem);
+	return;
+	}
+
+
+
+//
+// symbolic analysis
+//
+
+// relaxed amalgamation: a child is merged in its parent if the merged supernode has at most
+// d_spchol_nrelax[ii] columns and a fraction of explicit zeros below d_spchol_zrelax[ii]
+static const int d_spchol_nrelax[3] = {4, 16, 48};
+static const double d_spchol_zrelax[3] = {0.8, 0.1, 0.05};
+
+
+
+static int d_spchol_relax(int nc, double zfrac)
+	{
+	if(nc<=d_spchol_nrelax[0])
+		return 1;
+	if(nc<=d_spchol_nrelax[1])
+		return zfrac<d_spchol_zrelax[0];
+	if(nc<=d_spchol_nrelax[2])
+		return zfrac<d_spchol_zrelax[1];
+	return zfrac<d_spchol_zrelax[2];
+	}
+
+
+
+// entries of the lower trapezoid of a supernode with nc columns and m rows
+static double d_spchol_trap(int nc, int m)
+	{
+	return (double) nc*m - 0.5*(double) nc*(nc-1);
+	}
+
+
+
+void blasfeo_dspchol_analyze(int n, int *colptr, int *rowind, int order, struct blasfeo_dspchol *sp)
+	{
+	int ii, jj, kk, pp, ss, tt, cc, ff, nc, mm, m2, ns, nf, nnz;
+	double nz_g, tot;
+
+	int *xadj, *adj;
+	d_spchol_graph(n, colptr, rowind, &xadj, &adj);
+
+	int *perm = d_spchol_malloc(n*sizeof(int));
+	if(order==BLASFEO_SPCHOL_ORDER_MD)
+		d_spchol_md(n, xadj, adj, perm);
+	else if(order==BLASFEO_SPCHOL_ORDER_ND)
+		d_spchol_nd_order(n, xadj, adj, perm);
+	else
+		for(ii=0; ii<n; ii++)
+			perm[ii] = ii;
+
+	int *imem = d_spchol_malloc(10*(n+1)*sizeof(int));
+	int *iperm = imem;
+	int *parent = iperm+n+1;
+	int *work0 = parent+n+1;
+	int *work1 = work0+n+1;
+	int *work2 = work1+n+1;
+	int *cnt = work2+n+1; // column counts
+	int *fs_first = cnt+n+1; // fundamental supernodes
+	int *fs_parent = fs_first+n+1;
+	int *rep = fs_parent+n+1;
+	int *g_first = rep+n+1; // supernodes, last to first
+
+	// elimination tree of the permuted matrix (work0 is the virtual ancestor)
+	for(ii=0; ii<n; ii++)
+		iperm[perm[ii]] = ii;
+	for(kk=0; kk<n; kk++)
+		{
+		parent[kk] = -1;
+		work0[kk] = -1;
+		for(pp=xadj[perm[kk]]; pp<xadj[perm[kk]+1]; pp++)
+			{
+			ii = iperm[adj[pp]];
+			while(ii!=-1 && ii<kk)
+				{
+				jj = work0[ii];
+				work0[ii] = kk;
+				if(jj==-1)
+					parent[ii] = kk;
+				ii = jj;
+				}
+			}
+		}
+
+	// postorder (work0 head and work1 next of the children lists, work2 stack, cnt postorder)
+	for(ii=0; ii<n; ii++)
+		work0[ii] = -1;
+	for(ii=n-1; ii>=0; ii--)
+		{
+		if(parent[ii]!=-1)
+			{
+			work1[ii] = work0[parent[ii]];
+			work0[parent[ii]] = ii;
+			}
+		}
+	kk = 0;
+	for(jj=0; jj<n; jj++)
+		{
+		if(parent[jj]!=-1)
+			continue;
+		tt = 0;
+		work2[0] = jj;
+		while(tt>=0)
+			{
+			pp = work2[tt];
+			ii = work0[pp];
+			if(ii==-1)
+				{
+				tt--;
+				cnt[kk++] = pp;
+				}
+			else
+				{
+				work0[pp] = work1[ii];
+				work2[++tt] = ii;
+				}
+			}
+		}
+	// relabel in postorder
+	for(kk=0; kk<n; kk++)
+		work0[cnt[kk]] = kk;
+	for(kk=0; kk<n; kk++)
+		{
+		work1[kk] = perm[cnt[kk]];
+		work2[kk] = parent[cnt[kk]]==-1 ? -1 : work0[parent[cnt[kk]]];
+		}
+	for(kk=0; kk<n; kk++)
+		{
+		perm[kk] = work1[kk];
+		parent[kk] = work2[kk];
+		iperm[perm[kk]] = kk;
+		}
+
+	// column counts, from the row subtrees (work0 marker), and number of children (work1)
+	for(kk=0; kk<n; kk++)
+		{
+		cnt[kk] = 1;
+		work1[kk] = 0;
+		}
+	for(kk=0; kk<n; kk++)
+		{
+		if(parent[kk]!=-1)
+			work1[parent[kk]]++;
+		work0[kk] = kk;
+		for(pp=xadj[perm[kk]]; pp<xadj[perm[kk]+1]; pp++)
+			{
+			for(ii=iperm[adj[pp]]; ii<kk && work0[ii]!=kk; ii=parent[ii])
+				{
+				cnt[ii]++;
+				work0[ii] = kk;
+				}
+			}
+		}
+
+	// fundamental supernodes (work2 supernode of each column)
+	nf = 0;
+	for(kk=0; kk<n; kk++)
+		{
+		if(kk==0 || parent[kk-1]!=kk || cnt[kk-1]!=cnt[kk]+1 || work1[kk]!=1)
+			fs_first[nf++] = kk;
+		work2[kk] = nf-1;
+		}
+	fs_first[nf] = n;
+	for(ff=0; ff<nf; ff++)
+		{
+		jj = parent[fs_first[ff+1]-1];
+		fs_parent[ff] = jj==-1 ? -1 : work2[jj];
+		rep[ff] = ff;
+		}
+
+	// relaxed amalgamation, from the roots: the fundamental supernode just before a supernode (in postorder) is
+	// its last child, and its columns are contiguous to the ones of the supernode
+	ns = 0;
+	ff = nf-1;
+	while(ff>=0)
+		{
+		tt = ff;
+		nc = fs_first[tt+1]-fs_first[tt];
+		mm = cnt[fs_first[tt]];
+		nz_g = d_spchol_trap(nc, mm);
+		while(ff>0 && fs_parent[ff-1]!=-1 && rep[fs_parent[ff-1]]==tt)
+			{
+			cc = ff-1;
+			jj = fs_first[cc+1]-fs_first[cc];
+			tot = d_spchol_trap(nc+jj, mm+jj);
+			if(!d_spchol_relax(nc+jj, 1.0-(nz_g+d_spchol_trap(jj, cnt[fs_first[cc]]))/tot))
+				break;
+			rep[cc] = tt;
+			nz_g += d_spchol_trap(jj, cnt[fs_first[cc]]);
+			nc += jj;
+			mm += jj;
+			ff = cc;
+			}
+		g_first[ns] = fs_first[ff];
+		work0[ns] = mm; // number of rows
+		ns++;
+		ff--;
+		}
+
+	// allocate the analysis
+	nnz = 0;
+	for(jj=0; jj<n; jj++)
+		for(pp=colptr[jj]; pp<colptr[jj+1]; pp++)
+			nnz += rowind[pp]>=jj;
+	size_t n_idx = 0;
+	for(ss=0; ss<ns; ss++)
+		n_idx += work0[ss];
+	// the children lists (at most ns entries) are the dependencies of the task graph of the factorization
+	size_t size = 2*ns*sizeof(struct blasfeo_dmat) + (n + 6*(ns+1) + 2*n_idx + 3*nnz)*sizeof(int) + blasfeo_thread_dag_memsize(ns, ns);
+	sp->mem = d_spchol_malloc(size);
+	sp->sF = (struct blasfeo_dmat *) sp->mem;
+	sp->sU = sp->sF+ns;
+	sp->perm = (int *) (sp->sU+ns);
+	sp->sn_first = sp->perm+n;
+	sp->sn_parent = sp->sn_first+ns+1;
+	sp->sn_ptr = sp->sn_parent+ns+1;
+	sp->child_ptr = sp->sn_ptr+ns+1;
+	sp->child = sp->child_ptr+ns+1;
+	sp->a_ptr = sp->child+ns+1;
+	sp->sn_idx = sp->a_ptr+ns+1;
+	sp->sn_rel = sp->sn_idx+n_idx;
+	sp->a_idx = sp->sn_rel+n_idx;
+	sp->a_row = sp->a_idx+nnz;
+	sp->a_col = sp->a_row+nnz;
+	sp->dag_work = sp->a_col+nnz;
+	sp->n = n;
+	sp->ns = ns;
+
+	int *sn_first = sp->sn_first;
+	int *sn_parent = sp->sn_parent;
+	int *sn_ptr = sp->sn_ptr;
+	int *sn_idx = sp->sn_idx;
+	int *sn_rel = sp->sn_rel;
+	int *child_ptr = sp->child_ptr;
+	int *child = sp->child;
+	int *a_ptr = sp->a_ptr;
+
+	for(ii=0; ii<n; ii++)
+		sp->perm[ii] = perm[ii];
+	sn_ptr[0] = 0;
+	for(ss=0; ss<ns; ss++)
+		{
+		sn_first[ss] = g_first[ns-1-ss];
+		sn_ptr[ss+1] = sn_ptr[ss] + work0[ns-1-ss];
+		}
+	sn_first[ns] = n;
+	// supernode of each column (work2)
+	for(ss=0; ss<ns; ss++)
+		for(kk=sn_first[ss]; kk<sn_first[ss+1]; kk++)
+			work2[kk] = ss;
+	for(ss=0; ss<ns; ss++)
+		{
+		jj = parent[sn_first[ss+1]-1];
+		sn_parent[ss] = jj==-1 ? -1 : work2[jj];
+		}
+	// children lists
+	for(ss=0; ss<=ns; ss++)
+		child_ptr[ss] = 0;
+	for(ss=0; ss<ns; ss++)
+		if(sn_parent[ss]!=-1)
+			child_ptr[sn_parent[ss]+1]++;
+	for(ss=0; ss<ns; ss++)
+		child_ptr[ss+1] += child_ptr[ss];
+	for(ss=0; ss<ns; ss++)
+		work1[ss] = child_ptr[ss];
+	for(ss=0; ss<ns; ss++)
+		if(sn_parent[ss]!=-1)
+			child[work1[sn_parent[ss]]++] = ss;
+
+	// row indices of the supernodes: own columns, then the sorted rows below from A and from the children;
+	// position of the rows of the children in the parent (work0 marker, work1 position)
+	for(ii=0; ii<n; ii++)
+		work0[ii] = -1;
+	sp->m_max = 0;
+	sp->nnz_l = 0;
+	sp->flops = 0.0;
+	for(ss=0; ss<ns; ss++)
+		{
+		int *idx = sn_idx+sn_ptr[ss];
+		int first = sn_first[ss];
+		int last = sn_first[ss+1]-1;
+		nc = last-first+1;
+		kk = 0;
+		for(jj=first; jj<=last; jj++)
+			{
+			idx[kk++] = jj;
+			work0[jj] = ss;
+			}
+		for(jj=first; jj<=last; jj++)
+			{
+			for(pp=xadj[perm[jj]]; pp<xadj[perm[jj]+1]; pp++)
+				{
+				ii = iperm[adj[pp]];
+				if(ii>last && work0[ii]!=ss)
+					{
+					work0[ii] = ss;
+					idx[kk++] = ii;
+					}
+				}
+			}
+		for(tt=child_ptr[ss]; tt<child_ptr[ss+1]; tt++)
+			{
+			cc = child[tt];
+			for(pp=sn_ptr[cc]+sn_first[cc+1]-sn_first[cc]; pp<sn_ptr[cc+1]; pp++)
+				{
+				ii = sn_idx[pp];
+				if(ii>last && work0[ii]!=ss)
+					{
+					work0[ii] = ss;
+					idx[kk++] = ii;
+					}
+				}
+			}
+		mm = sn_ptr[ss+1]-sn_ptr[ss];
+		if(kk!=mm)
+			{
+			printf("\nerror: blasfeo_dspchol_analyze: inconsistent supernode structure\n");
+			exit(1);
+			}
+		qsort(idx+nc, mm-nc, sizeof(int), &d_spchol_cmp_int);
+
+		for(kk=0; kk<mm; kk++)
+			work1[idx[kk]] = kk;
+		for(tt=child_ptr[ss]; tt<child_ptr[ss+1]; tt++)
+			{
+			cc = child[tt];
+			for(pp=sn_ptr[cc]; pp<sn_ptr[cc+1]; pp++)
+				sn_rel[pp] = work1[sn_idx[pp]];
+			}
+		for(pp=sn_ptr[ss]; pp<sn_ptr[ss+1]; pp++)
+			sn_rel[pp] = 0;
+
+		m2 = mm-nc;
+		sp->m_max = mm>sp->m_max ? mm : sp->m_max;
+		sp->nnz_l += (long long) d_spchol_trap(nc, mm);
+		sp->flops += (double) nc*nc*nc/3.0 + (double) m2*nc*nc + (double) m2*m2*nc;
+		}
+
+	// entries of A assembled in each supernode, bucketed by pivot column (work0 counters): the global row and column
+	// are stored first, and converted to the position in the frontal matrix
+	for(kk=0; kk<=n; kk++)
+		work0[kk] = 0;
+	for(jj=0; jj<n; jj++)
+		{
+		for(pp=colptr[jj]; pp<colptr[jj+1]; pp++)
+			{
+			ii = rowind[pp];
+			if(ii>=jj)
+				{
+				kk = iperm[ii]<iperm[jj] ? iperm[ii] : iperm[jj];
+				work0[kk+1]++;
+				}
+			}
+		}
+	for(kk=0; kk<n; kk++)
+		work0[kk+1] += work0[kk];
+	for(ss=0; ss<=ns; ss++)
+		a_ptr[ss] = work0[sn_first[ss]];
+	for(jj=0; jj<n; jj++)
+		{
+		for(pp=colptr[jj]; pp<colptr[jj+1]; pp++)
+			{
+			ii = rowind[pp];
+			if(ii>=jj)
+				{
+				cc = iperm[jj];
+				kk = iperm[ii];
+				tt = kk<cc ? kk : cc;
+				kk = kk<cc ? cc : kk;
+				sp->a_idx[work0[tt]] = pp;
+				sp->a_row[work0[tt]] = kk;
+				sp->a_col[work0[tt]] = tt;
+				work0[tt]++;
+				}
+			}
+		}
+	for(ss=0; ss<ns; ss++)
+		{
+		for(pp=sn_ptr[ss]; pp<sn_ptr[ss+1]; pp++)
+			{
+			work1[sn_idx[pp]] = pp-sn_ptr[ss];
+			}
+		for(tt=a_ptr[ss]; tt<a_ptr[ss+1]; tt++)
+			{
+			sp->a_row[tt] = work1[sp->a_row[tt]];
+			sp->a_col[tt] -= sn_first[ss];
+			}
+		}
+
+	// panels of L, solve and extend-add workspace; the rows of the update matrix of a child are a subset of the ones of
+	// its parent, so each supernode gets its own segment of the extend-add vector and the parallel fronts do not share it
+	size = 0;
+	for(ss=0; ss<ns; ss++)
+		{
+		nc = sn_first[ss+1]-sn_first[ss];
+		mm = sn_ptr[ss+1]-sn_ptr[ss];
+		size += (blasfeo_memsize_dmat(mm, nc)+63)/64*64;
+		}
+	size += (blasfeo_memsize_dvec(n)+63)/64*64;
+	size += (blasfeo_memsize_dvec(sp->m_max)+63)/64*64;
+	size += (blasfeo_memsize_dvec(sn_ptr[ns])+63)/64*64;
+	blasfeo_malloc_align(&sp->mem_F, size);
+	char *c_ptr = (char *) sp->mem_F;
+	for(ss=0; ss<ns; ss++)
+		{
+		nc = sn_first[ss+1]-sn_first[ss];
+		mm = sn_ptr[ss+1]-sn_ptr[ss];
+		blasfeo_create_dmat(mm, nc, sp->sF+ss, c_ptr);
+		c_ptr += (blasfeo_memsize_dmat(mm, nc)+63)/64*64;
+		}
+	blasfeo_create_dvec(n, &sp->sw, c_ptr);
+	c_ptr += (blasfeo_memsize_dvec(n)+63)/64*64;
+	blasfeo_create_dvec(sp->m_max, &sp->st, c_ptr);
+	c_ptr += (blasfeo_memsize_dvec(sp->m_max)+63)/64*64;
+	blasfeo_create_dvec(sn_ptr[ns], &sp->se, c_ptr);
+
+	// stack of the update matrices in postorder: the ones of the children are on top when a supernode is factorized,
+	// its own goes above them and is moved down in their place after the extend-add
+	size = 0;
+	sp->memsize_U = 0;
+	for(ss=0; ss<ns; ss++)
+		{
+		m2 = sn_ptr[ss+1]-sn_ptr[ss] - (sn_first[ss+1]-sn_first[ss]);
+		size += d_spchol_memsize_u(m2);
+		sp->memsize_U = size>sp->memsize_U ? size : sp->memsize_U;
+		for(tt=child_ptr[ss]; tt<child_ptr[ss+1]; tt++)
+			{
+			cc = child[tt];
+			size -= d_spchol_memsize_u(sn_ptr[cc+1]-sn_ptr[cc] - (sn_first[cc+1]-sn_first[cc]));
+			}
+		}
+	sp->mem_U = NULL;
+
+	free(imem);
+	free(perm);
+	free(xadj);
+	free(adj);
+	return;
+	}
+
+
+
+void blasfeo_dspchol_free(struct blasfeo_dspchol *sp)
+	{
+	free(sp->mem);
+	blasfeo_free_align(sp->mem_F);
+	blasfeo_free_align(sp->mem_U);
+	sp->mem = NULL;
+	sp->mem_F = NULL;
+	sp->mem_U = NULL;
+	return;
+	}
+
+
+
+//
+// numeric factorization
+//
+
+struct d_spchol_arg
+	{
+	struct blasfeo_dspchol *sp;
+	double *val;
+	};
+
+
+
+// assemble the frontal matrix of supernode ss, factorize its columns and compute its update matrix in mem_U, or in
+// memory allocated here if mem_U is NULL (the update matrices of the children are then released after the extend-add)
+static void d_spchol_front(struct blasfeo_dspchol *sp, double *val, int ss, void *mem_U)
+	{
+	struct blasfeo_dmat *sF = sp->sF+ss;
+	struct blasfeo_dmat *sU = sp->sU+ss;
+	int nc = sp->sn_first[ss+1]-sp->sn_first[ss];
+	int m2 = sp->sn_ptr[ss+1]-sp->sn_ptr[ss] - nc;
+	int xi = sp->sn_ptr[ss];
+	int jj, tt, cc, ncc, m2c;
+	int *rel;
+
+	if(m2>0)
+		{
+		if(mem_U==NULL)
+			blasfeo_malloc_align(&mem_U, d_spchol_memsize_u(m2));
+		blasfeo_create_dmat(m2, m2, sU, mem_U);
+		blasfeo_dgese(m2, m2, 0.0, sU, 0, 0);
+		}
+	blasfeo_dgese(nc+m2, nc, 0.0, sF, 0, 0);
+
+	// entries of A, all in the columns of the supernode
+	for(tt=sp->a_ptr[ss]; tt<sp->a_ptr[ss+1]; tt++)
+		BLASFEO_DMATEL(sF, sp->a_row[tt], sp->a_col[tt]) += val[sp->a_idx[tt]];
+
+	// extend-add of the update matrices of the children, one column at a time: the rows are sorted, so the columns
+	// in the supernode come first and go to the panel of L, the others to the update matrix
+	for(tt=sp->child_ptr[ss]; tt<sp->child_ptr[ss+1]; tt++)
+		{
+		cc = sp->child[tt];
+		ncc = sp->sn_first[cc+1]-sp->sn_first[cc];
+		m2c = sp->sn_ptr[cc+1]-sp->sn_ptr[cc] - ncc;
+		rel = sp->sn_rel+sp->sn_ptr[cc]+ncc;
+		for(jj=0; jj<m2c; jj++)
+			{
+			blasfeo_dcolex(m2c-jj, sp->sU+cc, jj, jj, &sp->se, xi);
+			if(rel[jj]<nc)
+				blasfeo_dcolad_sp(m2c-jj, 1.0, &sp->se, xi, rel+jj, sF, 0, rel[jj]);
+			else
+				blasfeo_dcolad_sp(m2c-jj, 1.0, &sp->se, xi, rel+jj, sU, -nc, rel[jj]-nc);
+			}
+		if(m2c>0 && sp->mem_U==NULL)
+			blasfeo_free_align(sp->sU[cc].pA);
+		}
+
+	blasfeo_dpotrf_l_mn(nc+m2, nc, sF, 0, 0, sF, 0, 0);
+	if(m2>0)
+		blasfeo_dsyrk_ln(m2, nc, -1.0, sF, nc, 0, sF, nc, 0, 1.0, sU, 0, 0, sU, 0, 0);
+	return;
+	}
+
+
+
+static void d_spchol_task(void *ptr, int task_id)
+	{
+	struct d_spchol_arg *arg = (struct d_spchol_arg *) ptr;
+	d_spchol_front(arg->sp, arg->val, task_id, NULL);
+	return;
+	}
+
+
+
+void blasfeo_dspchol_factorize(double *val, struct blasfeo_dspchol *sp)
+	{
+	int ns = sp->ns;
+	int ss, tt, cc, m2;
+	size_t top, size;
+	char *c_ptr;
+
+	// a supernode is ready once its children are done: the children lists are the dependencies of the task graph
+	int nt = blasfeo_thread_pool_num_threads();
+	if(nt>1 && ns>1 && sp->flops>=2.0*nt*D_SPCHOL_MT_MIN_WORK)
+		{
+		struct d_spchol_arg arg;
+		arg.sp = sp;
+		arg.val = val;
+		blasfeo_free_align(sp->mem_U);
+		sp->mem_U = NULL;
+		blasfeo_thread_dag_run(ns, sp->child_ptr, sp->child, NULL, &d_spchol_task, &arg, sp->dag_work);
+		}
+	else
+		{
+		// the stack is kept for the next factorizations
+		if(sp->mem_U==NULL)
+			blasfeo_malloc_align(&sp->mem_U, sp->memsize_U>0 ? sp->memsize_U : 64);
+		top = 0;
+		for(ss=0; ss<ns; ss++)
+			{
+			m2 = sp->sn_ptr[ss+1]-sp->sn_ptr[ss] - (sp->sn_first[ss+1]-sp->sn_first[ss]);
+			c_ptr = (char *) sp->mem_U + top;
+			d_spchol_front(sp, val, ss, c_ptr);
+			for(tt=sp->child_ptr[ss]; tt<sp->child_ptr[ss+1]; tt++)
+				{
+				cc = sp->child[tt];
+				top -= d_spchol_memsize_u(sp->sn_ptr[cc+1]-sp->sn_ptr[cc] - (sp->sn_first[cc+1]-sp->sn_first[cc]));
+				}
+			size = d_spchol_memsize_u(m2);
+			if(size>0 && (char *) sp->mem_U + top != c_ptr)
+				{
+				memmove((char *) sp->mem_U + top, c_ptr, size);
+				blasfeo_create_dmat(m2, m2, sp->sU+ss, (char *) sp->mem_U + top);
+				}
+			top += size;
+			}
+		}
+	return;
+	}
+
+
+
+//
+// solve
+//
+
+void blasfeo_dspchol_solve(struct blasfeo_dspchol *sp, struct blasfeo_dvec *sb, int bi, struct blasfeo_dvec *sx, int xi)
+	{
+	struct blasfeo_dvec *sw = &sp->sw;
+	struct blasfeo_dvec *st = &sp->st;
+	int ss, c0, nc, m2;
+	int *idx;
+
+	blasfeo_dvecex_sp(sp->n, 1.0, sp->perm, sb, bi, sw, 0);
+
+	// L * y = P * b
+	for(ss=0; ss<sp->ns; ss++)
+		{
+		c0 = sp->sn_first[ss];
+		nc = sp->sn_first[ss+1]-c0;
+		m2 = sp->sn_ptr[ss+1]-sp->sn_ptr[ss] - nc;
+		idx = sp->sn_idx+sp->sn_ptr[ss]+nc;
+		blasfeo_dtrsv_lnn(nc, sp->sF+ss, 0, 0, sw, c0, sw, c0);
+		if(m2>0)
+			{
+			blasfeo_dgemv_n(m2, nc, 1.0, sp->sF+ss, nc, 0, sw, c0, 0.0, st, 0, st, 0);
+			blasfeo_dvecad_sp(m2, -1.0, st, 0, idx, sw, 0);
+			}
+		}
+
+	// L^T * P * x = y
+	for(ss=sp->ns-1; ss>=0; ss--)
+		{
+		c0 = sp->sn_first[ss];
+		nc = sp->sn_first[ss+1]-c0;
+		m2 = sp->sn_ptr[ss+1]-sp->sn_ptr[ss] - nc;
+		idx = sp->sn_idx+sp->sn_ptr[ss]+nc;
+		if(m2>0)
+			{
+			blasfeo_dvecex_sp(m2, 1.0, idx, sw, 0, st, 0);
+			blasfeo_dgemv_t(m2, nc, -1.0, sp->sF+ss, nc, 0, st, 0, 1.0, sw, c0, sw, c0);
+			}
+		blasfeo_dtrsv_ltn(nc, sp->sF+ss, 0, 0, sw, c0, sw, c0);
+		}
+
+	blasfeo_dvecin_sp(sp->n, 1.0, sw, 0, sp->perm, sx, xi);
+	return;
+	}
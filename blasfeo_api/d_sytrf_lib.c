@@ -0,0 +1,372 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "../include/blasfeo_common.h"
+#include "../include/blasfeo_d_aux.h"
+#include "../include/blasfeo_d_blasfeo_api.h"
+
+
+
+// symmetric indefinite LDL^T factorization with Bunch-Kaufman pivoting
+
+
+
+// width of the panels of the blocked factorization
+#define DSYTRF_NB 24
+// (1+sqrt(17))/8, threshold between 1x1 and 2x2 pivots minimizing the element growth bound
+#define DSYTRF_ALPHA 0.64038820320220756
+
+
+
+static int d_sytrf_size_align(int size)
+	{
+	return (size+63)/64*64;
+	}
+
+
+
+int blasfeo_dsytrf_l_worksize(int m)
+	{
+	int size = 64; // alignment
+	size += d_sytrf_size_align(blasfeo_memsize_dmat(m+3, DSYTRF_NB));
+	size += 2*d_sytrf_size_align(blasfeo_memsize_dvec(m));
+	size += d_sytrf_size_align(blasfeo_memsize_dvec(DSYTRF_NB));
+	return size;
+	}
+
+
+
+// y[k:m] <= column jc (rows k:m) of the symmetric matrix stored in the lower triangle of D, minus the updates of
+// the kk columns of the current panel: D[k:m,j0:j0+kk] * W[wi+jc,0:kk]^T
+static void d_sytrf_col(int m, int k, int jc, int j0, int kk, struct blasfeo_dmat *sD, int di, int dj, struct blasfeo_dmat *sW, int wi, struct blasfeo_dvec *sx, struct blasfeo_dvec *sy)
+	{
+	// rows k:jc are in row jc, rows jc:m in column jc
+	blasfeo_drowex(jc-k, 1.0, sD, di+jc, dj+k, sy, k);
+	blasfeo_dcolex(m-jc, sD, di+jc, dj+jc, sy, jc);
+	if(kk>0)
+		{
+		blasfeo_drowex(kk, 1.0, sW, wi+jc, 0, sx, 0);
+		blasfeo_dgemv_n(m-k, kk, -1.0, sD, di+k, dj+j0, sx, 0, 1.0, sy, k, sy, k);
+		}
+	return;
+	}
+
+
+
+// blocked as LAPACK dlasyf: the columns of a panel are updated on the fly, and their contribution L21*E1 is
+// accumulated in W, so that the trailing matrix is updated once per panel with dsyrk;
+// row interchanges are applied to all the previous columns, so that P*C*P^T = L*E*L^T holds with P the product of
+// all the interchanges
+void blasfeo_dsytrf_l(int m, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, int *ipiv, void *work)
+	{
+	if(m<=0)
+		return;
+
+	// invalidate stored inverse diagonal of result matrix
+	sD->use_dA = 0;
+
+	const int nb = DSYTRF_NB;
+	const double alpha = DSYTRF_ALPHA;
+
+	struct blasfeo_dmat sW;
+	struct blasfeo_dvec sx, sy0, sy1, sy_tmp;
+
+	// the rows of W are aligned in the panels as the rows of D
+	int wi = di%4;
+
+	char *c_ptr = (char *) (((size_t) work + 63) / 64 * 64);
+	blasfeo_create_dmat(m+3, nb, &sW, c_ptr);
+	c_ptr += d_sytrf_size_align(blasfeo_memsize_dmat(m+3, nb));
+	blasfeo_create_dvec(m, &sy0, c_ptr);
+	c_ptr += d_sytrf_size_align(blasfeo_memsize_dvec(m));
+	blasfeo_create_dvec(m, &sy1, c_ptr);
+	c_ptr += d_sytrf_size_align(blasfeo_memsize_dvec(m));
+	blasfeo_create_dvec(nb, &sx, c_ptr);
+
+	if(sC!=sD | ci!=di | cj!=dj)
+		blasfeo_dtrcp_l(m, sC, ci, cj, sD, di, dj);
+
+	int ii, j0, k, kk, kp, kstep, p, imax;
+	double absakk, colmax, rowmax, tmp, d11, d21, d22, y0, y1;
+	double *py0, *py1;
+
+	k = 0;
+	while(k<m)
+		{
+		j0 = k;
+		kk = 0;
+		// the last column of W is kept for a 2x2 pivot, unless the panel reaches the end of the matrix;
+		// the panel is closed early at the top of a panel of D, so that the trailing update is aligned
+		while(k<m & (kk<nb-1 | m-j0<=nb))
+			{
+			if(kk>=nb-4 & (di+k)%4==0 & m-j0>nb)
+				break;
+			kstep = 1;
+			d_sytrf_col(m, k, k, j0, kk, sD, di, dj, &sW, wi, &sx, &sy0);
+			py0 = sy0.pa;
+			absakk = fabs(py0[k]);
+			imax = k;
+			colmax = 0.0;
+			for(ii=k+1; ii<m; ii++)
+				{
+				tmp = fabs(py0[ii]);
+				if(tmp>colmax)
+					{
+					colmax = tmp;
+					imax = ii;
+					}
+				}
+			// a zero column gives a zero 1x1 pivot
+			if(absakk>=alpha*colmax)
+				{
+				kp = k;
+				}
+			else
+				{
+				d_sytrf_col(m, k, imax, j0, kk, sD, di, dj, &sW, wi, &sx, &sy1);
+				py1 = sy1.pa;
+				rowmax = 0.0;
+				for(ii=k; ii<m; ii++)
+					{
+					tmp = fabs(py1[ii]);
+					if(ii!=imax & tmp>rowmax)
+						rowmax = tmp;
+					}
+				if(absakk>=alpha*colmax*(colmax/rowmax))
+					{
+					kp = k;
+					}
+				else if(fabs(py1[imax])>=alpha*rowmax)
+					{
+					// 1x1 pivot on the column imax
+					kp = imax;
+					sy_tmp = sy0;
+					sy0 = sy1;
+					sy1 = sy_tmp;
+					py0 = sy0.pa;
+					py1 = sy1.pa;
+					}
+				else
+					{
+					kp = imax;
+					kstep = 2;
+					}
+				}
+
+			// interchange rows and columns p and kp
+			p = k+kstep-1;
+			if(kp!=p)
+				{
+				// trailing matrix, not updated yet; the column p is overwritten below
+				BLASFEO_DMATEL(sD, di+kp, dj+kp) = BLASFEO_DMATEL(sD, di+p, dj+p);
+				for(ii=p+1; ii<kp; ii++)
+					BLASFEO_DMATEL(sD, di+kp, dj+ii) = BLASFEO_DMATEL(sD, di+ii, dj+p);
+				for(ii=kp+1; ii<m; ii++)
+					BLASFEO_DMATEL(sD, di+ii, dj+kp) = BLASFEO_DMATEL(sD, di+ii, dj+p);
+				// factorized columns, panel updates, and current pivot columns
+				blasfeo_drowsw(k, sD, di+p, dj, sD, di+kp, dj);
+				blasfeo_drowsw(kk, &sW, wi+p, 0, &sW, wi+kp, 0);
+				tmp = py0[p];
+				py0[p] = py0[kp];
+				py0[kp] = tmp;
+				if(kstep==2)
+					{
+					tmp = py1[p];
+					py1[p] = py1[kp];
+					py1[kp] = tmp;
+					}
+				}
+
+			if(kstep==1)
+				{
+				blasfeo_dcolin(m-k, &sy0, k, &sW, wi+k, kk);
+				if(py0[k]!=0.0)
+					{
+					tmp = 1.0/py0[k];
+					for(ii=k+1; ii<m; ii++)
+						py0[ii] *= tmp;
+					}
+				blasfeo_dcolin(m-k, &sy0, k, sD, di+k, dj+k);
+				ipiv[k] = kp;
+				}
+			else
+				{
+				blasfeo_dcolin(m-k, &sy0, k, &sW, wi+k, kk);
+				blasfeo_dcolin(m-k, &sy1, k, &sW, wi+k, kk+1);
+				// L[k+2:m,k:k+2] <= W[k+2:m,kk:kk+2] * E^{-1}, in the scaled form of LAPACK dlasyf
+				d21 = py0[k+1];
+				d11 = py1[k+1] / d21;
+				d22 = py0[k] / d21;
+				d21 = 1.0 / (d11*d22-1.0) / d21;
+				for(ii=k+2; ii<m; ii++)
+					{
+					y0 = py0[ii];
+					y1 = py1[ii];
+					py0[ii] = d21*(d11*y0-y1);
+					py1[ii] = d21*(d22*y1-y0);
+					}
+				// E is left on the diagonal and the sub-diagonal
+				blasfeo_dcolin(m-k, &sy0, k, sD, di+k, dj+k);
+				blasfeo_dcolin(m-k-1, &sy1, k+1, sD, di+k+1, dj+k+1);
+				ipiv[k] = -kp-1;
+				ipiv[k+1] = -kp-1;
+				}
+
+			k += kstep;
+			kk += kstep;
+			}
+
+		// trailing matrix update
+		if(k<m)
+			blasfeo_dsyrk_ln(m-k, kk, -1.0, sD, di+k, dj+j0, &sW, wi+k, 0, 1.0, sD, di+k, dj+k, sD, di+k, dj+k);
+		}
+
+	return;
+	}
+
+
+
+// the triangular solves are blocked in groups of about 4 pivots: the rows in a group are solved element-wise,
+// and the rest of the right-hand side is updated with dgemm; the groups are made of whole pivots, as the
+// sub-diagonal of a 2x2 pivot holds E and not L
+void blasfeo_dsytrs_l(int m, int n, struct blasfeo_dmat *sA, int ai, int aj, int *ipiv, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	if(m<=0 | n<=0)
+		return;
+
+	// invalidate stored inverse diagonal of result matrix
+	sD->use_dA = 0;
+
+	int ii, jj, j0, j1, k, kk, kp, kstep;
+	double a, d11, d21, d22, b1, b2, den;
+
+	if(sB!=sD | bi!=di | bj!=dj)
+		blasfeo_dgecp(m, n, sB, bi, bj, sD, di, dj);
+
+	// D <= P * D
+	for(k=0; k<m; k+=kstep)
+		{
+		kstep = ipiv[k]>=0 ? 1 : 2;
+		kp = ipiv[k]>=0 ? ipiv[k] : -ipiv[k]-1;
+		if(kp!=k+kstep-1)
+			blasfeo_drowsw(n, sD, di+k+kstep-1, dj, sD, di+kp, dj);
+		}
+
+	// D <= L^{-1} * D
+	for(j0=0; j0<m; j0=j1)
+		{
+		for(j1=j0; j1<m & j1-j0<4; j1+=ipiv[j1]>=0 ? 1 : 2)
+			;
+		for(k=j0; k<j1; k+=kstep)
+			{
+			kstep = ipiv[k]>=0 ? 1 : 2;
+			for(kk=k; kk<k+kstep; kk++)
+				{
+				for(ii=k+kstep; ii<j1; ii++)
+					{
+					a = BLASFEO_DMATEL(sA, ai+ii, aj+kk);
+					for(jj=0; jj<n; jj++)
+						BLASFEO_DMATEL(sD, di+ii, dj+jj) -= a * BLASFEO_DMATEL(sD, di+kk, dj+jj);
+					}
+				}
+			}
+		if(j1<m)
+			blasfeo_dgemm_nn(m-j1, n, j1-j0, -1.0, sA, ai+j1, aj+j0, sD, di+j0, dj, 1.0, sD, di+j1, dj, sD, di+j1, dj);
+		}
+
+	// D <= E^{-1} * D
+	for(k=0; k<m; k+=kstep)
+		{
+		if(ipiv[k]>=0)
+			{
+			kstep = 1;
+			a = 1.0 / BLASFEO_DMATEL(sA, ai+k, aj+k);
+			for(jj=0; jj<n; jj++)
+				BLASFEO_DMATEL(sD, di+k, dj+jj) *= a;
+			}
+		else
+			{
+			kstep = 2;
+			d21 = BLASFEO_DMATEL(sA, ai+k+1, aj+k);
+			d11 = BLASFEO_DMATEL(sA, ai+k, aj+k) / d21;
+			d22 = BLASFEO_DMATEL(sA, ai+k+1, aj+k+1) / d21;
+			den = d11*d22 - 1.0;
+			for(jj=0; jj<n; jj++)
+				{
+				b1 = BLASFEO_DMATEL(sD, di+k, dj+jj) / d21;
+				b2 = BLASFEO_DMATEL(sD, di+k+1, dj+jj) / d21;
+				BLASFEO_DMATEL(sD, di+k, dj+jj) = (d22*b1 - b2) / den;
+				BLASFEO_DMATEL(sD, di+k+1, dj+jj) = (d11*b2 - b1) / den;
+				}
+			}
+		}
+
+	// D <= L^{-T} * D, from the bottom; a negative ipiv[k-1] ends a 2x2 pivot
+	for(j1=m; j1>0; j1=j0)
+		{
+		for(j0=j1; j0>0 & j1-j0<4; j0-=ipiv[j0-1]>=0 ? 1 : 2)
+			;
+		if(j1<m)
+			blasfeo_dgemm_tn(j1-j0, n, m-j1, -1.0, sA, ai+j1, aj+j0, sD, di+j1, dj, 1.0, sD, di+j0, dj, sD, di+j0, dj);
+		for(k=j1; k>j0; k-=kstep)
+			{
+			kstep = ipiv[k-1]>=0 ? 1 : 2;
+			for(kk=k-kstep; kk<k; kk++)
+				{
+				for(ii=k; ii<j1; ii++)
+					{
+					a = BLASFEO_DMATEL(sA, ai+ii, aj+kk);
+					for(jj=0; jj<n; jj++)
+						BLASFEO_DMATEL(sD, di+kk, dj+jj) -= a * BLASFEO_DMATEL(sD, di+ii, dj+jj);
+					}
+				}
+			}
+		}
+
+	// D <= P^T * D
+	for(k=m; k>0; k-=kstep)
+		{
+		kstep = ipiv[k-1]>=0 ? 1 : 2;
+		kp = ipiv[k-1]>=0 ? ipiv[k-1] : -ipiv[k-1]-1;
+		if(kp!=k-1)
+			blasfeo_drowsw(n, sD, di+k-1, dj, sD, di+kp, dj);
+		}
+
+	return;
+	}
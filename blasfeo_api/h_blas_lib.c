@@ -0,0 +1,226 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "../include/blasfeo_common.h"
+#include "../include/blasfeo_h_aux.h"
+#include "../include/blasfeo_s_kernel.h"
+#include "../include/blasfeo_s_blasfeo_api.h"
+
+
+
+#define HGEMV_T_MB 64
+
+
+
+// half precision storage, single precision compute: the kernels convert A on load, so that for the memory bound
+// level 2 routines the traffic is halved with respect to a single precision matrix
+
+
+
+void blasfeo_shgemv_n(int m, int n, float alpha, struct blasfeo_hmat *sA, int ai, int aj, struct blasfeo_svec *sx, int xi, float beta, struct blasfeo_svec *sy, int yi, struct blasfeo_svec *sz, int zi)
+	{
+	if(m<=0)
+		return;
+
+	float *x = sx->pa + xi;
+	float *y = sy->pa + yi;
+	float *z = sz->pa + zi;
+
+	int ii, jj;
+
+#if defined(LA_HIGH_PERFORMANCE) & defined(TARGET_X64_INTEL_HASWELL)
+	if(ai%BLASFEO_HMAT_PS==0)
+		{
+		const int bs = BLASFEO_HMAT_PS;
+		int sda = sA->cn;
+		unsigned short *pA = sA->pA + ai*sda + aj*bs;
+		for(ii=0; ii<m-7; ii+=8)
+			kernel_shgemv_n_8_lib8(n, &alpha, pA+ii*sda, x, &beta, y+ii, z+ii);
+		if(ii<m)
+			kernel_shgemv_n_8_vs_lib8(n, &alpha, pA+ii*sda, x, &beta, y+ii, z+ii, m-ii);
+		return;
+		}
+#endif
+
+	float tmp;
+	for(ii=0; ii<m; ii++)
+		{
+		tmp = 0.0;
+		for(jj=0; jj<n; jj++)
+			tmp += blasfeo_h2s(BLASFEO_HMATEL(sA, ai+ii, aj+jj)) * x[jj];
+		tmp *= alpha;
+		if(beta!=0.0)
+			tmp += beta * y[ii];
+		z[ii] = tmp;
+		}
+	return;
+	}
+
+
+
+void blasfeo_shgemv_t(int m, int n, float alpha, struct blasfeo_hmat *sA, int ai, int aj, struct blasfeo_svec *sx, int xi, float beta, struct blasfeo_svec *sy, int yi, struct blasfeo_svec *sz, int zi)
+	{
+	if(n<=0)
+		return;
+
+	float *x = sx->pa + xi;
+	float *y = sy->pa + yi;
+	float *z = sz->pa + zi;
+
+	int ii, jj;
+
+#if defined(LA_HIGH_PERFORMANCE) & defined(TARGET_X64_INTEL_HASWELL)
+	if(ai%BLASFEO_HMAT_PS==0)
+		{
+		const int bs = BLASFEO_HMAT_PS;
+		int sda = sA->cn;
+		unsigned short *pA = sA->pA + ai*sda + aj*bs;
+		// the rows are processed in blocks of HGEMV_T_MB rows, each swept for all columns before the next one, so that
+		// only a few panels are streamed from memory at the same time
+		float beta1 = 1.0;
+		float *pb, *py;
+		int mm;
+		for(ii=0; ii<m; ii+=HGEMV_T_MB)
+			{
+			mm = m-ii<HGEMV_T_MB ? m-ii : HGEMV_T_MB;
+			pb = ii==0 ? &beta : &beta1;
+			py = ii==0 ? y : z;
+			for(jj=0; jj<n-7; jj+=8)
+				kernel_shgemv_t_8_lib8(mm, &alpha, pA+ii*sda+jj*bs, sda, x+ii, pb, py+jj, z+jj);
+			if(jj<n)
+				kernel_shgemv_t_8_vs_lib8(mm, &alpha, pA+ii*sda+jj*bs, sda, x+ii, pb, py+jj, z+jj, n-jj);
+			}
+		return;
+		}
+#endif
+
+	float tmp;
+	for(jj=0; jj<n; jj++)
+		{
+		tmp = 0.0;
+		for(ii=0; ii<m; ii++)
+			tmp += blasfeo_h2s(BLASFEO_HMATEL(sA, ai+ii, aj+jj)) * x[ii];
+		tmp *= alpha;
+		if(beta!=0.0)
+			tmp += beta * y[jj];
+		z[jj] = tmp;
+		}
+	return;
+	}
+
+
+
+void blasfeo_shgemm_nt(int m, int n, int k, float alpha, struct blasfeo_hmat *sA, int ai, int aj, struct blasfeo_hmat *sB, int bi, int bj, float beta, struct blasfeo_smat *sC, int ci, int cj, struct blasfeo_smat *sD, int di, int dj)
+	{
+	if(m<=0 | n<=0)
+		return;
+
+	// invalidate stored inverse diagonal of result matrix
+	sD->use_dA = 0;
+
+	int ii, jj, ll;
+
+#if defined(LA_HIGH_PERFORMANCE) & defined(TARGET_X64_INTEL_HASWELL)
+	// the 8 rows of each block of A (one panel) must map onto one panel of C and D
+	if(ai%8==0 & ci%8==0 & di%8==0 & k>0)
+		{
+		const int bs = 8;
+		int sda = sA->cn;
+		int sdc = sC->cn;
+		int sdd = sD->cn;
+		unsigned short *pA = sA->pA + ai*sda + aj*bs;
+		float *pC = sC->pA + ci*sdc + cj*bs;
+		float *pD = sD->pA + di*sdd + dj*bs;
+		// one block of 12 rows of B at a time, converted to single precision and reused for all the rows of A
+		ALIGNED( float pW0[12*K_MAX_STACK], 64 );
+		void *mem;
+		float *pW;
+		if(k>K_MAX_STACK)
+			{
+			mem = malloc(12*k*sizeof(float)+63);
+			blasfeo_align_64_byte(mem, (void **) &pW);
+			}
+		else
+			{
+			pW = pW0;
+			}
+		int nn;
+		for(jj=0; jj<n; jj+=12)
+			{
+			nn = n-jj<12 ? n-jj : 12;
+			for(ll=0; ll<k; ll++)
+				{
+				for(ii=0; ii<nn; ii++)
+					pW[ii+12*ll] = blasfeo_h2s(BLASFEO_HMATEL(sB, bi+jj+ii, bj+ll));
+				for(; ii<12; ii++)
+					pW[ii+12*ll] = 0.0;
+				}
+			for(ii=0; ii<m-7; ii+=8)
+				{
+				if(nn==12)
+					kernel_shgemm_nt_8x12_lib8(k, &alpha, pA+ii*sda, pW, &beta, pC+ii*sdc+jj*bs, pD+ii*sdd+jj*bs);
+				else
+					kernel_shgemm_nt_8x12_vs_lib8(k, &alpha, pA+ii*sda, pW, &beta, pC+ii*sdc+jj*bs, pD+ii*sdd+jj*bs, 8, nn);
+				}
+			if(ii<m)
+				kernel_shgemm_nt_8x12_vs_lib8(k, &alpha, pA+ii*sda, pW, &beta, pC+ii*sdc+jj*bs, pD+ii*sdd+jj*bs, m-ii, nn);
+			}
+		if(k>K_MAX_STACK)
+			{
+			free(mem);
+			}
+		return;
+		}
+#endif
+
+	float tmp;
+	for(jj=0; jj<n; jj++)
+		{
+		for(ii=0; ii<m; ii++)
+			{
+			tmp = 0.0;
+			for(ll=0; ll<k; ll++)
+				tmp += blasfeo_h2s(BLASFEO_HMATEL(sA, ai+ii, aj+ll)) * blasfeo_h2s(BLASFEO_HMATEL(sB, bi+jj, bj+ll));
+			tmp *= alpha;
+			if(beta!=0.0)
+				tmp += beta * BLASFEO_SMATEL(sC, ci+ii, cj+jj);
+			BLASFEO_SMATEL(sD, di+ii, dj+jj) = tmp;
+			}
+		}
+	return;
+	}
@@ -0,0 +1,189 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "../include/blasfeo_common.h"
+#include "../include/blasfeo_d_kernel.h"
+#include "../include/blasfeo_d_blasfeo_api.h"
+
+
+
+// mixed precision level 3: single precision operands, double precision accumulation and result
+
+
+
+// element-wise version, for any LA and storage format
+static void dsgemm_ref(int tB, int m, int n, int k, double alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	int ii, jj, ll;
+	double tmp;
+	for(jj=0; jj<n; jj++)
+		{
+		for(ii=0; ii<m; ii++)
+			{
+			tmp = 0.0;
+			if(tB)
+				{
+				for(ll=0; ll<k; ll++)
+					tmp += (double) BLASFEO_SMATEL(sA, ai+ii, aj+ll) * (double) BLASFEO_SMATEL(sB, bi+jj, bj+ll);
+				}
+			else
+				{
+				for(ll=0; ll<k; ll++)
+					tmp += (double) BLASFEO_SMATEL(sA, ai+ii, aj+ll) * (double) BLASFEO_SMATEL(sB, bi+ll, bj+jj);
+				}
+			tmp *= alpha;
+			if(beta!=0.0)
+				tmp += beta * BLASFEO_DMATEL(sC, ci+ii, cj+jj);
+			BLASFEO_DMATEL(sD, di+ii, dj+jj) = tmp;
+			}
+		}
+	return;
+	}
+
+
+
+#if defined(LA_HIGH_PERFORMANCE) & defined(TARGET_X64_INTEL_HASWELL)
+// B[bi+jj:bi+jj+nn, bj:bj+k] (tB) or B[bi:bi+k, bj+jj:bj+jj+nn]^T converted to double precision and packed as
+// pW[ii+6*ll], padded with zeros if nn<6
+static void dsgemm_pack_b(int tB, int k, int nn, struct blasfeo_smat *sB, int bi, int bj, int jj, double *pW)
+	{
+	const int bss = 8;
+	int sdb = sB->cn;
+	float *pB;
+	int ii, ll;
+	for(ii=nn; ii<6; ii++)
+		for(ll=0; ll<k; ll++)
+			pW[ii+6*ll] = 0.0;
+	if(tB)
+		{
+		for(ii=0; ii<nn; ii++)
+			{
+			pB = sB->pA + (bi+jj+ii)/bss*bss*sdb + (bi+jj+ii)%bss + bj*bss;
+			for(ll=0; ll<k; ll++)
+				pW[ii+6*ll] = (double) pB[ll*bss];
+			}
+		}
+	else
+		{
+		for(ll=0; ll<k; ll++)
+			{
+			pB = sB->pA + (bi+ll)/bss*bss*sdb + (bi+ll)%bss + (bj+jj)*bss;
+			for(ii=0; ii<nn; ii++)
+				pW[ii+6*ll] = (double) pB[ii*bss];
+			}
+		}
+	return;
+	}
+#endif
+
+
+
+static void dsgemm(int tB, int m, int n, int k, double alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	if(m<=0 | n<=0)
+		return;
+
+	// invalidate stored inverse diagonal of result matrix
+	sD->use_dA = 0;
+
+#if defined(LA_HIGH_PERFORMANCE) & defined(TARGET_X64_INTEL_HASWELL)
+	// the 8 rows of each block of A (one panel) must map onto two panels of C and D
+	if(ai%8==0 & ci%4==0 & di%4==0 & k>0)
+		{
+		const int bss = 8;
+		const int bsd = 4;
+		int sda = sA->cn;
+		int sdc = sC->cn;
+		int sdd = sD->cn;
+		float *pA = sA->pA + ai*sda + aj*bss;
+		double *pC = sC->pA + ci*sdc + cj*bsd;
+		double *pD = sD->pA + di*sdd + dj*bsd;
+		// one column block of B at a time, converted to double precision and reused for all the rows of A
+		ALIGNED( double pW0[6*K_MAX_STACK], 64 );
+		void *mem;
+		double *pW;
+		if(k>K_MAX_STACK)
+			{
+			mem = malloc(6*k*sizeof(double)+63);
+			blasfeo_align_64_byte(mem, (void **) &pW);
+			}
+		else
+			{
+			pW = pW0;
+			}
+		int ii, jj;
+		for(jj=0; jj<n; jj+=6)
+			{
+			dsgemm_pack_b(tB, k, n-jj<6 ? n-jj : 6, sB, bi, bj, jj, pW);
+			for(ii=0; ii<m-7; ii+=8)
+				{
+				if(n-jj>=6)
+					kernel_dsgemm_nt_8x6_lib48(k, &alpha, pA+ii*sda, pW, &beta, pC+ii*sdc+jj*bsd, sdc, pD+ii*sdd+jj*bsd, sdd);
+				else
+					kernel_dsgemm_nt_8x6_vs_lib48(k, &alpha, pA+ii*sda, pW, &beta, pC+ii*sdc+jj*bsd, sdc, pD+ii*sdd+jj*bsd, sdd, 8, n-jj);
+				}
+			if(ii<m)
+				kernel_dsgemm_nt_8x6_vs_lib48(k, &alpha, pA+ii*sda, pW, &beta, pC+ii*sdc+jj*bsd, sdc, pD+ii*sdd+jj*bsd, sdd, m-ii, n-jj);
+			}
+		if(k>K_MAX_STACK)
+			{
+			free(mem);
+			}
+		return;
+		}
+#endif
+
+	dsgemm_ref(tB, m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+	return;
+	}
+
+
+
+void blasfeo_dsgemm_nn(int m, int n, int k, double alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	dsgemm(0, m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+	return;
+	}
+
+
+
+void blasfeo_dsgemm_nt(int m, int n, int k, double alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	dsgemm(1, m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+	return;
+	}
@@ -0,0 +1,212 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <float.h>
+
+#include "../include/blasfeo_common.h"
+#include "../include/blasfeo_d_aux.h"
+#include "../include/blasfeo_s_aux.h"
+#include "../include/blasfeo_m_aux.h"
+#include "../include/blasfeo_d_blasfeo_api.h"
+#include "../include/blasfeo_s_blasfeo_api.h"
+
+
+
+// mixed precision solvers: factorization in single precision, iterative refinement of the solution in double precision
+
+
+
+// maximum number of refinement steps (as in LAPACK dsposv and dsgesv)
+#define MIXED_ITER_MAX 30
+
+
+
+static int m_size_align(int size)
+	{
+	return (size+63)/64*64;
+	}
+
+
+
+static int m_worksize(int m, int lu)
+	{
+	int size = 64; // alignment
+	size += m_size_align(blasfeo_memsize_smat(m, m));
+	size += m_size_align(blasfeo_memsize_svec(m));
+	size += m_size_align(blasfeo_memsize_dvec(m));
+	if(lu)
+		{
+		size += m_size_align(m*sizeof(int));
+		size += m_size_align(blasfeo_sgetrf_rp_worksize(m, m));
+		}
+	return size;
+	}
+
+
+
+// w <= A^{-1} w, with the single precision factorization of A in sF
+static void m_solve(int m, int lu, struct blasfeo_smat *sF, int *ipiv, struct blasfeo_svec *sw)
+	{
+	if(lu)
+		{
+		blasfeo_svecpe(m, ipiv, sw, 0);
+		blasfeo_strsv_lnu(m, sF, 0, 0, sw, 0, sw, 0);
+		blasfeo_strsv_unn(m, sF, 0, 0, sw, 0, sw, 0);
+		}
+	else
+		{
+		blasfeo_strsv_lnn(m, sF, 0, 0, sw, 0, sw, 0);
+		blasfeo_strsv_ltn(m, sF, 0, 0, sw, 0, sw, 0);
+		}
+	return;
+	}
+
+
+
+static int m_solve_mixed(int m, int lu, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dvec *sb, int bi, struct blasfeo_dvec *sx, int xi, void *work)
+	{
+	if(m<=0)
+		return 0;
+
+	struct blasfeo_smat sF;
+	struct blasfeo_svec sw;
+	struct blasfeo_dvec sr;
+	int *ipiv = NULL;
+	void *lu_work = NULL;
+	char *ptr = (char *) (((size_t) work + 63) / 64 * 64);
+	blasfeo_create_smat(m, m, &sF, ptr);
+	ptr += m_size_align(blasfeo_memsize_smat(m, m));
+	blasfeo_create_svec(m, &sw, ptr);
+	ptr += m_size_align(blasfeo_memsize_svec(m));
+	blasfeo_create_dvec(m, &sr, ptr);
+	ptr += m_size_align(blasfeo_memsize_dvec(m));
+	if(lu)
+		{
+		ipiv = (int *) ptr;
+		ptr += m_size_align(m*sizeof(int));
+		lu_work = (void *) ptr;
+		}
+
+	int ii, jj, it;
+	double tmp, a_nrm, r_nrm, x_nrm;
+
+	// infinity norm of A
+	a_nrm = 0.0;
+	for(ii=0; ii<m; ii++)
+		{
+		tmp = 0.0;
+		for(jj=0; jj<m; jj++)
+			{
+			if(lu | jj<=ii)
+				tmp += fabs(BLASFEO_DMATEL(sA, ai+ii, aj+jj));
+			else
+				tmp += fabs(BLASFEO_DMATEL(sA, ai+jj, aj+ii));
+			}
+		a_nrm = tmp>a_nrm ? tmp : a_nrm;
+		}
+	// stopping tolerance on the residual, as in LAPACK
+	double cte = a_nrm * (0.5*DBL_EPSILON) * sqrt((double) m);
+
+	// factorize in single precision
+	blasfeo_cvt_d2s_mat(m, m, sA, ai, aj, &sF, 0, 0);
+	if(lu)
+		blasfeo_sgetrf_rp_ws(m, m, &sF, 0, 0, &sF, 0, 0, ipiv, lu_work);
+	else
+		blasfeo_spotrf_l(m, &sF, 0, 0, &sF, 0, 0);
+	for(ii=0; ii<m; ii++)
+		{
+		tmp = BLASFEO_SMATEL(&sF, ii, ii);
+		if(!(lu ? fabs(tmp)>0.0 : tmp>0.0))
+			return -1;
+		}
+
+	// x = A^{-1} b in single precision
+	blasfeo_cvt_d2s_vec(m, sb, bi, &sw, 0);
+	m_solve(m, lu, &sF, ipiv, &sw);
+	blasfeo_cvt_s2d_vec(m, &sw, 0, sx, xi);
+
+	for(it=0; it<=MIXED_ITER_MAX; it++)
+		{
+		// r = b - A x in double precision
+		if(lu)
+			blasfeo_dgemv_n(m, m, -1.0, sA, ai, aj, sx, xi, 1.0, sb, bi, &sr, 0);
+		else
+			blasfeo_dsymv_l(m, m, -1.0, sA, ai, aj, sx, xi, 1.0, sb, bi, &sr, 0);
+		blasfeo_dvecnrm_inf(m, &sr, 0, &r_nrm);
+		blasfeo_dvecnrm_inf(m, sx, xi, &x_nrm);
+		if(r_nrm<=x_nrm*cte)
+			return it;
+		if(it==MIXED_ITER_MAX)
+			break;
+		// x += A^{-1} r, with the correction in single precision
+		blasfeo_cvt_d2s_vec(m, &sr, 0, &sw, 0);
+		m_solve(m, lu, &sF, ipiv, &sw);
+		blasfeo_cvt_s2d_vec(m, &sw, 0, &sr, 0);
+		blasfeo_daxpy(m, 1.0, &sr, 0, sx, xi, sx, xi);
+		}
+
+	return -1;
+	}
+
+
+
+int blasfeo_dposv_mixed_worksize(int m)
+	{
+	return m_worksize(m, 0);
+	}
+
+
+
+int blasfeo_dposv_mixed(int m, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dvec *sb, int bi, struct blasfeo_dvec *sx, int xi, void *work)
+	{
+	return m_solve_mixed(m, 0, sA, ai, aj, sb, bi, sx, xi, work);
+	}
+
+
+
+int blasfeo_dgesv_mixed_worksize(int m)
+	{
+	return m_worksize(m, 1);
+	}
+
+
+
+int blasfeo_dgesv_mixed(int m, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dvec *sb, int bi, struct blasfeo_dvec *sx, int xi, void *work)
+	{
+	return m_solve_mixed(m, 1, sA, ai, aj, sb, bi, sx, xi, work);
+	}
@@ -948,8 +948,23 @@ void blasfeo_strsv_lnu(int m, struct blasfeo_smat *sA, int ai, int aj, struct bl
 	// z: m
 	if(zi+m > sz->m) printf("\n***** blasfeo_strsv_lnu : zi+m > size(z) : %d+%d > %d *****\n", zi, m, sz->m);
 #endif
-	printf("\n***** blasfeo_strsv_lnu : feature not implemented yet *****\n");
-	exit(1);
+	const int bs = 4;
+	int sda = sA->cn;
+	float *x = sx->pa + xi;
+	float *z = sz->pa + zi;
+	float *pA;
+	int ii, jj;
+	float tmp;
+	// forward substitution by rows (z can alias x)
+	for(ii=0; ii<m; ii++)
+		{
+		pA = sA->pA + (ai+ii)/bs*bs*sda + (ai+ii)%bs + aj*bs;
+		tmp = x[ii];
+		for(jj=0; jj<ii; jj++)
+			tmp -= pA[jj*bs] * z[jj];
+		z[ii] = tmp;
+		}
+	return;
 	}
 
 
@@ -1002,8 +1017,23 @@ void blasfeo_strsv_unn(int m, struct blasfeo_smat *sA, int ai, int aj, struct bl
 	// z: m
 	if(zi+m > sz->m) printf("\n***** blasfeo_strsv_unn : zi+m > size(z) : %d+%d > %d *****\n", zi, m, sz->m);
 #endif
-	printf("\n***** blasfeo_strsv_unn : feature not implemented yet *****\n");
-	exit(1);
+	const int bs = 4;
+	int sda = sA->cn;
+	float *x = sx->pa + xi;
+	float *z = sz->pa + zi;
+	float *pA;
+	int ii, jj;
+	float tmp;
+	// backward substitution by rows (z can alias x)
+	for(ii=m-1; ii>=0; ii--)
+		{
+		pA = sA->pA + (ai+ii)/bs*bs*sda + (ai+ii)%bs + aj*bs;
+		tmp = x[ii];
+		for(jj=ii+1; jj<m; jj++)
+			tmp -= pA[jj*bs] * z[jj];
+		z[ii] = tmp / pA[ii*bs];
+		}
+	return;
 	}
 
 
@@ -878,6 +878,90 @@ void blasfeo_strsv_ltn_mn(int m, int n, struct blasfeo_smat *sA, int ai, int aj,
 
 
 
+void blasfeo_strsv_lnu(int m, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_svec *sx, int xi, struct blasfeo_svec *sz, int zi)
+	{
+	if(m==0)
+		return;
+#if defined(DIM_CHECK)
+	// non-negative size
+	if(m<0) printf("\n****** blasfeo_strsv_lnu : m<0 : %d<0 *****\n", m);
+	// non-negative offset
+	if(ai<0) printf("\n****** blasfeo_strsv_lnu : ai<0 : %d<0 *****\n", ai);
+	if(aj<0) printf("\n****** blasfeo_strsv_lnu : aj<0 : %d<0 *****\n", aj);
+	if(xi<0) printf("\n****** blasfeo_strsv_lnu : xi<0 : %d<0 *****\n", xi);
+	if(zi<0) printf("\n****** blasfeo_strsv_lnu : zi<0 : %d<0 *****\n", zi);
+	// inside matrix
+	// A: m x k
+	if(ai+m > sA->m) printf("\n***** blasfeo_strsv_lnu : ai+m > row(A) : %d+%d > %d *****\n", ai, m, sA->m);
+	if(aj+m > sA->n) printf("\n***** blasfeo_strsv_lnu : aj+m > col(A) : %d+%d > %d *****\n", aj, m, sA->n);
+	// x: m
+	if(xi+m > sx->m) printf("\n***** blasfeo_strsv_lnu : xi+m > size(x) : %d+%d > %d *****\n", xi, m, sx->m);
+	// z: m
+	if(zi+m > sz->m) printf("\n***** blasfeo_strsv_lnu : zi+m > size(z) : %d+%d > %d *****\n", zi, m, sz->m);
+#endif
+	const int bs = 8;
+	int sda = sA->cn;
+	float *x = sx->pa + xi;
+	float *z = sz->pa + zi;
+	float *pA;
+	int ii, jj;
+	float tmp;
+	// forward substitution by rows (z can alias x)
+	for(ii=0; ii<m; ii++)
+		{
+		pA = sA->pA + (ai+ii)/bs*bs*sda + (ai+ii)%bs + aj*bs;
+		tmp = x[ii];
+		for(jj=0; jj<ii; jj++)
+			tmp -= pA[jj*bs] * z[jj];
+		z[ii] = tmp;
+		}
+	return;
+	}
+
+
+
+void blasfeo_strsv_unn(int m, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_svec *sx, int xi, struct blasfeo_svec *sz, int zi)
+	{
+	if(m==0)
+		return;
+#if defined(DIM_CHECK)
+	// non-negative size
+	if(m<0) printf("\n****** blasfeo_strsv_unn : m<0 : %d<0 *****\n", m);
+	// non-negative offset
+	if(ai<0) printf("\n****** blasfeo_strsv_unn : ai<0 : %d<0 *****\n", ai);
+	if(aj<0) printf("\n****** blasfeo_strsv_unn : aj<0 : %d<0 *****\n", aj);
+	if(xi<0) printf("\n****** blasfeo_strsv_unn : xi<0 : %d<0 *****\n", xi);
+	if(zi<0) printf("\n****** blasfeo_strsv_unn : zi<0 : %d<0 *****\n", zi);
+	// inside matrix
+	// A: m x k
+	if(ai+m > sA->m) printf("\n***** blasfeo_strsv_unn : ai+m > row(A) : %d+%d > %d *****\n", ai, m, sA->m);
+	if(aj+m > sA->n) printf("\n***** blasfeo_strsv_unn : aj+m > col(A) : %d+%d > %d *****\n", aj, m, sA->n);
+	// x: m
+	if(xi+m > sx->m) printf("\n***** blasfeo_strsv_unn : xi+m > size(x) : %d+%d > %d *****\n", xi, m, sx->m);
+	// z: m
+	if(zi+m > sz->m) printf("\n***** blasfeo_strsv_unn : zi+m > size(z) : %d+%d > %d *****\n", zi, m, sz->m);
+#endif
+	const int bs = 8;
+	int sda = sA->cn;
+	float *x = sx->pa + xi;
+	float *z = sz->pa + zi;
+	float *pA;
+	int ii, jj;
+	float tmp;
+	// backward substitution by rows (z can alias x)
+	for(ii=m-1; ii>=0; ii--)
+		{
+		pA = sA->pA + (ai+ii)/bs*bs*sda + (ai+ii)%bs + aj*bs;
+		tmp = x[ii];
+		for(jj=ii+1; jj<m; jj++)
+			tmp -= pA[jj*bs] * z[jj];
+		z[ii] = tmp / pA[ii*bs];
+		}
+	return;
+	}
+
+
+
 void blasfeo_sgemv_nt(int m, int n, float alpha_n, float alpha_t, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_svec *sx_n, int xi_n, struct blasfeo_svec *sx_t, int xi_t, float beta_n, float beta_t, struct blasfeo_svec *sy_n, int yi_n, struct blasfeo_svec *sy_t, int yi_t, struct blasfeo_svec *sz_n, int zi_n, struct blasfeo_svec *sz_t, int zi_t)
 	{
 
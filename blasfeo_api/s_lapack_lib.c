@@ -92,3 +92,18 @@
 
 #include "x_lapack_lib.c"
 
+
+
+// no work space needed
+int blasfeo_sgetrf_rp_worksize(int m, int n)
+	{
+	return 0;
+	}
+
+
+
+void blasfeo_sgetrf_rp_ws(int m, int n, struct blasfeo_smat *sC, int ci, int cj, struct blasfeo_smat *sD, int di, int dj, int *ipiv, void *work)
+	{
+	blasfeo_sgetrf_rp(m, n, sC, ci, cj, sD, di, dj, ipiv);
+	return;
+	}
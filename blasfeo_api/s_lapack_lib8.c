@@ -40,6 +40,7 @@
 #include "../include/blasfeo_common.h"
 #include "../include/blasfeo_s_aux.h"
 #include "../include/blasfeo_s_kernel.h"
+#include "../include/blasfeo_s_blasfeo_api.h"
 
 
 
@@ -878,14 +879,142 @@ void blasfeo_sgetrf_np(int m, int n, struct blasfeo_smat *sC, int ci, int cj, st
 
 
 // dgetrf row pivoting
+// D[ii][jy] += alpha * D[ii][jx] for ii in [i0, i1), in panel-major storage
+static void sgetrf_col_axpy(int i0, int i1, float alpha, float *pD, int sdd, int jx, int jy)
+	{
+	const int bs = 8;
+	float *px, *py;
+	int ii, ll;
+	ii = i0;
+	for(; ii<i1 & ii%bs!=0; ii++)
+		pD[ii/bs*bs*sdd+ii%bs+jy*bs] += alpha * pD[ii/bs*bs*sdd+ii%bs+jx*bs];
+	for(; ii<i1-bs+1; ii+=bs)
+		{
+		px = pD + ii*sdd + jx*bs;
+		py = pD + ii*sdd + jy*bs;
+		for(ll=0; ll<bs; ll++)
+			py[ll] += alpha * px[ll];
+		}
+	for(; ii<i1; ii++)
+		pD[ii/bs*bs*sdd+ii%bs+jy*bs] += alpha * pD[ii/bs*bs*sdd+ii%bs+jx*bs];
+	return;
+	}
+
+
+
+// blocked right-looking: the panel of nb columns is factorized column-wise, the trailing matrix is updated by sgemm_nt
+// with a transposed copy of the U12 block in sT if sT!=NULL, and by sgemm_nn reading U12 in place otherwise
+#define SGETRF_RP_NB 32 // multiple of bs, to keep the sgemm operands aligned
+static void sgetrf_rp_blk(int m, int n, struct blasfeo_smat *sC, int ci, int cj, struct blasfeo_smat *sD, int di, int dj, int *ipiv, struct blasfeo_smat *sT)
+	{
+	if(ci!=0 | di!=0)
+		{
+		printf("\nblasfeo_sgetrf_rp: feature not implemented yet: ci=%d, di=%d\n", ci, di);
+		exit(1);
+		}
+	if(m<=0 | n<=0)
+		return;
+	const int bs = 8;
+	const int nb = SGETRF_RP_NB;
+	int ii, jj, kk, ll, p, ib;
+	int mn = m<n ? m : n;
+	float tmp, amax, *dD = sD->dA;
+	if(sC!=sD | cj!=dj)
+		blasfeo_sgecp(m, n, sC, ci, cj, sD, di, dj);
+	int sdd = sD->cn;
+	float *pD = sD->pA + dj*bs;
+#define EL(i, j) pD[(i)/bs*bs*sdd+(i)%bs+(j)*bs]
+	for(jj=0; jj<mn; jj+=nb)
+		{
+		ib = mn-jj<nb ? mn-jj : nb;
+		// panel factorization
+		for(kk=jj; kk<jj+ib; kk++)
+			{
+			p = kk;
+			amax = fabs(EL(kk, kk));
+			for(ii=kk+1; ii<m; ii++)
+				{
+				tmp = fabs(EL(ii, kk));
+				if(tmp>amax)
+					{
+					amax = tmp;
+					p = ii;
+					}
+				}
+			ipiv[kk] = p;
+			if(p!=kk)
+				blasfeo_srowsw(n, sD, kk, dj, sD, p, dj);
+			tmp = EL(kk, kk);
+			tmp = tmp!=0.0 ? 1.0/tmp : 0.0;
+			if(dj==0)
+				dD[kk] = tmp;
+			for(ii=kk+1; ii<m; ii++)
+				EL(ii, kk) *= tmp;
+			for(ll=kk+1; ll<jj+ib; ll++)
+				sgetrf_col_axpy(kk+1, m, -EL(kk, ll), pD, sdd, kk, ll);
+			}
+		if(jj+ib>=n)
+			continue;
+		// U12 <= L11^{-1} A12
+		for(ll=jj+ib; ll<n; ll++)
+			{
+			for(kk=jj; kk<jj+ib-1; kk++)
+				sgetrf_col_axpy(kk+1, jj+ib, -EL(kk, ll), pD, sdd, kk, ll);
+			}
+		// A22 <= A22 - L21 * U12
+		if(jj+ib<m)
+			{
+			if(sT!=NULL)
+				{
+				blasfeo_sgetr(ib, n-jj-ib, sD, jj, dj+jj+ib, sT, 0, 0);
+				blasfeo_sgemm_nt(m-jj-ib, n-jj-ib, ib, -1.0, sD, jj+ib, dj+jj, sT, 0, 0, 1.0, sD, jj+ib, dj+jj+ib, sD, jj+ib, dj+jj+ib);
+				}
+			else
+				{
+				blasfeo_sgemm_nn(m-jj-ib, n-jj-ib, ib, -1.0, sD, jj+ib, dj+jj, sD, jj, dj+jj+ib, 1.0, sD, jj+ib, dj+jj+ib, sD, jj+ib, dj+jj+ib);
+				}
+			}
+		}
+#undef EL
+	sD->use_dA = dj==0 && m>=n ? 1 : 0;
+	return;
+	}
+
+
+
 void blasfeo_sgetrf_rp(int m, int n, struct blasfeo_smat *sC, int ci, int cj, struct blasfeo_smat *sD, int di, int dj, int *ipiv)
 	{
-#ifndef BENCHMARKS_MODE
-	printf("\nblasfeo_sgetrf_rp: feature not implemented yet\n");
-	exit(1);
-#endif
+	sgetrf_rp_blk(m, n, sC, ci, cj, sD, di, dj, ipiv, NULL);
+	return;
+	}
+
+
+
+// work space for the transposed copy of the U12 block
+int blasfeo_sgetrf_rp_worksize(int m, int n)
+	{
+	const int nb = SGETRF_RP_NB;
+	if(m<=nb | n<=nb)
+		return 0;
+	return blasfeo_memsize_smat(n-nb, nb)+64;
+	}
+
+
+
+void blasfeo_sgetrf_rp_ws(int m, int n, struct blasfeo_smat *sC, int ci, int cj, struct blasfeo_smat *sD, int di, int dj, int *ipiv, void *work)
+	{
+	const int nb = SGETRF_RP_NB;
+	struct blasfeo_smat sT;
+	if(m<=nb | n<=nb)
+		{
+		sgetrf_rp_blk(m, n, sC, ci, cj, sD, di, dj, ipiv, NULL);
+		return;
+		}
+	blasfeo_create_smat(n-nb, nb, &sT, (void *) (((size_t) work + 63) / 64 * 64));
+	sgetrf_rp_blk(m, n, sC, ci, cj, sD, di, dj, ipiv, &sT);
 	return;
 	}
+#undef SGETRF_RP_NB
 
 
 
@@ -404,16 +404,16 @@ void TRSM_LLNN(int m, int n, REAL alpha, struct XMAT *sA, int ai, int aj, struct
 	REAL *dA = sA->dA;
 	if(ai==0 & aj==0)
 		{
-		if(sA->use_dA<n)
+		if(sA->use_dA<m)
 			{
-			for(ii=0; ii<n; ii++)
+			for(ii=0; ii<m; ii++)
 				dA[ii] = 1.0 / pA[ii+lda*ii];
-			sA->use_dA = n;
+			sA->use_dA = m;
 			}
 		}
 	else
 		{
-		for(ii=0; ii<n; ii++)
+		for(ii=0; ii<m; ii++)
 			dA[ii] = 1.0 / pA[ii+lda*ii];
 		sA->use_dA = 0; // nonzero offset makes diagonal dirty
 		}
@@ -1047,16 +1047,16 @@ void TRSM_LUTN(int m, int n, REAL alpha, struct XMAT *sA, int ai, int aj, struct
 	REAL *dA = sA->dA;
 	if(ai==0 & aj==0)
 		{
-		if(sA->use_dA<n)
+		if(sA->use_dA<m)
 			{
-			for(ii=0; ii<n; ii++)
+			for(ii=0; ii<m; ii++)
 				dA[ii] = 1.0 / pA[ii+lda*ii];
-			sA->use_dA = n;
+			sA->use_dA = m;
 			}
 		}
 	else
 		{
-		for(ii=0; ii<n; ii++)
+		for(ii=0; ii<m; ii++)
 			dA[ii] = 1.0 / pA[ii+lda*ii];
 		sA->use_dA = 0; // nonzero offset makes diagonal dirty
 		}
@@ -773,9 +773,9 @@ void GETRF_NOPIVOT_LIBSTR(int m, int n, struct STRMAT *sC, int ci, int cj, struc
 	jj = 0;
 	for(; jj<n-1; jj+=2)
 		{
-		// upper
+		// upper, at most m rows if n>m
 		ii = 0;
-		for(; ii<jj-1; ii+=2)
+		for(; ii<jj-1 & ii<m-1; ii+=2)
 			{
 			// correct upper
 			d_00 = pC[(ii+0)+ldc*(jj+0)];
@@ -797,7 +797,7 @@ void GETRF_NOPIVOT_LIBSTR(int m, int n, struct STRMAT *sC, int ci, int cj, struc
 			pD[(ii+0)+ldd*(jj+1)] = d_01;
 			pD[(ii+1)+ldd*(jj+1)] = d_11;
 			}
-		for(; ii<jj; ii++)
+		for(; ii<jj & ii<m; ii++)
 			{
 			// correct upper
 			d_00 = pC[(ii+0)+ldc*(jj+0)];
@@ -904,9 +904,9 @@ void GETRF_NOPIVOT_LIBSTR(int m, int n, struct STRMAT *sC, int ci, int cj, struc
 		}
 	for(; jj<n; jj++)
 		{
-		// upper
+		// upper, at most m rows if n>m
 		ii = 0;
-		for(; ii<jj-1; ii+=2)
+		for(; ii<jj-1 & ii<m-1; ii+=2)
 			{
 			// correct upper
 			d_00 = pC[(ii+0)+ldc*jj];
@@ -921,7 +921,7 @@ void GETRF_NOPIVOT_LIBSTR(int m, int n, struct STRMAT *sC, int ci, int cj, struc
 			pD[(ii+0)+ldd*jj] = d_00;
 			pD[(ii+1)+ldd*jj] = d_10;
 			}
-		for(; ii<jj; ii++)
+		for(; ii<jj & ii<m; ii++)
 			{
 			// correct upper
 			d_00 = pC[(ii+0)+ldc*jj];
@@ -1049,8 +1049,10 @@ void GETRF_LIBSTR(int m, int n, struct STRMAT *sC, int ci, int cj, struct STRMAT
 		}
 	// factorize
 #if 1
+	// pivots and L in the first min(m,n) columns, the row exchanges are applied to the whole rows
+	int p = m<n ? m : n;
 	jj = 0;
-	for(; jj<n-1; jj+=2)
+	for(; jj<p-1; jj+=2)
 		{
 		ii = 0;
 		for(; ii<jj-1; ii+=2)
@@ -1244,7 +1246,7 @@ void GETRF_LIBSTR(int m, int n, struct STRMAT *sC, int ci, int cj, struct STRMAT
 			pD[ii+ldd*(jj+1)] = d_00;
 			}
 		}
-	for(; jj<n; jj++)
+	for(; jj<p; jj++)
 		{
 		ii = 0;
 		for(; ii<jj-1; ii+=2)
@@ -1344,6 +1346,37 @@ void GETRF_LIBSTR(int m, int n, struct STRMAT *sC, int ci, int cj, struct STRMAT
 			pD[ii+ldd*jj] = d_00;
 			}
 		}
+	// remaining columns of U if n>m
+	for(; jj<n; jj++)
+		{
+		ii = 0;
+		for(; ii<m-1; ii+=2)
+			{
+			// correct upper
+			d_00 = pD[(ii+0)+ldd*jj];
+			d_10 = pD[(ii+1)+ldd*jj];
+			for(kk=0; kk<ii; kk++)
+				{
+				d_00 -= pD[(ii+0)+ldd*kk] * pD[kk+ldd*jj];
+				d_10 -= pD[(ii+1)+ldd*kk] * pD[kk+ldd*jj];
+				}
+			// solve upper
+			d_10 -= pD[(ii+1)+ldd*kk] * d_00;
+			pD[(ii+0)+ldd*jj] = d_00;
+			pD[(ii+1)+ldd*jj] = d_10;
+			}
+		for(; ii<m; ii++)
+			{
+			// correct upper
+			d_00 = pD[ii+ldd*jj];
+			for(kk=0; kk<ii; kk++)
+				{
+				d_00 -= pD[ii+ldd*kk] * pD[kk+ldd*jj];
+				}
+			// solve upper
+			pD[ii+ldd*jj] = d_00;
+			}
+		}
 #else
 	int iimax = m<n ? m : n;
 	for(ii=0; ii<iimax; ii++)
@@ -0,0 +1,388 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <complex.h>
+
+#include "../include/blasfeo_common.h"
+#include "../include/blasfeo_z_aux.h"
+#include "../include/blasfeo_z_kernel.h"
+#include "../include/blasfeo_z_blasfeo_api.h"
+
+
+
+// pack (up to) 4 columns of op(B) starting at column jj into pW[c+4*l] (as the rows of one panel), padded with zeros:
+// op(B) = B (tB=0), B^T (tB=1) or B^H (tB=2)
+static void zgemm_pack_b(int tB, int k, int nn, struct blasfeo_zmat *sB, int bi, int bj, int jj, double _Complex *pW)
+	{
+	const int bs = BLASFEO_ZMAT_PS;
+	int ii, ll;
+	for(ll=0; ll<k; ll++)
+		{
+		for(ii=0; ii<nn; ii++)
+			{
+			if(tB==0)
+				pW[ii+bs*ll] = BLASFEO_ZMATEL(sB, bi+ll, bj+jj+ii);
+			else if(tB==1)
+				pW[ii+bs*ll] = BLASFEO_ZMATEL(sB, bi+jj+ii, bj+ll);
+			else
+				pW[ii+bs*ll] = conj(BLASFEO_ZMATEL(sB, bi+jj+ii, bj+ll));
+			}
+		for(; ii<bs; ii++)
+			pW[ii+bs*ll] = 0.0;
+		}
+	return;
+	}
+
+
+
+// one 4x2 block of D, with B^T (conj_b=0) or B^H (conj_b=1)
+static void zgemm_kernel_4x2(int conj_b, int k, double _Complex *alpha, double _Complex *A, double _Complex *B, double _Complex *beta, double _Complex *C, double _Complex *D, int km, int kn)
+	{
+	if(km>=4 & kn>=2)
+		{
+		if(conj_b)
+			kernel_zgemm_nc_4x2_lib4(k, alpha, A, B, beta, C, D);
+		else
+			kernel_zgemm_nt_4x2_lib4(k, alpha, A, B, beta, C, D);
+		}
+	else
+		{
+		if(conj_b)
+			kernel_zgemm_nc_4x2_vs_lib4(k, alpha, A, B, beta, C, D, km, kn);
+		else
+			kernel_zgemm_nt_4x2_vs_lib4(k, alpha, A, B, beta, C, D, km, kn);
+		}
+	return;
+	}
+
+
+
+static void zgemm(int tB, int m, int n, int k, double _Complex alpha, struct blasfeo_zmat *sA, int ai, int aj, struct blasfeo_zmat *sB, int bi, int bj, double _Complex beta, struct blasfeo_zmat *sC, int ci, int cj, struct blasfeo_zmat *sD, int di, int dj)
+	{
+	if(m<=0 | n<=0)
+		return;
+
+	const int bs = BLASFEO_ZMAT_PS;
+
+	int ii, jj, ll;
+
+	// the rows of A, C and D must start at the top of a panel
+	if(ai%bs==0 & ci%bs==0 & di%bs==0)
+		{
+		int sda = sA->cn;
+		int sdc = sC->cn;
+		int sdd = sD->cn;
+		double _Complex *pA = sA->pA + ai*sda + aj*bs;
+		double _Complex *pC = sC->pA + ci*sdc + cj*bs;
+		double _Complex *pD = sD->pA + di*sdd + dj*bs;
+		double _Complex *pB;
+		int sdb = sB->cn;
+		int cc;
+		// B^T and B^H with the rows of B at the top of a panel are read in place by the kernels, otherwise op(B)
+		// is packed 4 columns at a time, and reused for all the rows of A
+		int pack = tB==0 | bi%bs!=0;
+		int conj_b = tB==2 & !pack;
+		ALIGNED( double _Complex pW0[4*K_MAX_STACK], 64 );
+		void *mem;
+		double _Complex *pW = pW0;
+		if(pack & k>K_MAX_STACK)
+			{
+			mem = malloc(4*k*sizeof(double _Complex)+63);
+			pW = (double _Complex *) (((size_t) mem + 63) / 64 * 64);
+			}
+		for(jj=0; jj<n; jj+=4)
+			{
+			if(pack)
+				{
+				zgemm_pack_b(tB, k, n-jj<4 ? n-jj : 4, sB, bi, bj, jj, pW);
+				pB = pW;
+				}
+			else
+				{
+				pB = sB->pA + (bi+jj)*sdb + bj*bs;
+				}
+			for(cc=0; cc<4 & jj+cc<n; cc+=2)
+				for(ii=0; ii<m; ii+=4)
+					zgemm_kernel_4x2(conj_b, k, &alpha, pA+ii*sda, pB+cc, &beta, pC+ii*sdc+(jj+cc)*bs, pD+ii*sdd+(jj+cc)*bs, m-ii, n-jj-cc);
+			}
+		if(pack & k>K_MAX_STACK)
+			{
+			free(mem);
+			}
+		return;
+		}
+
+	double _Complex tmp, b;
+	for(jj=0; jj<n; jj++)
+		{
+		for(ii=0; ii<m; ii++)
+			{
+			tmp = 0.0;
+			for(ll=0; ll<k; ll++)
+				{
+				if(tB==0)
+					b = BLASFEO_ZMATEL(sB, bi+ll, bj+jj);
+				else if(tB==1)
+					b = BLASFEO_ZMATEL(sB, bi+jj, bj+ll);
+				else
+					b = conj(BLASFEO_ZMATEL(sB, bi+jj, bj+ll));
+				tmp += BLASFEO_ZMATEL(sA, ai+ii, aj+ll) * b;
+				}
+			tmp *= alpha;
+			if(beta!=0.0)
+				tmp += beta * BLASFEO_ZMATEL(sC, ci+ii, cj+jj);
+			BLASFEO_ZMATEL(sD, di+ii, dj+jj) = tmp;
+			}
+		}
+	return;
+	}
+
+
+
+void blasfeo_zgemm_nn(int m, int n, int k, double _Complex alpha, struct blasfeo_zmat *sA, int ai, int aj, struct blasfeo_zmat *sB, int bi, int bj, double _Complex beta, struct blasfeo_zmat *sC, int ci, int cj, struct blasfeo_zmat *sD, int di, int dj)
+	{
+	zgemm(0, m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+	return;
+	}
+
+
+
+void blasfeo_zgemm_nt(int m, int n, int k, double _Complex alpha, struct blasfeo_zmat *sA, int ai, int aj, struct blasfeo_zmat *sB, int bi, int bj, double _Complex beta, struct blasfeo_zmat *sC, int ci, int cj, struct blasfeo_zmat *sD, int di, int dj)
+	{
+	zgemm(1, m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+	return;
+	}
+
+
+
+void blasfeo_zgemm_nc(int m, int n, int k, double _Complex alpha, struct blasfeo_zmat *sA, int ai, int aj, struct blasfeo_zmat *sB, int bi, int bj, double _Complex beta, struct blasfeo_zmat *sC, int ci, int cj, struct blasfeo_zmat *sD, int di, int dj)
+	{
+	zgemm(2, m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+	return;
+	}
+
+
+
+// D <= alpha * B
+static void zgesc_cp(int m, int n, double _Complex alpha, struct blasfeo_zmat *sB, int bi, int bj, struct blasfeo_zmat *sD, int di, int dj)
+	{
+	int ii, jj;
+	if(alpha==1.0)
+		{
+		blasfeo_zgecp(m, n, sB, bi, bj, sD, di, dj);
+		return;
+		}
+	for(jj=0; jj<n; jj++)
+		for(ii=0; ii<m; ii++)
+			BLASFEO_ZMATEL(sD, di+ii, dj+jj) = alpha * BLASFEO_ZMATEL(sB, bi+ii, bj+jj);
+	return;
+	}
+
+
+
+// the triangular solves are blocked by panel: the diagonal blocks are solved element-wise, and the rest of the
+// right-hand side is updated with zgemm, right-looking
+
+void blasfeo_ztrsm_llnu(int m, int n, double _Complex alpha, struct blasfeo_zmat *sA, int ai, int aj, struct blasfeo_zmat *sB, int bi, int bj, struct blasfeo_zmat *sD, int di, int dj)
+	{
+	if(m<=0 | n<=0)
+		return;
+
+	const int bs = BLASFEO_ZMAT_PS;
+
+	double _Complex a;
+	int ii, jj, ll, rr, ib;
+
+	zgesc_cp(m, n, alpha, sB, bi, bj, sD, di, dj);
+
+	// the diagonal blocks are solved by the kernel if they start at the top of a panel
+	int sda = sA->cn;
+	int sdd = sD->cn;
+	double _Complex *pE, *pD;
+
+	for(ii=0; ii<m; ii+=bs)
+		{
+		ib = m-ii<bs ? m-ii : bs;
+		if(ai%bs==0 & di%bs==0)
+			{
+			pE = sA->pA + (ai+ii)*sda + (aj+ii)*bs;
+			pD = sD->pA + (di+ii)*sdd + dj*bs;
+			for(jj=0; jj<n; jj+=bs)
+				kernel_ztrsm_nn_ll_one_4x4_vs_lib4(pD+jj*bs, pD+jj*bs, pE, ib, n-jj<bs ? n-jj : bs);
+			}
+		else
+			{
+			for(rr=1; rr<ib; rr++)
+				{
+				for(ll=0; ll<rr; ll++)
+					{
+					a = BLASFEO_ZMATEL(sA, ai+ii+rr, aj+ii+ll);
+					for(jj=0; jj<n; jj++)
+						BLASFEO_ZMATEL(sD, di+ii+rr, dj+jj) -= a * BLASFEO_ZMATEL(sD, di+ii+ll, dj+jj);
+					}
+				}
+			}
+		if(ii+ib<m)
+			blasfeo_zgemm_nn(m-ii-ib, n, ib, -1.0, sA, ai+ii+ib, aj+ii, sD, di+ii, dj, 1.0, sD, di+ii+ib, dj, sD, di+ii+ib, dj);
+		}
+	return;
+	}
+
+
+
+void blasfeo_ztrsm_lunn(int m, int n, double _Complex alpha, struct blasfeo_zmat *sA, int ai, int aj, struct blasfeo_zmat *sB, int bi, int bj, struct blasfeo_zmat *sD, int di, int dj)
+	{
+	if(m<=0 | n<=0)
+		return;
+
+	const int bs = BLASFEO_ZMAT_PS;
+
+	double _Complex a, inv;
+	int ii, jj, ll, rr, ib;
+
+	zgesc_cp(m, n, alpha, sB, bi, bj, sD, di, dj);
+
+	// the blocks start at multiples of the panel size, from the bottom one
+	for(ii=(m-1)/bs*bs; ii>=0; ii-=bs)
+		{
+		ib = m-ii<bs ? m-ii : bs;
+		for(rr=ib-1; rr>=0; rr--)
+			{
+			inv = 1.0 / BLASFEO_ZMATEL(sA, ai+ii+rr, aj+ii+rr);
+			for(jj=0; jj<n; jj++)
+				BLASFEO_ZMATEL(sD, di+ii+rr, dj+jj) *= inv;
+			for(ll=0; ll<rr; ll++)
+				{
+				a = BLASFEO_ZMATEL(sA, ai+ii+ll, aj+ii+rr);
+				for(jj=0; jj<n; jj++)
+					BLASFEO_ZMATEL(sD, di+ii+ll, dj+jj) -= a * BLASFEO_ZMATEL(sD, di+ii+rr, dj+jj);
+				}
+			}
+		if(ii>0)
+			blasfeo_zgemm_nn(ii, n, ib, -1.0, sA, ai, aj+ii, sD, di+ii, dj, 1.0, sD, di, dj, sD, di, dj);
+		}
+	return;
+	}
+
+
+
+void blasfeo_ztrsm_rlcn(int m, int n, double _Complex alpha, struct blasfeo_zmat *sA, int ai, int aj, struct blasfeo_zmat *sB, int bi, int bj, struct blasfeo_zmat *sD, int di, int dj)
+	{
+	if(m<=0 | n<=0)
+		return;
+
+	const int bs = BLASFEO_ZMAT_PS;
+
+	double _Complex a, inv;
+	int ii, jj, cc, c2, jb;
+
+	zgesc_cp(m, n, alpha, sB, bi, bj, sD, di, dj);
+
+	// left-looking by blocks of 4 columns, with the update and the solve of each 4x4 block in the kernel
+	if(ai%bs==0 & di%bs==0)
+		{
+		int sda = sA->cn;
+		int sdd = sD->cn;
+		double _Complex *pA = sA->pA + ai*sda + aj*bs;
+		double _Complex *pD = sD->pA + di*sdd + dj*bs;
+		double _Complex inv_diag[4];
+		for(jj=0; jj<n; jj+=bs)
+			{
+			jb = n-jj<bs ? n-jj : bs;
+			for(cc=0; cc<jb; cc++)
+				inv_diag[cc] = 1.0 / conj(BLASFEO_ZMATEL(sA, ai+jj+cc, aj+jj+cc));
+			for(ii=0; ii<m; ii+=bs)
+				kernel_ztrsm_nc_rl_inv_4x4_vs_lib4(jj, pD+ii*sdd, pA+jj*sda, pD+ii*sdd+jj*bs, pD+ii*sdd+jj*bs, pA+jj*sda+jj*bs, inv_diag, m-ii<bs ? m-ii : bs, jb);
+			}
+		return;
+		}
+
+	for(jj=0; jj<n; jj+=bs)
+		{
+		jb = n-jj<bs ? n-jj : bs;
+		for(cc=0; cc<jb; cc++)
+			{
+			inv = 1.0 / conj(BLASFEO_ZMATEL(sA, ai+jj+cc, aj+jj+cc));
+			for(ii=0; ii<m; ii++)
+				BLASFEO_ZMATEL(sD, di+ii, dj+jj+cc) *= inv;
+			for(c2=cc+1; c2<jb; c2++)
+				{
+				a = conj(BLASFEO_ZMATEL(sA, ai+jj+c2, aj+jj+cc));
+				for(ii=0; ii<m; ii++)
+					BLASFEO_ZMATEL(sD, di+ii, dj+jj+c2) -= BLASFEO_ZMATEL(sD, di+ii, dj+jj+cc) * a;
+				}
+			}
+		if(jj+jb<n)
+			blasfeo_zgemm_nc(m, n-jj-jb, jb, -1.0, sD, di, dj+jj, sA, ai+jj+jb, aj+jj, 1.0, sD, di, dj+jj+jb, sD, di, dj+jj+jb);
+		}
+	return;
+	}
+
+
+
+void blasfeo_ztrsm_runn(int m, int n, double _Complex alpha, struct blasfeo_zmat *sA, int ai, int aj, struct blasfeo_zmat *sB, int bi, int bj, struct blasfeo_zmat *sD, int di, int dj)
+	{
+	if(m<=0 | n<=0)
+		return;
+
+	const int bs = BLASFEO_ZMAT_PS;
+
+	double _Complex a, inv;
+	int ii, jj, cc, c2, jb;
+
+	zgesc_cp(m, n, alpha, sB, bi, bj, sD, di, dj);
+
+	for(jj=0; jj<n; jj+=bs)
+		{
+		jb = n-jj<bs ? n-jj : bs;
+		for(cc=0; cc<jb; cc++)
+			{
+			inv = 1.0 / BLASFEO_ZMATEL(sA, ai+jj+cc, aj+jj+cc);
+			for(ii=0; ii<m; ii++)
+				BLASFEO_ZMATEL(sD, di+ii, dj+jj+cc) *= inv;
+			for(c2=cc+1; c2<jb; c2++)
+				{
+				a = BLASFEO_ZMATEL(sA, ai+jj+cc, aj+jj+c2);
+				for(ii=0; ii<m; ii++)
+					BLASFEO_ZMATEL(sD, di+ii, dj+jj+c2) -= BLASFEO_ZMATEL(sD, di+ii, dj+jj+cc) * a;
+				}
+			}
+		if(jj+jb<n)
+			blasfeo_zgemm_nn(m, n-jj-jb, jb, -1.0, sD, di, dj+jj, sA, ai+jj, aj+jj+jb, 1.0, sD, di, dj+jj+jb, sD, di, dj+jj+jb);
+		}
+	return;
+	}
@@ -0,0 +1,207 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <complex.h>
+
+#include "../include/blasfeo_common.h"
+#include "../include/blasfeo_z_aux.h"
+#include "../include/blasfeo_z_kernel.h"
+#include "../include/blasfeo_z_blasfeo_api.h"
+
+
+
+// D <= chol(C), lower factor of the hermitian positive definite C; only the lower triangle of C is accessed, and only
+// the lower triangle of D is written.
+// Left-looking, blocked by panel: with C and D starting at the top of a panel, each 4x4 block is updated and
+// factorized (or solved) by one kernel; otherwise the panel below each diagonal block is updated with zgemm_nc.
+void blasfeo_zpotrf_l(int m, struct blasfeo_zmat *sC, int ci, int cj, struct blasfeo_zmat *sD, int di, int dj)
+	{
+	if(m<=0)
+		return;
+
+	const int bs = BLASFEO_ZMAT_PS;
+
+	double _Complex tmp, inv;
+	double d;
+	int ii, jj, ll, cc, c2, jb;
+
+	if(ci%bs==0 & di%bs==0)
+		{
+		int sdc = sC->cn;
+		int sdd = sD->cn;
+		double _Complex *pC = sC->pA + ci*sdc + cj*bs;
+		double _Complex *pD = sD->pA + di*sdd + dj*bs;
+		double _Complex inv_diag[4];
+		for(jj=0; jj<m; jj+=bs)
+			{
+			jb = m-jj<bs ? m-jj : bs;
+			kernel_zpotrf_nc_l_4x4_vs_lib4(jj, pD+jj*sdd, pD+jj*sdd, pC+jj*sdc+jj*bs, pD+jj*sdd+jj*bs, inv_diag, jb, jb);
+			for(ii=jj+bs; ii<m; ii+=bs)
+				kernel_ztrsm_nc_rl_inv_4x4_vs_lib4(jj, pD+ii*sdd, pD+jj*sdd, pC+ii*sdc+jj*bs, pD+ii*sdd+jj*bs, pD+jj*sdd+jj*bs, inv_diag, m-ii<bs ? m-ii : bs, jb);
+			}
+		return;
+		}
+
+	for(jj=0; jj<m; jj+=bs)
+		{
+		jb = m-jj<bs ? m-jj : bs;
+		// diagonal block, lower triangle
+		for(cc=0; cc<jb; cc++)
+			{
+			for(ii=cc; ii<jb; ii++)
+				{
+				tmp = BLASFEO_ZMATEL(sC, ci+jj+ii, cj+jj+cc);
+				for(ll=0; ll<jj; ll++)
+					tmp -= BLASFEO_ZMATEL(sD, di+jj+ii, dj+ll) * conj(BLASFEO_ZMATEL(sD, di+jj+cc, dj+ll));
+				BLASFEO_ZMATEL(sD, di+jj+ii, dj+jj+cc) = tmp;
+				}
+			}
+		for(cc=0; cc<jb; cc++)
+			{
+			d = creal(BLASFEO_ZMATEL(sD, di+jj+cc, dj+jj+cc));
+			d = d>0.0 ? sqrt(d) : 0.0;
+			BLASFEO_ZMATEL(sD, di+jj+cc, dj+jj+cc) = d;
+			inv = d>0.0 ? 1.0/d : 0.0;
+			for(ii=cc+1; ii<jb; ii++)
+				BLASFEO_ZMATEL(sD, di+jj+ii, dj+jj+cc) *= inv;
+			for(c2=cc+1; c2<jb; c2++)
+				{
+				tmp = conj(BLASFEO_ZMATEL(sD, di+jj+c2, dj+jj+cc));
+				for(ii=c2; ii<jb; ii++)
+					BLASFEO_ZMATEL(sD, di+jj+ii, dj+jj+c2) -= BLASFEO_ZMATEL(sD, di+jj+ii, dj+jj+cc) * tmp;
+				}
+			}
+		if(jj+jb<m)
+			{
+			// panel below the diagonal block
+			blasfeo_zgemm_nc(m-jj-jb, jb, jj, -1.0, sD, di+jj+jb, dj, sD, di+jj, dj, 1.0, sC, ci+jj+jb, cj+jj, sD, di+jj+jb, dj+jj);
+			blasfeo_ztrsm_rlcn(m-jj-jb, jb, 1.0, sD, di+jj, dj+jj, sD, di+jj+jb, dj+jj, sD, di+jj+jb, dj+jj);
+			}
+		}
+	return;
+	}
+
+
+
+// D <= lu(C), with row pivoting: ipiv[ii] is the row swapped with row ii at step ii.
+// Right-looking, blocked by panel: the panel is factorized element-wise (by the kernel if D starts at the top of a
+// panel), and the trailing matrix is updated with ztrsm_llnu and zgemm_nn.
+void blasfeo_zgetrf_rp(int m, int n, struct blasfeo_zmat *sC, int ci, int cj, struct blasfeo_zmat *sD, int di, int dj, int *ipiv)
+	{
+	if(m<=0 | n<=0)
+		return;
+
+	const int bs = BLASFEO_ZMAT_PS;
+
+	double _Complex tmp, inv;
+	double amax, a;
+	int ii, jj, cc, c2, jb, ip;
+	int mn = m<n ? m : n;
+
+	if(sC!=sD | ci!=di | cj!=dj)
+		blasfeo_zgecp(m, n, sC, ci, cj, sD, di, dj);
+
+	int sdd = sD->cn;
+	double _Complex *pD = sD->pA + di*sdd + dj*bs;
+
+	for(jj=0; jj<mn; jj+=bs)
+		{
+		jb = mn-jj<bs ? mn-jj : bs;
+		if(di%bs==0)
+			{
+			// the kernel swaps the rows in the columns of the panel only
+			kernel_zgetrf_pivot_4_vs_lib4(m-jj, pD+jj*sdd+jj*bs, sdd, ipiv+jj, jb);
+			for(cc=jj; cc<jj+jb; cc++)
+				{
+				ipiv[cc] += jj;
+				if(ipiv[cc]!=cc)
+					{
+					blasfeo_zrowsw(jj, sD, di+cc, dj, sD, di+ipiv[cc], dj);
+					blasfeo_zrowsw(n-jj-jb, sD, di+cc, dj+jj+jb, sD, di+ipiv[cc], dj+jj+jb);
+					}
+				}
+			}
+		else
+			{
+			for(cc=jj; cc<jj+jb; cc++)
+				{
+				// pivot search on |real| + |imag|
+				ip = cc;
+				tmp = BLASFEO_ZMATEL(sD, di+cc, dj+cc);
+				amax = fabs(creal(tmp)) + fabs(cimag(tmp));
+				for(ii=cc+1; ii<m; ii++)
+					{
+					tmp = BLASFEO_ZMATEL(sD, di+ii, dj+cc);
+					a = fabs(creal(tmp)) + fabs(cimag(tmp));
+					if(a>amax)
+						{
+						amax = a;
+						ip = ii;
+						}
+					}
+				ipiv[cc] = ip;
+				if(ip!=cc)
+					blasfeo_zrowsw(n, sD, di+cc, dj, sD, di+ip, dj);
+				tmp = BLASFEO_ZMATEL(sD, di+cc, dj+cc);
+				if(tmp!=0.0)
+					{
+					inv = 1.0 / tmp;
+					for(ii=cc+1; ii<m; ii++)
+						BLASFEO_ZMATEL(sD, di+ii, dj+cc) *= inv;
+					}
+				// rest of the panel
+				for(c2=cc+1; c2<jj+jb; c2++)
+					{
+					tmp = BLASFEO_ZMATEL(sD, di+cc, dj+c2);
+					if(tmp!=0.0)
+						{
+						for(ii=cc+1; ii<m; ii++)
+							BLASFEO_ZMATEL(sD, di+ii, dj+c2) -= BLASFEO_ZMATEL(sD, di+ii, dj+cc) * tmp;
+						}
+					}
+				}
+			}
+		if(jj+jb<n)
+			{
+			blasfeo_ztrsm_llnu(jb, n-jj-jb, 1.0, sD, di+jj, dj+jj, sD, di+jj, dj+jj+jb, sD, di+jj, dj+jj+jb);
+			if(jj+jb<m)
+				blasfeo_zgemm_nn(m-jj-jb, n-jj-jb, jb, -1.0, sD, di+jj+jb, dj+jj, sD, di+jj, dj+jj+jb, 1.0, sD, di+jj+jb, dj+jj+jb, sD, di+jj+jb, dj+jj+jb);
+			}
+		}
+	return;
+	}
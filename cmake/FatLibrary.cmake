@@ -0,0 +1,78 @@
+# Build the blasfeo library for target X64_FAT: the target-dependent sources
+# are compiled once for each target in X64_FAT_TARGETS, each set is merged into
+# one relocatable object and its global symbols are renamed with the prefix
+# blasfeo_fat_<target>_ . The public symbols are then defined by one-jump
+# trampolines through a table, filled at load time with the best target
+# supported by the processor (auxiliary/blasfeo_fat.c)
+
+function( FatLibrary )
+
+  set( FAT_DIR ${CMAKE_CURRENT_BINARY_DIR}/fat )
+  file( MAKE_DIRECTORY ${FAT_DIR} )
+
+  set( FAT_OBJS "" )
+  set( FAT_SYMS "" )
+
+  foreach( FAT_TARGET ${X64_FAT_TARGETS} )
+
+    # sources of this target
+    set( TARGET ${FAT_TARGET} )
+    blasfeo_select_sources()
+
+    add_library( blasfeo_${FAT_TARGET} OBJECT ${AUX_SRC} ${KERNEL_SRC} ${BLAS_SRC} ${EXT_SRC} )
+    target_compile_definitions( blasfeo_${FAT_TARGET} PRIVATE TARGET_${FAT_TARGET} )
+    target_include_directories( blasfeo_${FAT_TARGET} PRIVATE ${PROJECT_SOURCE_DIR}/include )
+    separate_arguments( FAT_C_FLAGS UNIX_COMMAND "${C_FLAGS_TARGET_${FAT_TARGET}}" )
+    separate_arguments( FAT_ASM_FLAGS UNIX_COMMAND "${ASM_FLAGS_TARGET_${FAT_TARGET}}" )
+    target_compile_options( blasfeo_${FAT_TARGET} PRIVATE
+      $<$<COMPILE_LANGUAGE:C>:${FAT_C_FLAGS}>
+      $<$<COMPILE_LANGUAGE:ASM>:${FAT_ASM_FLAGS}> )
+
+    # merge and rename
+    string( TOLOWER "blasfeo_fat_${FAT_TARGET}_" FAT_PREFIX )
+    set( FAT_OBJ ${FAT_DIR}/blasfeo_${FAT_TARGET}.o )
+    set( FAT_SYM ${FAT_DIR}/blasfeo_${FAT_TARGET}.sym )
+    file( GENERATE OUTPUT ${FAT_DIR}/blasfeo_${FAT_TARGET}.objs CONTENT "$<TARGET_OBJECTS:blasfeo_${FAT_TARGET}>" )
+
+    add_custom_command(
+      OUTPUT ${FAT_OBJ} ${FAT_SYM}
+      COMMAND ${CMAKE_COMMAND}
+        -DLINKER=${CMAKE_LINKER}
+        -DNM=${CMAKE_NM}
+        -DOBJCOPY=${CMAKE_OBJCOPY}
+        -DPREFIX=${FAT_PREFIX}
+        -DOBJS_FILE=${FAT_DIR}/blasfeo_${FAT_TARGET}.objs
+        -DOUTPUT=${FAT_OBJ}
+        -DSYMBOLS=${FAT_SYM}
+        -P ${PROJECT_SOURCE_DIR}/cmake/fat_library/rename.cmake
+      DEPENDS blasfeo_${FAT_TARGET} $<TARGET_OBJECTS:blasfeo_${FAT_TARGET}> ${PROJECT_SOURCE_DIR}/cmake/fat_library/rename.cmake
+      COMMENT "Renaming the symbols of target ${FAT_TARGET}"
+      VERBATIM )
+
+    list( APPEND FAT_OBJS ${FAT_OBJ} )
+    list( APPEND FAT_SYMS ${FAT_SYM} )
+
+  endforeach()
+
+  set_source_files_properties( ${FAT_OBJS} PROPERTIES EXTERNAL_OBJECT TRUE GENERATED TRUE )
+
+  # trampolines and dispatch tables, for the functions defined by any target
+  string( REPLACE ";" "," FAT_TARGETS "${X64_FAT_TARGETS}" )
+  add_custom_command(
+    OUTPUT ${FAT_DIR}/blasfeo_fat_dispatch.S ${FAT_DIR}/blasfeo_fat_table.c
+    COMMAND ${CMAKE_COMMAND}
+      -DTARGETS=${FAT_TARGETS}
+      -DDIR=${FAT_DIR}
+      -P ${PROJECT_SOURCE_DIR}/cmake/fat_library/dispatch.cmake
+    DEPENDS ${FAT_SYMS} ${PROJECT_SOURCE_DIR}/cmake/fat_library/dispatch.cmake
+    COMMENT "Generating the fat library dispatch"
+    VERBATIM )
+
+  add_library( blasfeo
+    ${CMN_SRC}
+    ${PROJECT_SOURCE_DIR}/auxiliary/blasfeo_fat.c
+    ${FAT_DIR}/blasfeo_fat_table.c
+    ${FAT_DIR}/blasfeo_fat_dispatch.S
+    ${FAT_OBJS} )
+
+endfunction()
@@ -0,0 +1,77 @@
+# Generate the dispatch of the fat library for the public functions defined by any of
+# the targets: blasfeo_fat_table.c (one table of function pointers per target, and the
+# active table, initialized to the first target) and blasfeo_fat_dispatch.S (one
+# trampoline per function, jumping through the active table, and the registration of
+# the table selection at load time).
+# A public function missing in a target is replaced in its table by a stub reporting that
+# the feature is not implemented for that target: the implementation of another
+# target can not be used instead, since it may need instructions the processor does
+# not have, or a different panel size of the single precision matrices
+#
+# Usage: cmake -DTARGETS=<comma separated list> -DDIR= -P dispatch.cmake
+
+string( REPLACE "," ";" TARGETS "${TARGETS}" )
+
+# public functions (blasfeo_ prefix) defined by any target, and internal functions
+# (kernels and helpers) defined by all targets
+set( FUNS "" )
+foreach( TARGET ${TARGETS} )
+  file( STRINGS ${DIR}/blasfeo_${TARGET}.sym FUNS_${TARGET} )
+  list( APPEND FUNS ${FUNS_${TARGET}} )
+endforeach()
+list( REMOVE_DUPLICATES FUNS )
+foreach( TARGET ${TARGETS} )
+  set( TMP "" )
+  foreach( FUN ${FUNS} )
+    list( FIND FUNS_${TARGET} ${FUN} IDX )
+    if( FUN MATCHES "^blasfeo_" OR NOT ${IDX} EQUAL -1 )
+      list( APPEND TMP ${FUN} )
+    endif()
+  endforeach()
+  set( FUNS ${TMP} )
+endforeach()
+list( SORT FUNS )
+list( LENGTH FUNS N_FUN )
+
+set( HEADER "// generated by cmake/fat_library/dispatch.cmake, do not edit\n\n" )
+
+# tables
+set( TAB "${HEADER}#include <stdio.h>\n#include <stdlib.h>\n\n" )
+foreach( TARGET ${TARGETS} )
+  string( TOLOWER "blasfeo_fat_${TARGET}_" PREFIX )
+  set( ENTRIES "" )
+  foreach( FUN ${FUNS} )
+    list( FIND FUNS_${TARGET} ${FUN} IDX )
+    if( ${IDX} EQUAL -1 )
+      set( TAB "${TAB}static void ${PREFIX}missing_${FUN}(void)\n\t{\n\tprintf(\"\\n${FUN}: feature not implemented yet for target ${TARGET}\\n\");\n\texit(1);\n\t}\n" )
+      set( ENTRIES "${ENTRIES}\t(void *) ${PREFIX}missing_${FUN},\n" )
+    else()
+      set( TAB "${TAB}void ${PREFIX}${FUN}(void);\n" )
+      set( ENTRIES "${ENTRIES}\t(void *) ${PREFIX}${FUN},\n" )
+    endif()
+  endforeach()
+  set( ENTRIES_${TARGET} "${ENTRIES}" )
+  set( TAB "${TAB}\n" )
+endforeach()
+list( GET TARGETS 0 FIRST_TARGET )
+set( TAB "${TAB}__attribute__ ((visibility (\"hidden\"))) void *blasfeo_fat_table[${N_FUN}] =\n\t{\n${ENTRIES_${FIRST_TARGET}}\t};\n\n" )
+foreach( TARGET ${TARGETS} )
+  set( TAB "${TAB}__attribute__ ((visibility (\"hidden\"))) void * const blasfeo_fat_table_${TARGET}[${N_FUN}] =\n\t{\n${ENTRIES_${TARGET}}\t};\n\n" )
+endforeach()
+set( TAB "${TAB}__attribute__ ((visibility (\"hidden\"))) const int blasfeo_fat_table_size = ${N_FUN};\n" )
+file( WRITE ${DIR}/blasfeo_fat_table.c "${TAB}" )
+
+# trampolines
+set( ASM "${HEADER}" )
+set( ASM "${ASM}\t.hidden blasfeo_fat_table\n\t.text\n\n" )
+set( IDX 0 )
+foreach( FUN ${FUNS} )
+  math( EXPR OFF "8*${IDX}" )
+  set( ASM "${ASM}\t.p2align 4\n\t.globl ${FUN}\n\t.type ${FUN}, @function\n${FUN}:\n\tjmp *blasfeo_fat_table+${OFF}(%rip)\n\t.size ${FUN}, .-${FUN}\n\n" )
+  math( EXPR IDX "${IDX}+1" )
+endforeach()
+# table selection at load time (auxiliary/blasfeo_fat.c), referenced from here since any
+# program calling a trampoline links this object
+set( ASM "${ASM}\t.hidden blasfeo_fat_init\n\t.section .init_array,\"aw\"\n\t.p2align 3\n\t.quad blasfeo_fat_init\n\n" )
+set( ASM "${ASM}\t.section .note.GNU-stack,\"\",@progbits\n" )
+file( WRITE ${DIR}/blasfeo_fat_dispatch.S "${ASM}" )
@@ -0,0 +1,45 @@
+# Merge the objects of one target of the fat library into OUTPUT, and add PREFIX
+# to all the global symbols it defines. The renamed functions are listed in SYMBOLS
+#
+# Usage: cmake -DLINKER= -DNM= -DOBJCOPY= -DPREFIX= -DOBJS_FILE= -DOUTPUT= -DSYMBOLS= -P rename.cmake
+
+file( READ ${OBJS_FILE} OBJS )
+
+execute_process(
+  COMMAND ${LINKER} -r -o ${OUTPUT}.tmp ${OBJS}
+  RESULT_VARIABLE RES )
+if( NOT ${RES} EQUAL 0 )
+  message( FATAL_ERROR "Unable to merge the objects into ${OUTPUT}" )
+endif()
+
+execute_process(
+  COMMAND ${NM} -g --defined-only ${OUTPUT}.tmp
+  OUTPUT_VARIABLE NM_OUT
+  RESULT_VARIABLE RES )
+if( NOT ${RES} EQUAL 0 )
+  message( FATAL_ERROR "Unable to list the symbols of ${OUTPUT}" )
+endif()
+
+# nm lines are in the form: <address> <type> <name>
+string( REPLACE "\n" ";" NM_LINES "${NM_OUT}" )
+set( MAP "" )
+set( FUNS "" )
+foreach( LINE ${NM_LINES} )
+  if( LINE MATCHES "^[0-9a-fA-F]* *([A-Za-z]) ([A-Za-z_][A-Za-z0-9_]*)$" )
+    set( MAP "${MAP}${CMAKE_MATCH_2} ${PREFIX}${CMAKE_MATCH_2}\n" )
+    if( CMAKE_MATCH_1 STREQUAL "T" )
+      set( FUNS "${FUNS}${CMAKE_MATCH_2}\n" )
+    endif()
+  endif()
+endforeach()
+file( WRITE ${OUTPUT}.map "${MAP}" )
+
+execute_process(
+  COMMAND ${OBJCOPY} --redefine-syms=${OUTPUT}.map ${OUTPUT}.tmp ${OUTPUT}
+  RESULT_VARIABLE RES )
+if( NOT ${RES} EQUAL 0 )
+  message( FATAL_ERROR "Unable to rename the symbols of ${OUTPUT}" )
+endif()
+file( REMOVE ${OUTPUT}.tmp )
+
+file( WRITE ${SYMBOLS} "${FUNS}" )
@@ -59,6 +59,15 @@ int main()
         exit(3);
     }
 
+    int l1, l2, l3, line;
+    blasfeo_processor_cache_size( &l1, &l2, &l3 );
+    blasfeo_processor_cache_line_size( &line );
+    printf( "Processor caches: L1 %d, L2 %d, L3 %d bytes, line %d bytes\n", l1, l2, l3, line );
+
+    int kc, mc, nc;
+    blasfeo_processor_gemm_block_size( 4, 4, sizeof( double ), &kc, &mc, &nc );
+    printf( "dgemm blocking around a 4x4 kernel: kc %d, mc %d, nc %d\n\n", kc, mc, nc );
+
     int ii;  // loop index
 
     int n = 12;  // matrix size
@@ -0,0 +1,726 @@
+#! /usr/bin/python3
+
+###################################################################################################
+#                                                                                                 #
+# This file is part of BLASFEO.                                                                   #
+#                                                                                                 #
+# BLASFEO -- BLAS For Embedded Optimization.                                                      #
+# Copyright (C) 2019 by Gianluca Frison.                                                          #
+# Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              #
+# All rights reserved.                                                                            #
+#                                                                                                 #
+# The 2-Clause BSD License                                                                        #
+#                                                                                                 #
+# Redistribution and use in source and binary forms, with or without                              #
+# modification, are permitted provided that the following conditions are met:                     #
+#                                                                                                 #
+# 1. Redistributions of source code must retain the above copyright notice, this                  #
+#    list of conditions and the following disclaimer.                                             #
+# 2. Redistributions in binary form must reproduce the above copyright notice,                    #
+#    this list of conditions and the following disclaimer in the documentation                    #
+#    and/or other materials provided with the distribution.                                       #
+#                                                                                                 #
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 #
+# ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   #
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          #
+# DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 #
+# ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  #
+# (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    #
+# LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     #
+# ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      #
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   #
+# SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    #
+#                                                                                                 #
+# Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             #
+#                                                                                                 #
+###################################################################################################
+
+# Generator of fully unrolled BLASFEO API routines for matrix sizes known at build time.
+#
+# usage: generate_fixed_size.py SIZE_LIST OUTPUT_DIR
+#
+# Each line of SIZE_LIST holds a routine followed by its sizes (# starts a comment):
+#   dgemm_nn m n k
+#   dgemm_nt m n k
+#   dsyrk_ln m k
+#   dpotrf_l m
+#   dtrsm_rltn m n
+# For each line, e.g. "dgemm_nt 12 12 4", the routine blasfeo_dgemm_nt_12x12x4 is generated with the same
+# arguments as blasfeo_dgemm_nt; it falls back to blasfeo_dgemm_nt if called with other sizes, or with row
+# offsets which are not a multiple of the panel size. For each routine, a dispatcher (e.g.
+# blasfeo_dgemm_nt_fixed_size) selects among the generated sizes at run-time.
+# The routines are written in OUTPUT_DIR/blasfeo_d_fixed_size.{c,h}, and a residual test checking them against the
+# generic routines in OUTPUT_DIR/test_d_fixed_size.c (built with tests/test_residual.h).
+
+import sys
+import os
+
+
+
+PS = 4
+
+# maximum size of each dimension, to keep the unrolled code size reasonable
+SIZE_MAX = 32
+
+# number of row panels in the gemm register tiles (i.e. 12x4 tiles, as the haswell kernels)
+TILE_PANELS = 3
+
+ROUTINES = {
+	# name: (number of sizes, names of the sizes)
+	'dgemm_nn': ('m', 'n', 'k'),
+	'dgemm_nt': ('m', 'n', 'k'),
+	'dsyrk_ln': ('m', 'k'),
+	'dpotrf_l': ('m',),
+	'dtrsm_rltn': ('m', 'n'),
+	}
+
+ARGS = {
+	'dgemm_nn': 'int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj',
+	'dgemm_nt': 'int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj',
+	'dsyrk_ln': 'int m, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj',
+	'dpotrf_l': 'int m, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj',
+	'dtrsm_rltn': 'int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj',
+	}
+
+CALL = {
+	'dgemm_nn': 'm, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj',
+	'dgemm_nt': 'm, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj',
+	'dsyrk_ln': 'm, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj',
+	'dpotrf_l': 'm, sC, ci, cj, sD, di, dj',
+	'dtrsm_rltn': 'm, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj',
+	}
+
+# matrices with a row offset, which has to be a multiple of the panel size
+ROW_OFFSETS = {
+	'dgemm_nn': ('ai', 'bi', 'ci', 'di'),
+	'dgemm_nt': ('ai', 'bi', 'ci', 'di'),
+	'dsyrk_ln': ('ai', 'bi', 'ci', 'di'),
+	'dpotrf_l': ('ci', 'di'),
+	'dtrsm_rltn': ('ai', 'bi', 'di'),
+	}
+
+
+
+LICENSE = '''/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+// This file is generated by fixed_size/generate_fixed_size.py, do not edit.
+'''
+
+
+
+# vector of 4 doubles (one panel column), on AVX registers if available
+PREAMBLE = '''
+#if defined(LA_HIGH_PERFORMANCE)
+
+#if defined(__AVX__)
+
+#include <immintrin.h>
+
+typedef __m256d v4d;
+
+static inline v4d v_load(const double *p) { return _mm256_loadu_pd(p); }
+static inline v4d v_bcast(const double *p) { return _mm256_broadcast_sd(p); }
+static inline v4d v_set1(double x) { return _mm256_set1_pd(x); }
+static inline v4d v_zero() { return _mm256_setzero_pd(); }
+static inline v4d v_mul(v4d a, v4d b) { return _mm256_mul_pd(a, b); }
+#if defined(__FMA__)
+static inline v4d v_fmadd(v4d a, v4d b, v4d c) { return _mm256_fmadd_pd(a, b, c); }
+static inline v4d v_fnmadd(v4d a, v4d b, v4d c) { return _mm256_fnmadd_pd(a, b, c); }
+#else
+static inline v4d v_fmadd(v4d a, v4d b, v4d c) { return _mm256_add_pd(_mm256_mul_pd(a, b), c); }
+static inline v4d v_fnmadd(v4d a, v4d b, v4d c) { return _mm256_sub_pd(c, _mm256_mul_pd(a, b)); }
+#endif
+static inline void v_store(double *p, v4d a) { _mm256_storeu_pd(p, a); }
+
+#else
+
+typedef struct { double v[4]; } v4d;
+
+static inline v4d v_load(const double *p) { v4d r; r.v[0] = p[0]; r.v[1] = p[1]; r.v[2] = p[2]; r.v[3] = p[3]; return r; }
+static inline v4d v_bcast(const double *p) { v4d r; r.v[0] = p[0]; r.v[1] = p[0]; r.v[2] = p[0]; r.v[3] = p[0]; return r; }
+static inline v4d v_set1(double x) { v4d r; r.v[0] = x; r.v[1] = x; r.v[2] = x; r.v[3] = x; return r; }
+static inline v4d v_zero() { return v_set1(0.0); }
+static inline v4d v_mul(v4d a, v4d b) { v4d r; r.v[0] = a.v[0]*b.v[0]; r.v[1] = a.v[1]*b.v[1]; r.v[2] = a.v[2]*b.v[2]; r.v[3] = a.v[3]*b.v[3]; return r; }
+static inline v4d v_fmadd(v4d a, v4d b, v4d c) { v4d r; r.v[0] = c.v[0]+a.v[0]*b.v[0]; r.v[1] = c.v[1]+a.v[1]*b.v[1]; r.v[2] = c.v[2]+a.v[2]*b.v[2]; r.v[3] = c.v[3]+a.v[3]*b.v[3]; return r; }
+static inline v4d v_fnmadd(v4d a, v4d b, v4d c) { v4d r; r.v[0] = c.v[0]-a.v[0]*b.v[0]; r.v[1] = c.v[1]-a.v[1]*b.v[1]; r.v[2] = c.v[2]-a.v[2]*b.v[2]; r.v[3] = c.v[3]-a.v[3]*b.v[3]; return r; }
+static inline void v_store(double *p, v4d a) { p[0] = a.v[0]; p[1] = a.v[1]; p[2] = a.v[2]; p[3] = a.v[3]; }
+
+#endif
+
+// store the lanes l0 to l1-1 (known at compile time)
+static inline void v_store_lanes(double *p, v4d a, int l0, int l1)
+	{
+	double t[4];
+	v_store(t, a);
+	int ii;
+	for(ii=l0; ii<l1; ii++)
+		p[ii] = t[ii];
+	}
+
+// lane l (known at compile time)
+static inline double v_lane(v4d a, int l)
+	{
+	double t[4];
+	v_store(t, a);
+	return t[l];
+	}
+
+#endif // LA_HIGH_PERFORMANCE
+
+'''
+
+
+
+# checks of the generated routines against the generic ones, on the row offsets supported by both (multiples of the
+# panel size, zero where the generic routines do not support them) and on a nonzero column offset
+TEST_PREAMBLE = '''
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "blasfeo_common.h"
+#include "blasfeo_d_aux.h"
+#include "blasfeo_d_aux_ext_dep.h"
+#include "blasfeo_d_blasfeo_api.h"
+#include "blasfeo_d_fixed_size.h"
+
+#include "test_residual.h"
+
+
+
+#define TOL 1e-12
+
+
+
+typedef void (*gemm_fun)(%(dgemm_nn)s);
+typedef void (*syrk_fun)(%(dsyrk_ln)s);
+typedef void (*potrf_fun)(%(dpotrf_l)s);
+typedef void (*trsm_fun)(%(dtrsm_rltn)s);
+
+
+
+// compare the whole matrices sD and sD_ref, so that writes outside of the result block are detected too
+static int check_result(char *name, int ri, int cj, struct blasfeo_dmat *sD, struct blasfeo_dmat *sD_ref)
+	{
+	double err = 0.0;
+	int ii, jj;
+	for(jj=0; jj<sD->n; jj++)
+		for(ii=0; ii<sD->m; ii++)
+			err = fmax(err, fabs(blasfeo_dgeex1(sD, ii, jj) - blasfeo_dgeex1(sD_ref, ii, jj)));
+	double ref = test_d_max_abs(sD->m, sD->n, sD_ref, 0, 0);
+	if(err>TOL*(1.0+ref))
+		{
+		printf("%%s at offsets (%%d, %%d): error %%e\\n", name, ri, cj, err);
+		return 1;
+		}
+	return 0;
+	}
+
+
+
+static int check_gemm(char *name, gemm_fun fun, gemm_fun fun_ref, int tran_b, int m, int n, int k)
+	{
+	struct blasfeo_dmat sA, sB, sC, sD, sD_ref;
+	int n_fail = 0;
+	int ri, cj;
+	for(ri=0; ri<=4; ri+=4)
+		{
+		cj = ri/4;
+		blasfeo_allocate_dmat(ri+m, cj+k, &sA);
+		if(tran_b)
+			blasfeo_allocate_dmat(ri+n, cj+k, &sB);
+		else
+			blasfeo_allocate_dmat(ri+k, cj+n, &sB);
+		blasfeo_allocate_dmat(ri+m, cj+n, &sC);
+		blasfeo_allocate_dmat(ri+m, cj+n, &sD);
+		blasfeo_allocate_dmat(ri+m, cj+n, &sD_ref);
+		test_d_rnd_mat(sA.m, sA.n, &sA, 0, 0);
+		test_d_rnd_mat(sB.m, sB.n, &sB, 0, 0);
+		test_d_rnd_mat(sC.m, sC.n, &sC, 0, 0);
+		test_d_rnd_mat(sD.m, sD.n, &sD, 0, 0);
+		blasfeo_dgecp(sD.m, sD.n, &sD, 0, 0, &sD_ref, 0, 0);
+		fun(m, n, k, 1.5, &sA, ri, cj, &sB, ri, cj, -0.5, &sC, ri, cj, &sD, ri, cj);
+		fun_ref(m, n, k, 1.5, &sA, ri, cj, &sB, ri, cj, -0.5, &sC, ri, cj, &sD_ref, ri, cj);
+		n_fail += check_result(name, ri, cj, &sD, &sD_ref);
+		blasfeo_free_dmat(&sA);
+		blasfeo_free_dmat(&sB);
+		blasfeo_free_dmat(&sC);
+		blasfeo_free_dmat(&sD);
+		blasfeo_free_dmat(&sD_ref);
+		}
+	return n_fail;
+	}
+
+
+
+static int check_syrk(char *name, syrk_fun fun, int m, int k)
+	{
+	struct blasfeo_dmat sA, sB, sC, sD, sD_ref;
+	int n_fail = 0;
+	int ri, cj;
+	for(ri=0; ri<=4; ri+=4)
+		{
+		cj = ri/4;
+		blasfeo_allocate_dmat(ri+m, cj+k, &sA);
+		blasfeo_allocate_dmat(ri+m, cj+k, &sB);
+		blasfeo_allocate_dmat(ri+m, cj+m, &sC);
+		blasfeo_allocate_dmat(ri+m, cj+m, &sD);
+		blasfeo_allocate_dmat(ri+m, cj+m, &sD_ref);
+		test_d_rnd_mat(sA.m, sA.n, &sA, 0, 0);
+		test_d_rnd_mat(sB.m, sB.n, &sB, 0, 0);
+		test_d_rnd_mat(sC.m, sC.n, &sC, 0, 0);
+		test_d_rnd_mat(sD.m, sD.n, &sD, 0, 0);
+		blasfeo_dgecp(sD.m, sD.n, &sD, 0, 0, &sD_ref, 0, 0);
+		fun(m, k, 1.5, &sA, ri, cj, &sB, ri, cj, -0.5, &sC, ri, cj, &sD, ri, cj);
+		blasfeo_dsyrk_ln(m, k, 1.5, &sA, ri, cj, &sB, ri, cj, -0.5, &sC, ri, cj, &sD_ref, ri, cj);
+		n_fail += check_result(name, ri, cj, &sD, &sD_ref);
+		blasfeo_free_dmat(&sA);
+		blasfeo_free_dmat(&sB);
+		blasfeo_free_dmat(&sC);
+		blasfeo_free_dmat(&sD);
+		blasfeo_free_dmat(&sD_ref);
+		}
+	return n_fail;
+	}
+
+
+
+// the generic dpotrf_l needs zero row offsets
+static int check_potrf(char *name, potrf_fun fun, int m)
+	{
+	struct blasfeo_dmat sA, sC, sD, sD_ref;
+	int n_fail = 0;
+	int cj;
+	for(cj=0; cj<=1; cj++)
+		{
+		blasfeo_allocate_dmat(m, m, &sA);
+		blasfeo_allocate_dmat(m, cj+m, &sC);
+		blasfeo_allocate_dmat(m, cj+m, &sD);
+		blasfeo_allocate_dmat(m, cj+m, &sD_ref);
+		test_d_rnd_mat(m, m, &sA, 0, 0);
+		test_d_rnd_mat(sC.m, sC.n, &sC, 0, 0);
+		// symmetric positive definite C
+		blasfeo_dgemm_nt(m, m, m, 1.0, &sA, 0, 0, &sA, 0, 0, 0.0, &sC, 0, cj, &sC, 0, cj);
+		blasfeo_ddiare(m, 1.0*m, &sC, 0, cj);
+		test_d_rnd_mat(sD.m, sD.n, &sD, 0, 0);
+		blasfeo_dgecp(sD.m, sD.n, &sD, 0, 0, &sD_ref, 0, 0);
+		fun(m, &sC, 0, cj, &sD, 0, cj);
+		blasfeo_dpotrf_l(m, &sC, 0, cj, &sD_ref, 0, cj);
+		n_fail += check_result(name, 0, cj, &sD, &sD_ref);
+		blasfeo_free_dmat(&sA);
+		blasfeo_free_dmat(&sC);
+		blasfeo_free_dmat(&sD);
+		blasfeo_free_dmat(&sD_ref);
+		}
+	return n_fail;
+	}
+
+
+
+// the generic dtrsm_rltn needs a zero row offset of A and alpha=1
+static int check_trsm(char *name, trsm_fun fun, int m, int n)
+	{
+	struct blasfeo_dmat sA, sB, sD, sD_ref;
+	int n_fail = 0;
+	int ri, cj;
+	for(ri=0; ri<=4; ri+=4)
+		{
+		cj = ri/4;
+		blasfeo_allocate_dmat(n, cj+n, &sA);
+		blasfeo_allocate_dmat(ri+m, cj+n, &sB);
+		blasfeo_allocate_dmat(ri+m, cj+n, &sD);
+		blasfeo_allocate_dmat(ri+m, cj+n, &sD_ref);
+		// lower triangular A, well conditioned
+		test_d_rnd_mat(sA.m, sA.n, &sA, 0, 0);
+		blasfeo_ddiare(n, 2.0, &sA, 0, cj);
+		test_d_rnd_mat(sB.m, sB.n, &sB, 0, 0);
+		test_d_rnd_mat(sD.m, sD.n, &sD, 0, 0);
+		blasfeo_dgecp(sD.m, sD.n, &sD, 0, 0, &sD_ref, 0, 0);
+		fun(m, n, 1.0, &sA, 0, cj, &sB, ri, cj, &sD, ri, cj);
+		blasfeo_dtrsm_rltn(m, n, 1.0, &sA, 0, cj, &sB, ri, cj, &sD_ref, ri, cj);
+		n_fail += check_result(name, ri, cj, &sD, &sD_ref);
+		blasfeo_free_dmat(&sA);
+		blasfeo_free_dmat(&sB);
+		blasfeo_free_dmat(&sD);
+		blasfeo_free_dmat(&sD_ref);
+		}
+	return n_fail;
+	}
+
+''' % ARGS
+
+
+
+def func_name(routine, sizes):
+	return 'blasfeo_' + routine + '_' + 'x'.join(str(s) for s in sizes)
+
+
+
+class Emitter:
+
+	def __init__(self):
+		self.lines = []
+
+	def __call__(self, line, indent=1):
+		self.lines.append('\t'*indent + line)
+
+	def text(self):
+		return '\n'.join(self.lines) + '\n'
+
+
+
+# index of the element (i,j) of a panel-major matrix with panel stride sd, from its (0,0) element
+def idx(sd, i, j):
+	return '%d*%s+%d' % (i//PS*PS, sd, j*PS+i%PS) if i//PS>0 else '%d' % (j*PS+i%PS)
+
+# pointer to the element (i,j)
+def el(ptr, sd, i, j):
+	return ptr + '+' + idx(sd, i, j)
+
+
+
+# store a vector holding rows 4*p to 4*p+3 of column j, only the rows in [r0, r1)
+def store(e, ptr, sd, p, j, v, r0, r1, indent):
+	l0 = max(r0-PS*p, 0)
+	l1 = min(r1-PS*p, PS)
+	if l0>=l1:
+		return
+	if l0==0 and l1==PS:
+		e('v_store(%s, %s);' % (el(ptr, sd, PS*p, j), v), indent)
+	else:
+		e('v_store_lanes(%s, %s, %d, %d);' % (el(ptr, sd, PS*p, j), v, l0, l1), indent)
+
+
+
+# D = beta*C + alpha*A*B^T (tran_b) or alpha*A*B, on register tiles of up to TILE_PANELS row panels times 4
+# columns of the output; with lower, only the lower triangle of D is computed and stored
+def gen_gemm(e, m, n, k, tran_b, lower):
+	np = (m+PS-1)//PS
+	e('const double *pA = sA->pA + ai*sA->cn + aj*%d;' % PS)
+	e('const double *pB = sB->pA + bi*sB->cn + bj*%d;' % PS)
+	e('const double *pC = sC->pA + ci*sC->cn + cj*%d;' % PS)
+	e('double *pD = sD->pA + di*sD->cn + dj*%d;' % PS)
+	e('const int sda = sA->cn;')
+	e('const int sdb = sB->cn;')
+	e('const int sdc = sC->cn;')
+	e('const int sdd = sD->cn;')
+	e('const v4d v_alpha = v_set1(alpha);')
+	e('const v4d v_beta = v_set1(beta);')
+	e('v4d b;')
+	for t in range(min(TILE_PANELS, np)):
+		e('v4d a%d, %s;' % (t, ', '.join('c%d_%d' % (t, jj) for jj in range(min(PS, n)))))
+	e('')
+	e('// invalidate stored inverse diagonal of result matrix')
+	e('sD->use_dA = 0;')
+	for jb in range(0, n, PS):
+		nj = min(PS, n-jb)
+		# row panels of the tiles on this column block
+		panels = [p for p in range(np) if not (lower and PS*p+PS<=jb)]
+		for t0 in range(0, len(panels), TILE_PANELS):
+			tile = panels[t0:t0+TILE_PANELS]
+			e('')
+			e('// rows %d-%d, cols %d-%d' % (PS*tile[0], min(PS*tile[-1]+PS, m)-1, jb, jb+nj-1))
+			for t in range(len(tile)):
+				for jj in range(nj):
+					e('c%d_%d = v_zero();' % (t, jj))
+			for kk in range(k):
+				for t, p in enumerate(tile):
+					e('a%d = v_load(%s);' % (t, el('pA', 'sda', PS*p, kk)))
+				for jj in range(nj):
+					if tran_b:
+						e('b = v_bcast(%s);' % el('pB', 'sdb', jb+jj, kk))
+					else:
+						e('b = v_bcast(%s);' % el('pB', 'sdb', kk, jb+jj))
+					for t in range(len(tile)):
+						e('c%d_%d = v_fmadd(a%d, b, c%d_%d);' % (t, jj, t, t, jj))
+			for t in range(len(tile)):
+				for jj in range(nj):
+					e('c%d_%d = v_mul(v_alpha, c%d_%d);' % (t, jj, t, jj))
+			e('if(beta!=0.0)')
+			e('\t{')
+			for t, p in enumerate(tile):
+				for jj in range(nj):
+					e('c%d_%d = v_fmadd(v_beta, v_load(%s), c%d_%d);' % (t, jj, el('pC', 'sdc', PS*p, jb+jj), t, jj), 2)
+			e('\t}')
+			for t, p in enumerate(tile):
+				for jj in range(nj):
+					r0 = jb+jj if lower else 0
+					store(e, 'pD', 'sdd', p, jb+jj, 'c%d_%d' % (t, jj), r0, m, 1)
+
+
+
+# D = chol(C), left-looking by columns, keeping the computed columns on vectors d_p_j
+def gen_potrf(e, m):
+	np = (m+PS-1)//PS
+	e('const double *pC = sC->pA + ci*sC->cn + cj*%d;' % PS)
+	e('double *pD = sD->pA + di*sD->cn + dj*%d;' % PS)
+	e('const int sdc = sC->cn;')
+	e('const int sdd = sD->cn;')
+	e('double *dD = sD->dA;')
+	e('double d_jj, inv;')
+	e('int store_dA = (di==0) & (dj==0);')
+	for j in range(m):
+		e('v4d ' + ', '.join('d_%d_%d' % (p, j) for p in range(j//PS, np)) + ';')
+	e('')
+	e('sD->use_dA = store_dA ? %d : 0;' % m)
+	for j in range(m):
+		pj = j//PS
+		e('')
+		e('// col %d' % j)
+		for p in range(pj, np):
+			e('d_%d_%d = v_load(%s);' % (p, j, el('pC', 'sdc', PS*p, j)))
+			for l in range(j):
+				e('d_%d_%d = v_fnmadd(d_%d_%d, v_bcast(%s), d_%d_%d);' % (p, j, p, l, el('pD', 'sdd', j, l), p, j))
+		e('d_jj = v_lane(d_%d_%d, %d);' % (pj, j, j%PS))
+		e('if(d_jj>0.0)')
+		e('\t{')
+		e('d_jj = sqrt(d_jj);', 2)
+		e('inv = 1.0/d_jj;', 2)
+		e('\t}')
+		e('else')
+		e('\t{')
+		e('d_jj = 0.0;', 2)
+		e('inv = 0.0;', 2)
+		e('\t}')
+		for p in range(pj, np):
+			e('d_%d_%d = v_mul(v_set1(inv), d_%d_%d);' % (p, j, p, j))
+			store(e, 'pD', 'sdd', p, j, 'd_%d_%d' % (p, j), j+1 if p==pj else 0, m, 1)
+		e('pD[%s] = d_jj;' % idx('sdd', j, j))
+		e('if(store_dA)')
+		e('\tdD[%d] = inv;' % j)
+
+
+
+# D = alpha * B * A^{-T}, with A lower triangular, by columns on vectors d_p_j
+def gen_trsm_rltn(e, m, n):
+	np = (m+PS-1)//PS
+	e('const double *pA = sA->pA + ai*sA->cn + aj*%d;' % PS)
+	e('const double *pB = sB->pA + bi*sB->cn + bj*%d;' % PS)
+	e('double *pD = sD->pA + di*sD->cn + dj*%d;' % PS)
+	e('const int sda = sA->cn;')
+	e('const int sdb = sB->cn;')
+	e('const int sdd = sD->cn;')
+	e('const v4d v_alpha = v_set1(alpha);')
+	e('double inv_local[%d];' % n)
+	e('double *inv = inv_local;')
+	for j in range(n):
+		e('v4d ' + ', '.join('d_%d_%d' % (p, j) for p in range(np)) + ';')
+	e('')
+	e('// inverse of the diagonal of A, stored in A as by blasfeo_dtrsm_rltn')
+	e('if((ai==0) & (aj==0))')
+	e('\t{')
+	e('if(sA->use_dA<%d)' % n, 2)
+	e('\t{', 2)
+	for j in range(n):
+		e('sA->dA[%d] = 1.0/pA[%s];' % (j, idx('sda', j, j)), 3)
+	e('sA->use_dA = %d;' % n, 3)
+	e('\t}', 2)
+	e('inv = sA->dA;', 2)
+	e('\t}')
+	e('else')
+	e('\t{')
+	for j in range(n):
+		e('inv_local[%d] = 1.0/pA[%s];' % (j, idx('sda', j, j)), 2)
+	e('\t}')
+	for j in range(n):
+		e('')
+		e('// col %d' % j)
+		for p in range(np):
+			e('d_%d_%d = v_mul(v_alpha, v_load(%s));' % (p, j, el('pB', 'sdb', PS*p, j)))
+			for l in range(j):
+				e('d_%d_%d = v_fnmadd(d_%d_%d, v_bcast(%s), d_%d_%d);' % (p, j, p, l, el('pA', 'sda', j, l), p, j))
+			e('d_%d_%d = v_mul(v_set1(inv[%d]), d_%d_%d);' % (p, j, j, p, j))
+			store(e, 'pD', 'sdd', p, j, 'd_%d_%d' % (p, j), 0, m, 1)
+
+
+
+def gen_routine(routine, sizes):
+	e = Emitter()
+	name = func_name(routine, sizes)
+	e('void %s(%s)' % (name, ARGS[routine]), 0)
+	e('\t{', 0)
+	e('#if defined(LA_HIGH_PERFORMANCE) & (D_PS==%d)' % PS, 0)
+	cond = ' | '.join('(%s!=%d)' % (s, v) for s, v in zip(ROUTINES[routine], sizes))
+	cond += ''.join(' | ((%s&%d)!=0)' % (o, PS-1) for o in ROW_OFFSETS[routine])
+	e('if(%s)' % cond)
+	e('\t{')
+	e('blasfeo_%s(%s);' % (routine, CALL[routine]), 2)
+	e('return;', 2)
+	e('\t}')
+	e('')
+	if routine=='dgemm_nn':
+		gen_gemm(e, sizes[0], sizes[1], sizes[2], False, False)
+	elif routine=='dgemm_nt':
+		gen_gemm(e, sizes[0], sizes[1], sizes[2], True, False)
+	elif routine=='dsyrk_ln':
+		gen_gemm(e, sizes[0], sizes[0], sizes[1], True, True)
+	elif routine=='dpotrf_l':
+		gen_potrf(e, sizes[0])
+	elif routine=='dtrsm_rltn':
+		gen_trsm_rltn(e, sizes[0], sizes[1])
+	e('')
+	e('return;')
+	# drop the panel strides not used by the unrolled code
+	for sd in ('sda', 'sdb', 'sdc', 'sdd'):
+		decl = [l for l in e.lines if l.startswith('\tconst int %s = ' % sd)]
+		if decl and sum(l.count(sd) for l in e.lines)==1:
+			e.lines.remove(decl[0])
+	e('#else', 0)
+	e('blasfeo_%s(%s);' % (routine, CALL[routine]))
+	e('#endif', 0)
+	e('\t}', 0)
+	return e.text()
+
+
+
+def gen_dispatch(routine, size_list):
+	e = Emitter()
+	e('void blasfeo_%s_fixed_size(%s)' % (routine, ARGS[routine]), 0)
+	e('\t{', 0)
+	for sizes in size_list:
+		cond = ' & '.join('(%s==%d)' % (s, v) for s, v in zip(ROUTINES[routine], sizes))
+		e('if(%s)' % cond)
+		e('\t{')
+		e('%s(%s);' % (func_name(routine, sizes), CALL[routine]), 2)
+		e('return;', 2)
+		e('\t}')
+	e('blasfeo_%s(%s);' % (routine, CALL[routine]))
+	e('return;')
+	e('\t}', 0)
+	return e.text()
+
+
+
+# call of the check of routine fun, with the sizes
+def test_call(routine, name, fun, sizes):
+	args = ', '.join(str(s) for s in sizes)
+	if routine=='dgemm_nn':
+		return 'n_fail += check_gemm("%s", %s, blasfeo_dgemm_nn, 0, %s);' % (name, fun, args)
+	if routine=='dgemm_nt':
+		return 'n_fail += check_gemm("%s", %s, blasfeo_dgemm_nt, 1, %s);' % (name, fun, args)
+	if routine=='dsyrk_ln':
+		return 'n_fail += check_syrk("%s", %s, %s);' % (name, fun, args)
+	if routine=='dpotrf_l':
+		return 'n_fail += check_potrf("%s", %s, %s);' % (name, fun, args)
+	return 'n_fail += check_trsm("%s", %s, %s);' % (name, fun, args)
+
+
+
+# each fixed-size routine on its sizes, on the fallback to the generic routine (first size plus one), and the
+# dispatcher on all the sizes
+def gen_test(size_lists):
+	e = Emitter()
+	e('int main()', 0)
+	e('\t{', 0)
+	e('int n_fail = 0;')
+	for routine in sorted(size_lists):
+		e('')
+		e('// %s' % routine)
+		for sizes in size_lists[routine]:
+			name = func_name(routine, sizes)
+			e(test_call(routine, name, name, sizes))
+			other = (sizes[0]+1,) + sizes[1:]
+			e(test_call(routine, name+' (fallback '+'x'.join(str(s) for s in other)+')', name, other))
+			e(test_call(routine, 'blasfeo_%s_fixed_size' % routine, 'blasfeo_%s_fixed_size' % routine, sizes))
+	e('')
+	e('return test_report("fixed-size routines", n_fail);')
+	e('\t}', 0)
+	return e.text()
+
+
+
+def parse_size_list(file_name):
+	size_lists = {}
+	with open(file_name) as f:
+		for line_num, line in enumerate(f, 1):
+			line = line.split('#')[0].split()
+			if not line:
+				continue
+			routine = line[0]
+			if routine not in ROUTINES:
+				sys.exit('%s:%d: unknown routine %s (available: %s)' % (file_name, line_num, routine, ', '.join(sorted(ROUTINES))))
+			try:
+				sizes = tuple(int(s) for s in line[1:])
+			except ValueError:
+				sys.exit('%s:%d: sizes have to be integers' % (file_name, line_num))
+			if len(sizes)!=len(ROUTINES[routine]):
+				sys.exit('%s:%d: %s needs the sizes %s' % (file_name, line_num, routine, ' '.join(ROUTINES[routine])))
+			if any(s<1 or s>SIZE_MAX for s in sizes):
+				sys.exit('%s:%d: sizes have to be between 1 and %d' % (file_name, line_num, SIZE_MAX))
+			if sizes not in size_lists.setdefault(routine, []):
+				size_lists[routine].append(sizes)
+	return size_lists
+
+
+
+def main():
+	if len(sys.argv)!=3:
+		sys.exit('usage: %s SIZE_LIST OUTPUT_DIR' % sys.argv[0])
+	size_lists = parse_size_list(sys.argv[1])
+	out_dir = sys.argv[2]
+	os.makedirs(out_dir, exist_ok=True)
+
+	h = LICENSE
+	h += '\n#ifndef BLASFEO_D_FIXED_SIZE_H_\n#define BLASFEO_D_FIXED_SIZE_H_\n\n'
+	h += '#include "blasfeo_common.h"\n#include "blasfeo_d_blasfeo_api.h"\n\n'
+	h += '#ifdef __cplusplus\nextern "C" {\n#endif\n\n\n\n'
+	for routine in sorted(size_lists):
+		h += '// %s for fixed sizes (%s), falling back to blasfeo_%s for other sizes\n' % (routine, ' '.join(ROUTINES[routine]), routine)
+		for sizes in size_lists[routine]:
+			h += 'void %s(%s);\n' % (func_name(routine, sizes), ARGS[routine])
+		h += '// select among the fixed sizes of %s at run-time\n' % routine
+		h += 'void blasfeo_%s_fixed_size(%s);\n\n' % (routine, ARGS[routine])
+	h += '\n\n#ifdef __cplusplus\n}\n#endif\n\n#endif // BLASFEO_D_FIXED_SIZE_H_\n'
+
+	c = LICENSE
+	c += '\n#include <math.h>\n\n#include "blasfeo_d_fixed_size.h"\n\n\n'
+	c += PREAMBLE
+	for routine in sorted(size_lists):
+		for sizes in size_lists[routine]:
+			c += '\n\n' + gen_routine(routine, sizes)
+		c += '\n\n' + gen_dispatch(routine, size_lists[routine])
+
+	with open(os.path.join(out_dir, 'blasfeo_d_fixed_size.h'), 'w') as f:
+		f.write(h)
+	with open(os.path.join(out_dir, 'blasfeo_d_fixed_size.c'), 'w') as f:
+		f.write(c)
+	with open(os.path.join(out_dir, 'test_d_fixed_size.c'), 'w') as f:
+		f.write(LICENSE + TEST_PREAMBLE + '\n\n' + gen_test(size_lists))
+
+
+
+if __name__ == '__main__':
+	main()
@@ -41,10 +41,20 @@
 #include "blasfeo_d_aux_ext_dep.h"
 #include "blasfeo_d_kernel.h"
 #include "blasfeo_d_blas.h"
+#include "blasfeo_d_spchol.h"
 #include "blasfeo_s_aux.h"
 #include "blasfeo_s_aux_ext_dep.h"
 #include "blasfeo_s_kernel.h"
 #include "blasfeo_s_blas.h"
+#include "blasfeo_m_aux.h"
+#include "blasfeo_h_aux.h"
+#include "blasfeo_z_aux.h"
+#include "blasfeo_z_blasfeo_api.h"
+#include "blasfeo_z_kernel.h"
 #include "blasfeo_i_aux_ext_dep.h"
 #include "blasfeo_v_aux_ext_dep.h"
 #include "blasfeo_timing.h"
+#include "blasfeo_thread.h"
+#include "blasfeo_stdlib.h"
+#include "blasfeo_tuning.h"
+#include "blasfeo_jit.h"
@@ -115,6 +115,13 @@
 #define D_NC 4 // 2 // until the smaller kernel is 4x4
 #define S_NC 4 //2
 
+#elif defined( TARGET_X64_FAT )
+
+#define D_PS 4
+#define S_PS blasfeo_fat_s_ps() // 4 or 8, depending on the target selected at run-time
+#define D_NC 4 // 2 // until the smaller kernel is 4x4
+#define S_NC 4 //2
+
 #else
 #error "Unknown architecture"
 #endif
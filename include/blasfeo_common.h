@@ -63,6 +63,11 @@ extern "C" {
 
 #include "blasfeo_block_size.h"
 
+#if defined(TARGET_X64_FAT)
+// panel size of the single precision matrices of the target selected at run-time
+int blasfeo_fat_s_ps();
+#endif
+
 // matrix structure
 struct blasfeo_dmat
 	{
@@ -161,6 +166,74 @@ struct blasfeo_svec
 
 
 
+// interleaved ("compact") batch of matrices: element (i,j) of the BLASFEO_DMAT_BATCH_LANES matrices is stored contiguously
+#define BLASFEO_DMAT_BATCH_LANES 4
+
+// matrix batch structure
+struct blasfeo_dmat_batch
+	{
+	int m; // rows
+	int n; // cols
+	double *pA; // pointer to a m*n*lanes array of doubles, the first is aligned to cache line size
+	int memsize; // size of needed memory
+	};
+
+#define BLASFEO_DMAT_BATCH_EL(sA,ai,aj,al) ((sA)->pA[BLASFEO_DMAT_BATCH_LANES*((ai)+(aj)*(sA)->m)+(al)])
+
+
+
+// half precision (IEEE 754 binary16) storage matrix, panel-major with the same panel size for all targets and LA
+#define BLASFEO_HMAT_PS 8
+
+// matrix structure
+struct blasfeo_hmat
+	{
+	int m; // rows
+	int n; // cols
+	int pm; // packed number or rows
+	int cn; // packed number or cols
+	unsigned short *pA; // pointer to a pm*cn array of half precision bit patterns, the first is aligned to cache line size
+	int memsize; // size of needed memory
+	};
+
+// bit pattern of element (ai,aj), see blasfeo_hgeex1 and blasfeo_hgein1 to access its value
+#define BLASFEO_HMATEL(sA,ai,aj) ((sA)->pA[((ai)-((ai)&(BLASFEO_HMAT_PS-1)))*(sA)->cn+(aj)*BLASFEO_HMAT_PS+((ai)&(BLASFEO_HMAT_PS-1))])
+
+
+
+#ifdef COMPLEX
+
+// double precision complex matrix, panel-major with the same panel size for all targets and LA (real and imaginary
+// parts interleaved, a panel column of 4 elements fills a cache line); C99 complex types, only with COMPLEX=1
+#define BLASFEO_ZMAT_PS 4
+
+// matrix structure
+struct blasfeo_zmat
+	{
+	int m; // rows
+	int n; // cols
+	int pm; // packed number or rows
+	int cn; // packed number or cols
+	double _Complex *pA; // pointer to a pm*cn array of complex, the first is aligned to cache line size
+	int memsize; // size of needed memory
+	};
+
+// vector structure
+struct blasfeo_zvec
+	{
+	int m; // size
+	int pm; // packed size
+	double _Complex *pa; // pointer to a pm array of complex, the first is aligned to cache line size
+	int memsize; // size of needed memory
+	};
+
+#define BLASFEO_ZMATEL(sA,ai,aj) ((sA)->pA[((ai)-((ai)&(BLASFEO_ZMAT_PS-1)))*(sA)->cn+(aj)*BLASFEO_ZMAT_PS+((ai)&(BLASFEO_ZMAT_PS-1))])
+#define BLASFEO_ZVECEL(sa,ai) ((sa)->pa[ai])
+
+#endif // COMPLEX
+
+
+
 #if defined(TESTING_MODE)
 
 // matrix structure
@@ -165,6 +165,7 @@ void blasfeo_drowpei(int kmax, int *ipiv, struct blasfeo_dmat *sA);
 void blasfeo_dcolex(int kmax, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dvec *sx, int xi);
 void blasfeo_dcolin(int kmax, struct blasfeo_dvec *sx, int xi, struct blasfeo_dmat *sA, int ai, int aj);
 void blasfeo_dcolad(int kmax, double alpha, struct blasfeo_dvec *sx, int xi, struct blasfeo_dmat *sA, int ai, int aj);
+void blasfeo_dcolad_sp(int kmax, double alpha, struct blasfeo_dvec *sx, int xi, int *idx, struct blasfeo_dmat *sD, int di, int dj);
 void blasfeo_dcolsc(int kmax, double alpha, struct blasfeo_dmat *sA, int ai, int aj);
 void blasfeo_dcolsw(int kmax, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sC, int ci, int cj);
 void blasfeo_dcolpe(int kmax, int *ipiv, struct blasfeo_dmat *sA);
@@ -203,6 +204,19 @@ void blasfeo_dvecpei(int kmax, int *ipiv, struct blasfeo_dvec *sx, int xi);
 
 
 
+// --- interleaved matrix batch
+//
+// returns the memory size (in bytes) needed for a dmat_batch
+int blasfeo_memsize_dmat_batch(int m, int n);
+// create a dmat_batch for BLASFEO_DMAT_BATCH_LANES matrices of size m*n by using memory passed by a pointer (aligned as for dmat)
+void blasfeo_create_dmat_batch(int m, int n, struct blasfeo_dmat_batch *sA, void *memory);
+// pack the m*n submatrices of the BLASFEO_DMAT_BATCH_LANES dmat sA[l] into the lanes of sB (NULL offset arrays mean zero offsets)
+void blasfeo_pack_dmat_batch(int m, int n, struct blasfeo_dmat **sA, int *ai, int *aj, struct blasfeo_dmat_batch *sB, int bi, int bj);
+// unpack the lanes of sA into the BLASFEO_DMAT_BATCH_LANES dmat sB[l]
+void blasfeo_unpack_dmat_batch(int m, int n, struct blasfeo_dmat_batch *sA, int ai, int aj, struct blasfeo_dmat **sB, int *bi, int *bj);
+
+
+
 #ifdef __cplusplus
 }
 #endif
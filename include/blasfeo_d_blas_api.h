@@ -40,6 +40,8 @@
 
 
 
+#include <stddef.h>
+
 #include "blasfeo_target.h"
 
 
@@ -54,6 +56,12 @@ extern "C" {
 
 
 
+// worst-case size of the workspace arena (blasfeo_blas_workspace_set) for a BLAS API call on matrices with dimensions
+// up to m, n and k, for any number of threads of the pool; in bytes
+size_t blasfeo_blas_workspace_size(int m, int n, int k);
+
+
+
 #ifdef FORTRAN_BLAS_API
 
 
@@ -69,6 +77,12 @@ double ddot_(int *n, double *x, int *incx, double *y, int *incy);
 // BLAS 3
 //
 void dgemm_(char *ta, char *tb, int *m, int *n, int *k, double *alpha, double *A, int *lda, double *B, int *ldb, double *beta, double *C, int *ldc);
+// pack once alpha*op(A) (identifier 'A') or alpha*op(B) ('B') in a handle of dgemm_pack_get_size bytes
+int dgemm_pack_get_size_(char *identifier, int *m, int *n, int *k);
+//
+void dgemm_pack_(char *identifier, char *trans, int *m, int *n, int *k, double *alpha, double *src, int *ld, void *dest);
+// C = op(A) * op(B) + beta * C, with ta and/or tb equal to 'P' for a packed operand
+void dgemm_compute_(char *ta, char *tb, int *m, int *n, int *k, double *A, int *lda, double *B, int *ldb, double *beta, double *C, int *ldc);
 //
 void dsyrk_(char *uplo, char *ta, int *m, int *k, double *alpha, double *A, int *lda, double *beta, double *C, int *ldc);
 //
@@ -115,6 +129,12 @@ void blasfeo_dcopy(int *n, double *x, int *incx, double *y, int *incy);
 // BLAS 3
 //
 void blasfeo_dgemm(char *ta, char *tb, int *m, int *n, int *k, double *alpha, double *A, int *lda, double *B, int *ldb, double *beta, double *C, int *ldc);
+// pack once alpha*op(A) (identifier 'A') or alpha*op(B) ('B') in a handle of blasfeo_dgemm_pack_get_size bytes
+int blasfeo_dgemm_pack_get_size(char *identifier, int *m, int *n, int *k);
+//
+void blasfeo_dgemm_pack(char *identifier, char *trans, int *m, int *n, int *k, double *alpha, double *src, int *ld, void *dest);
+// C = op(A) * op(B) + beta * C, with ta and/or tb equal to 'P' for a packed operand
+void blasfeo_dgemm_compute(char *ta, char *tb, int *m, int *n, int *k, double *A, int *lda, double *B, int *ldb, double *beta, double *C, int *ldc);
 //
 void blasfeo_dsyrk(char *uplo, char *ta, int *m, int *k, double *alpha, double *A, int *lda, double *beta, double *C, int *ldc);
 //
@@ -140,6 +140,10 @@ void blasfeo_dgemm_nt(int m, int n, int k, double alpha, struct blasfeo_dmat *sA
 void blasfeo_dgemm_tn(int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
 // D <= beta * C + alpha * A^T * B^T
 void blasfeo_dgemm_tt(int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
+// D <= beta * C + alpha * A * B ; A, B in single precision, products accumulated in double precision
+void blasfeo_dsgemm_nn(int m, int n, int k, double alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
+// D <= beta * C + alpha * A * B^T ; A, B in single precision, products accumulated in double precision
+void blasfeo_dsgemm_nt(int m, int n, int k, double alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
 // D <= beta * C + alpha * A * B^T ; C, D lower triangular
 void blasfeo_dsyrk_ln(int m, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
 void blasfeo_dsyrk_ln_mn(int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
@@ -186,6 +190,15 @@ void blasfeo_dtrsm_rutn(int m, int n, double alpha, struct blasfeo_dmat *sA, int
 // D <= alpha * B * A^{-T} , with A upper triangular with unit diagonal
 void blasfeo_dtrsm_rutu(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj);
 
+// batched
+
+// D[ii] <= beta * C[ii] + alpha * A[ii] * B[ii], for ii=0,...,batch-1 ; offsets arrays can be NULL (all zero)
+void blasfeo_dgemm_nn_batch(int batch, int m, int n, int k, double alpha, struct blasfeo_dmat **sA, int *ai, int *aj, struct blasfeo_dmat **sB, int *bi, int *bj, double beta, struct blasfeo_dmat **sC, int *ci, int *cj, struct blasfeo_dmat **sD, int *di, int *dj);
+// D[ii] <= beta * C[ii] + alpha * A[ii] * B[ii]^T, for ii=0,...,batch-1 ; offsets arrays can be NULL (all zero)
+void blasfeo_dgemm_nt_batch(int batch, int m, int n, int k, double alpha, struct blasfeo_dmat **sA, int *ai, int *aj, struct blasfeo_dmat **sB, int *bi, int *bj, double beta, struct blasfeo_dmat **sC, int *ci, int *cj, struct blasfeo_dmat **sD, int *di, int *dj);
+// D[ii] <= beta * C[ii] + alpha * A[ii] * B[ii]^T, for ii=0,...,batch-1 ; C, D lower triangular ; offsets arrays can be NULL (all zero)
+void blasfeo_dsyrk_ln_batch(int batch, int m, int k, double alpha, struct blasfeo_dmat **sA, int *ai, int *aj, struct blasfeo_dmat **sB, int *bi, int *bj, double beta, struct blasfeo_dmat **sC, int *ci, int *cj, struct blasfeo_dmat **sD, int *di, int *dj);
+
 // diagonal
 
 // D <= alpha * A * B + beta * C, with A diagonal (stored as strvec)
@@ -203,16 +216,92 @@ void blasfeo_dgemm_nd(int m, int n, double alpha, struct blasfeo_dmat *sA, int a
 // D <= chol( C ) ; C, D lower triangular
 void blasfeo_dpotrf_l(int m, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
 void blasfeo_dpotrf_l_mn(int m, int n, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
+// D <= chol( C ) ; C, D lower triangular ; tiled task-parallel factorization if MULTI_THREAD and more than one thread are set,
+// with the work space of the task scheduler provided by the caller (blasfeo_dpotrf_l and blasfeo_dpotrf_l_mn allocate it
+// only if EXT_DEP is defined, and are serial otherwise)
+int blasfeo_dpotrf_l_mt_worksize(int m, int n); // in bytes
+void blasfeo_dpotrf_l_mt(int m, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work);
+void blasfeo_dpotrf_l_mn_mt(int m, int n, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work);
+// D <= chol( C ) ; C, D lower triangular ; D holding the factor of a matrix differing from C only in the trailing (m-k)x(m-k)
+// block: the first k columns of D are kept, only the trailing factor is recomputed
+int blasfeo_dpotrf_l_from_worksize(int m, int k); // in bytes
+void blasfeo_dpotrf_l_from(int m, int k, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work);
 // D <= chol( C + A * B' ) ; C, D lower triangular
 void blasfeo_dsyrk_dpotrf_ln(int m, int k, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
 void blasfeo_dsyrk_dpotrf_ln_mn(int m, int n, int k, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
+// D <= chol( C * C^T + V * V^T ) ; C, D lower triangular Cholesky factors, V of size (m)x(k) ; O(k*m^2) plane rotations
+int blasfeo_dpotrf_update_l_worksize(int m, int k); // in bytes
+void blasfeo_dpotrf_update_l(int m, int k, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sV, int vi, int vj, struct blasfeo_dmat *sD, int di, int dj, void *work);
+// D <= chol( C * C^T - V * V^T ) ; C, D lower triangular Cholesky factors, V of size (m)x(k) ; O(k*m^2) hyperbolic rotations ;
+// return 0, or ii+1 if C * C^T - V * V^T is found not positive definite at row ii (D is then only partially updated)
+int blasfeo_dpotrf_downdate_l_worksize(int m, int k); // in bytes
+int blasfeo_dpotrf_downdate_l(int m, int k, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sV, int vi, int vj, struct blasfeo_dmat *sD, int di, int dj, void *work);
 // D <= lu( C ) ; no pivoting
 void blasfeo_dgetrf_np(int m, int n, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
+// D <= lu( C ) ; no pivoting ; as above, with D holding the factors of a matrix differing from C only in the trailing
+// (m-k)x(n-k) block: the first k columns of L and rows of U are kept, only the trailing factors are recomputed
+int blasfeo_dgetrf_np_from_worksize(int m, int n, int k); // in bytes
+void blasfeo_dgetrf_np_from(int m, int n, int k, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work);
 // D <= lu( C ) ; row pivoting
 void blasfeo_dgetrf_rp(int m, int n, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, int *ipiv);
+// D <= lu( C ) ; row pivoting ; task-parallel factorization if MULTI_THREAD and more than one thread are set, with the work
+// space of the task scheduler provided by the caller (blasfeo_dgetrf_rp allocates it only if EXT_DEP is defined, and is serial otherwise)
+int blasfeo_dgetrf_rp_mt_worksize(int m, int n); // in bytes
+void blasfeo_dgetrf_rp_mt(int m, int n, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, int *ipiv, void *work);
+// D <= ldl( C ) ; C symmetric indefinite, only the lower triangle is accessed ; Bunch-Kaufman pivoting, P * C * P^T = L * E * L^T,
+// with L unit lower triangular and E block diagonal with 1x1 and 2x2 blocks, stored on the diagonal and sub-diagonal of D ;
+// ipiv[k]>=0: 1x1 block, row k interchanged with row ipiv[k] ; ipiv[k]=ipiv[k+1]<0: 2x2 block, row k+1 interchanged with row -ipiv[k]-1
+int blasfeo_dsytrf_l_worksize(int m); // in bytes
+void blasfeo_dsytrf_l(int m, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, int *ipiv, void *work);
+// D <= C^{-1} * B ; C factorized by blasfeo_dsytrf_l in A and ipiv
+void blasfeo_dsytrs_l(int m, int n, struct blasfeo_dmat *sA, int ai, int aj, int *ipiv, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj);
+// block tridiagonal Cholesky: A = L * L^T, with A symmetric positive definite with N diagonal blocks D[ii] (lower triangle accessed)
+// and N-1 sub-diagonal blocks E[ii] at block position (ii+1,ii), all of size (nx)x(nx) ;
+// mode BLASFEO_BTRF_SEQ: recursion over the stages, L has diagonal blocks LD[ii] and sub-diagonal blocks LE[ii], ii=0,...,N-2 ;
+// mode BLASFEO_BTRF_CR: cyclic reduction, the stages of each reduction level are processed in parallel (MULTI_THREAD=1)
+// at about twice the flops, LE has 2*(N-1) blocks
+#define BLASFEO_BTRF_SEQ 0
+#define BLASFEO_BTRF_CR 1
+int blasfeo_dbtrf_worksize(int N, int nx, int mode); // in bytes
+void blasfeo_dbtrf(int N, int nx, struct blasfeo_dmat **sD, struct blasfeo_dmat **sE, struct blasfeo_dmat **sLD, struct blasfeo_dmat **sLE, int mode, void *work);
+// x <= A^{-1} * b, with A factorized by blasfeo_dbtrf with the same mode ; b, x arrays of N vectors of size nx
+void blasfeo_dbtrs(int N, int nx, struct blasfeo_dmat **sLD, struct blasfeo_dmat **sLE, struct blasfeo_dvec **sb, struct blasfeo_dvec **sx, int mode);
 // D <= qr( C )
 int blasfeo_dgeqrf_worksize(int m, int n); // in bytes
 void blasfeo_dgeqrf(int m, int n, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work);
+// D <= qr( C ), tall-skinny QR (TSQR) for m>>n: row blocks factorized in parallel, R factors combined in a binary tree;
+// R is in the top (n)x(n) upper triangle of D, the Householder vectors in D, and their tau in T, of size blasfeo_dgeqrf_tsqr_tausize
+int blasfeo_dgeqrf_tsqr_tausize(int m, int n);
+int blasfeo_dgeqrf_tsqr_worksize(int m, int n); // in bytes
+void blasfeo_dgeqrf_tsqr(int m, int n, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, struct blasfeo_dvec *sT, int ti, void *work);
+// D <= Q^T * C, with Q from blasfeo_dgeqrf_tsqr of the (m)x(k) matrix A ; C, D of size (m)x(n) ; k must be the number
+// of columns A was factorized with, since the row blocks and the layout of tau depend on it: all the reflectors are applied
+int blasfeo_dormqr_tsqr_worksize(int m, int n, int k); // in bytes
+void blasfeo_dormqr_tsqr_lt(int m, int n, int k, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dvec *sT, int ti, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work);
+// D <= Q * C, with Q from blasfeo_dgeqrf_tsqr of the (m)x(k) matrix A ; C, D of size (m)x(n) ; same k as above
+void blasfeo_dormqr_tsqr_ln(int m, int n, int k, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dvec *sT, int ti, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work);
+// A = Q * R, with Q (m)x(m) orthogonal and R (m)x(n) upper triangular explicitly stored: update Q and R in place when a column
+// or a row of A is inserted or deleted, with Givens rotations in O(m*n+m^2) flops ; Q, R must have room for the larger size
+int blasfeo_dgeqrf_update_worksize(int m, int n); // in bytes
+// x inserted as column j of A: R becomes (m)x(n+1)
+void blasfeo_dgeqrf_insert_col(int m, int n, int j, struct blasfeo_dvec *sx, int xi, struct blasfeo_dmat *sQ, int qi, int qj, struct blasfeo_dmat *sR, int ri, int rj, void *work);
+// column j of A deleted: R becomes (m)x(n-1)
+void blasfeo_dgeqrf_delete_col(int m, int n, int j, struct blasfeo_dmat *sQ, int qi, int qj, struct blasfeo_dmat *sR, int ri, int rj, void *work);
+// x^T inserted as row i of A: Q becomes (m+1)x(m+1), R (m+1)x(n)
+void blasfeo_dgeqrf_insert_row(int m, int n, int i, struct blasfeo_dvec *sx, int xi, struct blasfeo_dmat *sQ, int qi, int qj, struct blasfeo_dmat *sR, int ri, int rj, void *work);
+// row i of A deleted: Q becomes (m-1)x(m-1), R (m-1)x(n)
+void blasfeo_dgeqrf_delete_row(int m, int n, int i, struct blasfeo_dmat *sQ, int qi, int qj, struct blasfeo_dmat *sR, int ri, int rj, void *work);
+// A = L * Q, with L (m)x(n) lower triangular and Q (n)x(n) orthogonal explicitly stored (e.g. from blasfeo_dorglq): update L and Q
+// in place when a row or a column of A is inserted or deleted, with Givens rotations in O(m*n+n^2) flops
+int blasfeo_dgelqf_update_worksize(int m, int n); // in bytes
+// x^T inserted as row i of A: L becomes (m+1)x(n)
+void blasfeo_dgelqf_insert_row(int m, int n, int i, struct blasfeo_dvec *sx, int xi, struct blasfeo_dmat *sL, int li, int lj, struct blasfeo_dmat *sQ, int qi, int qj, void *work);
+// row i of A deleted: L becomes (m-1)x(n)
+void blasfeo_dgelqf_delete_row(int m, int n, int i, struct blasfeo_dmat *sL, int li, int lj, struct blasfeo_dmat *sQ, int qi, int qj, void *work);
+// x inserted as column j of A: L becomes (m)x(n+1), Q (n+1)x(n+1)
+void blasfeo_dgelqf_insert_col(int m, int n, int j, struct blasfeo_dvec *sx, int xi, struct blasfeo_dmat *sL, int li, int lj, struct blasfeo_dmat *sQ, int qi, int qj, void *work);
+// column j of A deleted: L becomes (m)x(n-1), Q (n-1)x(n-1)
+void blasfeo_dgelqf_delete_col(int m, int n, int j, struct blasfeo_dmat *sL, int li, int lj, struct blasfeo_dmat *sQ, int qi, int qj, void *work);
 // D <= Q factor, where C is the output of the LQ factorization
 int blasfeo_dorglq_worksize(int m, int n, int k); // in bytes
 void blasfeo_dorglq(int m, int n, int k, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work);
@@ -225,6 +314,14 @@ void blasfeo_dgelqf_pd(int m, int n, struct blasfeo_dmat *sC, int ci, int cj, st
 // L lower triangular, of size (m)x(m)
 // A full, of size (m)x(n1)
 void blasfeo_dgelqf_pd_la(int m, int n1, struct blasfeo_dmat *sL, int li, int lj, struct blasfeo_dmat *sA, int ai, int aj, void *work);
+// x <= A^{-1} * b, with A symmetric positive definite (lower triangle), factorized in single precision, and x refined in
+// double precision ; return the number of refinement steps, or -1 if the single precision factorization fails or the
+// refinement does not converge (e.g. ill-conditioned A, to be solved in double precision)
+int blasfeo_dposv_mixed_worksize(int m); // in bytes
+int blasfeo_dposv_mixed(int m, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dvec *sb, int bi, struct blasfeo_dvec *sx, int xi, void *work);
+// x <= A^{-1} * b, with A general, LU factorized with row pivoting in single precision, and x refined in double precision
+int blasfeo_dgesv_mixed_worksize(int m); // in bytes
+int blasfeo_dgesv_mixed(int m, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dvec *sb, int bi, struct blasfeo_dvec *sx, int xi, void *work);
 // [L, L, A] <= lq( [L, L, A] ), positive diagonal elements, array of matrices, with:
 // L lower triangular, of size (m)x(m)
 // A full, of size (m)x(n1)
@@ -232,6 +329,33 @@ void blasfeo_dgelqf_pd_lla(int m, int n1, struct blasfeo_dmat *sL0, int l0i, int
 
 
 
+//
+// interleaved batch ("compact"), one matrix per SIMD lane
+//
+
+// D <= beta * C + alpha * A * B
+void blasfeo_dgemm_nn_compact(int m, int n, int k, double alpha, struct blasfeo_dmat_batch *sA, int ai, int aj, struct blasfeo_dmat_batch *sB, int bi, int bj, double beta, struct blasfeo_dmat_batch *sC, int ci, int cj, struct blasfeo_dmat_batch *sD, int di, int dj);
+// D <= beta * C + alpha * A * B^T
+void blasfeo_dgemm_nt_compact(int m, int n, int k, double alpha, struct blasfeo_dmat_batch *sA, int ai, int aj, struct blasfeo_dmat_batch *sB, int bi, int bj, double beta, struct blasfeo_dmat_batch *sC, int ci, int cj, struct blasfeo_dmat_batch *sD, int di, int dj);
+// D <= beta * C + alpha * A * B^T ; C, D lower triangular
+void blasfeo_dsyrk_ln_compact(int m, int k, double alpha, struct blasfeo_dmat_batch *sA, int ai, int aj, struct blasfeo_dmat_batch *sB, int bi, int bj, double beta, struct blasfeo_dmat_batch *sC, int ci, int cj, struct blasfeo_dmat_batch *sD, int di, int dj);
+// D <= alpha * A^{-1} * B , with A lower triangular employing explicit inverse of diagonal
+void blasfeo_dtrsm_llnn_compact(int m, int n, double alpha, struct blasfeo_dmat_batch *sA, int ai, int aj, struct blasfeo_dmat_batch *sB, int bi, int bj, struct blasfeo_dmat_batch *sD, int di, int dj);
+// D <= alpha * A^{-1} * B , with A lower triangular with unit diagonal
+void blasfeo_dtrsm_llnu_compact(int m, int n, double alpha, struct blasfeo_dmat_batch *sA, int ai, int aj, struct blasfeo_dmat_batch *sB, int bi, int bj, struct blasfeo_dmat_batch *sD, int di, int dj);
+// D <= alpha * A^{-T} * B , with A lower triangular employing explicit inverse of diagonal
+void blasfeo_dtrsm_lltn_compact(int m, int n, double alpha, struct blasfeo_dmat_batch *sA, int ai, int aj, struct blasfeo_dmat_batch *sB, int bi, int bj, struct blasfeo_dmat_batch *sD, int di, int dj);
+// D <= alpha * A^{-1} * B , with A upper triangular employing explicit inverse of diagonal
+void blasfeo_dtrsm_lunn_compact(int m, int n, double alpha, struct blasfeo_dmat_batch *sA, int ai, int aj, struct blasfeo_dmat_batch *sB, int bi, int bj, struct blasfeo_dmat_batch *sD, int di, int dj);
+// D <= alpha * B * A^{-T} , with A lower triangular employing explicit inverse of diagonal
+void blasfeo_dtrsm_rltn_compact(int m, int n, double alpha, struct blasfeo_dmat_batch *sA, int ai, int aj, struct blasfeo_dmat_batch *sB, int bi, int bj, struct blasfeo_dmat_batch *sD, int di, int dj);
+// D <= chol( C ) ; C, D lower triangular
+void blasfeo_dpotrf_l_compact(int m, struct blasfeo_dmat_batch *sC, int ci, int cj, struct blasfeo_dmat_batch *sD, int di, int dj);
+// D <= lu( C ) ; no pivoting
+void blasfeo_dgetrf_np_compact(int m, int n, struct blasfeo_dmat_batch *sC, int ci, int cj, struct blasfeo_dmat_batch *sD, int di, int dj);
+
+
+
 #ifdef __cplusplus
 }
 #endif
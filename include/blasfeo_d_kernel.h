@@ -292,6 +292,9 @@ void kernel_dger4_sub_8r_lib4(int k, double *A, int sda, double *B, double *C, i
 void kernel_dger4_sub_8r_vs_lib4(int k, double *A, int sda, double *B, double *C, int sdc, int km);
 void kernel_dger4_sub_4r_lib4(int n, double *A, double *B, double *C);
 void kernel_dger4_sub_4r_vs_lib4(int n, double *A, double *B, double *C, int km);
+// mixed precision: A in single precision (panel size 8), B, C and D in double precision (panel size 4)
+void kernel_dsgemm_nt_8x6_lib48(int k, double *alpha, float *A, double *B, double *beta, double *C, int sdc, double *D, int sdd);
+void kernel_dsgemm_nt_8x6_vs_lib48(int k, double *alpha, float *A, double *B, double *beta, double *C, int sdc, double *D, int sdd, int km, int kn);
 
 
 
@@ -556,6 +559,23 @@ void kernel_dpacp_nn_4_vs_lib4(int kmax, int offsetA, double *A, int sda, double
 
 
 
+// rotations on 4 contiguous rows of a panel, columns at distance cd, cv; 8: 2 blocks of 4 rows
+// Cholesky factor update (downdate==0) or downdate
+void kernel_dpotrf_update_rot_4_lib4(int nb, int k, int downdate, double *rot, double *pD, int cd, double *pV, int cv);
+void kernel_dpotrf_update_rot_8_lib4(int nb, int k, int downdate, double *rot, double *pD0, double *pD1, int cd, double *pV0, double *pV1, int cv);
+// sequence of plane rotations on the pairs of rows at off[2*rr], off[2*rr+1]
+void kernel_drot_seq_8_lib4(int nrot, double *p0, double *p1, int *off, double *cs);
+
+
+
+// interleaved batch ("compact"): each element is the BLASFEO_DMAT_BATCH_LANES lanes at A[i*as0+l*as1], B[l*bs0+j*bs1],
+// C[i*cs0+j*cs1], D[i*ds0+j*ds1]; alpha and beta per lane, beta==NULL means beta=0 (C not accessed)
+// 4x3
+void kernel_dgemm_4x3_compact(int k, double *alpha, double *A, int as0, int as1, double *B, int bs0, int bs1, double *beta, double *C, int cs0, int cs1, double *D, int ds0, int ds1);
+void kernel_dgemm_4x3_vs_compact(int k, double *alpha, double *A, int as0, int as1, double *B, int bs0, int bs1, double *beta, double *C, int cs0, int cs1, double *D, int ds0, int ds1, int m1, int n1);
+
+
+
 /************************************************
 * BLAS API kernels
 ************************************************/
@@ -0,0 +1,111 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#ifndef BLASFEO_D_SPCHOL_H_
+#define BLASFEO_D_SPCHOL_H_
+
+#include <stddef.h>
+
+#include "blasfeo_common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+
+//
+// supernodal sparse Cholesky factorization
+//
+
+// fill-reducing orderings
+#define BLASFEO_SPCHOL_ORDER_NATURAL 0 // no reordering
+#define BLASFEO_SPCHOL_ORDER_MD 1 // approximate minimum degree
+#define BLASFEO_SPCHOL_ORDER_ND 2 // nested dissection (level structure separators), minimum degree on the small subgraphs
+
+// symbolic and numeric factorization of a sparse symmetric positive definite matrix A: P * A * P^T = L * L^T ;
+// the columns of L are grouped in supernodes, and each supernode is stored as a dense panel of L
+struct blasfeo_dspchol
+	{
+	struct blasfeo_dmat *sF; // panel of L of each supernode: its columns, and the rows in sn_idx
+	struct blasfeo_dmat *sU; // update matrix of each supernode, only valid until the extend-add into its parent
+	struct blasfeo_dvec sw; // solve workspace (permuted right-hand side)
+	struct blasfeo_dvec st; // solve workspace (update rows of a supernode)
+	struct blasfeo_dvec se; // extend-add workspace: supernode s uses the entries from sn_ptr[s], as many as its rows
+	int *perm; // the k-th pivot is row and column perm[k] of A
+	int *sn_first; // columns of supernode s in pivot order: sn_first[s],...,sn_first[s+1]-1
+	int *sn_parent; // parent supernode in the assembly tree (-1 for the roots)
+	int *sn_ptr; // rows of supernode s: sn_idx[sn_ptr[s]],...,sn_idx[sn_ptr[s+1]-1], its own columns first
+	int *sn_idx;
+	int *sn_rel; // row of the frontal matrix of the parent of each row of supernode s past its columns
+	int *child_ptr; // children of supernode s: child[child_ptr[s]],...,child[child_ptr[s+1]-1]
+	int *child;
+	int *a_ptr; // entries of A assembled in supernode s: a_idx[a_ptr[s]],...,a_idx[a_ptr[s+1]-1]
+	int *a_idx; // position of the entry in the value array of A
+	int *a_row; // row of the entry in the frontal matrix
+	int *a_col; // column of the entry in the frontal matrix
+	void *dag_work; // task scheduler workspace of the factorization
+	void *mem; // index arrays
+	void *mem_F; // panels of L
+	void *mem_U; // stack of the update matrices (sequential factorization)
+	size_t memsize_U; // largest size of the stack of the update matrices
+	int n; // size of A
+	int ns; // number of supernodes
+	int m_max; // largest number of rows of a supernode
+	long long nnz_l; // number of entries of L, explicit zeros of amalgamated supernodes included
+	double flops; // floating point operations of the numeric factorization
+	};
+
+
+
+// symbolic analysis of the sparsity pattern of A, given in compressed sparse column format (column pointers colptr,
+// row indices rowind); only the entries in the lower triangle are accessed, the diagonal is always assumed nonzero;
+// computes the fill-reducing ordering, the elimination tree and the (amalgamated) supernodes, and allocates the factor
+void blasfeo_dspchol_analyze(int n, int *colptr, int *rowind, int order, struct blasfeo_dspchol *sp);
+// release the memory allocated by blasfeo_dspchol_analyze
+void blasfeo_dspchol_free(struct blasfeo_dspchol *sp);
+// numeric factorization, given the values of A in the same format as the analysis; supernodes in independent subtrees
+// are factorized in parallel (MULTI_THREAD=1)
+void blasfeo_dspchol_factorize(double *val, struct blasfeo_dspchol *sp);
+// x <= A^{-1} * b, using the factorization ; x and b can be the same vector
+void blasfeo_dspchol_solve(struct blasfeo_dspchol *sp, struct blasfeo_dvec *sb, int bi, struct blasfeo_dvec *sx, int xi);
+
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // BLASFEO_D_SPCHOL_H_
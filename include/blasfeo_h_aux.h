@@ -0,0 +1,76 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#ifndef BLASFEO_H_AUX_H_
+#define BLASFEO_H_AUX_H_
+
+#include "blasfeo_common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+
+// --- half precision storage matrix
+
+// conversion of one element between single precision and half precision (round to nearest even)
+unsigned short blasfeo_s2h(float a);
+float blasfeo_h2s(unsigned short a);
+
+// returns the memory size (in bytes) needed for a hmat
+int blasfeo_memsize_hmat(int m, int n);
+// create a hmat for a matrix of size m*n by using memory passed by a pointer (aligned as for smat)
+void blasfeo_create_hmat(int m, int n, struct blasfeo_hmat *sA, void *memory);
+// A <= a
+void blasfeo_hgein1(float a, struct blasfeo_hmat *sA, int ai, int aj);
+// return A[ai,aj]
+float blasfeo_hgeex1(struct blasfeo_hmat *sA, int ai, int aj);
+// pack the column-major single precision matrix A into the hmat sB
+void blasfeo_pack_hmat(int m, int n, float *A, int lda, struct blasfeo_hmat *sB, int bi, int bj);
+// unpack the hmat sA into the column-major single precision matrix B
+void blasfeo_unpack_hmat(int m, int n, struct blasfeo_hmat *sA, int ai, int aj, float *B, int ldb);
+// B <= A, with A single precision and B half precision
+void blasfeo_cvt_s2h_mat(int m, int n, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_hmat *sB, int bi, int bj);
+// B <= A, with A half precision and B single precision
+void blasfeo_cvt_h2s_mat(int m, int n, struct blasfeo_hmat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj);
+
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // BLASFEO_H_AUX_H_
@@ -0,0 +1,81 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#ifndef BLASFEO_JIT_H_
+#define BLASFEO_JIT_H_
+
+#include "blasfeo_common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+
+// kernel types
+#define BLASFEO_JIT_DGEMM_NN 0
+#define BLASFEO_JIT_DGEMM_NT 1
+#define BLASFEO_JIT_DSYRK_LN 2
+
+// maximum m, n and k of the generated kernels, and of m*n*k (larger fully unrolled kernels overflow the instruction cache)
+#define BLASFEO_JIT_MAX_SIZE 24
+#define BLASFEO_JIT_MAX_MNK 4096
+
+
+
+// D = beta*C + alpha*A*B (nn), alpha*A*B^T (nt), or its lower triangle (syrk_ln, with n=m), with a kernel generated
+// at run-time for the exact sizes (x86_64 AVX2 and FMA, compiled with the opt-in JIT=1 on Linux); the kernels are cached, and
+// return 0 if no kernel is available (sizes larger than BLASFEO_JIT_MAX_SIZE or BLASFEO_JIT_MAX_MNK, row offsets not multiple of the panel
+// size, JIT disabled at build time or with the environment variable BLASFEO_JIT=0, or executable memory not available)
+int blasfeo_jit_dgemm(int type, int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
+// the kernel of blasfeo_jit_dgemm for the given sizes, to run it on many calls of the same sizes with blasfeo_jit_dgemm_run;
+// NULL if no kernel is available
+void *blasfeo_jit_dgemm_kernel(int type, int m, int n, int k, double beta);
+// run a kernel returned by blasfeo_jit_dgemm_kernel for the same type, sizes and beta (zero or not); the row offsets
+// ai, bi, ci and di must be multiple of the panel size
+void blasfeo_jit_dgemm_run(void *kernel, int type, int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
+// number of kernels generated so far
+int blasfeo_jit_kernel_count();
+// release the pages of the generated kernels, which otherwise stay mapped until the process exits;
+// must not be called concurrently with routines that can use them
+void blasfeo_jit_free();
+
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BLASFEO_JIT_H_
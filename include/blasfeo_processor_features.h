@@ -39,20 +39,21 @@
 /**
  * Flags to indicate the different processor features
  */
-enum
+enum BLASFEO_PROCESSOR_FEATURES
 {
     // x86-64 CPU features
     BLASFEO_PROCESSOR_FEATURE_AVX  = 0x0001,    /// AVX instruction set
     BLASFEO_PROCESSOR_FEATURE_AVX2 = 0x0002,    /// AVX2 instruction set
     BLASFEO_PROCESSOR_FEATURE_FMA  = 0x0004,    /// FMA instruction set
     BLASFEO_PROCESSOR_FEATURE_SSE3 = 0x0008,    /// SSE3 instruction set
+    BLASFEO_PROCESSOR_FEATURE_F16C = 0x0010,    /// F16C half precision conversion instructions
 
     // ARM CPU features
     BLASFEO_PROCESSOR_FEATURE_VFPv3  = 0x0100,  /// VFPv3 instruction set
     BLASFEO_PROCESSOR_FEATURE_NEON   = 0x0100,  /// NEON instruction set
     BLASFEO_PROCESSOR_FEATURE_VFPv4  = 0x0100,  /// VFPv4 instruction set
     BLASFEO_PROCESSOR_FEATURE_NEONv2 = 0x0100,  /// NEONv2 instruction set
-} BLASFEO_PROCESSOR_FEATURES;
+};
 
 /**
  * Test the features that this processor provides against what the library was compiled with.
@@ -85,4 +86,45 @@ void blasfeo_processor_feature_string( int features, char* featureString );
  */
 void blasfeo_processor_library_string( char* featureString );
 
+/**
+ * Get the name of the target selected at run-time by the fat library (TARGET=X64_FAT),
+ * or of the target the library was compiled for otherwise.
+ *
+ * @param targetString - Character array to store the target name in
+ */
+void blasfeo_processor_target_string( char* targetString );
+
+/**
+ * Get the size of the caches of the processor, used to derive the cache blocking of the level 3 routines.
+ * The sizes are detected on the first call, from cpuid on x86 processors or from /sys/devices/system/cpu
+ * on Linux, and default to typical values for the target if the detection fails.
+ *
+ * @param l1 - Pointer to an integer to store the size in bytes of the level 1 data cache
+ * @param l2 - Pointer to an integer to store the size in bytes of the level 2 cache
+ * @param l3 - Pointer to an integer to store the size in bytes of the level 3 cache (0 if not present)
+ */
+void blasfeo_processor_cache_size( int* l1, int* l2, int* l3 );
+
+/**
+ * Get the size of the level 1 data cache line of the processor, detected as in blasfeo_processor_cache_size.
+ *
+ * @param line - Pointer to an integer to store the size in bytes of the cache line
+ */
+void blasfeo_processor_cache_line_size( int* line );
+
+/**
+ * Get the cache blocking of the gemm loops around a m_kernel x n_kernel kernel: panels of A and B of
+ * depth kc fit in L1, a mc x kc block of A in L2, and a kc x nc block of B in L3.
+ * The block sizes are derived from the detected cache sizes at each call, so callers on a hot path
+ * should compute them once and keep them.
+ *
+ * @param m_kernel - Rows of the kernel
+ * @param n_kernel - Cols of the kernel
+ * @param size_el - Size in bytes of the matrix elements
+ * @param kc - Pointer to an integer to store the block size along the inner dimension (multiple of 8)
+ * @param mc - Pointer to an integer to store the block size along the rows (multiple of m_kernel)
+ * @param nc - Pointer to an integer to store the block size along the cols (multiple of n_kernel)
+ */
+void blasfeo_processor_gemm_block_size( int m_kernel, int n_kernel, int size_el, int* kc, int* mc, int* nc );
+
 #endif  // BLASFEO_PROCESSOR_FEATURES_H_
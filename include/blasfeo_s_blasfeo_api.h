@@ -81,6 +81,10 @@ void blasfeo_srowrot(int m, struct blasfeo_smat *sA, int ai0, int ai1, int aj, f
 void blasfeo_sgemv_n(int m, int n, float alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_svec *sx, int xi, float beta, struct blasfeo_svec *sy, int yi, struct blasfeo_svec *sz, int zi);
 // z <= beta * y + alpha * A' * x
 void blasfeo_sgemv_t(int m, int n, float alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_svec *sx, int xi, float beta, struct blasfeo_svec *sy, int yi, struct blasfeo_svec *sz, int zi);
+// z <= beta * y + alpha * A * x ; A in half precision, converted to single precision on load
+void blasfeo_shgemv_n(int m, int n, float alpha, struct blasfeo_hmat *sA, int ai, int aj, struct blasfeo_svec *sx, int xi, float beta, struct blasfeo_svec *sy, int yi, struct blasfeo_svec *sz, int zi);
+// z <= beta * y + alpha * A' * x ; A in half precision, converted to single precision on load
+void blasfeo_shgemv_t(int m, int n, float alpha, struct blasfeo_hmat *sA, int ai, int aj, struct blasfeo_svec *sx, int xi, float beta, struct blasfeo_svec *sy, int yi, struct blasfeo_svec *sz, int zi);
 // z <= inv( A ) * x, A (m)x(n)
 void blasfeo_strsv_lnn_mn(int m, int n, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_svec *sx, int xi, struct blasfeo_svec *sz, int zi);
 // z <= inv( A' ) * x, A (m)x(n)
@@ -128,6 +132,8 @@ void blasfeo_sgemv_d(int m, float alpha, struct blasfeo_svec *sA, int ai, struct
 void blasfeo_sgemm_nn(int m, int n, int k, float alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, float beta, struct blasfeo_smat *sC, int ci, int cj, struct blasfeo_smat *sD, int di, int dj);
 // D <= beta * C + alpha * A * B^T
 void blasfeo_sgemm_nt(int m, int n, int k, float alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, float beta, struct blasfeo_smat *sC, int ci, int cj, struct blasfeo_smat *sD, int di, int dj);
+// D <= beta * C + alpha * A * B^T ; A, B in half precision, converted to single precision on load
+void blasfeo_shgemm_nt(int m, int n, int k, float alpha, struct blasfeo_hmat *sA, int ai, int aj, struct blasfeo_hmat *sB, int bi, int bj, float beta, struct blasfeo_smat *sC, int ci, int cj, struct blasfeo_smat *sD, int di, int dj);
 // D <= beta * C + alpha * A^T * B
 void blasfeo_sgemm_tn(int m, int n, int k, float alpha, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj, float beta, struct blasfeo_smat *sC, int ci, int cj, struct blasfeo_smat *sD, int di, int dj);
 // D <= beta * C + alpha * A^T * B
@@ -202,6 +208,10 @@ void blasfeo_ssyrk_spotrf_ln_mn(int m, int n, int k, struct blasfeo_smat *sA, in
 void blasfeo_sgetrf_np(int m, int n, struct blasfeo_smat *sC, int ci, int cj, struct blasfeo_smat *sD, int di, int dj);
 // D <= lu( C ) ; row pivoting
 void blasfeo_sgetrf_rp(int m, int n, struct blasfeo_smat *sC, int ci, int cj, struct blasfeo_smat *sD, int di, int dj, int *ipiv);
+// D <= lu( C ) ; row pivoting ; with the work space provided by the caller (used by the blocked factorization for a
+// transposed copy of the U blocks, with panel size 8 only)
+int blasfeo_sgetrf_rp_worksize(int m, int n); // in bytes
+void blasfeo_sgetrf_rp_ws(int m, int n, struct blasfeo_smat *sC, int ci, int cj, struct blasfeo_smat *sD, int di, int dj, int *ipiv, void *work);
 // D <= qr( C )
 void blasfeo_sgeqrf(int m, int n, struct blasfeo_smat *sC, int ci, int cj, struct blasfeo_smat *sD, int di, int dj, void *work);
 int blasfeo_sgeqrf_worksize(int m, int n); // in bytes
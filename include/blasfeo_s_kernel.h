@@ -176,6 +176,14 @@ void kernel_ssymv_l_4r_lib8(int kmax, float *alpha, float *A, int sda, float *x,
 void kernel_ssymv_l_4l_gen_lib8(int kmax, float *alpha, int offA, float *A, int sda, float *x, float *z, int km);
 void kernel_ssymv_l_4r_gen_lib8(int kmax, float *alpha, int offA, float *A, int sda, float *x, float *z, int km);
 
+// mixed precision: A in half precision (panel size 8), B, x, y, C and D in single precision
+void kernel_shgemm_nt_8x12_lib8(int k, float *alpha, unsigned short *A, float *B, float *beta, float *C, float *D);
+void kernel_shgemm_nt_8x12_vs_lib8(int k, float *alpha, unsigned short *A, float *B, float *beta, float *C, float *D, int km, int kn);
+void kernel_shgemv_n_8_lib8(int k, float *alpha, unsigned short *A, float *x, float *beta, float *y, float *z);
+void kernel_shgemv_n_8_vs_lib8(int k, float *alpha, unsigned short *A, float *x, float *beta, float *y, float *z, int k1);
+void kernel_shgemv_t_8_lib8(int k, float *alpha, unsigned short *A, int sda, float *x, float *beta, float *y, float *z);
+void kernel_shgemv_t_8_vs_lib8(int k, float *alpha, unsigned short *A, int sda, float *x, float *beta, float *y, float *z, int k1);
+
 // -------- aux
 
 // ---- copy
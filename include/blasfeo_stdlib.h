@@ -36,6 +36,8 @@
 #ifndef BLASFEO_STDLIB_H_
 #define BLASFEO_STDLIB_H_
 
+#include <stddef.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -47,6 +49,18 @@ void blasfeo_malloc_align(void **ptr, size_t size);
 //
 void blasfeo_free_align(void *ptr);
 
+// set the workspace arena used by the BLAS API routines in place of malloc for their packing buffers;
+// the arena is private to the calling thread, and work==NULL unsets it
+void blasfeo_blas_workspace_set(void *work, size_t size);
+// (the arena size for given matrix dimensions is blasfeo_blas_workspace_size, in the BLAS API header)
+// allocate from the arena of the calling thread, or with malloc if it is unset or too small
+void *blasfeo_blas_workspace_malloc(size_t size);
+// release an allocation from the arena, together with all later ones (or free the malloc fallback)
+void blasfeo_blas_workspace_free(void *ptr);
+// largest use of the arena of the calling thread since it was set, counting also the allocations that did not fit
+// (larger than the arena size if any fell back to malloc)
+size_t blasfeo_blas_workspace_peak();
+
 
 
 #ifdef __cplusplus
@@ -0,0 +1,88 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+#ifndef BLASFEO_THREAD_H_
+#define BLASFEO_THREAD_H_
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+
+// maximum number of threads in the pool (calling thread included)
+#define BLASFEO_MAX_THREADS 64
+
+
+
+//
+// user interface
+//
+
+// set the number of threads used by the multi-threaded routines (default 1, i.e. single-threaded);
+// no effect if the library is compiled without MULTI_THREAD
+void blasfeo_set_num_threads(int num_threads);
+// get the number of threads used by the multi-threaded routines
+int blasfeo_get_num_threads();
+
+
+
+//
+// thread pool interface
+//
+
+// number of threads available to the caller: 1 if called from inside a parallel region
+int blasfeo_thread_pool_num_threads();
+// call fun(arg, ii) for ii=0,...,n_task-1 distributing the tasks over the thread pool;
+// the calling thread takes part in the computation, and the routine returns once all tasks are done
+void blasfeo_thread_pool_run(int n_task, void (*fun)(void *arg, int task_id), void *arg);
+// call fun(arg, ii) for ii=0,...,n_task-1 over the thread pool, respecting the dependencies of a task graph:
+// task ii starts after tasks pred[pred_idx[ii]],...,pred[pred_idx[ii+1]-1] are done;
+// among the ready tasks, the one with the smallest prio (or task id if prio is NULL) is executed first;
+// work is a buffer of at least blasfeo_thread_dag_memsize(n_task, pred_idx[n_task]) bytes
+void blasfeo_thread_dag_run(int n_task, int *pred_idx, int *pred, int *prio, void (*fun)(void *arg, int task_id), void *arg, void *work);
+// size in bytes of the work space of blasfeo_thread_dag_run, for a graph of n_task tasks and n_edge dependencies
+size_t blasfeo_thread_dag_memsize(int n_task, int n_edge);
+
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // BLASFEO_THREAD_H_
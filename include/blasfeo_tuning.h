@@ -0,0 +1,98 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#ifndef BLASFEO_TUNING_H_
+#define BLASFEO_TUNING_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+
+// dispatch thresholds between the algorithm variants of the BLAS API routines;
+// a negative entry selects the built-in value of the target
+struct blasfeo_tuning
+	{
+	// dgemm with k<=K_MAX_STACK: small matrix algorithm if m and n are at most small_mn,
+	// else pack a single operand if m or n is at most pack_one_mn or k is below pack_one_k, else pack both
+	int dgemm_nn_small_mn;
+	int dgemm_nn_pack_one_mn;
+	int dgemm_nn_pack_one_k;
+	int dgemm_nt_small_mn;
+	int dgemm_nt_pack_one_mn;
+	int dgemm_nt_pack_one_k;
+	int dgemm_tn_pack_one_mn;
+	int dgemm_tn_pack_one_k;
+	int dgemm_tt_small_mn;
+	int dgemm_tt_pack_one_mn;
+	int dgemm_tt_pack_one_k;
+	// dtrsm (side, uplo, trans): pack the operands if m or n is at least pack_mn
+	int dtrsm_lln_pack_mn;
+	int dtrsm_llt_pack_mn;
+	int dtrsm_lun_pack_mn;
+	int dtrsm_lut_pack_mn;
+	int dtrsm_rln_pack_mn;
+	int dtrsm_rlt_pack_mn;
+	int dtrsm_run_pack_mn;
+	int dtrsm_rut_pack_mn;
+	// dgetrf: pack the matrix if m or n is at least pack_mn
+	int dgetrf_pack_mn;
+	};
+
+
+
+// set all the entries to -1 (built-in values of the target)
+void blasfeo_tuning_default(struct blasfeo_tuning *tun);
+// copy the tuning table in use
+void blasfeo_tuning_get(struct blasfeo_tuning *tun);
+// replace the tuning table in use (not thread-safe against concurrent BLAS API calls)
+void blasfeo_tuning_set(struct blasfeo_tuning *tun);
+// read "name value" lines (# starts a comment) into the tuning table in use, starting from the built-in values;
+// return 0 on success, or the number of the first line which can not be parsed (-1 if the file can not be opened)
+int blasfeo_tuning_load(char *file_name);
+// write a tuning table in the format read by blasfeo_tuning_load; return 0 on success
+int blasfeo_tuning_save(struct blasfeo_tuning *tun, char *file_name);
+// tuning table in use, read from the file in the BLASFEO_TUNING_FILE environment variable on the first call
+// (concurrent first calls wait for the one reading the file)
+struct blasfeo_tuning *blasfeo_tuning_table();
+
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BLASFEO_TUNING_H_
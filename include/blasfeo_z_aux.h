@@ -0,0 +1,108 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#ifndef BLASFEO_Z_AUX_H_
+#define BLASFEO_Z_AUX_H_
+
+#include "blasfeo_common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+
+#ifdef COMPLEX
+
+
+
+// --- memory calculations
+
+// returns the memory size (in bytes) needed for a zmat
+int blasfeo_memsize_zmat(int m, int n);
+// returns the memory size (in bytes) needed for a zvec
+int blasfeo_memsize_zvec(int m);
+
+// --- creation
+
+// create a zmat for a matrix of size m*n by using memory passed by a pointer (aligned as for dmat)
+void blasfeo_create_zmat(int m, int n, struct blasfeo_zmat *sA, void *memory);
+// create a zvec for a vector of size m by using memory passed by a pointer (aligned as for dvec)
+void blasfeo_create_zvec(int m, struct blasfeo_zvec *sa, void *memory);
+
+// --- packing
+
+// pack the column-major matrix A into the zmat sB
+void blasfeo_pack_zmat(int m, int n, double _Complex *A, int lda, struct blasfeo_zmat *sB, int bi, int bj);
+// pack the vector x into the zvec sy
+void blasfeo_pack_zvec(int m, double _Complex *x, struct blasfeo_zvec *sy, int yi);
+// unpack the zmat sA into the column-major matrix B
+void blasfeo_unpack_zmat(int m, int n, struct blasfeo_zmat *sA, int ai, int aj, double _Complex *B, int ldb);
+// unpack the zvec sx into the vector y
+void blasfeo_unpack_zvec(int m, struct blasfeo_zvec *sx, int xi, double _Complex *y);
+
+// --- insert/extract
+
+// A <= a
+void blasfeo_zgein1(double _Complex a, struct blasfeo_zmat *sA, int ai, int aj);
+// return A[ai,aj]
+double _Complex blasfeo_zgeex1(struct blasfeo_zmat *sA, int ai, int aj);
+// x <= a
+void blasfeo_zvecin1(double _Complex a, struct blasfeo_zvec *sx, int xi);
+// return x[xi]
+double _Complex blasfeo_zvecex1(struct blasfeo_zvec *sx, int xi);
+
+// --- copy, permutation
+
+// B <= A
+void blasfeo_zgecp(int m, int n, struct blasfeo_zmat *sA, int ai, int aj, struct blasfeo_zmat *sB, int bi, int bj);
+// swap the rows of length kmax of A and C
+void blasfeo_zrowsw(int kmax, struct blasfeo_zmat *sA, int ai, int aj, struct blasfeo_zmat *sC, int ci, int cj);
+// permute the first kmax rows of A (whole rows) as given by ipiv
+void blasfeo_zrowpe(int kmax, int *ipiv, struct blasfeo_zmat *sA);
+// permute the first kmax entries of x as given by ipiv
+void blasfeo_zvecpe(int kmax, int *ipiv, struct blasfeo_zvec *sx, int xi);
+
+
+
+#endif // COMPLEX
+
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // BLASFEO_Z_AUX_H_
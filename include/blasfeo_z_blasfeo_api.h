@@ -0,0 +1,95 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#ifndef BLASFEO_Z_BLASFEO_API_H_
+#define BLASFEO_Z_BLASFEO_API_H_
+
+#include "blasfeo_common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+
+#ifdef COMPLEX
+
+
+
+// A^H denotes the conjugate transpose of A
+
+
+
+//
+// level 3 BLAS
+//
+
+// D <= beta * C + alpha * A * B
+void blasfeo_zgemm_nn(int m, int n, int k, double _Complex alpha, struct blasfeo_zmat *sA, int ai, int aj, struct blasfeo_zmat *sB, int bi, int bj, double _Complex beta, struct blasfeo_zmat *sC, int ci, int cj, struct blasfeo_zmat *sD, int di, int dj);
+// D <= beta * C + alpha * A * B^T
+void blasfeo_zgemm_nt(int m, int n, int k, double _Complex alpha, struct blasfeo_zmat *sA, int ai, int aj, struct blasfeo_zmat *sB, int bi, int bj, double _Complex beta, struct blasfeo_zmat *sC, int ci, int cj, struct blasfeo_zmat *sD, int di, int dj);
+// D <= beta * C + alpha * A * B^H
+void blasfeo_zgemm_nc(int m, int n, int k, double _Complex alpha, struct blasfeo_zmat *sA, int ai, int aj, struct blasfeo_zmat *sB, int bi, int bj, double _Complex beta, struct blasfeo_zmat *sC, int ci, int cj, struct blasfeo_zmat *sD, int di, int dj);
+// D <= alpha * A^{-1} * B , with A lower triangular with unit diagonal
+void blasfeo_ztrsm_llnu(int m, int n, double _Complex alpha, struct blasfeo_zmat *sA, int ai, int aj, struct blasfeo_zmat *sB, int bi, int bj, struct blasfeo_zmat *sD, int di, int dj);
+// D <= alpha * A^{-1} * B , with A upper triangular
+void blasfeo_ztrsm_lunn(int m, int n, double _Complex alpha, struct blasfeo_zmat *sA, int ai, int aj, struct blasfeo_zmat *sB, int bi, int bj, struct blasfeo_zmat *sD, int di, int dj);
+// D <= alpha * B * A^{-H} , with A lower triangular
+void blasfeo_ztrsm_rlcn(int m, int n, double _Complex alpha, struct blasfeo_zmat *sA, int ai, int aj, struct blasfeo_zmat *sB, int bi, int bj, struct blasfeo_zmat *sD, int di, int dj);
+// D <= alpha * B * A^{-1} , with A upper triangular
+void blasfeo_ztrsm_runn(int m, int n, double _Complex alpha, struct blasfeo_zmat *sA, int ai, int aj, struct blasfeo_zmat *sB, int bi, int bj, struct blasfeo_zmat *sD, int di, int dj);
+
+
+
+//
+// LAPACK
+//
+
+// D <= chol( C ) ; C Hermitian positive definite, D lower triangular with D * D^H = C ; only the lower triangle of C is accessed
+void blasfeo_zpotrf_l(int m, struct blasfeo_zmat *sC, int ci, int cj, struct blasfeo_zmat *sD, int di, int dj);
+// D <= lu( C ) ; row pivoting, P * C = L * U with L unit lower (stored below the diagonal of D) and U upper
+void blasfeo_zgetrf_rp(int m, int n, struct blasfeo_zmat *sC, int ci, int cj, struct blasfeo_zmat *sD, int di, int dj, int *ipiv);
+
+
+
+#endif // COMPLEX
+
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // BLASFEO_Z_BLASFEO_API_H_
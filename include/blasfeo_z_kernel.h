@@ -0,0 +1,82 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#ifndef BLASFEO_Z_KERNEL_H_
+#define BLASFEO_Z_KERNEL_H_
+
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+
+#ifdef COMPLEX
+
+
+
+//
+// lib4
+//
+
+// 4x2: A 4 x k (one panel), B 2 x k (two rows of a panel, B[c+4*l]), C and D 4 x 2 (one panel)
+// D <= alpha * A * B^T + beta * C
+void kernel_zgemm_nt_4x2_lib4(int k, double _Complex *alpha, double _Complex *A, double _Complex *B, double _Complex *beta, double _Complex *C, double _Complex *D);
+void kernel_zgemm_nt_4x2_vs_lib4(int k, double _Complex *alpha, double _Complex *A, double _Complex *B, double _Complex *beta, double _Complex *C, double _Complex *D, int km, int kn);
+// D <= alpha * A * B^H + beta * C
+void kernel_zgemm_nc_4x2_lib4(int k, double _Complex *alpha, double _Complex *A, double _Complex *B, double _Complex *beta, double _Complex *C, double _Complex *D);
+void kernel_zgemm_nc_4x2_vs_lib4(int k, double _Complex *alpha, double _Complex *A, double _Complex *B, double _Complex *beta, double _Complex *C, double _Complex *D, int km, int kn);
+// 4x4: A and B 4 x k (one panel each), C, D and E 4 x 4 (one panel)
+// D <= chol(C - A * B^H), lower triangle
+void kernel_zpotrf_nc_l_4x4_vs_lib4(int k, double _Complex *A, double _Complex *B, double _Complex *C, double _Complex *D, double _Complex *inv_diag_D, int km, int kn);
+// D <= (C - A * B^H) * E^{-H}, E lower triangular
+void kernel_ztrsm_nc_rl_inv_4x4_vs_lib4(int k, double _Complex *A, double _Complex *B, double _Complex *C, double _Complex *D, double _Complex *E, double _Complex *inv_diag_E, int km, int kn);
+// D <= E^{-1} * C, E unit lower triangular
+void kernel_ztrsm_nn_ll_one_4x4_vs_lib4(double _Complex *C, double _Complex *D, double _Complex *E, int km, int kn);
+// LU factorization with row pivoting of a block of 4 columns
+void kernel_zgetrf_pivot_4_vs_lib4(int m, double _Complex *pA, int sda, int *ipiv, int n);
+
+
+
+#endif // COMPLEX
+
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // BLASFEO_Z_KERNEL_H_
@@ -0,0 +1,175 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <mmintrin.h>
+#include <xmmintrin.h>  // SSE
+#include <emmintrin.h>  // SSE2
+#include <pmmintrin.h>  // SSE3
+#include <smmintrin.h>  // SSE4
+#include <immintrin.h>  // AVX
+#include "../../include/blasfeo_d_kernel.h"
+
+
+
+// a * b + c
+static inline __m256d kernel_dgemm_compact_fmadd(__m256d a, __m256d b, __m256d c)
+	{
+#if defined(TARGET_X64_INTEL_HASWELL)
+	return _mm256_fmadd_pd(a, b, c);
+#else
+	return _mm256_add_pd(_mm256_mul_pd(a, b), c);
+#endif
+	}
+
+
+
+// alpha * acc + beta * C, with beta==NULL meaning beta=0 (C not accessed)
+static inline __m256d kernel_dgemm_compact_scale(__m256d acc, __m256d alpha, double *beta, double *C)
+	{
+	if(beta==NULL)
+		return _mm256_mul_pd(alpha, acc);
+	return kernel_dgemm_compact_fmadd(alpha, acc, _mm256_mul_pd(_mm256_loadu_pd(beta), _mm256_loadu_pd(C)));
+	}
+
+
+
+// only the first m1 rows and n1 columns of D are stored; the missing rows and columns are computed on the last valid
+// one, so that the inner loop has no branches and reads no memory outside of the operands; a single column (as in the
+// row by row triangular solves) has its own loop, not to waste three quarters of the work
+static inline void kernel_dgemm_4x3_gen_compact(int k, double *alpha, double *A, int as0, int as1, double *B, int bs0, int bs1, double *beta, double *C, int cs0, int cs1, double *D, int ds0, int ds1, int m1, int n1)
+	{
+
+	int ii, jj, ll;
+
+	double *pA0 = A;
+	double *pA1 = A + (m1>1 ? 1 : 0)*as0;
+	double *pA2 = A + (m1>2 ? 2 : m1-1)*as0;
+	double *pA3 = A + (m1>3 ? 3 : m1-1)*as0;
+	double *pB0 = B;
+	double *pB1 = B + (n1>1 ? 1 : 0)*bs1;
+	double *pB2 = B + (n1>2 ? 2 : n1-1)*bs1;
+
+	__m256d a0, a1, a2, a3, b, alpha_v, d[12];
+
+	__m256d
+		c00 = _mm256_setzero_pd(), c10 = _mm256_setzero_pd(), c20 = _mm256_setzero_pd(), c30 = _mm256_setzero_pd(),
+		c01 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd(),
+		c02 = _mm256_setzero_pd(), c12 = _mm256_setzero_pd(), c22 = _mm256_setzero_pd(), c32 = _mm256_setzero_pd();
+
+	if(n1==1)
+		{
+		for(ll=0; ll<k; ll++)
+			{
+			b = _mm256_loadu_pd( pB0 );
+			a0 = _mm256_loadu_pd( pA0 );
+			a1 = _mm256_loadu_pd( pA1 );
+			a2 = _mm256_loadu_pd( pA2 );
+			a3 = _mm256_loadu_pd( pA3 );
+			c00 = kernel_dgemm_compact_fmadd( a0, b, c00 );
+			c10 = kernel_dgemm_compact_fmadd( a1, b, c10 );
+			c20 = kernel_dgemm_compact_fmadd( a2, b, c20 );
+			c30 = kernel_dgemm_compact_fmadd( a3, b, c30 );
+			pA0 += as1;
+			pA1 += as1;
+			pA2 += as1;
+			pA3 += as1;
+			pB0 += bs0;
+			}
+		}
+	else
+		{
+		for(ll=0; ll<k; ll++)
+			{
+			a0 = _mm256_loadu_pd( pA0 );
+			a1 = _mm256_loadu_pd( pA1 );
+			a2 = _mm256_loadu_pd( pA2 );
+			a3 = _mm256_loadu_pd( pA3 );
+			b = _mm256_loadu_pd( pB0 );
+			c00 = kernel_dgemm_compact_fmadd( a0, b, c00 );
+			c10 = kernel_dgemm_compact_fmadd( a1, b, c10 );
+			c20 = kernel_dgemm_compact_fmadd( a2, b, c20 );
+			c30 = kernel_dgemm_compact_fmadd( a3, b, c30 );
+			b = _mm256_loadu_pd( pB1 );
+			c01 = kernel_dgemm_compact_fmadd( a0, b, c01 );
+			c11 = kernel_dgemm_compact_fmadd( a1, b, c11 );
+			c21 = kernel_dgemm_compact_fmadd( a2, b, c21 );
+			c31 = kernel_dgemm_compact_fmadd( a3, b, c31 );
+			b = _mm256_loadu_pd( pB2 );
+			c02 = kernel_dgemm_compact_fmadd( a0, b, c02 );
+			c12 = kernel_dgemm_compact_fmadd( a1, b, c12 );
+			c22 = kernel_dgemm_compact_fmadd( a2, b, c22 );
+			c32 = kernel_dgemm_compact_fmadd( a3, b, c32 );
+			pA0 += as1;
+			pA1 += as1;
+			pA2 += as1;
+			pA3 += as1;
+			pB0 += bs0;
+			pB1 += bs0;
+			pB2 += bs0;
+			}
+		}
+
+	d[0] = c00; d[1] = c10; d[2] = c20; d[3] = c30;
+	d[4] = c01; d[5] = c11; d[6] = c21; d[7] = c31;
+	d[8] = c02; d[9] = c12; d[10] = c22; d[11] = c32;
+
+	alpha_v = _mm256_loadu_pd( alpha );
+	for(jj=0; jj<n1; jj++)
+		{
+		for(ii=0; ii<m1; ii++)
+			{
+			_mm256_storeu_pd( D+ii*ds0+jj*ds1, kernel_dgemm_compact_scale( d[ii+4*jj], alpha_v, beta, C+ii*cs0+jj*cs1 ) );
+			}
+		}
+
+	return;
+
+	}
+
+
+
+void kernel_dgemm_4x3_compact(int k, double *alpha, double *A, int as0, int as1, double *B, int bs0, int bs1, double *beta, double *C, int cs0, int cs1, double *D, int ds0, int ds1)
+	{
+	kernel_dgemm_4x3_gen_compact(k, alpha, A, as0, as1, B, bs0, bs1, beta, C, cs0, cs1, D, ds0, ds1, 4, 3);
+	return;
+	}
+
+
+
+void kernel_dgemm_4x3_vs_compact(int k, double *alpha, double *A, int as0, int as1, double *B, int bs0, int bs1, double *beta, double *C, int cs0, int cs1, double *D, int ds0, int ds1, int m1, int n1)
+	{
+	kernel_dgemm_4x3_gen_compact(k, alpha, A, as0, as1, B, bs0, bs1, beta, C, cs0, cs1, D, ds0, ds1, m1<4 ? m1 : 4, n1<3 ? n1 : 3);
+	return;
+	}
@@ -0,0 +1,156 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <mmintrin.h>
+#include <xmmintrin.h>  // SSE
+#include <emmintrin.h>  // SSE2
+#include <pmmintrin.h>  // SSE3
+#include <smmintrin.h>  // SSE4
+#include <immintrin.h>  // AVX
+
+#include "../../include/blasfeo_d_kernel.h"
+
+
+
+// rotations of a Cholesky factor update (downdate==0) or downdate: for each of the nb columns jj of D, the k rotations at
+// rot+4*(jj*k+ll) are applied in sequence to the pair (D(:,jj), V(:,ll)); rot is [c s . .] for the plane rotations and
+// [1/c t/c c t], with c=sqrt(1-t^2), for the hyperbolic ones; 4 contiguous rows, columns of D and V at distance cd and cv
+void kernel_dpotrf_update_rot_4_lib4(int nb, int k, int downdate, double *rot, double *pD, int cd, double *pV, int cv)
+	{
+	int jj, ll;
+	__m256d d, v, r0, r1, d_tmp;
+	for(jj=0; jj<nb; jj++)
+		{
+		d = _mm256_loadu_pd(pD+jj*cd);
+		for(ll=0; ll<k; ll++)
+			{
+			v = _mm256_loadu_pd(pV+ll*cv);
+			r0 = _mm256_broadcast_sd(rot+0);
+			r1 = _mm256_broadcast_sd(rot+1);
+			if(downdate)
+				{
+				d = _mm256_sub_pd(_mm256_mul_pd(r0, d), _mm256_mul_pd(r1, v));
+				r0 = _mm256_broadcast_sd(rot+2);
+				r1 = _mm256_broadcast_sd(rot+3);
+				v = _mm256_sub_pd(_mm256_mul_pd(r0, v), _mm256_mul_pd(r1, d));
+				}
+			else
+				{
+				d_tmp = _mm256_add_pd(_mm256_mul_pd(r0, d), _mm256_mul_pd(r1, v));
+				v = _mm256_sub_pd(_mm256_mul_pd(r0, v), _mm256_mul_pd(r1, d));
+				d = d_tmp;
+				}
+			_mm256_storeu_pd(pV+ll*cv, v);
+			rot += 4;
+			}
+		_mm256_storeu_pd(pD+jj*cd, d);
+		}
+	return;
+	}
+
+
+
+// as kernel_dpotrf_update_rot_4_lib4 on 2 blocks of 4 contiguous rows, as two independent dependency chains to hide the
+// latency of the rotations
+void kernel_dpotrf_update_rot_8_lib4(int nb, int k, int downdate, double *rot, double *pD0, double *pD1, int cd, double *pV0, double *pV1, int cv)
+	{
+	int jj, ll;
+	__m256d d0, d1, v0, v1, r0, r1, d_tmp0, d_tmp1;
+	for(jj=0; jj<nb; jj++)
+		{
+		d0 = _mm256_loadu_pd(pD0+jj*cd);
+		d1 = _mm256_loadu_pd(pD1+jj*cd);
+		for(ll=0; ll<k; ll++)
+			{
+			v0 = _mm256_loadu_pd(pV0+ll*cv);
+			v1 = _mm256_loadu_pd(pV1+ll*cv);
+			r0 = _mm256_broadcast_sd(rot+0);
+			r1 = _mm256_broadcast_sd(rot+1);
+			if(downdate)
+				{
+				d0 = _mm256_sub_pd(_mm256_mul_pd(r0, d0), _mm256_mul_pd(r1, v0));
+				d1 = _mm256_sub_pd(_mm256_mul_pd(r0, d1), _mm256_mul_pd(r1, v1));
+				r0 = _mm256_broadcast_sd(rot+2);
+				r1 = _mm256_broadcast_sd(rot+3);
+				v0 = _mm256_sub_pd(_mm256_mul_pd(r0, v0), _mm256_mul_pd(r1, d0));
+				v1 = _mm256_sub_pd(_mm256_mul_pd(r0, v1), _mm256_mul_pd(r1, d1));
+				}
+			else
+				{
+				d_tmp0 = _mm256_add_pd(_mm256_mul_pd(r0, d0), _mm256_mul_pd(r1, v0));
+				d_tmp1 = _mm256_add_pd(_mm256_mul_pd(r0, d1), _mm256_mul_pd(r1, v1));
+				v0 = _mm256_sub_pd(_mm256_mul_pd(r0, v0), _mm256_mul_pd(r1, d0));
+				v1 = _mm256_sub_pd(_mm256_mul_pd(r0, v1), _mm256_mul_pd(r1, d1));
+				d0 = d_tmp0;
+				d1 = d_tmp1;
+				}
+			_mm256_storeu_pd(pV0+ll*cv, v0);
+			_mm256_storeu_pd(pV1+ll*cv, v1);
+			rot += 4;
+			}
+		_mm256_storeu_pd(pD0+jj*cd, d0);
+		_mm256_storeu_pd(pD1+jj*cd, d1);
+		}
+	return;
+	}
+
+
+
+// sequence of nrot plane rotations [x y] <= [x y] [c -s; s c], with c and s at cs+2*rr, on the pairs of 4 contiguous rows
+// at p+off[2*rr] and p+off[2*rr+1]; 2 blocks of rows at p0 and p1, as two independent dependency chains
+void kernel_drot_seq_8_lib4(int nrot, double *p0, double *p1, int *off, double *cs)
+	{
+	int rr;
+	__m256d c, s, x0, x1, y0, y1, tmp0, tmp1;
+	for(rr=0; rr<nrot; rr++)
+		{
+		c = _mm256_broadcast_sd(cs+2*rr+0);
+		s = _mm256_broadcast_sd(cs+2*rr+1);
+		x0 = _mm256_loadu_pd(p0+off[2*rr+0]);
+		x1 = _mm256_loadu_pd(p1+off[2*rr+0]);
+		y0 = _mm256_loadu_pd(p0+off[2*rr+1]);
+		y1 = _mm256_loadu_pd(p1+off[2*rr+1]);
+		tmp0 = _mm256_add_pd(_mm256_mul_pd(c, x0), _mm256_mul_pd(s, y0));
+		tmp1 = _mm256_add_pd(_mm256_mul_pd(c, x1), _mm256_mul_pd(s, y1));
+		y0 = _mm256_sub_pd(_mm256_mul_pd(c, y0), _mm256_mul_pd(s, x0));
+		y1 = _mm256_sub_pd(_mm256_mul_pd(c, y1), _mm256_mul_pd(s, x1));
+		_mm256_storeu_pd(p0+off[2*rr+0], tmp0);
+		_mm256_storeu_pd(p1+off[2*rr+0], tmp1);
+		_mm256_storeu_pd(p0+off[2*rr+1], y0);
+		_mm256_storeu_pd(p1+off[2*rr+1], y1);
+		}
+	return;
+	}
+
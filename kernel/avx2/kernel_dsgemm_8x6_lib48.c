@@ -0,0 +1,235 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <mmintrin.h>
+#include <xmmintrin.h>  // SSE
+#include <emmintrin.h>  // SSE2
+#include <pmmintrin.h>  // SSE3
+#include <smmintrin.h>  // SSE4
+#include <immintrin.h>  // AVX
+#include "../../include/blasfeo_d_kernel.h"
+
+
+
+// D <= alpha * A * B^T + beta * C, with A 8 x k in single precision (panel-major, panel size 8), B 6 x k in double
+// precision (packed, B[c+6*l]), and C, D 8 x 6 in double precision (two panels of size 4): A is converted to double
+// precision on load, and the products are accumulated in double precision into 12 registers, enough to hide the
+// latency of the fma
+static inline void kernel_dsgemm_nt_8x6_acc_lib48(int k, float *A, double *B, __m256d *d)
+	{
+
+	const int bs = 8;
+
+	__m256d a0, a1, b;
+
+	__m256d
+		d00 = _mm256_setzero_pd(), d01 = _mm256_setzero_pd(), d02 = _mm256_setzero_pd(),
+		d03 = _mm256_setzero_pd(), d04 = _mm256_setzero_pd(), d05 = _mm256_setzero_pd(),
+		d10 = _mm256_setzero_pd(), d11 = _mm256_setzero_pd(), d12 = _mm256_setzero_pd(),
+		d13 = _mm256_setzero_pd(), d14 = _mm256_setzero_pd(), d15 = _mm256_setzero_pd();
+
+	int l;
+
+	for(l=0; l<k-1; l+=2)
+		{
+		a0 = _mm256_cvtps_pd( _mm_load_ps( &A[0+bs*0] ) );
+		a1 = _mm256_cvtps_pd( _mm_load_ps( &A[4+bs*0] ) );
+		b = _mm256_broadcast_sd( &B[0] );
+		d00 = _mm256_fmadd_pd( a0, b, d00 );
+		d10 = _mm256_fmadd_pd( a1, b, d10 );
+		b = _mm256_broadcast_sd( &B[1] );
+		d01 = _mm256_fmadd_pd( a0, b, d01 );
+		d11 = _mm256_fmadd_pd( a1, b, d11 );
+		b = _mm256_broadcast_sd( &B[2] );
+		d02 = _mm256_fmadd_pd( a0, b, d02 );
+		d12 = _mm256_fmadd_pd( a1, b, d12 );
+		b = _mm256_broadcast_sd( &B[3] );
+		d03 = _mm256_fmadd_pd( a0, b, d03 );
+		d13 = _mm256_fmadd_pd( a1, b, d13 );
+		b = _mm256_broadcast_sd( &B[4] );
+		d04 = _mm256_fmadd_pd( a0, b, d04 );
+		d14 = _mm256_fmadd_pd( a1, b, d14 );
+		b = _mm256_broadcast_sd( &B[5] );
+		d05 = _mm256_fmadd_pd( a0, b, d05 );
+		d15 = _mm256_fmadd_pd( a1, b, d15 );
+
+		a0 = _mm256_cvtps_pd( _mm_load_ps( &A[0+bs*1] ) );
+		a1 = _mm256_cvtps_pd( _mm_load_ps( &A[4+bs*1] ) );
+		b = _mm256_broadcast_sd( &B[6] );
+		d00 = _mm256_fmadd_pd( a0, b, d00 );
+		d10 = _mm256_fmadd_pd( a1, b, d10 );
+		b = _mm256_broadcast_sd( &B[7] );
+		d01 = _mm256_fmadd_pd( a0, b, d01 );
+		d11 = _mm256_fmadd_pd( a1, b, d11 );
+		b = _mm256_broadcast_sd( &B[8] );
+		d02 = _mm256_fmadd_pd( a0, b, d02 );
+		d12 = _mm256_fmadd_pd( a1, b, d12 );
+		b = _mm256_broadcast_sd( &B[9] );
+		d03 = _mm256_fmadd_pd( a0, b, d03 );
+		d13 = _mm256_fmadd_pd( a1, b, d13 );
+		b = _mm256_broadcast_sd( &B[10] );
+		d04 = _mm256_fmadd_pd( a0, b, d04 );
+		d14 = _mm256_fmadd_pd( a1, b, d14 );
+		b = _mm256_broadcast_sd( &B[11] );
+		d05 = _mm256_fmadd_pd( a0, b, d05 );
+		d15 = _mm256_fmadd_pd( a1, b, d15 );
+
+		A += 2*bs;
+		B += 12;
+		}
+	for(; l<k; l++)
+		{
+		a0 = _mm256_cvtps_pd( _mm_load_ps( &A[0] ) );
+		a1 = _mm256_cvtps_pd( _mm_load_ps( &A[4] ) );
+		b = _mm256_broadcast_sd( &B[0] );
+		d00 = _mm256_fmadd_pd( a0, b, d00 );
+		d10 = _mm256_fmadd_pd( a1, b, d10 );
+		b = _mm256_broadcast_sd( &B[1] );
+		d01 = _mm256_fmadd_pd( a0, b, d01 );
+		d11 = _mm256_fmadd_pd( a1, b, d11 );
+		b = _mm256_broadcast_sd( &B[2] );
+		d02 = _mm256_fmadd_pd( a0, b, d02 );
+		d12 = _mm256_fmadd_pd( a1, b, d12 );
+		b = _mm256_broadcast_sd( &B[3] );
+		d03 = _mm256_fmadd_pd( a0, b, d03 );
+		d13 = _mm256_fmadd_pd( a1, b, d13 );
+		b = _mm256_broadcast_sd( &B[4] );
+		d04 = _mm256_fmadd_pd( a0, b, d04 );
+		d14 = _mm256_fmadd_pd( a1, b, d14 );
+		b = _mm256_broadcast_sd( &B[5] );
+		d05 = _mm256_fmadd_pd( a0, b, d05 );
+		d15 = _mm256_fmadd_pd( a1, b, d15 );
+
+		A += bs;
+		B += 6;
+		}
+
+	d[0] = d00; d[1] = d01; d[2] = d02; d[3] = d03; d[4] = d04; d[5] = d05;
+	d[6] = d10; d[7] = d11; d[8] = d12; d[9] = d13; d[10] = d14; d[11] = d15;
+
+	return;
+
+	}
+
+
+
+void kernel_dsgemm_nt_8x6_lib48(int k, double *alpha, float *A, double *B, double *beta, double *C, int sdc, double *D, int sdd)
+	{
+
+	const int bs = 4;
+
+	__m256d d[12], alph, bet;
+
+	int jj;
+
+	kernel_dsgemm_nt_8x6_acc_lib48(k, A, B, d);
+
+	alph = _mm256_broadcast_sd( alpha );
+	for(jj=0; jj<12; jj++)
+		d[jj] = _mm256_mul_pd( alph, d[jj] );
+
+	if(*beta!=0.0)
+		{
+		bet = _mm256_broadcast_sd( beta );
+		for(jj=0; jj<6; jj++)
+			{
+			d[jj] = _mm256_fmadd_pd( bet, _mm256_load_pd( &C[0+bs*jj] ), d[jj] );
+			d[6+jj] = _mm256_fmadd_pd( bet, _mm256_load_pd( &C[sdc*bs+bs*jj] ), d[6+jj] );
+			}
+		}
+
+	for(jj=0; jj<6; jj++)
+		{
+		_mm256_store_pd( &D[0+bs*jj], d[jj] );
+		_mm256_store_pd( &D[sdd*bs+bs*jj], d[6+jj] );
+		}
+
+	return;
+
+	}
+
+
+
+// store only the first km rows and kn columns; the second panel of C and D is not accessed if km<=4
+void kernel_dsgemm_nt_8x6_vs_lib48(int k, double *alpha, float *A, double *B, double *beta, double *C, int sdc, double *D, int sdd, int km, int kn)
+	{
+
+	const int bs = 4;
+
+	__m256d d[12], alph, bet;
+	double tmp[4];
+
+	int ii, jj;
+
+	if(km<=0 | kn<=0)
+		return;
+	if(km>8)
+		km = 8;
+	if(kn>6)
+		kn = 6;
+
+	kernel_dsgemm_nt_8x6_acc_lib48(k, A, B, d);
+
+	alph = _mm256_broadcast_sd( alpha );
+	for(jj=0; jj<12; jj++)
+		d[jj] = _mm256_mul_pd( alph, d[jj] );
+
+	if(*beta!=0.0)
+		{
+		bet = _mm256_broadcast_sd( beta );
+		for(jj=0; jj<kn; jj++)
+			{
+			d[jj] = _mm256_fmadd_pd( bet, _mm256_load_pd( &C[0+bs*jj] ), d[jj] );
+			if(km>4)
+				d[6+jj] = _mm256_fmadd_pd( bet, _mm256_load_pd( &C[sdc*bs+bs*jj] ), d[6+jj] );
+			}
+		}
+
+	for(jj=0; jj<kn; jj++)
+		{
+		_mm256_storeu_pd( tmp, d[jj] );
+		for(ii=0; ii<km & ii<4; ii++)
+			D[ii+bs*jj] = tmp[ii];
+		if(km>4)
+			{
+			_mm256_storeu_pd( tmp, d[6+jj] );
+			for(ii=0; ii<km-4; ii++)
+				D[sdd*bs+ii+bs*jj] = tmp[ii];
+			}
+		}
+
+	return;
+
+	}
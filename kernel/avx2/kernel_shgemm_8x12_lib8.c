@@ -0,0 +1,178 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <mmintrin.h>
+#include <xmmintrin.h>  // SSE
+#include <emmintrin.h>  // SSE2
+#include <pmmintrin.h>  // SSE3
+#include <smmintrin.h>  // SSE4
+#include <immintrin.h>  // AVX, F16C
+#include "../../include/blasfeo_s_kernel.h"
+
+
+
+// D <= alpha * A * B^T + beta * C, with A 8 x k in half precision (panel-major, panel size 8), B 12 x k in single
+// precision (packed, B[c+12*l]), and C, D 8 x 12 in single precision (one panel of size 8): A is converted to single
+// precision on load (vcvtph2ps), and the products are accumulated into 12 registers
+static inline void kernel_shgemm_nt_8x12_acc_lib8(int k, unsigned short *A, float *B, __m256 *d)
+	{
+
+	const int bs = 8;
+
+	__m256 a, b;
+
+	__m256
+		d00 = _mm256_setzero_ps(), d01 = _mm256_setzero_ps(), d02 = _mm256_setzero_ps(), d03 = _mm256_setzero_ps(),
+		d04 = _mm256_setzero_ps(), d05 = _mm256_setzero_ps(), d06 = _mm256_setzero_ps(), d07 = _mm256_setzero_ps(),
+		d08 = _mm256_setzero_ps(), d09 = _mm256_setzero_ps(), d10 = _mm256_setzero_ps(), d11 = _mm256_setzero_ps();
+
+	int l;
+
+	for(l=0; l<k; l++)
+		{
+		a = _mm256_cvtph_ps( _mm_load_si128( (__m128i *) &A[0] ) );
+		b = _mm256_broadcast_ss( &B[0] );
+		d00 = _mm256_fmadd_ps( a, b, d00 );
+		b = _mm256_broadcast_ss( &B[1] );
+		d01 = _mm256_fmadd_ps( a, b, d01 );
+		b = _mm256_broadcast_ss( &B[2] );
+		d02 = _mm256_fmadd_ps( a, b, d02 );
+		b = _mm256_broadcast_ss( &B[3] );
+		d03 = _mm256_fmadd_ps( a, b, d03 );
+		b = _mm256_broadcast_ss( &B[4] );
+		d04 = _mm256_fmadd_ps( a, b, d04 );
+		b = _mm256_broadcast_ss( &B[5] );
+		d05 = _mm256_fmadd_ps( a, b, d05 );
+		b = _mm256_broadcast_ss( &B[6] );
+		d06 = _mm256_fmadd_ps( a, b, d06 );
+		b = _mm256_broadcast_ss( &B[7] );
+		d07 = _mm256_fmadd_ps( a, b, d07 );
+		b = _mm256_broadcast_ss( &B[8] );
+		d08 = _mm256_fmadd_ps( a, b, d08 );
+		b = _mm256_broadcast_ss( &B[9] );
+		d09 = _mm256_fmadd_ps( a, b, d09 );
+		b = _mm256_broadcast_ss( &B[10] );
+		d10 = _mm256_fmadd_ps( a, b, d10 );
+		b = _mm256_broadcast_ss( &B[11] );
+		d11 = _mm256_fmadd_ps( a, b, d11 );
+		A += bs;
+		B += 12;
+		}
+
+	d[0] = d00;
+	d[1] = d01;
+	d[2] = d02;
+	d[3] = d03;
+	d[4] = d04;
+	d[5] = d05;
+	d[6] = d06;
+	d[7] = d07;
+	d[8] = d08;
+	d[9] = d09;
+	d[10] = d10;
+	d[11] = d11;
+
+	return;
+
+	}
+
+
+
+void kernel_shgemm_nt_8x12_lib8(int k, float *alpha, unsigned short *A, float *B, float *beta, float *C, float *D)
+	{
+
+	const int bs = 8;
+
+	__m256 d[12], alph, bet;
+
+	int jj;
+
+	kernel_shgemm_nt_8x12_acc_lib8(k, A, B, d);
+
+	alph = _mm256_broadcast_ss( alpha );
+	for(jj=0; jj<12; jj++)
+		d[jj] = _mm256_mul_ps( alph, d[jj] );
+
+	if(*beta!=0.0)
+		{
+		bet = _mm256_broadcast_ss( beta );
+		for(jj=0; jj<12; jj++)
+			d[jj] = _mm256_fmadd_ps( bet, _mm256_load_ps( &C[bs*jj] ), d[jj] );
+		}
+
+	for(jj=0; jj<12; jj++)
+		_mm256_store_ps( &D[bs*jj], d[jj] );
+
+	return;
+
+	}
+
+
+
+// store only the first km rows and kn columns
+void kernel_shgemm_nt_8x12_vs_lib8(int k, float *alpha, unsigned short *A, float *B, float *beta, float *C, float *D, int km, int kn)
+	{
+
+	const int bs = 8;
+
+	__m256 d[12], alph, bet;
+	__m256i mask;
+
+	int jj;
+
+	if(kn>12)
+		kn = 12;
+
+	kernel_shgemm_nt_8x12_acc_lib8(k, A, B, d);
+
+	mask = _mm256_castps_si256( _mm256_cmp_ps( _mm256_set_ps( 7.5, 6.5, 5.5, 4.5, 3.5, 2.5, 1.5, 0.5 ), _mm256_set1_ps( (float) km ), _CMP_LT_OQ ) );
+
+	alph = _mm256_broadcast_ss( alpha );
+	for(jj=0; jj<kn; jj++)
+		d[jj] = _mm256_mul_ps( alph, d[jj] );
+
+	if(*beta!=0.0)
+		{
+		bet = _mm256_broadcast_ss( beta );
+		for(jj=0; jj<kn; jj++)
+			d[jj] = _mm256_fmadd_ps( bet, _mm256_load_ps( &C[bs*jj] ), d[jj] );
+		}
+
+	for(jj=0; jj<kn; jj++)
+		_mm256_maskstore_ps( &D[bs*jj], mask, d[jj] );
+
+	return;
+
+	}
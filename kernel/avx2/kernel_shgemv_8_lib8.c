@@ -0,0 +1,249 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <mmintrin.h>
+#include <xmmintrin.h>  // SSE
+#include <emmintrin.h>  // SSE2
+#include <pmmintrin.h>  // SSE3
+#include <smmintrin.h>  // SSE4
+#include <immintrin.h>  // AVX, F16C
+#include "../../include/blasfeo_s_kernel.h"
+
+
+
+// A is stored in half precision (panel-major, panel size 8) and converted to single precision on load (vcvtph2ps)
+#define LOAD_H8(ptr) _mm256_cvtph_ps( _mm_load_si128( (__m128i *) (ptr) ) )
+
+
+
+// z <= alpha * A * x + beta * y, with A 8 x k
+void kernel_shgemv_n_8_lib8(int k, float *alpha, unsigned short *A, float *x, float *beta, float *y, float *z)
+	{
+
+	const int bs = 8;
+
+	__m256
+		z0 = _mm256_setzero_ps(), z1 = _mm256_setzero_ps(),
+		z2 = _mm256_setzero_ps(), z3 = _mm256_setzero_ps();
+
+	int jj;
+
+	for(jj=0; jj<k-3; jj+=4)
+		{
+		z0 = _mm256_fmadd_ps( LOAD_H8( &A[bs*0] ), _mm256_broadcast_ss( &x[0] ), z0 );
+		z1 = _mm256_fmadd_ps( LOAD_H8( &A[bs*1] ), _mm256_broadcast_ss( &x[1] ), z1 );
+		z2 = _mm256_fmadd_ps( LOAD_H8( &A[bs*2] ), _mm256_broadcast_ss( &x[2] ), z2 );
+		z3 = _mm256_fmadd_ps( LOAD_H8( &A[bs*3] ), _mm256_broadcast_ss( &x[3] ), z3 );
+		A += 4*bs;
+		x += 4;
+		}
+	for(; jj<k; jj++)
+		{
+		z0 = _mm256_fmadd_ps( LOAD_H8( &A[0] ), _mm256_broadcast_ss( &x[0] ), z0 );
+		A += bs;
+		x += 1;
+		}
+
+	z0 = _mm256_add_ps( _mm256_add_ps( z0, z1 ), _mm256_add_ps( z2, z3 ) );
+	z0 = _mm256_mul_ps( _mm256_broadcast_ss( alpha ), z0 );
+	if(*beta!=0.0)
+		z0 = _mm256_fmadd_ps( _mm256_broadcast_ss( beta ), _mm256_loadu_ps( &y[0] ), z0 );
+
+	_mm256_storeu_ps( &z[0], z0 );
+
+	return;
+
+	}
+
+
+
+// only the first k1 entries of y and z are accessed
+void kernel_shgemv_n_8_vs_lib8(int k, float *alpha, unsigned short *A, float *x, float *beta, float *y, float *z, int k1)
+	{
+
+	const int bs = 8;
+
+	__m256
+		z0 = _mm256_setzero_ps(), z1 = _mm256_setzero_ps(),
+		z2 = _mm256_setzero_ps(), z3 = _mm256_setzero_ps();
+	__m256i mask;
+
+	int jj;
+
+	mask = _mm256_castps_si256( _mm256_cmp_ps( _mm256_set_ps( 7.5, 6.5, 5.5, 4.5, 3.5, 2.5, 1.5, 0.5 ), _mm256_set1_ps( (float) k1 ), _CMP_LT_OQ ) );
+
+	for(jj=0; jj<k-3; jj+=4)
+		{
+		z0 = _mm256_fmadd_ps( LOAD_H8( &A[bs*0] ), _mm256_broadcast_ss( &x[0] ), z0 );
+		z1 = _mm256_fmadd_ps( LOAD_H8( &A[bs*1] ), _mm256_broadcast_ss( &x[1] ), z1 );
+		z2 = _mm256_fmadd_ps( LOAD_H8( &A[bs*2] ), _mm256_broadcast_ss( &x[2] ), z2 );
+		z3 = _mm256_fmadd_ps( LOAD_H8( &A[bs*3] ), _mm256_broadcast_ss( &x[3] ), z3 );
+		A += 4*bs;
+		x += 4;
+		}
+	for(; jj<k; jj++)
+		{
+		z0 = _mm256_fmadd_ps( LOAD_H8( &A[0] ), _mm256_broadcast_ss( &x[0] ), z0 );
+		A += bs;
+		x += 1;
+		}
+
+	z0 = _mm256_add_ps( _mm256_add_ps( z0, z1 ), _mm256_add_ps( z2, z3 ) );
+	z0 = _mm256_mul_ps( _mm256_broadcast_ss( alpha ), z0 );
+	if(*beta!=0.0)
+		z0 = _mm256_fmadd_ps( _mm256_broadcast_ss( beta ), _mm256_maskload_ps( &y[0], mask ), z0 );
+
+	_mm256_maskstore_ps( &z[0], mask, z0 );
+
+	return;
+
+	}
+
+
+
+// sum the 8 accumulators of the 8 columns into one vector
+static inline __m256 kernel_shgemv_t_8_reduce(__m256 c0, __m256 c1, __m256 c2, __m256 c3, __m256 c4, __m256 c5, __m256 c6, __m256 c7)
+	{
+	__m256 u0, u1;
+	u0 = _mm256_hadd_ps( _mm256_hadd_ps( c0, c1 ), _mm256_hadd_ps( c2, c3 ) );
+	u1 = _mm256_hadd_ps( _mm256_hadd_ps( c4, c5 ), _mm256_hadd_ps( c6, c7 ) );
+	return _mm256_add_ps( _mm256_permute2f128_ps( u0, u1, 0x20 ), _mm256_permute2f128_ps( u0, u1, 0x31 ) );
+	}
+
+
+
+// z <= alpha * A^T * x + beta * y, with A k x 8 starting at the top of a panel
+void kernel_shgemv_t_8_lib8(int k, float *alpha, unsigned short *A, int sda, float *x, float *beta, float *y, float *z)
+	{
+
+	const int bs = 8;
+
+	__m256
+		c0 = _mm256_setzero_ps(), c1 = _mm256_setzero_ps(), c2 = _mm256_setzero_ps(), c3 = _mm256_setzero_ps(),
+		c4 = _mm256_setzero_ps(), c5 = _mm256_setzero_ps(), c6 = _mm256_setzero_ps(), c7 = _mm256_setzero_ps(),
+		xx, zz, mask;
+	__m256i imask;
+
+	int ii;
+
+	for(ii=0; ii<k-7; ii+=8)
+		{
+		xx = _mm256_loadu_ps( &x[0] );
+		c0 = _mm256_fmadd_ps( LOAD_H8( &A[bs*0] ), xx, c0 );
+		c1 = _mm256_fmadd_ps( LOAD_H8( &A[bs*1] ), xx, c1 );
+		c2 = _mm256_fmadd_ps( LOAD_H8( &A[bs*2] ), xx, c2 );
+		c3 = _mm256_fmadd_ps( LOAD_H8( &A[bs*3] ), xx, c3 );
+		c4 = _mm256_fmadd_ps( LOAD_H8( &A[bs*4] ), xx, c4 );
+		c5 = _mm256_fmadd_ps( LOAD_H8( &A[bs*5] ), xx, c5 );
+		c6 = _mm256_fmadd_ps( LOAD_H8( &A[bs*6] ), xx, c6 );
+		c7 = _mm256_fmadd_ps( LOAD_H8( &A[bs*7] ), xx, c7 );
+		A += bs*sda;
+		x += bs;
+		}
+	if(ii<k)
+		{
+		// the padding rows of the last panel are masked out in A too, since they may hold inf or nan
+		mask = _mm256_cmp_ps( _mm256_set_ps( 7.5, 6.5, 5.5, 4.5, 3.5, 2.5, 1.5, 0.5 ), _mm256_set1_ps( (float) (k-ii) ), _CMP_LT_OQ );
+		imask = _mm256_castps_si256( mask );
+		xx = _mm256_maskload_ps( &x[0], imask );
+		c0 = _mm256_fmadd_ps( _mm256_and_ps( LOAD_H8( &A[bs*0] ), mask ), xx, c0 );
+		c1 = _mm256_fmadd_ps( _mm256_and_ps( LOAD_H8( &A[bs*1] ), mask ), xx, c1 );
+		c2 = _mm256_fmadd_ps( _mm256_and_ps( LOAD_H8( &A[bs*2] ), mask ), xx, c2 );
+		c3 = _mm256_fmadd_ps( _mm256_and_ps( LOAD_H8( &A[bs*3] ), mask ), xx, c3 );
+		c4 = _mm256_fmadd_ps( _mm256_and_ps( LOAD_H8( &A[bs*4] ), mask ), xx, c4 );
+		c5 = _mm256_fmadd_ps( _mm256_and_ps( LOAD_H8( &A[bs*5] ), mask ), xx, c5 );
+		c6 = _mm256_fmadd_ps( _mm256_and_ps( LOAD_H8( &A[bs*6] ), mask ), xx, c6 );
+		c7 = _mm256_fmadd_ps( _mm256_and_ps( LOAD_H8( &A[bs*7] ), mask ), xx, c7 );
+		}
+
+	zz = kernel_shgemv_t_8_reduce( c0, c1, c2, c3, c4, c5, c6, c7 );
+	zz = _mm256_mul_ps( _mm256_broadcast_ss( alpha ), zz );
+	if(*beta!=0.0)
+		zz = _mm256_fmadd_ps( _mm256_broadcast_ss( beta ), _mm256_loadu_ps( &y[0] ), zz );
+
+	_mm256_storeu_ps( &z[0], zz );
+
+	return;
+
+	}
+
+
+
+// only the first k1 columns of A, and entries of y and z, are accessed
+void kernel_shgemv_t_8_vs_lib8(int k, float *alpha, unsigned short *A, int sda, float *x, float *beta, float *y, float *z, int k1)
+	{
+
+	const int bs = 8;
+
+	__m256 c[8], xx, zz, mask;
+	__m256i imask;
+
+	int ii, jj;
+
+	if(k1>8)
+		k1 = 8;
+
+	for(jj=0; jj<8; jj++)
+		c[jj] = _mm256_setzero_ps();
+
+	for(ii=0; ii<k-7; ii+=8)
+		{
+		xx = _mm256_loadu_ps( &x[0] );
+		for(jj=0; jj<k1; jj++)
+			c[jj] = _mm256_fmadd_ps( LOAD_H8( &A[bs*jj] ), xx, c[jj] );
+		A += bs*sda;
+		x += bs;
+		}
+	if(ii<k)
+		{
+		mask = _mm256_cmp_ps( _mm256_set_ps( 7.5, 6.5, 5.5, 4.5, 3.5, 2.5, 1.5, 0.5 ), _mm256_set1_ps( (float) (k-ii) ), _CMP_LT_OQ );
+		imask = _mm256_castps_si256( mask );
+		xx = _mm256_maskload_ps( &x[0], imask );
+		for(jj=0; jj<k1; jj++)
+			c[jj] = _mm256_fmadd_ps( _mm256_and_ps( LOAD_H8( &A[bs*jj] ), mask ), xx, c[jj] );
+		}
+
+	zz = kernel_shgemv_t_8_reduce( c[0], c[1], c[2], c[3], c[4], c[5], c[6], c[7] );
+	zz = _mm256_mul_ps( _mm256_broadcast_ss( alpha ), zz );
+
+	imask = _mm256_castps_si256( _mm256_cmp_ps( _mm256_set_ps( 7.5, 6.5, 5.5, 4.5, 3.5, 2.5, 1.5, 0.5 ), _mm256_set1_ps( (float) k1 ), _CMP_LT_OQ ) );
+	if(*beta!=0.0)
+		zz = _mm256_fmadd_ps( _mm256_broadcast_ss( beta ), _mm256_maskload_ps( &y[0], imask ), zz );
+
+	_mm256_maskstore_ps( &z[0], imask, zz );
+
+	return;
+
+	}
@@ -0,0 +1,180 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <complex.h>
+
+#include <mmintrin.h>
+#include <xmmintrin.h>  // SSE
+#include <emmintrin.h>  // SSE2
+#include <pmmintrin.h>  // SSE3
+#include <smmintrin.h>  // SSE4
+#include <immintrin.h>  // AVX
+#include "../../include/blasfeo_z_kernel.h"
+
+
+
+// D <= alpha * A * op(B) + beta * C, with op(B) = B^T (conj_b=0) or B^H (conj_b=1), A 4 x k (one panel), B 2 x k
+// (two rows of a panel, B[c+4*l]), and C, D 4 x 2 (one panel); only the first km rows and kn columns of D are
+// stored.
+// The products are computed on the real and imaginary parts, to avoid the inf and nan checks of the C99 complex
+// multiplication in the inner loop: the accumulators hold A * real(B) and A * imag(B) separately, combined at the
+// end with one addsub
+static inline void kernel_zgemm_nt_4x2_gen_lib4(int k, int conj_b, double _Complex *alpha, double _Complex *A, double _Complex *B, double _Complex *beta, double _Complex *C, double _Complex *D, int km, int kn)
+	{
+
+	const int bs = 4;
+
+	int ii, jj, ll;
+
+	double *pA = (double *) A;
+	double *pB = (double *) B;
+	double *pC = (double *) C;
+	double *pD = (double *) D;
+	double tmp[4];
+
+	__m256d a0, a1, br, bi, d[4], c,
+		r00 = _mm256_setzero_pd(), r10 = _mm256_setzero_pd(), i00 = _mm256_setzero_pd(), i10 = _mm256_setzero_pd(),
+		r01 = _mm256_setzero_pd(), r11 = _mm256_setzero_pd(), i01 = _mm256_setzero_pd(), i11 = _mm256_setzero_pd();
+
+	for(ll=0; ll<k; ll++)
+		{
+		a0 = _mm256_load_pd( &pA[0] );
+		a1 = _mm256_load_pd( &pA[4] );
+		br = _mm256_broadcast_sd( &pB[0] );
+		bi = _mm256_broadcast_sd( &pB[1] );
+		r00 = _mm256_fmadd_pd( a0, br, r00 );
+		r10 = _mm256_fmadd_pd( a1, br, r10 );
+		i00 = _mm256_fmadd_pd( a0, bi, i00 );
+		i10 = _mm256_fmadd_pd( a1, bi, i10 );
+		br = _mm256_broadcast_sd( &pB[2] );
+		bi = _mm256_broadcast_sd( &pB[3] );
+		r01 = _mm256_fmadd_pd( a0, br, r01 );
+		r11 = _mm256_fmadd_pd( a1, br, r11 );
+		i01 = _mm256_fmadd_pd( a0, bi, i01 );
+		i11 = _mm256_fmadd_pd( a1, bi, i11 );
+		pA += 2*bs;
+		pB += 2*bs;
+		}
+
+	// a * b = r + i * im, a * conj(b) = r - i * im
+	if(conj_b)
+		{
+		c = _mm256_setzero_pd();
+		i00 = _mm256_sub_pd( c, i00 );
+		i10 = _mm256_sub_pd( c, i10 );
+		i01 = _mm256_sub_pd( c, i01 );
+		i11 = _mm256_sub_pd( c, i11 );
+		}
+
+	// d[2*jj+ii]: rows 2*ii, 2*ii+1 of column jj
+	d[0] = _mm256_addsub_pd( r00, _mm256_permute_pd( i00, 0x5 ) );
+	d[1] = _mm256_addsub_pd( r10, _mm256_permute_pd( i10, 0x5 ) );
+	d[2] = _mm256_addsub_pd( r01, _mm256_permute_pd( i01, 0x5 ) );
+	d[3] = _mm256_addsub_pd( r11, _mm256_permute_pd( i11, 0x5 ) );
+
+	br = _mm256_broadcast_sd( &((double *) alpha)[0] );
+	bi = _mm256_broadcast_sd( &((double *) alpha)[1] );
+	for(ii=0; ii<4; ii++)
+		d[ii] = _mm256_addsub_pd( _mm256_mul_pd( d[ii], br ), _mm256_mul_pd( _mm256_permute_pd( d[ii], 0x5 ), bi ) );
+
+	if(*beta!=0.0)
+		{
+		br = _mm256_broadcast_sd( &((double *) beta)[0] );
+		bi = _mm256_broadcast_sd( &((double *) beta)[1] );
+		for(jj=0; jj<kn & jj<2; jj++)
+			{
+			for(ii=0; ii<2; ii++)
+				{
+				c = _mm256_load_pd( &pC[2*bs*jj+4*ii] );
+				d[2*jj+ii] = _mm256_add_pd( d[2*jj+ii], _mm256_addsub_pd( _mm256_mul_pd( c, br ), _mm256_mul_pd( _mm256_permute_pd( c, 0x5 ), bi ) ) );
+				}
+			}
+		}
+
+	if(km>=4 & kn>=2)
+		{
+		_mm256_store_pd( &pD[0], d[0] );
+		_mm256_store_pd( &pD[4], d[1] );
+		_mm256_store_pd( &pD[2*bs+0], d[2] );
+		_mm256_store_pd( &pD[2*bs+4], d[3] );
+		}
+	else
+		{
+		for(jj=0; jj<kn & jj<2; jj++)
+			{
+			for(ii=0; ii<km & ii<4; ii++)
+				{
+				_mm256_storeu_pd( tmp, d[2*jj+ii/2] );
+				pD[2*bs*jj+2*ii+0] = tmp[2*(ii%2)+0];
+				pD[2*bs*jj+2*ii+1] = tmp[2*(ii%2)+1];
+				}
+			}
+		}
+
+	return;
+
+	}
+
+
+
+void kernel_zgemm_nt_4x2_lib4(int k, double _Complex *alpha, double _Complex *A, double _Complex *B, double _Complex *beta, double _Complex *C, double _Complex *D)
+	{
+	kernel_zgemm_nt_4x2_gen_lib4(k, 0, alpha, A, B, beta, C, D, 4, 2);
+	return;
+	}
+
+
+
+void kernel_zgemm_nt_4x2_vs_lib4(int k, double _Complex *alpha, double _Complex *A, double _Complex *B, double _Complex *beta, double _Complex *C, double _Complex *D, int km, int kn)
+	{
+	kernel_zgemm_nt_4x2_gen_lib4(k, 0, alpha, A, B, beta, C, D, km, kn);
+	return;
+	}
+
+
+
+void kernel_zgemm_nc_4x2_lib4(int k, double _Complex *alpha, double _Complex *A, double _Complex *B, double _Complex *beta, double _Complex *C, double _Complex *D)
+	{
+	kernel_zgemm_nt_4x2_gen_lib4(k, 1, alpha, A, B, beta, C, D, 4, 2);
+	return;
+	}
+
+
+
+void kernel_zgemm_nc_4x2_vs_lib4(int k, double _Complex *alpha, double _Complex *A, double _Complex *B, double _Complex *beta, double _Complex *C, double _Complex *D, int km, int kn)
+	{
+	kernel_zgemm_nt_4x2_gen_lib4(k, 1, alpha, A, B, beta, C, D, km, kn);
+	return;
+	}
@@ -0,0 +1,106 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <stdlib.h>
+
+#include "../../include/blasfeo_common.h"
+#include "../../include/blasfeo_d_kernel.h"
+
+
+
+// D <= beta * C + alpha * A * B on the BLASFEO_DMAT_BATCH_LANES interleaved lanes of a compact batch, for a block of
+// m1 x n1 (at most 4 x 3) elements; only the lanes are vectorized by the compiler
+static void kernel_dgemm_4x3_gen_compact(int k, double *alpha, double *A, int as0, int as1, double *B, int bs0, int bs1, double *beta, double *C, int cs0, int cs1, double *D, int ds0, int ds1, int m1, int n1)
+	{
+
+	const int nl = BLASFEO_DMAT_BATCH_LANES;
+
+	int ii, jj, ll, kk;
+
+	double c[12*BLASFEO_DMAT_BATCH_LANES] = {0};
+	double *pA, *pB, *pD, *pC;
+
+	for(kk=0; kk<k; kk++)
+		{
+		for(jj=0; jj<n1; jj++)
+			{
+			pB = B + kk*bs0 + jj*bs1;
+			for(ii=0; ii<m1; ii++)
+				{
+				pA = A + ii*as0 + kk*as1;
+				for(ll=0; ll<nl; ll++)
+					c[nl*(ii+4*jj)+ll] += pA[ll] * pB[ll];
+				}
+			}
+		}
+
+	for(jj=0; jj<n1; jj++)
+		{
+		for(ii=0; ii<m1; ii++)
+			{
+			pD = D + ii*ds0 + jj*ds1;
+			if(beta==NULL)
+				{
+				for(ll=0; ll<nl; ll++)
+					pD[ll] = alpha[ll] * c[nl*(ii+4*jj)+ll];
+				}
+			else
+				{
+				pC = C + ii*cs0 + jj*cs1;
+				for(ll=0; ll<nl; ll++)
+					pD[ll] = alpha[ll] * c[nl*(ii+4*jj)+ll] + beta[ll] * pC[ll];
+				}
+			}
+		}
+
+	return;
+
+	}
+
+
+
+void kernel_dgemm_4x3_compact(int k, double *alpha, double *A, int as0, int as1, double *B, int bs0, int bs1, double *beta, double *C, int cs0, int cs1, double *D, int ds0, int ds1)
+	{
+	kernel_dgemm_4x3_gen_compact(k, alpha, A, as0, as1, B, bs0, bs1, beta, C, cs0, cs1, D, ds0, ds1, 4, 3);
+	return;
+	}
+
+
+
+void kernel_dgemm_4x3_vs_compact(int k, double *alpha, double *A, int as0, int as1, double *B, int bs0, int bs1, double *beta, double *C, int cs0, int cs1, double *D, int ds0, int ds1, int m1, int n1)
+	{
+	kernel_dgemm_4x3_gen_compact(k, alpha, A, as0, as1, B, bs0, bs1, beta, C, cs0, cs1, D, ds0, ds1, m1<4 ? m1 : 4, n1<3 ? n1 : 3);
+	return;
+	}
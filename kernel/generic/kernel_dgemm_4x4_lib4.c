@@ -2413,6 +2413,7 @@ void kernel_dsyrk_nt_l_4x4_gen_lib4(int kmax, double *alpha, double *A, double *
 	double
 		*C1, *D1;
 
+	// load the whole block: with n0>0 the stored lower triangle is shifted right by n0 columns
 	if(offsetC==0)
 		{
 		CC[0+bs*0] = beta[0]*C0[0+bs*0];
@@ -2420,13 +2421,19 @@ void kernel_dsyrk_nt_l_4x4_gen_lib4(int kmax, double *alpha, double *A, double *
 		CC[2+bs*0] = beta[0]*C0[2+bs*0];
 		CC[3+bs*0] = beta[0]*C0[3+bs*0];
 
+		CC[0+bs*1] = beta[0]*C0[0+bs*1];
 		CC[1+bs*1] = beta[0]*C0[1+bs*1];
 		CC[2+bs*1] = beta[0]*C0[2+bs*1];
 		CC[3+bs*1] = beta[0]*C0[3+bs*1];
 
+		CC[0+bs*2] = beta[0]*C0[0+bs*2];
+		CC[1+bs*2] = beta[0]*C0[1+bs*2];
 		CC[2+bs*2] = beta[0]*C0[2+bs*2];
 		CC[3+bs*2] = beta[0]*C0[3+bs*2];
 
+		CC[0+bs*3] = beta[0]*C0[0+bs*3];
+		CC[1+bs*3] = beta[0]*C0[1+bs*3];
+		CC[2+bs*3] = beta[0]*C0[2+bs*3];
 		CC[3+bs*3] = beta[0]*C0[3+bs*3];
 		}
 	else if(offsetC==1)
@@ -2438,13 +2445,19 @@ void kernel_dsyrk_nt_l_4x4_gen_lib4(int kmax, double *alpha, double *A, double *
 		CC[2+bs*0] = beta[0]*C0[3+bs*0];
 		CC[3+bs*0] = beta[0]*C1[0+bs*0];
 
+		CC[0+bs*1] = beta[0]*C0[1+bs*1];
 		CC[1+bs*1] = beta[0]*C0[2+bs*1];
 		CC[2+bs*1] = beta[0]*C0[3+bs*1];
 		CC[3+bs*1] = beta[0]*C1[0+bs*1];
 
+		CC[0+bs*2] = beta[0]*C0[1+bs*2];
+		CC[1+bs*2] = beta[0]*C0[2+bs*2];
 		CC[2+bs*2] = beta[0]*C0[3+bs*2];
 		CC[3+bs*2] = beta[0]*C1[0+bs*2];
 
+		CC[0+bs*3] = beta[0]*C0[1+bs*3];
+		CC[1+bs*3] = beta[0]*C0[2+bs*3];
+		CC[2+bs*3] = beta[0]*C0[3+bs*3];
 		CC[3+bs*3] = beta[0]*C1[0+bs*3];
 		}
 	else if(offsetC==2)
@@ -2456,13 +2469,19 @@ void kernel_dsyrk_nt_l_4x4_gen_lib4(int kmax, double *alpha, double *A, double *
 		CC[2+bs*0] = beta[0]*C1[0+bs*0];
 		CC[3+bs*0] = beta[0]*C1[1+bs*0];
 
+		CC[0+bs*1] = beta[0]*C0[2+bs*1];
 		CC[1+bs*1] = beta[0]*C0[3+bs*1];
 		CC[2+bs*1] = beta[0]*C1[0+bs*1];
 		CC[3+bs*1] = beta[0]*C1[1+bs*1];
 
+		CC[0+bs*2] = beta[0]*C0[2+bs*2];
+		CC[1+bs*2] = beta[0]*C0[3+bs*2];
 		CC[2+bs*2] = beta[0]*C1[0+bs*2];
 		CC[3+bs*2] = beta[0]*C1[1+bs*2];
 
+		CC[0+bs*3] = beta[0]*C0[2+bs*3];
+		CC[1+bs*3] = beta[0]*C0[3+bs*3];
+		CC[2+bs*3] = beta[0]*C1[0+bs*3];
 		CC[3+bs*3] = beta[0]*C1[1+bs*3];
 		}
 	else //if(offsetC==3)
@@ -2474,13 +2493,19 @@ void kernel_dsyrk_nt_l_4x4_gen_lib4(int kmax, double *alpha, double *A, double *
 		CC[2+bs*0] = beta[0]*C1[1+bs*0];
 		CC[3+bs*0] = beta[0]*C1[2+bs*0];
 
+		CC[0+bs*1] = beta[0]*C0[3+bs*1];
 		CC[1+bs*1] = beta[0]*C1[0+bs*1];
 		CC[2+bs*1] = beta[0]*C1[1+bs*1];
 		CC[3+bs*1] = beta[0]*C1[2+bs*1];
 
+		CC[0+bs*2] = beta[0]*C0[3+bs*2];
+		CC[1+bs*2] = beta[0]*C1[0+bs*2];
 		CC[2+bs*2] = beta[0]*C1[1+bs*2];
 		CC[3+bs*2] = beta[0]*C1[2+bs*2];
 
+		CC[0+bs*3] = beta[0]*C0[3+bs*3];
+		CC[1+bs*3] = beta[0]*C1[0+bs*3];
+		CC[2+bs*3] = beta[0]*C1[1+bs*3];
 		CC[3+bs*3] = beta[0]*C1[2+bs*3];
 		}
 	
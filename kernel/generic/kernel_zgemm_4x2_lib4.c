@@ -0,0 +1,133 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <complex.h>
+
+#include "../../include/blasfeo_z_kernel.h"
+
+
+
+// D <= alpha * A * op(B) + beta * C, with op(B) = B^T (conj_b=0) or B^H (conj_b=1), A 4 x k (one panel), B 2 x k
+// (two rows of a panel, B[c+4*l]), and C, D 4 x 2 (one panel); only the first km rows and kn columns of D are
+// stored.
+// The products are computed on the real and imaginary parts, to avoid the inf and nan checks of the C99 complex
+// multiplication in the inner loop
+static void kernel_zgemm_nt_4x2_gen_lib4(int k, int conj_b, double _Complex *alpha, double _Complex *A, double _Complex *B, double _Complex *beta, double _Complex *C, double _Complex *D, int km, int kn)
+	{
+
+	const int bs = 4;
+
+	int ii, jj, ll;
+
+	double *pA = (double *) A;
+	double *pB = (double *) B;
+	double dr[8], di[8];
+	double a_r, a_i, b_r, b_i, c_r, c_i;
+
+	for(ii=0; ii<8; ii++)
+		{
+		dr[ii] = 0.0;
+		di[ii] = 0.0;
+		}
+
+	for(ll=0; ll<k; ll++)
+		{
+		for(jj=0; jj<2; jj++)
+			{
+			b_r = pB[2*jj+0];
+			b_i = conj_b ? -pB[2*jj+1] : pB[2*jj+1];
+			for(ii=0; ii<4; ii++)
+				{
+				a_r = pA[2*ii+0];
+				a_i = pA[2*ii+1];
+				dr[ii+4*jj] += a_r*b_r - a_i*b_i;
+				di[ii+4*jj] += a_r*b_i + a_i*b_r;
+				}
+			}
+		pA += 2*bs;
+		pB += 2*bs;
+		}
+
+	for(jj=0; jj<kn & jj<2; jj++)
+		{
+		for(ii=0; ii<km & ii<4; ii++)
+			{
+			c_r = creal(*alpha)*dr[ii+4*jj] - cimag(*alpha)*di[ii+4*jj];
+			c_i = creal(*alpha)*di[ii+4*jj] + cimag(*alpha)*dr[ii+4*jj];
+			if(*beta!=0.0)
+				{
+				c_r += creal(*beta)*creal(C[ii+bs*jj]) - cimag(*beta)*cimag(C[ii+bs*jj]);
+				c_i += creal(*beta)*cimag(C[ii+bs*jj]) + cimag(*beta)*creal(C[ii+bs*jj]);
+				}
+			((double *) &D[ii+bs*jj])[0] = c_r;
+			((double *) &D[ii+bs*jj])[1] = c_i;
+			}
+		}
+
+	return;
+
+	}
+
+
+
+void kernel_zgemm_nt_4x2_lib4(int k, double _Complex *alpha, double _Complex *A, double _Complex *B, double _Complex *beta, double _Complex *C, double _Complex *D)
+	{
+	kernel_zgemm_nt_4x2_gen_lib4(k, 0, alpha, A, B, beta, C, D, 4, 2);
+	return;
+	}
+
+
+
+void kernel_zgemm_nt_4x2_vs_lib4(int k, double _Complex *alpha, double _Complex *A, double _Complex *B, double _Complex *beta, double _Complex *C, double _Complex *D, int km, int kn)
+	{
+	kernel_zgemm_nt_4x2_gen_lib4(k, 0, alpha, A, B, beta, C, D, km, kn);
+	return;
+	}
+
+
+
+void kernel_zgemm_nc_4x2_lib4(int k, double _Complex *alpha, double _Complex *A, double _Complex *B, double _Complex *beta, double _Complex *C, double _Complex *D)
+	{
+	kernel_zgemm_nt_4x2_gen_lib4(k, 1, alpha, A, B, beta, C, D, 4, 2);
+	return;
+	}
+
+
+
+void kernel_zgemm_nc_4x2_vs_lib4(int k, double _Complex *alpha, double _Complex *A, double _Complex *B, double _Complex *beta, double _Complex *C, double _Complex *D, int km, int kn)
+	{
+	kernel_zgemm_nt_4x2_gen_lib4(k, 1, alpha, A, B, beta, C, D, km, kn);
+	return;
+	}
@@ -0,0 +1,106 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <math.h>
+#include <complex.h>
+
+#include "../../include/blasfeo_z_kernel.h"
+
+
+
+// LU factorization with row pivoting of the m x n block pA (n<=4 columns, m>=n rows starting at the top of a panel,
+// sda the number of columns of the panels): ipiv[c] is the row swapped with row c at step c, and the row swaps are
+// applied only to the n columns of the block; the pivot is the largest in |real| + |imag|
+void kernel_zgetrf_pivot_4_vs_lib4(int m, double _Complex *pA, int sda, int *ipiv, int n)
+	{
+
+	const int bs = 4;
+
+	double _Complex tmp, inv;
+	double amax, a;
+	int ii, jj, cc, ip;
+	double _Complex *pc, *pi;
+
+	for(cc=0; cc<n; cc++)
+		{
+		pc = pA + cc/bs*bs*sda + cc%bs;
+		// pivot search
+		ip = cc;
+		tmp = pc[bs*cc];
+		amax = fabs(creal(tmp)) + fabs(cimag(tmp));
+		for(ii=cc+1; ii<m; ii++)
+			{
+			tmp = pA[ii/bs*bs*sda+ii%bs+bs*cc];
+			a = fabs(creal(tmp)) + fabs(cimag(tmp));
+			if(a>amax)
+				{
+				amax = a;
+				ip = ii;
+				}
+			}
+		ipiv[cc] = ip;
+		if(ip!=cc)
+			{
+			pi = pA + ip/bs*bs*sda + ip%bs;
+			for(jj=0; jj<n; jj++)
+				{
+				tmp = pc[bs*jj];
+				pc[bs*jj] = pi[bs*jj];
+				pi[bs*jj] = tmp;
+				}
+			}
+		// column below the pivot
+		tmp = pc[bs*cc];
+		if(tmp!=0.0)
+			{
+			inv = 1.0 / tmp;
+			for(ii=cc+1; ii<m; ii++)
+				pA[ii/bs*bs*sda+ii%bs+bs*cc] *= inv;
+			}
+		// rest of the block
+		for(jj=cc+1; jj<n; jj++)
+			{
+			tmp = pc[bs*jj];
+			if(tmp!=0.0)
+				{
+				for(ii=cc+1; ii<m; ii++)
+					pA[ii/bs*bs*sda+ii%bs+bs*jj] -= pA[ii/bs*bs*sda+ii%bs+bs*cc] * tmp;
+				}
+			}
+		}
+
+	return;
+
+	}
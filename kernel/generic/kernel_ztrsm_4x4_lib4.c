@@ -0,0 +1,157 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <math.h>
+#include <complex.h>
+
+#include "../../include/blasfeo_common.h"
+#include "../../include/blasfeo_z_kernel.h"
+
+
+
+// the factorization and solve kernels work on one 4 x 4 block: the product with the panels A and B is computed by the
+// 4x2 gemm kernels into a local block, and the triangular part is then computed element-wise on the local block
+
+
+
+// D <= chol(C - A * B^H), lower factor of the 4 x 4 diagonal block, with A and B 4 x k (one panel each) and C, D 4 x 4
+// (one panel); inv_diag_D[c] <= 1.0 / D[c,c] (0.0 for a non positive pivot); only the lower triangle of the first km
+// rows and kn columns of D is stored
+void kernel_zpotrf_nc_l_4x4_vs_lib4(int k, double _Complex *A, double _Complex *B, double _Complex *C, double _Complex *D, double _Complex *inv_diag_D, int km, int kn)
+	{
+
+	const int bs = 4;
+
+	double _Complex alpha = -1.0;
+	double _Complex beta = 1.0;
+	ALIGNED( double _Complex T[16], 64 );
+	double _Complex tmp;
+	double d, inv;
+	int ii, jj, ll;
+
+	kernel_zgemm_nc_4x2_vs_lib4(k, &alpha, A, B, &beta, C, T, km, kn);
+	if(kn>2)
+		kernel_zgemm_nc_4x2_vs_lib4(k, &alpha, A, B+2, &beta, C+2*bs, T+2*bs, km, kn-2);
+
+	for(jj=0; jj<kn; jj++)
+		{
+		d = creal(T[jj+bs*jj]);
+		d = d>0.0 ? sqrt(d) : 0.0;
+		inv = d>0.0 ? 1.0/d : 0.0;
+		T[jj+bs*jj] = d;
+		inv_diag_D[jj] = inv;
+		for(ii=jj+1; ii<km; ii++)
+			T[ii+bs*jj] *= inv;
+		for(ll=jj+1; ll<kn; ll++)
+			{
+			tmp = conj(T[ll+bs*jj]);
+			for(ii=ll; ii<km; ii++)
+				T[ii+bs*ll] -= T[ii+bs*jj] * tmp;
+			}
+		}
+
+	for(jj=0; jj<kn; jj++)
+		for(ii=jj; ii<km; ii++)
+			D[ii+bs*jj] = T[ii+bs*jj];
+
+	return;
+
+	}
+
+
+
+// D <= (C - A * B^H) * E^{-H}, with E lower triangular, A and B 4 x k (one panel each), C, D and E 4 x 4 (one panel),
+// and inv_diag_E[c] = 1.0 / conj(E[c,c]); only the first km rows and kn columns of D are stored
+void kernel_ztrsm_nc_rl_inv_4x4_vs_lib4(int k, double _Complex *A, double _Complex *B, double _Complex *C, double _Complex *D, double _Complex *E, double _Complex *inv_diag_E, int km, int kn)
+	{
+
+	const int bs = 4;
+
+	double _Complex alpha = -1.0;
+	double _Complex beta = 1.0;
+	ALIGNED( double _Complex T[16], 64 );
+	double _Complex tmp;
+	int ii, jj, ll;
+
+	kernel_zgemm_nc_4x2_vs_lib4(k, &alpha, A, B, &beta, C, T, km, kn);
+	if(kn>2)
+		kernel_zgemm_nc_4x2_vs_lib4(k, &alpha, A, B+2, &beta, C+2*bs, T+2*bs, km, kn-2);
+
+	for(jj=0; jj<kn; jj++)
+		{
+		for(ll=0; ll<jj; ll++)
+			{
+			tmp = conj(E[jj+bs*ll]);
+			for(ii=0; ii<km; ii++)
+				T[ii+bs*jj] -= T[ii+bs*ll] * tmp;
+			}
+		for(ii=0; ii<km; ii++)
+			T[ii+bs*jj] *= inv_diag_E[jj];
+		}
+
+	for(jj=0; jj<kn; jj++)
+		for(ii=0; ii<km; ii++)
+			D[ii+bs*jj] = T[ii+bs*jj];
+
+	return;
+
+	}
+
+
+
+// D <= E^{-1} * C, with E unit lower triangular, and C, D and E 4 x 4 (one panel); only the first km rows and
+// columns of E are accessed, and only the first km rows and kn columns of D are stored
+void kernel_ztrsm_nn_ll_one_4x4_vs_lib4(double _Complex *C, double _Complex *D, double _Complex *E, int km, int kn)
+	{
+
+	const int bs = 4;
+
+	double _Complex T[4];
+	int ii, jj, ll;
+
+	for(jj=0; jj<kn; jj++)
+		{
+		for(ii=0; ii<km; ii++)
+			T[ii] = C[ii+bs*jj];
+		for(ll=0; ll<km; ll++)
+			for(ii=ll+1; ii<km; ii++)
+				T[ii] -= E[ii+bs*ll] * T[ll];
+		for(ii=0; ii<km; ii++)
+			D[ii+bs*jj] = T[ii];
+		}
+
+	return;
+
+	}
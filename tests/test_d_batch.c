@@ -0,0 +1,178 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "../include/blasfeo_common.h"
+#include "../include/blasfeo_d_aux_ext_dep.h"
+#include "../include/blasfeo_d_aux.h"
+#include "../include/blasfeo_d_blas.h"
+#include "../include/blasfeo_thread.h"
+
+#include "test_residual.h"
+
+
+
+#define BATCH 5
+
+
+
+// residual of the batched dgemm_nn, dgemm_nt and dsyrk_ln against a naive triple loop for each entry of the batch:
+// NULL offsets arrays, row offsets at the top of a panel (the kernels called directly, any row offset of B in gemm_nn),
+// and some entries at row offsets in the panel (the single-matrix routines); on 1 and 4 threads (with MULTI_THREAD=1,
+// otherwise both are serial); the entries of D out of the result (and out of the lower triangle in dsyrk_ln) must
+// not be written
+int main()
+	{
+
+	int ms[] = {1, 3, 4, 5, 8, 11, 12, 13, 24, 27};
+	int ns[] = {1, 5, 8, 13};
+	int ks[] = {1, 4, 7};
+
+	int ii, jj, ll, bb, op, im, in, ik, mode, nt;
+	int m, n, k, nm, ref_in;
+	double res, tmp, a, b;
+	int n_fail = 0;
+
+	struct blasfeo_dmat sA[BATCH], sB[BATCH], sC[BATCH], sD[BATCH];
+	struct blasfeo_dmat *pA[BATCH], *pB[BATCH], *pC[BATCH], *pD[BATCH];
+	int ai[BATCH], aj[BATCH], bi[BATCH], bj[BATCH], ci[BATCH], cj[BATCH], di[BATCH], dj[BATCH];
+	int *pai, *paj, *pbi, *pbj, *pci, *pcj, *pdi, *pdj;
+
+	for(nt=1; nt<=4; nt+=3)
+	for(op=0; op<3; op++)
+	for(mode=0; mode<3; mode++)
+	for(im=0; im<10; im++)
+	for(in=0; in<4; in++)
+	for(ik=0; ik<3; ik++)
+		{
+		blasfeo_set_num_threads(nt);
+		m = ms[im];
+		n = op==2 ? m : ns[in];
+		k = ks[ik];
+		if(op==2 & in>0)
+			continue;
+		nm = 8+(m>n ? m : n)+k;
+
+		for(bb=0; bb<BATCH; bb++)
+			{
+			// mode 0: no offsets; 1: row offsets multiple of 4 (any for B in gemm_nn); 2: some entries in the panel
+			ai[bb] = mode==0 ? 0 : 4*(bb&1);
+			aj[bb] = mode==0 ? 0 : bb;
+			bi[bb] = mode==0 ? 0 : op==0 ? bb : 4*(bb>>1&1);
+			bj[bb] = mode==0 ? 0 : 2*bb;
+			ci[bb] = mode==0 ? 0 : 4*(bb>>1&1);
+			cj[bb] = mode==0 ? 0 : 1;
+			di[bb] = mode==0 ? 0 : 4*(bb&1);
+			dj[bb] = mode==0 ? 0 : 3;
+			if(mode==2 & (bb&1))
+				{
+				ai[bb] += 1;
+				ci[bb] += 3;
+				di[bb] += 2;
+				}
+			blasfeo_allocate_dmat(nm, nm, &sA[bb]);
+			blasfeo_allocate_dmat(nm, nm, &sB[bb]);
+			blasfeo_allocate_dmat(nm, nm, &sC[bb]);
+			blasfeo_allocate_dmat(nm, nm, &sD[bb]);
+			test_d_rnd_mat(nm, nm, &sA[bb], 0, 0);
+			test_d_rnd_mat(nm, nm, &sB[bb], 0, 0);
+			test_d_rnd_mat(nm, nm, &sC[bb], 0, 0);
+			blasfeo_dgese(nm, nm, 7.0, &sD[bb], 0, 0);
+			pA[bb] = &sA[bb];
+			pB[bb] = &sB[bb];
+			pC[bb] = &sC[bb];
+			pD[bb] = &sD[bb];
+			}
+		pai = mode==0 ? NULL : ai;
+		paj = mode==0 ? NULL : aj;
+		pbi = mode==0 ? NULL : bi;
+		pbj = mode==0 ? NULL : bj;
+		pci = mode==0 ? NULL : ci;
+		pcj = mode==0 ? NULL : cj;
+		pdi = mode==0 ? NULL : di;
+		pdj = mode==0 ? NULL : dj;
+
+		if(op==0)
+			blasfeo_dgemm_nn_batch(BATCH, m, n, k, -1.0, pA, pai, paj, pB, pbi, pbj, 0.5, pC, pci, pcj, pD, pdi, pdj);
+		else if(op==1)
+			blasfeo_dgemm_nt_batch(BATCH, m, n, k, -1.0, pA, pai, paj, pB, pbi, pbj, 0.5, pC, pci, pcj, pD, pdi, pdj);
+		else
+			blasfeo_dsyrk_ln_batch(BATCH, m, k, -1.0, pA, pai, paj, pB, pbi, pbj, 0.5, pC, pci, pcj, pD, pdi, pdj);
+
+		for(bb=0; bb<BATCH; bb++)
+			{
+			res = 0.0;
+			for(jj=0; jj<nm; jj++)
+				for(ii=0; ii<nm; ii++)
+					{
+					ref_in = ii>=di[bb] & ii<di[bb]+m & jj>=dj[bb] & jj<dj[bb]+n;
+					if(op==2)
+						ref_in &= ii-di[bb]>=jj-dj[bb];
+					if(ref_in)
+						{
+						tmp = 0.5 * blasfeo_dgeex1(&sC[bb], ci[bb]+ii-di[bb], cj[bb]+jj-dj[bb]);
+						for(ll=0; ll<k; ll++)
+							{
+							a = blasfeo_dgeex1(&sA[bb], ai[bb]+ii-di[bb], aj[bb]+ll);
+							b = op==0 ? blasfeo_dgeex1(&sB[bb], bi[bb]+ll, bj[bb]+jj-dj[bb]) : blasfeo_dgeex1(&sB[bb], bi[bb]+jj-dj[bb], bj[bb]+ll);
+							tmp -= a * b;
+							}
+						}
+					else
+						{
+						tmp = 7.0;
+						}
+					res = fmax(res, fabs(tmp - blasfeo_dgeex1(&sD[bb], ii, jj)));
+					}
+			if(res>1e-12*k)
+				{
+				printf("\n%s batch: threads=%d, mode=%d, m=%d, n=%d, k=%d, entry %d, residual %e\n", op==0 ? "dgemm_nn" : op==1 ? "dgemm_nt" : "dsyrk_ln", nt, mode, m, n, k, bb, res);
+				n_fail++;
+				}
+			blasfeo_free_dmat(&sA[bb]);
+			blasfeo_free_dmat(&sB[bb]);
+			blasfeo_free_dmat(&sC[bb]);
+			blasfeo_free_dmat(&sD[bb]);
+			}
+		}
+
+	blasfeo_set_num_threads(1);
+
+	return test_report("batched dgemm and dsyrk", n_fail);
+
+	}
@@ -0,0 +1,227 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "../include/blasfeo_common.h"
+#include "../include/blasfeo_stdlib.h"
+#include "../include/blasfeo_thread.h"
+#include "../include/blasfeo_d_blas_api.h"
+
+#include "test_residual.h"
+
+
+
+#if defined(FORTRAN_BLAS_API)
+#define blasfeo_dgemm dgemm_
+#define blasfeo_dgetrf dgetrf_
+#endif
+
+
+
+// workspace arena of the BLAS API: allocations from the arena on cache line boundaries in stack order, release of the
+// later allocations with an earlier one, malloc fallback when the arena is exhausted or unset; then dgemm (all
+// transposes) and dgetrf (m x min(m,n)) with an arena of blasfeo_blas_workspace_size bytes on 1 and 4 threads: the peak use of the
+// arena must fit in it (no malloc fallback), and the results must match the ones without arena
+int main()
+	{
+
+	int sizes[][3] = {{1, 1, 1}, {20, 30, 40}, {130, 97, 70}, {300, 200, 500}, {650, 700, 600}};
+	int nts[] = {1, 4};
+	size_t arena_size = 4096;
+
+	int ii, is, it, tr, info;
+	int m, n, k, lda, ldb, ldc, mn;
+	size_t size, peak;
+	char ta, tb;
+	double alpha = 1.5;
+	double beta = -0.5;
+	double err;
+	double *A, *B, *C0, *C1, *C2, *LU1, *LU2;
+	int *ipiv1, *ipiv2;
+	char *arena, *p0, *p1, *p2, *p3;
+	int n_fail = 0;
+
+	// arena mechanics
+	blasfeo_malloc_align((void **) &arena, arena_size);
+	blasfeo_blas_workspace_set(arena, arena_size);
+	p0 = blasfeo_blas_workspace_malloc(100);
+	p1 = blasfeo_blas_workspace_malloc(10);
+	p2 = blasfeo_blas_workspace_malloc(64);
+	if(p0!=arena | p1!=arena+128 | p2!=arena+192)
+		{
+		printf("\nworkspace arena: allocations not in stack order on cache line boundaries\n");
+		n_fail++;
+		}
+	// p1 releases also p2
+	blasfeo_blas_workspace_free(p1);
+	p3 = blasfeo_blas_workspace_malloc(8);
+	if(p3!=arena+128 | blasfeo_blas_workspace_peak()!=256)
+		{
+		printf("\nworkspace arena: free does not release the later allocations\n");
+		n_fail++;
+		}
+	// p0 releases everything: the whole arena fits, one more byte does not
+	blasfeo_blas_workspace_free(p0);
+	p0 = blasfeo_blas_workspace_malloc(arena_size);
+	p1 = blasfeo_blas_workspace_malloc(1);
+	if(p0!=arena | (p1>=arena & p1<arena+arena_size) | blasfeo_blas_workspace_peak()!=arena_size+64)
+		{
+		printf("\nworkspace arena: no malloc fallback when exhausted\n");
+		n_fail++;
+		}
+	memset(p1, 0, 1);
+	blasfeo_blas_workspace_free(p1);
+	blasfeo_blas_workspace_free(p0);
+	// unset
+	blasfeo_blas_workspace_set(NULL, 0);
+	p0 = blasfeo_blas_workspace_malloc(16);
+	if(p0>=arena & p0<arena+arena_size)
+		{
+		printf("\nworkspace arena: used after being unset\n");
+		n_fail++;
+		}
+	memset(p0, 0, 16);
+	blasfeo_blas_workspace_free(p0);
+	blasfeo_free_align(arena);
+
+	// coverage of blasfeo_blas_workspace_size
+	for(is=0; is<5; is++)
+		{
+		m = sizes[is][0];
+		n = sizes[is][1];
+		k = sizes[is][2];
+		mn = m<n ? m : n;
+		size = blasfeo_blas_workspace_size(m, n, k);
+		blasfeo_malloc_align((void **) &arena, size>0 ? size : 64);
+
+		lda = (m>k ? m : k) + 1;
+		ldb = (n>k ? n : k) + 3;
+		ldc = m + 2;
+		A = malloc(lda*(m>k ? m : k)*sizeof(double));
+		B = malloc(ldb*(n>k ? n : k)*sizeof(double));
+		C0 = malloc(ldc*n*sizeof(double));
+		C1 = malloc(ldc*n*sizeof(double));
+		C2 = malloc(ldc*n*sizeof(double));
+		LU1 = malloc(ldc*n*sizeof(double));
+		LU2 = malloc(ldc*n*sizeof(double));
+		ipiv1 = malloc(mn*sizeof(int));
+		ipiv2 = malloc(mn*sizeof(int));
+		for(ii=0; ii<lda*(m>k ? m : k); ii++)
+			A[ii] = test_rnd();
+		for(ii=0; ii<ldb*(n>k ? n : k); ii++)
+			B[ii] = test_rnd();
+		for(ii=0; ii<ldc*n; ii++)
+			C0[ii] = test_rnd();
+
+		for(it=0; it<2; it++)
+			{
+			blasfeo_set_num_threads(nts[it]);
+
+			for(tr=0; tr<4; tr++)
+				{
+				ta = tr&2 ? 'T' : 'N';
+				tb = tr&1 ? 'T' : 'N';
+				memcpy(C1, C0, ldc*n*sizeof(double));
+				memcpy(C2, C0, ldc*n*sizeof(double));
+				blasfeo_blas_workspace_set(NULL, 0);
+				blasfeo_dgemm(&ta, &tb, &m, &n, &k, &alpha, A, &lda, B, &ldb, &beta, C1, &ldc);
+				blasfeo_blas_workspace_set(arena, size);
+				blasfeo_dgemm(&ta, &tb, &m, &n, &k, &alpha, A, &lda, B, &ldb, &beta, C2, &ldc);
+				peak = blasfeo_blas_workspace_peak();
+				blasfeo_blas_workspace_set(NULL, 0);
+				err = 0.0;
+				for(ii=0; ii<ldc*n; ii++)
+					err = fmax(err, fabs(C1[ii]-C2[ii]));
+				if(peak>size | err>1e-13*k)
+					{
+					printf("\ndgemm_%c%c: m=%d, n=%d, k=%d, threads=%d, arena %zu, peak use %zu, error %e\n", ta, tb, m, n, k, nts[it], size, peak, err);
+					n_fail++;
+					}
+				// the packing buffers of the largest sizes do not fit on the stack
+				if(is==4 & peak==0)
+					{
+					printf("\ndgemm_%c%c: m=%d, n=%d, k=%d, threads=%d, arena not used\n", ta, tb, m, n, k, nts[it]);
+					n_fail++;
+					}
+				}
+
+			// dgetrf of the m x min(m,n) block of C0
+			memcpy(LU1, C0, ldc*n*sizeof(double));
+			memcpy(LU2, C0, ldc*n*sizeof(double));
+			blasfeo_blas_workspace_set(NULL, 0);
+			blasfeo_dgetrf(&m, &mn, LU1, &ldc, ipiv1, &info);
+			blasfeo_blas_workspace_set(arena, size);
+			blasfeo_dgetrf(&m, &mn, LU2, &ldc, ipiv2, &info);
+			peak = blasfeo_blas_workspace_peak();
+			blasfeo_blas_workspace_set(NULL, 0);
+			err = 0.0;
+			for(ii=0; ii<ldc*n; ii++)
+				err = fmax(err, fabs(LU1[ii]-LU2[ii]));
+			for(ii=0; ii<mn; ii++)
+				if(ipiv1[ii]!=ipiv2[ii])
+					err = INFINITY;
+			if(peak>size | err>1e-13*m)
+				{
+				printf("\ndgetrf: m=%d, n=%d, threads=%d, arena %zu, peak use %zu, error %e\n", m, mn, nts[it], size, peak, err);
+				n_fail++;
+				}
+			if(is==4 & peak==0)
+				{
+				printf("\ndgetrf: m=%d, n=%d, threads=%d, arena not used\n", m, mn, nts[it]);
+				n_fail++;
+				}
+			}
+
+		free(A);
+		free(B);
+		free(C0);
+		free(C1);
+		free(C2);
+		free(LU1);
+		free(LU2);
+		free(ipiv1);
+		free(ipiv2);
+		blasfeo_free_align(arena);
+		}
+
+	blasfeo_set_num_threads(1);
+
+	return test_report("BLAS API workspace arena", n_fail);
+
+	}
@@ -0,0 +1,177 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "../include/blasfeo_common.h"
+#include "../include/blasfeo_d_aux_ext_dep.h"
+#include "../include/blasfeo_d_aux.h"
+#include "../include/blasfeo_d_blas.h"
+#include "../include/blasfeo_thread.h"
+
+#include "test_residual.h"
+
+
+
+// residual of the block tridiagonal Cholesky factorization dbtrf and solve dbtrs: A * x = b with N blocks of size nx,
+// in sequential and cyclic reduction mode, the latter on 1 and 4 threads (with MULTI_THREAD=1, otherwise serial)
+int main()
+	{
+
+	int Ns[] = {1, 2, 3, 5, 8, 13};
+	int nxs[] = {1, 4, 7, 40};
+	int nts[] = {1, 4};
+
+	int ii, jj, ll, kk, iN, ix, mode, it;
+	int N, nx;
+	double res, tmp;
+	int n_fail = 0;
+
+	struct blasfeo_dmat **sD, **sE, **sLD, **sLE;
+	struct blasfeo_dvec **sb, **sx;
+	void *work;
+
+	for(mode=0; mode<2; mode++)
+	for(it=0; it<(mode==BLASFEO_BTRF_CR ? 2 : 1); it++)
+	for(iN=0; iN<6; iN++)
+	for(ix=0; ix<4; ix++)
+		{
+		N = Ns[iN];
+		nx = nxs[ix];
+		blasfeo_set_num_threads(nts[it]);
+
+		sD = malloc(N*sizeof(struct blasfeo_dmat *));
+		sE = malloc(N*sizeof(struct blasfeo_dmat *));
+		sLD = malloc(N*sizeof(struct blasfeo_dmat *));
+		sLE = malloc(2*N*sizeof(struct blasfeo_dmat *));
+		sb = malloc(N*sizeof(struct blasfeo_dvec *));
+		sx = malloc(N*sizeof(struct blasfeo_dvec *));
+
+		// symmetric positive definite: the diagonal blocks dominate the row sums of the off-diagonal ones
+		for(kk=0; kk<N; kk++)
+			{
+			sD[kk] = malloc(sizeof(struct blasfeo_dmat));
+			sLD[kk] = malloc(sizeof(struct blasfeo_dmat));
+			sb[kk] = malloc(sizeof(struct blasfeo_dvec));
+			sx[kk] = malloc(sizeof(struct blasfeo_dvec));
+			blasfeo_allocate_dmat(nx, nx, sD[kk]);
+			blasfeo_allocate_dmat(nx, nx, sLD[kk]);
+			blasfeo_allocate_dvec(nx, sb[kk]);
+			blasfeo_allocate_dvec(nx, sx[kk]);
+			for(jj=0; jj<nx; jj++)
+				for(ii=jj; ii<nx; ii++)
+					{
+					tmp = test_rnd() + (ii==jj ? 3.0*nx : 0.0);
+					blasfeo_dgein1(tmp, sD[kk], ii, jj);
+					blasfeo_dgein1(tmp, sD[kk], jj, ii);
+					}
+			for(ii=0; ii<nx; ii++)
+				blasfeo_dvecin1(test_rnd(), sb[kk], ii);
+			}
+		for(kk=0; kk<2*(N-1); kk++)
+			{
+			sLE[kk] = malloc(sizeof(struct blasfeo_dmat));
+			blasfeo_allocate_dmat(nx, nx, sLE[kk]);
+			}
+		for(kk=0; kk<N-1; kk++)
+			{
+			sE[kk] = malloc(sizeof(struct blasfeo_dmat));
+			blasfeo_allocate_dmat(nx, nx, sE[kk]);
+			test_d_rnd_mat(nx, nx, sE[kk], 0, 0);
+			}
+
+		work = malloc(blasfeo_dbtrf_worksize(N, nx, mode));
+		blasfeo_dbtrf(N, nx, sD, sE, sLD, sLE, mode, work);
+		blasfeo_dbtrs(N, nx, sLD, sLE, sb, sx, mode);
+		free(work);
+
+		// row block kk of A * x - b: E[kk-1] * x[kk-1] + D[kk] * x[kk] + E[kk]^T * x[kk+1] - b[kk]
+		res = 0.0;
+		for(kk=0; kk<N; kk++)
+			for(ii=0; ii<nx; ii++)
+				{
+				tmp = -blasfeo_dvecex1(sb[kk], ii);
+				for(ll=0; ll<nx; ll++)
+					{
+					tmp += blasfeo_dgeex1(sD[kk], ii, ll) * blasfeo_dvecex1(sx[kk], ll);
+					if(kk>0)
+						tmp += blasfeo_dgeex1(sE[kk-1], ii, ll) * blasfeo_dvecex1(sx[kk-1], ll);
+					if(kk<N-1)
+						tmp += blasfeo_dgeex1(sE[kk], ll, ii) * blasfeo_dvecex1(sx[kk+1], ll);
+					}
+				res = fmax(res, fabs(tmp));
+				}
+		if(res>1e-12*nx)
+			{
+			printf("\ndbtrf: N=%d, nx=%d, mode=%s, threads=%d, residual %e\n", N, nx, mode==BLASFEO_BTRF_CR ? "CR" : "SEQ", nts[it], res);
+			n_fail++;
+			}
+
+		for(kk=0; kk<N; kk++)
+			{
+			blasfeo_free_dmat(sD[kk]);
+			blasfeo_free_dmat(sLD[kk]);
+			blasfeo_free_dvec(sb[kk]);
+			blasfeo_free_dvec(sx[kk]);
+			free(sD[kk]);
+			free(sLD[kk]);
+			free(sb[kk]);
+			free(sx[kk]);
+			}
+		for(kk=0; kk<2*(N-1); kk++)
+			{
+			blasfeo_free_dmat(sLE[kk]);
+			free(sLE[kk]);
+			}
+		for(kk=0; kk<N-1; kk++)
+			{
+			blasfeo_free_dmat(sE[kk]);
+			free(sE[kk]);
+			}
+		free(sD);
+		free(sE);
+		free(sLD);
+		free(sLE);
+		free(sb);
+		free(sx);
+		}
+
+	blasfeo_set_num_threads(1);
+
+	return test_report("block tridiagonal", n_fail);
+
+	}
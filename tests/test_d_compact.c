@@ -0,0 +1,233 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "../include/blasfeo_common.h"
+#include "../include/blasfeo_d_aux_ext_dep.h"
+#include "../include/blasfeo_d_aux.h"
+#include "../include/blasfeo_d_blas.h"
+#include "../include/blasfeo_stdlib.h"
+
+#include "test_residual.h"
+
+
+
+#define NMAX 16 // largest size of the operands
+#define OFF 2 // offset of the operands in the batches
+
+
+
+// pack and unpack of the interleaved batch ("compact") at lane dependent offsets, and the compact routines, one
+// matrix per lane, against the dmat routines on each lane: the
+// operands are packed from dmats, and read back from the batch; sizes across the 4x3 tiles
+// of the kernel, beta zero and nonzero; the entries of D out of the result (the upper triangle for syrk and potrf)
+// must not be written
+int main()
+	{
+
+	int mnks[][3] = {{1, 1, 1}, {2, 3, 1}, {3, 2, 4}, {4, 3, 5}, {5, 4, 3}, {7, 6, 8}, {8, 9, 2}, {13, 11, 16}, {16, 16, 0}};
+	char *names[] = {"gemm_nn", "gemm_nt", "syrk_ln", "trsm_llnn", "trsm_llnu", "trsm_lltn", "trsm_lunn", "trsm_rltn", "potrf_l", "getrf_np"};
+	int n_op = 10;
+	int offs[BLASFEO_DMAT_BATCH_LANES];
+	const int nl = BLASFEO_DMAT_BATCH_LANES;
+
+	int ii, jj, ll, imnk, op, ib;
+	int m, n, k, lower;
+	double alpha, beta, err, ref, tmp;
+	int n_fail = 0;
+
+	struct blasfeo_dmat sA[BLASFEO_DMAT_BATCH_LANES], sB[BLASFEO_DMAT_BATCH_LANES], sC[BLASFEO_DMAT_BATCH_LANES], sD[BLASFEO_DMAT_BATCH_LANES], sR[BLASFEO_DMAT_BATCH_LANES];
+	struct blasfeo_dmat *pA[BLASFEO_DMAT_BATCH_LANES], *pB[BLASFEO_DMAT_BATCH_LANES], *pC[BLASFEO_DMAT_BATCH_LANES], *pR[BLASFEO_DMAT_BATCH_LANES];
+	struct blasfeo_dmat_batch bA, bB, bC, bD;
+	void *mem_A, *mem_B, *mem_C, *mem_D;
+
+	for(ll=0; ll<nl; ll++)
+		{
+		offs[ll] = ll;
+		blasfeo_allocate_dmat(NMAX+nl, NMAX+nl, sA+ll);
+		blasfeo_allocate_dmat(NMAX+nl, NMAX+nl, sB+ll);
+		blasfeo_allocate_dmat(NMAX+nl, NMAX+nl, sC+ll);
+		blasfeo_allocate_dmat(NMAX+nl, NMAX+nl, sD+ll);
+		blasfeo_allocate_dmat(NMAX+nl, NMAX+nl, sR+ll);
+		pA[ll] = sA+ll;
+		pB[ll] = sB+ll;
+		pC[ll] = sC+ll;
+		pR[ll] = sR+ll;
+		}
+	blasfeo_malloc_align(&mem_A, blasfeo_memsize_dmat_batch(NMAX+OFF, NMAX+OFF));
+	blasfeo_malloc_align(&mem_B, blasfeo_memsize_dmat_batch(NMAX+OFF, NMAX+OFF));
+	blasfeo_malloc_align(&mem_C, blasfeo_memsize_dmat_batch(NMAX+OFF, NMAX+OFF));
+	blasfeo_malloc_align(&mem_D, blasfeo_memsize_dmat_batch(NMAX+OFF, NMAX+OFF));
+	blasfeo_create_dmat_batch(NMAX+OFF, NMAX+OFF, &bA, mem_A);
+	blasfeo_create_dmat_batch(NMAX+OFF, NMAX+OFF, &bB, mem_B);
+	blasfeo_create_dmat_batch(NMAX+OFF, NMAX+OFF, &bC, mem_C);
+	blasfeo_create_dmat_batch(NMAX+OFF, NMAX+OFF, &bD, mem_D);
+
+	// pack and unpack, at lane dependent offsets
+	for(ll=0; ll<nl; ll++)
+		test_d_rnd_mat(NMAX, NMAX, sA+ll, ll, ll);
+	blasfeo_pack_dmat_batch(NMAX, NMAX, pA, offs, offs, &bA, OFF, OFF);
+	err = 0.0;
+	for(ll=0; ll<nl; ll++)
+		for(jj=0; jj<NMAX; jj++)
+			for(ii=0; ii<NMAX; ii++)
+				err = fmax(err, fabs(BLASFEO_DMAT_BATCH_EL(&bA, OFF+ii, OFF+jj, ll) - blasfeo_dgeex1(sA+ll, ll+ii, ll+jj)));
+	blasfeo_unpack_dmat_batch(NMAX, NMAX, &bA, OFF, OFF, pR, NULL, NULL);
+	for(ll=0; ll<nl; ll++)
+		for(jj=0; jj<NMAX; jj++)
+			for(ii=0; ii<NMAX; ii++)
+				err = fmax(err, fabs(blasfeo_dgeex1(sR+ll, ii, jj) - blasfeo_dgeex1(sA+ll, ll+ii, ll+jj)));
+	if(err!=0.0)
+		{
+		printf("\npack/unpack_dmat_batch: error %e\n", err);
+		n_fail++;
+		}
+
+	for(op=0; op<n_op; op++)
+	for(imnk=0; imnk<9; imnk++)
+	for(ib=0; ib<2; ib++)
+		{
+		m = mnks[imnk][0];
+		n = mnks[imnk][1];
+		k = mnks[imnk][2];
+		alpha = ib==0 ? 1.25 : -0.5;
+		beta = ib==0 ? 0.0 : 0.75;
+		// A diagonally dominant for the triangular solves, C symmetric and diagonally dominant for the factorizations
+		for(ll=0; ll<nl; ll++)
+			{
+			test_d_rnd_mat(NMAX, NMAX, sA+ll, 0, 0);
+			test_d_rnd_mat(NMAX, NMAX, sB+ll, 0, 0);
+			test_d_rnd_mat(NMAX, NMAX, sC+ll, 0, 0);
+			for(jj=0; jj<NMAX; jj++)
+				{
+				blasfeo_dgein1(4.0+ll, sA+ll, jj, jj);
+				for(ii=0; ii<jj; ii++)
+					blasfeo_dgein1(blasfeo_dgeex1(sC+ll, jj, ii), sC+ll, ii, jj);
+				blasfeo_dgein1(NMAX+1.0, sC+ll, jj, jj);
+				}
+			}
+		blasfeo_pack_dmat_batch(NMAX, NMAX, pA, NULL, NULL, &bA, OFF, OFF);
+		blasfeo_pack_dmat_batch(NMAX, NMAX, pB, NULL, NULL, &bB, OFF, OFF);
+		blasfeo_pack_dmat_batch(NMAX, NMAX, pC, NULL, NULL, &bC, OFF, OFF);
+		for(ii=0; ii<nl*(NMAX+OFF)*(NMAX+OFF); ii++)
+			bD.pA[ii] = -7.0;
+
+		lower = op==2 | op==8;
+		if(lower)
+			n = m;
+		// the dmat routines need aligned operands
+		ii = 0;
+		for(ll=0; ll<nl; ll++)
+			{
+			switch(op)
+				{
+				case 0: blasfeo_dgemm_nn(m, n, k, alpha, sA+ll, ii, ii, sB+ll, ii, ii, beta, sC+ll, ii, ii, sD+ll, 0, 0); break;
+				case 1: blasfeo_dgemm_nt(m, n, k, alpha, sA+ll, ii, ii, sB+ll, ii, ii, beta, sC+ll, ii, ii, sD+ll, 0, 0); break;
+				case 2: blasfeo_dsyrk_ln(m, k, alpha, sA+ll, ii, ii, sB+ll, ii, ii, beta, sC+ll, ii, ii, sD+ll, 0, 0); break;
+				case 3: blasfeo_dtrsm_llnn(m, n, alpha, sA+ll, ii, ii, sB+ll, ii, ii, sD+ll, 0, 0); break;
+				case 4: blasfeo_dtrsm_llnu(m, n, alpha, sA+ll, ii, ii, sB+ll, ii, ii, sD+ll, 0, 0); break;
+				// lltn is not implemented by the dmat routines, and lunn and rltn only for alpha=1: solve with the
+				// (transposed) upper factor and scale afterwards
+				case 5:
+					blasfeo_dgetr(m, m, sA+ll, ii, ii, sR+ll, 0, 0);
+					blasfeo_dtrsm_lunn(m, n, 1.0, sR+ll, 0, 0, sB+ll, ii, ii, sD+ll, 0, 0);
+					blasfeo_dgesc(m, n, alpha, sD+ll, 0, 0);
+					break;
+				case 6:
+					blasfeo_dtrsm_lunn(m, n, 1.0, sA+ll, ii, ii, sB+ll, ii, ii, sD+ll, 0, 0);
+					blasfeo_dgesc(m, n, alpha, sD+ll, 0, 0);
+					break;
+				case 7:
+					blasfeo_dtrsm_rltn(m, n, 1.0, sA+ll, ii, ii, sB+ll, ii, ii, sD+ll, 0, 0);
+					blasfeo_dgesc(m, n, alpha, sD+ll, 0, 0);
+					break;
+				case 8: blasfeo_dpotrf_l(m, sC+ll, ii, ii, sD+ll, 0, 0); break;
+				default: blasfeo_dgetrf_np(m, n, sC+ll, ii, ii, sD+ll, 0, 0); break;
+				}
+			}
+		switch(op)
+			{
+			case 0: blasfeo_dgemm_nn_compact(m, n, k, alpha, &bA, OFF, OFF, &bB, OFF, OFF, beta, &bC, OFF, OFF, &bD, OFF, OFF); break;
+			case 1: blasfeo_dgemm_nt_compact(m, n, k, alpha, &bA, OFF, OFF, &bB, OFF, OFF, beta, &bC, OFF, OFF, &bD, OFF, OFF); break;
+			case 2: blasfeo_dsyrk_ln_compact(m, k, alpha, &bA, OFF, OFF, &bB, OFF, OFF, beta, &bC, OFF, OFF, &bD, OFF, OFF); break;
+			case 3: blasfeo_dtrsm_llnn_compact(m, n, alpha, &bA, OFF, OFF, &bB, OFF, OFF, &bD, OFF, OFF); break;
+			case 4: blasfeo_dtrsm_llnu_compact(m, n, alpha, &bA, OFF, OFF, &bB, OFF, OFF, &bD, OFF, OFF); break;
+			case 5: blasfeo_dtrsm_lltn_compact(m, n, alpha, &bA, OFF, OFF, &bB, OFF, OFF, &bD, OFF, OFF); break;
+			case 6: blasfeo_dtrsm_lunn_compact(m, n, alpha, &bA, OFF, OFF, &bB, OFF, OFF, &bD, OFF, OFF); break;
+			case 7: blasfeo_dtrsm_rltn_compact(m, n, alpha, &bA, OFF, OFF, &bB, OFF, OFF, &bD, OFF, OFF); break;
+			case 8: blasfeo_dpotrf_l_compact(m, &bC, OFF, OFF, &bD, OFF, OFF); break;
+			default: blasfeo_dgetrf_np_compact(m, n, &bC, OFF, OFF, &bD, OFF, OFF); break;
+			}
+
+		err = 0.0;
+		for(ll=0; ll<nl; ll++)
+			for(jj=0; jj<NMAX+OFF; jj++)
+				for(ii=0; ii<NMAX+OFF; ii++)
+					{
+					tmp = BLASFEO_DMAT_BATCH_EL(&bD, ii, jj, ll);
+					if(ii>=OFF & ii<OFF+m & jj>=OFF & jj<OFF+n & (!lower | ii>=jj))
+						{
+						ref = blasfeo_dgeex1(sD+ll, ii-OFF, jj-OFF);
+						err = fmax(err, fabs(tmp-ref) / (1.0+fabs(ref)));
+						}
+					else if(tmp!=-7.0)
+						err = INFINITY;
+					}
+		if(err>1e-13)
+			{
+			printf("\nd%s_compact: m=%d, n=%d, k=%d, beta=%f, error %e\n", names[op], m, n, k, beta, err);
+			n_fail++;
+			}
+		}
+
+	blasfeo_free_align(mem_A);
+	blasfeo_free_align(mem_B);
+	blasfeo_free_align(mem_C);
+	blasfeo_free_align(mem_D);
+	for(ll=0; ll<nl; ll++)
+		{
+		blasfeo_free_dmat(sA+ll);
+		blasfeo_free_dmat(sB+ll);
+		blasfeo_free_dmat(sC+ll);
+		blasfeo_free_dmat(sD+ll);
+		blasfeo_free_dmat(sR+ll);
+		}
+
+	return test_report("compact batch", n_fail);
+
+	}
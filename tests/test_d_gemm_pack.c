@@ -0,0 +1,179 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "../include/blasfeo_common.h"
+#include "../include/blasfeo_d_blas_api.h"
+
+#include "test_residual.h"
+
+
+
+#if defined(FORTRAN_BLAS_API)
+#define blasfeo_dgemm_pack_get_size dgemm_pack_get_size_
+#define blasfeo_dgemm_pack dgemm_pack_
+#define blasfeo_dgemm_compute dgemm_compute_
+#endif
+
+
+
+// bytes after the handle that dgemm_pack must not touch
+#define GUARD 64
+
+
+
+// residual of the BLAS API dgemm with pre-packed operands: A and/or B are packed with dgemm_pack ('A' and 'B' handles,
+// both transposes, alpha folded in at pack time) and dgemm_compute is called with the packed ones as 'P' and the others
+// column-major, C = alpha_A * alpha_B * op(A) * op(B) + beta * C; checks the rows of C below m (ldc>m) and the bytes after
+// the handles are not written; k above the stack limit of the packed block of the unpacked operand
+int main()
+	{
+
+	int sizes[][3] = {{1, 1, 1}, {5, 3, 7}, {13, 9, 4}, {37, 29, 41}, {20, 15, 1100}};
+	char trans[] = {'N', 'T'};
+	double alpha_a = 1.5;
+	double alpha_b = -0.75;
+	double beta = 0.5;
+
+	int ii, jj, ll, is, ta, tb, mode, pa, pb, size_a, size_b;
+	int m, n, k, lda, ldb, ldc;
+	double *A, *B, *C, *C0, *D;
+	char *hA, *hB;
+	char ca, cb;
+	double tmp, alpha, err, nrm;
+	int n_fail = 0;
+
+	for(is=0; is<5; is++)
+		{
+		m = sizes[is][0];
+		n = sizes[is][1];
+		k = sizes[is][2];
+		ldc = m+2;
+		C0 = malloc(ldc*n*sizeof(double));
+		C = malloc(ldc*n*sizeof(double));
+		D = malloc(m*n*sizeof(double));
+		for(ii=0; ii<ldc*n; ii++)
+			C0[ii] = test_rnd();
+
+		for(ta=0; ta<2; ta++)
+		for(tb=0; tb<2; tb++)
+			{
+			// op(A) m x k, op(B) k x n, leading dimensions with some padding
+			lda = (ta ? k : m) + 1;
+			ldb = (tb ? n : k) + 3;
+			A = malloc(lda*(ta ? m : k)*sizeof(double));
+			B = malloc(ldb*(tb ? k : n)*sizeof(double));
+			for(ii=0; ii<lda*(ta ? m : k); ii++)
+				A[ii] = test_rnd();
+			for(ii=0; ii<ldb*(tb ? k : n); ii++)
+				B[ii] = test_rnd();
+
+			size_a = blasfeo_dgemm_pack_get_size("A", &m, &n, &k);
+			size_b = blasfeo_dgemm_pack_get_size("B", &m, &n, &k);
+			hA = malloc(size_a+GUARD);
+			hB = malloc(size_b+GUARD);
+			memset(hA, 0x5a, size_a+GUARD);
+			memset(hB, 0x5a, size_b+GUARD);
+			blasfeo_dgemm_pack("A", trans+ta, &m, &n, &k, &alpha_a, A, &lda, hA);
+			blasfeo_dgemm_pack("B", trans+tb, &m, &n, &k, &alpha_b, B, &ldb, hB);
+			for(ii=0; ii<GUARD; ii++)
+				{
+				if(hA[size_a+ii]!=0x5a | hB[size_b+ii]!=0x5a)
+					{
+					printf("\ndgemm_pack: m=%d, n=%d, k=%d, trans=%c%c, written past the size of the handle\n", m, n, k, trans[ta], trans[tb]);
+					n_fail++;
+					break;
+					}
+				}
+
+			// reference op(A) * op(B)
+			for(jj=0; jj<n; jj++)
+				for(ii=0; ii<m; ii++)
+					{
+					tmp = 0.0;
+					for(ll=0; ll<k; ll++)
+						tmp += (ta ? A[ll+lda*ii] : A[ii+lda*ll]) * (tb ? B[jj+ldb*ll] : B[ll+ldb*jj]);
+					D[ii+m*jj] = tmp;
+					}
+
+			// mode: bit 0 packed A, bit 1 packed B
+			for(mode=0; mode<4; mode++)
+				{
+				pa = mode&1;
+				pb = (mode>>1)&1;
+				ca = pa ? 'P' : trans[ta];
+				cb = pb ? 'P' : trans[tb];
+				alpha = (pa ? alpha_a : 1.0) * (pb ? alpha_b : 1.0);
+				memcpy(C, C0, ldc*n*sizeof(double));
+				blasfeo_dgemm_compute(&ca, &cb, &m, &n, &k, pa ? (double *) hA : A, &lda, pb ? (double *) hB : B, &ldb, &beta, C, &ldc);
+				err = 0.0;
+				nrm = 0.0;
+				for(jj=0; jj<n; jj++)
+					{
+					for(ii=0; ii<m; ii++)
+						{
+						tmp = alpha*D[ii+m*jj] + beta*C0[ii+ldc*jj];
+						err = fmax(err, fabs(C[ii+ldc*jj] - tmp));
+						nrm = fmax(nrm, fabs(tmp));
+						}
+					for(; ii<ldc; ii++)
+						if(C[ii+ldc*jj]!=C0[ii+ldc*jj])
+							err = INFINITY;
+					}
+				if(err>1e-15*k*(1.0+nrm))
+					{
+					printf("\ndgemm_compute: m=%d, n=%d, k=%d, ta=%c, tb=%c, error %e\n", m, n, k, ca, cb, err);
+					n_fail++;
+					}
+				}
+
+			free(A);
+			free(B);
+			free(hA);
+			free(hB);
+			}
+
+		free(C0);
+		free(C);
+		free(D);
+		}
+
+	return test_report("dgemm pack/compute", n_fail);
+
+	}
@@ -0,0 +1,153 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "../include/blasfeo_common.h"
+#include "../include/blasfeo_d_aux_ext_dep.h"
+#include "../include/blasfeo_d_aux.h"
+#include "../include/blasfeo_d_blas.h"
+#include "../include/blasfeo_jit.h"
+
+#include "test_residual.h"
+
+
+
+// residual of the small dgemm_nn, dgemm_nt and dsyrk_ln with the kernels generated at run-time (JIT=1, otherwise
+// blasfeo_jit_dgemm does nothing and only the blasfeo_api routines are checked), called both directly and through
+// the blasfeo_api routines; the kernels are released with blasfeo_jit_free and generated again in a second pass
+int main()
+	{
+
+	int ms[] = {1, 3, 4, 5, 8, 11, 12, 16, 24};
+	int ks[] = {1, 2, 7, 24};
+	int offs[][2] = {{0, 0}, {4, 1}};
+	double betas[] = {0.0, 0.5};
+
+	int ii, jj, ll, im, in, ik, io, ib, type, pass, api;
+	int m, n, k, ai, aj;
+	double beta, res, tmp;
+	int n_fail = 0;
+
+	struct blasfeo_dmat sA, sB, sC, sD;
+
+	for(pass=0; pass<2; pass++)
+		{
+		for(type=0; type<3; type++)
+		for(im=0; im<9; im++)
+		for(in=0; in<9; in++)
+		for(ik=0; ik<4; ik++)
+		for(io=0; io<2; io++)
+		for(ib=0; ib<2; ib++)
+		for(api=0; api<2; api++)
+			{
+			m = ms[im];
+			n = type==BLASFEO_JIT_DSYRK_LN ? m : ms[in];
+			k = ks[ik];
+			ai = offs[io][0];
+			aj = offs[io][1];
+			beta = betas[ib];
+			if(type==BLASFEO_JIT_DSYRK_LN & in>0)
+				continue;
+
+			blasfeo_allocate_dmat(ai+m, aj+k, &sA);
+			blasfeo_allocate_dmat(type==BLASFEO_JIT_DGEMM_NN ? ai+k : ai+n, type==BLASFEO_JIT_DGEMM_NN ? aj+n : aj+k, &sB);
+			blasfeo_allocate_dmat(ai+m, aj+n, &sC);
+			blasfeo_allocate_dmat(ai+m, aj+n, &sD);
+			test_d_rnd_mat(sA.m, sA.n, &sA, 0, 0);
+			test_d_rnd_mat(sB.m, sB.n, &sB, 0, 0);
+			test_d_rnd_mat(sC.m, sC.n, &sC, 0, 0);
+			// the strictly upper part of dsyrk_ln must be left untouched
+			blasfeo_dgese(ai+m, aj+n, 7.0, &sD, 0, 0);
+
+			if(api)
+				{
+				if(type==BLASFEO_JIT_DGEMM_NN)
+					blasfeo_dgemm_nn(m, n, k, 1.5, &sA, ai, aj, &sB, ai, aj, beta, &sC, ai, aj, &sD, ai, aj);
+				else if(type==BLASFEO_JIT_DGEMM_NT)
+					blasfeo_dgemm_nt(m, n, k, 1.5, &sA, ai, aj, &sB, ai, aj, beta, &sC, ai, aj, &sD, ai, aj);
+				else
+					blasfeo_dsyrk_ln(m, k, 1.5, &sA, ai, aj, &sB, ai, aj, beta, &sC, ai, aj, &sD, ai, aj);
+				}
+			else if(!blasfeo_jit_dgemm(type, m, n, k, 1.5, &sA, ai, aj, &sB, ai, aj, beta, &sC, ai, aj, &sD, ai, aj))
+				{
+				// no kernel for these sizes, or JIT not available
+				blasfeo_free_dmat(&sA);
+				blasfeo_free_dmat(&sB);
+				blasfeo_free_dmat(&sC);
+				blasfeo_free_dmat(&sD);
+				continue;
+				}
+
+			res = 0.0;
+			for(jj=0; jj<n; jj++)
+				for(ii=0; ii<m; ii++)
+					{
+					if(type==BLASFEO_JIT_DSYRK_LN & ii<jj)
+						{
+						res = fmax(res, fabs(7.0 - blasfeo_dgeex1(&sD, ai+ii, aj+jj)));
+						continue;
+						}
+					tmp = beta*blasfeo_dgeex1(&sC, ai+ii, aj+jj);
+					for(ll=0; ll<k; ll++)
+						tmp += 1.5 * blasfeo_dgeex1(&sA, ai+ii, aj+ll) *
+							(type==BLASFEO_JIT_DGEMM_NN ? blasfeo_dgeex1(&sB, ai+ll, aj+jj) : blasfeo_dgeex1(&sB, ai+jj, aj+ll));
+					res = fmax(res, fabs(tmp - blasfeo_dgeex1(&sD, ai+ii, aj+jj)));
+					}
+			if(res>1e-12*k)
+				{
+				printf("\n%s%s: m=%d, n=%d, k=%d, offset=(%d,%d), beta=%f, pass=%d, residual %e\n", api ? "blasfeo_" : "blasfeo_jit_", type==BLASFEO_JIT_DGEMM_NN ? "dgemm_nn" : type==BLASFEO_JIT_DGEMM_NT ? "dgemm_nt" : "dsyrk_ln", m, n, k, ai, aj, beta, pass, res);
+				n_fail++;
+				}
+
+			blasfeo_free_dmat(&sA);
+			blasfeo_free_dmat(&sB);
+			blasfeo_free_dmat(&sC);
+			blasfeo_free_dmat(&sD);
+			}
+
+		blasfeo_jit_free();
+		if(blasfeo_jit_kernel_count()!=0)
+			{
+			printf("\nblasfeo_jit_free: %d kernels left\n", blasfeo_jit_kernel_count());
+			n_fail++;
+			}
+		}
+
+	return test_report("JIT", n_fail);
+
+	}
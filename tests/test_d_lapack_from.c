@@ -0,0 +1,134 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "../include/blasfeo_common.h"
+#include "../include/blasfeo_d_aux_ext_dep.h"
+#include "../include/blasfeo_d_aux.h"
+#include "../include/blasfeo_d_blas.h"
+
+#include "test_residual.h"
+
+
+
+// residual of the partial refactorizations dpotrf_l_from and dgetrf_np_from: the matrix is first factorized with k=0,
+// then its trailing block is changed and only the trailing factors are recomputed; matrices at row and column offsets
+int main()
+	{
+
+	int ms[] = {1, 4, 7, 16, 33};
+	int offs[] = {0, 1, 3, 4, 5};
+
+	int ii, jj, ll, im, ik, io, lu;
+	int m, n, k, off;
+	double res, tmp;
+	int n_fail = 0;
+
+	struct blasfeo_dmat sC, sD;
+	void *work;
+
+	for(lu=0; lu<2; lu++)
+	for(im=0; im<5; im++)
+	for(ik=0; ik<4; ik++)
+	for(io=0; io<5; io++)
+		{
+		m = ms[im];
+		n = lu ? m+ik : m;
+		k = ik==0 ? 0 : ik==1 ? 1 : ik==2 ? m/2 : m-1;
+		off = offs[io];
+
+		// well conditioned matrix: diagonally dominant, symmetric for dpotrf_l
+		blasfeo_allocate_dmat(off+m, off+n, &sC);
+		blasfeo_allocate_dmat(off+m, off+n, &sD);
+		blasfeo_dgese(off+m, off+n, 0.0, &sC, 0, 0);
+		blasfeo_dgese(off+m, off+n, 0.0, &sD, 0, 0);
+		test_d_rnd_mat(m, n, &sC, off, off);
+		if(!lu)
+			for(jj=0; jj<m; jj++)
+				for(ii=0; ii<jj; ii++)
+					blasfeo_dgein1(blasfeo_dgeex1(&sC, off+ii, off+jj), &sC, off+jj, off+ii);
+		for(ii=0; ii<m; ii++)
+			blasfeo_dgein1(blasfeo_dgeex1(&sC, off+ii, off+ii)+m, &sC, off+ii, off+ii);
+
+		work = malloc(lu ? blasfeo_dgetrf_np_from_worksize(m, n, 0) : blasfeo_dpotrf_l_from_worksize(m, 0));
+		if(lu)
+			blasfeo_dgetrf_np_from(m, n, 0, &sC, off, off, &sD, off, 0, work);
+		else
+			blasfeo_dpotrf_l_from(m, 0, &sC, off, off, &sD, off, 0, work);
+		free(work);
+
+		// change the trailing block, keeping the matrix symmetric and diagonally dominant
+		for(jj=k; jj<n; jj++)
+			for(ii=k; ii<m; ii++)
+				blasfeo_dgein1(blasfeo_dgeex1(&sC, off+ii, off+jj)+0.25*(ii==jj), &sC, off+ii, off+jj);
+
+		work = malloc(lu ? blasfeo_dgetrf_np_from_worksize(m, n, k) : blasfeo_dpotrf_l_from_worksize(m, k));
+		if(lu)
+			blasfeo_dgetrf_np_from(m, n, k, &sC, off, off, &sD, off, 0, work);
+		else
+			blasfeo_dpotrf_l_from(m, k, &sC, off, off, &sD, off, 0, work);
+		free(work);
+
+		// C = L * L^T (lower part) or C = L * U, L unit lower
+		res = 0.0;
+		for(jj=0; jj<n; jj++)
+			for(ii=lu ? 0 : jj; ii<m; ii++)
+				{
+				tmp = 0.0;
+				for(ll=0; ll<=(ii<jj ? ii : jj); ll++)
+					{
+					if(lu)
+						tmp += (ll==ii ? 1.0 : blasfeo_dgeex1(&sD, off+ii, ll)) * blasfeo_dgeex1(&sD, off+ll, jj);
+					else
+						tmp += blasfeo_dgeex1(&sD, off+ii, ll) * blasfeo_dgeex1(&sD, off+jj, ll);
+					}
+				res = fmax(res, fabs(tmp - blasfeo_dgeex1(&sC, off+ii, off+jj)));
+				}
+		if(res>1e-12*m)
+			{
+			printf("\nd%s_from: m=%d, n=%d, k=%d, offset=%d, residual %e\n", lu ? "getrf_np" : "potrf_l", m, n, k, off, res);
+			n_fail++;
+			}
+
+		blasfeo_free_dmat(&sC);
+		blasfeo_free_dmat(&sD);
+		}
+
+	return test_report("partial refactorization", n_fail);
+
+	}
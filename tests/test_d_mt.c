@@ -0,0 +1,281 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "../include/blasfeo_common.h"
+#include "../include/blasfeo_d_aux_ext_dep.h"
+#include "../include/blasfeo_d_aux.h"
+#include "../include/blasfeo_d_blas.h"
+#include "../include/blasfeo_d_blas_api.h"
+#include "../include/blasfeo_thread.h"
+
+#include "test_residual.h"
+
+
+
+#if defined(FORTRAN_BLAS_API)
+#define blasfeo_dgemm dgemm_
+#endif
+
+
+
+// residual of the multi-threaded paths: dgemm_{nn,nt,tn,tt} on matrices large enough to be split over the threads,
+// dpotrf_l_mt and dgetrf_rp_mt large enough for the task scheduler; each call is repeated on 1 and 4 threads
+// (with MULTI_THREAD=1, otherwise both are serial), matrices at row and column offsets (only column offsets for the
+// factorizations, which do not support row offsets); the BLAS API dgemm on column-major matrices with padded leading
+// dimensions, split over rows and columns, only rows (n small) and only columns (m smaller than the kernel)
+int main()
+	{
+
+	int gs[][3] = {{130, 97, 70}, {200, 200, 200}};
+	int bs[][3] = {{130, 97, 70}, {200, 200, 200}, {700, 6, 300}, {3, 500, 600}};
+	int fs[][2] = {{250, 250}, {300, 210}, {210, 300}};
+	int offs[][2] = {{0, 0}, {0, 3}, {1, 2}};
+	int nts[] = {1, 4};
+
+	int ii, jj, ll, ig, io, it, tr, lu;
+	int m, n, k, ai, aj, mn;
+	int lda, ldb, ldc;
+	double res, tmp;
+	double *ref, *A, *B, *C, *C0;
+	char ta, tb;
+	double alpha = -0.75;
+	double beta = 0.5;
+	int *ipiv;
+	int n_fail = 0;
+
+	struct blasfeo_dmat sA, sB, sC, sD, sP;
+	void *work;
+
+	// dgemm: D = 0.5 * C + A^{(T)} * B^{(T)}
+	for(tr=0; tr<4; tr++)
+	for(ig=0; ig<2; ig++)
+	for(io=0; io<3; io++)
+		{
+		m = gs[ig][0];
+		n = gs[ig][1];
+		k = gs[ig][2];
+		ai = offs[io][0];
+		aj = offs[io][1];
+
+		blasfeo_allocate_dmat(ai+(tr&2 ? k : m), aj+(tr&2 ? m : k), &sA);
+		blasfeo_allocate_dmat(ai+(tr&1 ? n : k), aj+(tr&1 ? k : n), &sB);
+		blasfeo_allocate_dmat(ai+m, aj+n, &sC);
+		blasfeo_allocate_dmat(ai+m, aj+n, &sD);
+		test_d_rnd_mat(sA.m, sA.n, &sA, 0, 0);
+		test_d_rnd_mat(sB.m, sB.n, &sB, 0, 0);
+		test_d_rnd_mat(m, n, &sC, ai, aj);
+
+		ref = malloc(m*n*sizeof(double));
+		for(jj=0; jj<n; jj++)
+			for(ii=0; ii<m; ii++)
+				{
+				tmp = 0.5*blasfeo_dgeex1(&sC, ai+ii, aj+jj);
+				for(ll=0; ll<k; ll++)
+					tmp += (tr&2 ? blasfeo_dgeex1(&sA, ai+ll, aj+ii) : blasfeo_dgeex1(&sA, ai+ii, aj+ll)) *
+						(tr&1 ? blasfeo_dgeex1(&sB, ai+jj, aj+ll) : blasfeo_dgeex1(&sB, ai+ll, aj+jj));
+				ref[ii+m*jj] = tmp;
+				}
+
+		for(it=0; it<2; it++)
+			{
+			blasfeo_set_num_threads(nts[it]);
+			blasfeo_dgese(ai+m, aj+n, 0.0, &sD, 0, 0);
+			if(tr==0)
+				blasfeo_dgemm_nn(m, n, k, 1.0, &sA, ai, aj, &sB, ai, aj, 0.5, &sC, ai, aj, &sD, ai, aj);
+			else if(tr==1)
+				blasfeo_dgemm_nt(m, n, k, 1.0, &sA, ai, aj, &sB, ai, aj, 0.5, &sC, ai, aj, &sD, ai, aj);
+			else if(tr==2)
+				blasfeo_dgemm_tn(m, n, k, 1.0, &sA, ai, aj, &sB, ai, aj, 0.5, &sC, ai, aj, &sD, ai, aj);
+			else
+				blasfeo_dgemm_tt(m, n, k, 1.0, &sA, ai, aj, &sB, ai, aj, 0.5, &sC, ai, aj, &sD, ai, aj);
+			res = 0.0;
+			for(jj=0; jj<n; jj++)
+				for(ii=0; ii<m; ii++)
+					res = fmax(res, fabs(ref[ii+m*jj] - blasfeo_dgeex1(&sD, ai+ii, aj+jj)));
+			if(res>1e-12*k)
+				{
+				printf("\ndgemm_%s: m=%d, n=%d, k=%d, offset=(%d,%d), threads=%d, residual %e\n", tr==0 ? "nn" : tr==1 ? "nt" : tr==2 ? "tn" : "tt", m, n, k, ai, aj, nts[it], res);
+				n_fail++;
+				}
+			}
+
+		free(ref);
+		blasfeo_free_dmat(&sA);
+		blasfeo_free_dmat(&sB);
+		blasfeo_free_dmat(&sC);
+		blasfeo_free_dmat(&sD);
+		}
+
+	// dpotrf_l_mt: C = L * L^T ; dgetrf_rp_mt: P * C = L * U, L unit lower
+	for(lu=0; lu<2; lu++)
+	for(ig=0; ig<(lu ? 3 : 1); ig++)
+	for(io=0; io<2; io++)
+		{
+		m = fs[ig][0];
+		n = lu ? fs[ig][1] : m;
+		mn = m<n ? m : n;
+		ai = offs[io][0];
+		aj = offs[io][1];
+
+		// well conditioned matrix: diagonally dominant, symmetric for dpotrf_l
+		blasfeo_allocate_dmat(ai+m, aj+n, &sC);
+		blasfeo_allocate_dmat(ai+m, aj+n, &sD);
+		blasfeo_allocate_dmat(m, n, &sP);
+		test_d_rnd_mat(m, n, &sC, ai, aj);
+		if(!lu)
+			for(jj=0; jj<m; jj++)
+				for(ii=0; ii<jj; ii++)
+					blasfeo_dgein1(blasfeo_dgeex1(&sC, ai+ii, aj+jj), &sC, ai+jj, aj+ii);
+		for(ii=0; ii<mn; ii++)
+			blasfeo_dgein1(blasfeo_dgeex1(&sC, ai+ii, aj+ii)+m, &sC, ai+ii, aj+ii);
+		ipiv = malloc(mn*sizeof(int));
+
+		for(it=0; it<2; it++)
+			{
+			blasfeo_set_num_threads(nts[it]);
+			blasfeo_dgese(ai+m, aj+n, 0.0, &sD, 0, 0);
+			work = malloc(lu ? blasfeo_dgetrf_rp_mt_worksize(m, n) : blasfeo_dpotrf_l_mt_worksize(m, m));
+			if(lu)
+				blasfeo_dgetrf_rp_mt(m, n, &sC, ai, aj, &sD, ai, aj, ipiv, work);
+			else
+				blasfeo_dpotrf_l_mt(m, &sC, ai, aj, &sD, ai, aj, work);
+			free(work);
+
+			// row exchanges applied to a copy of C at the origin
+			blasfeo_dgecp(m, n, &sC, ai, aj, &sP, 0, 0);
+			if(lu)
+				blasfeo_drowpe(mn, ipiv, &sP);
+
+			res = 0.0;
+			for(jj=0; jj<n; jj++)
+				for(ii=lu ? 0 : jj; ii<m; ii++)
+					{
+					tmp = 0.0;
+					for(ll=0; ll<=(ii<jj ? ii : jj) & ll<mn; ll++)
+						{
+						if(lu)
+							tmp += (ll==ii ? 1.0 : blasfeo_dgeex1(&sD, ai+ii, aj+ll)) * blasfeo_dgeex1(&sD, ai+ll, aj+jj);
+						else
+							tmp += blasfeo_dgeex1(&sD, ai+ii, aj+ll) * blasfeo_dgeex1(&sD, ai+jj, aj+ll);
+						}
+					res = fmax(res, fabs(tmp - blasfeo_dgeex1(&sP, ii, jj)));
+					}
+			if(res>1e-12*m)
+				{
+				printf("\nd%s_mt: m=%d, n=%d, offset=(%d,%d), threads=%d, residual %e\n", lu ? "getrf_rp" : "potrf_l", m, n, ai, aj, nts[it], res);
+				n_fail++;
+				}
+			}
+
+		free(ipiv);
+		blasfeo_free_dmat(&sC);
+		blasfeo_free_dmat(&sD);
+		blasfeo_free_dmat(&sP);
+		}
+
+#if defined(BLAS_API)
+	// BLAS API dgemm: C = alpha * op(A) * op(B) + beta * C
+	for(tr=0; tr<4; tr++)
+	for(ig=0; ig<4; ig++)
+		{
+		m = bs[ig][0];
+		n = bs[ig][1];
+		k = bs[ig][2];
+		ta = tr&2 ? 'T' : 'N';
+		tb = tr&1 ? 'T' : 'N';
+		lda = (tr&2 ? k : m) + 3;
+		ldb = (tr&1 ? n : k) + 1;
+		ldc = m + 2;
+		A = malloc(lda*(tr&2 ? m : k)*sizeof(double));
+		B = malloc(ldb*(tr&1 ? k : n)*sizeof(double));
+		C0 = malloc(ldc*n*sizeof(double));
+		C = malloc(ldc*n*sizeof(double));
+		for(ii=0; ii<lda*(tr&2 ? m : k); ii++)
+			A[ii] = test_rnd();
+		for(ii=0; ii<ldb*(tr&1 ? k : n); ii++)
+			B[ii] = test_rnd();
+		for(ii=0; ii<ldc*n; ii++)
+			C0[ii] = test_rnd();
+
+		ref = malloc(m*n*sizeof(double));
+		for(jj=0; jj<n; jj++)
+			for(ii=0; ii<m; ii++)
+				{
+				tmp = 0.0;
+				for(ll=0; ll<k; ll++)
+					tmp += (tr&2 ? A[ll+lda*ii] : A[ii+lda*ll]) * (tr&1 ? B[jj+ldb*ll] : B[ll+ldb*jj]);
+				ref[ii+m*jj] = alpha*tmp + beta*C0[ii+ldc*jj];
+				}
+
+		for(it=0; it<2; it++)
+			{
+			blasfeo_set_num_threads(nts[it]);
+			for(ii=0; ii<ldc*n; ii++)
+				C[ii] = C0[ii];
+			blasfeo_dgemm(&ta, &tb, &m, &n, &k, &alpha, A, &lda, B, &ldb, &beta, C, &ldc);
+			res = 0.0;
+			for(jj=0; jj<n; jj++)
+				{
+				for(ii=0; ii<m; ii++)
+					res = fmax(res, fabs(ref[ii+m*jj] - C[ii+ldc*jj]));
+				// padding rows not written
+				for(; ii<ldc; ii++)
+					if(C[ii+ldc*jj]!=C0[ii+ldc*jj])
+						res = INFINITY;
+				}
+			if(res>1e-12*k)
+				{
+				printf("\nBLAS API dgemm: ta=%c, tb=%c, m=%d, n=%d, k=%d, threads=%d, residual %e\n", ta, tb, m, n, k, nts[it], res);
+				n_fail++;
+				}
+			}
+
+		free(ref);
+		free(A);
+		free(B);
+		free(C0);
+		free(C);
+		}
+#endif
+
+	blasfeo_set_num_threads(1);
+
+	return test_report("multi-threaded", n_fail);
+
+	}
@@ -0,0 +1,152 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "../include/blasfeo_common.h"
+#include "../include/blasfeo_d_aux_ext_dep.h"
+#include "../include/blasfeo_d_aux.h"
+#include "../include/blasfeo_d_blas.h"
+
+#include "test_residual.h"
+
+
+
+// residual of the rank-k update and downdate of a Cholesky factor: the factor of A is updated with V, the result
+// downdated with V again, and both compared with the products of the factors; a downdate making the matrix indefinite
+// must report the row of the breakdown; matrices at row and column offsets, out of place and in place
+int main()
+	{
+
+	int ms[] = {1, 3, 4, 7, 16, 33, 70};
+	int ks[] = {1, 2, 5};
+	int offs[] = {0, 1, 5};
+
+	int ii, jj, ll, im, ik, io, ip, ret;
+	int m, k, off;
+	double res, res_dd, tmp;
+	int n_fail = 0;
+
+	struct blasfeo_dmat sA, sL, sC, sD, sV;
+	void *work;
+
+	for(ip=0; ip<2; ip++)
+	for(im=0; im<7; im++)
+	for(ik=0; ik<3; ik++)
+	for(io=0; io<3; io++)
+		{
+		m = ms[im];
+		k = ks[ik];
+		off = offs[io];
+
+		// symmetric positive definite A = L * L^T, with L computed at the origin
+		blasfeo_allocate_dmat(m, m, &sA);
+		blasfeo_allocate_dmat(m, m, &sL);
+		blasfeo_allocate_dmat(off+m, off+m, &sC);
+		blasfeo_allocate_dmat(off+m, off+m, &sD);
+		blasfeo_allocate_dmat(off+m, k+1, &sV);
+		for(jj=0; jj<m; jj++)
+			for(ii=jj; ii<m; ii++)
+				{
+				tmp = test_rnd() + (ii==jj ? m : 0.0);
+				blasfeo_dgein1(tmp, &sA, ii, jj);
+				blasfeo_dgein1(tmp, &sA, jj, ii);
+				}
+		blasfeo_dpotrf_l(m, &sA, 0, 0, &sL, 0, 0);
+		blasfeo_dgese(off+m, off+m, 0.0, &sC, 0, 0);
+		blasfeo_dgecp(m, m, &sL, 0, 0, &sC, off, off);
+		test_d_rnd_mat(m, k, &sV, off, 1);
+
+		work = malloc(blasfeo_dpotrf_update_l_worksize(m, k));
+
+		// update, then downdate back to the factor of A
+		if(ip)
+			{
+			blasfeo_dpotrf_update_l(m, k, &sC, off, off, &sV, off, 1, &sC, off, off, work);
+			blasfeo_dgecp(m, m, &sC, off, off, &sD, off, 0);
+			ret = blasfeo_dpotrf_downdate_l(m, k, &sC, off, off, &sV, off, 1, &sC, off, off, work);
+			}
+		else
+			{
+			blasfeo_dpotrf_update_l(m, k, &sC, off, off, &sV, off, 1, &sD, off, 0, work);
+			ret = blasfeo_dpotrf_downdate_l(m, k, &sD, off, 0, &sV, off, 1, &sC, off, off, work);
+			}
+
+		// D * D^T = A + V * V^T, C * C^T = A (lower part)
+		res = 0.0;
+		res_dd = 0.0;
+		for(jj=0; jj<m; jj++)
+			for(ii=jj; ii<m; ii++)
+				{
+				tmp = -blasfeo_dgeex1(&sA, ii, jj);
+				for(ll=0; ll<k; ll++)
+					tmp -= blasfeo_dgeex1(&sV, off+ii, 1+ll) * blasfeo_dgeex1(&sV, off+jj, 1+ll);
+				for(ll=0; ll<=jj; ll++)
+					tmp += blasfeo_dgeex1(&sD, off+ii, ll) * blasfeo_dgeex1(&sD, off+jj, ll);
+				res = fmax(res, fabs(tmp));
+				tmp = -blasfeo_dgeex1(&sA, ii, jj);
+				for(ll=0; ll<=jj; ll++)
+					tmp += blasfeo_dgeex1(&sC, off+ii, off+ll) * blasfeo_dgeex1(&sC, off+jj, off+ll);
+				res_dd = fmax(res_dd, fabs(tmp));
+				}
+		if(res>1e-12*m | res_dd>1e-12*m | ret!=0)
+			{
+			printf("\ndpotrf_update_l: m=%d, k=%d, offset=%d, in place=%d, residual %e, downdate residual %e, return %d\n", m, k, off, ip, res, res_dd, ret);
+			n_fail++;
+			}
+
+		// breakdown at the first row: A(0,0) - V(0,0)^2 < 0
+		blasfeo_dgecp(m, m, &sL, 0, 0, &sC, off, off);
+		blasfeo_dgein1(2.0*blasfeo_dgeex1(&sL, 0, 0), &sV, off, 1);
+		ret = blasfeo_dpotrf_downdate_l(m, k, &sC, off, off, &sV, off, 1, &sD, off, 0, work);
+		if(ret!=1)
+			{
+			printf("\ndpotrf_downdate_l: m=%d, k=%d, offset=%d, breakdown at row 0 returned %d\n", m, k, off, ret);
+			n_fail++;
+			}
+
+		free(work);
+		blasfeo_free_dmat(&sA);
+		blasfeo_free_dmat(&sL);
+		blasfeo_free_dmat(&sC);
+		blasfeo_free_dmat(&sD);
+		blasfeo_free_dmat(&sV);
+		}
+
+	return test_report("Cholesky update", n_fail);
+
+	}
@@ -0,0 +1,206 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "../include/blasfeo_common.h"
+#include "../include/blasfeo_d_aux_ext_dep.h"
+#include "../include/blasfeo_d_aux.h"
+#include "../include/blasfeo_d_blas.h"
+
+#include "test_residual.h"
+
+
+
+// residual of the updates of explicit QR and LQ factorizations: starting from A = R, Q = I (or A = L, Q = I), columns
+// and rows are inserted and deleted at the first, middle and last position, and after each step the factors are
+// compared with the updated A, only the upper (lower) trapezoid of R (L) being used, and Q is checked to be orthogonal;
+// matrices at row and column offsets
+int main()
+	{
+
+	int mns[][2] = {{1, 1}, {5, 3}, {3, 5}, {8, 8}, {13, 6}, {6, 13}, {30, 20}};
+	int offs[] = {0, 1, 5};
+	// operation (insert column, delete column, insert row, delete row) and position (first, middle, last)
+	int ops[][2] = {{0, 0}, {0, 2}, {0, 1}, {1, 0}, {1, 1}, {1, 2}, {2, 0}, {2, 2}, {2, 1}, {3, 0}, {3, 1}, {3, 2}};
+
+	int ii, jj, ll, imn, io, iop, lq, op, pos;
+	int m, n, mq, lda, off;
+	double res, res_q, tmp;
+	double *A;
+	int n_fail = 0;
+
+	struct blasfeo_dmat sQ, sR;
+	struct blasfeo_dvec sx;
+	void *work;
+
+	for(lq=0; lq<2; lq++)
+	for(imn=0; imn<7; imn++)
+	for(io=0; io<3; io++)
+		{
+		m = mns[imn][0];
+		n = mns[imn][1];
+		off = offs[io];
+		lda = m+3;
+
+		// Q has the size of the rows of A for QR, of the columns for LQ
+		blasfeo_allocate_dmat(off+(lq ? n : m)+3, (lq ? n : m)+5, &sQ);
+		blasfeo_allocate_dmat(off+m+4, off+n+3, &sR);
+		blasfeo_allocate_dvec((m>n ? m : n)+2, &sx);
+		A = malloc(lda*(n+3)*sizeof(double));
+		work = malloc(lq ? blasfeo_dgelqf_update_worksize(m+3, n+3) : blasfeo_dgeqrf_update_worksize(m+3, n+3));
+
+		mq = lq ? n : m;
+		blasfeo_dgese(mq, mq, 0.0, &sQ, off, 2);
+		blasfeo_ddiare(mq, 1.0, &sQ, off, 2);
+		blasfeo_dgese(m, n, 0.0, &sR, off+1, off);
+		for(jj=0; jj<n; jj++)
+			for(ii=0; ii<m; ii++)
+				{
+				A[ii+lda*jj] = lq ? (ii>=jj ? test_rnd() : 0.0) : (ii<=jj ? test_rnd() : 0.0);
+				blasfeo_dgein1(A[ii+lda*jj], &sR, off+1+ii, off+jj);
+				}
+
+		for(iop=0; iop<12; iop++)
+			{
+			op = ops[iop][0];
+			pos = ops[iop][1];
+			if(op==0)
+				{
+				// insert column
+				pos = pos==0 ? 0 : pos==1 ? n/2 : n;
+				for(ii=0; ii<m; ii++)
+					blasfeo_dvecin1(test_rnd(), &sx, 1+ii);
+				for(jj=n; jj>pos; jj--)
+					for(ii=0; ii<m; ii++)
+						A[ii+lda*jj] = A[ii+lda*(jj-1)];
+				for(ii=0; ii<m; ii++)
+					A[ii+lda*pos] = blasfeo_dvecex1(&sx, 1+ii);
+				if(lq)
+					blasfeo_dgelqf_insert_col(m, n, pos, &sx, 1, &sR, off+1, off, &sQ, off, 2, work);
+				else
+					blasfeo_dgeqrf_insert_col(m, n, pos, &sx, 1, &sQ, off, 2, &sR, off+1, off, work);
+				n++;
+				}
+			else if(op==1)
+				{
+				// delete column
+				pos = pos==0 ? 0 : pos==1 ? n/2 : n-1;
+				for(jj=pos; jj<n-1; jj++)
+					for(ii=0; ii<m; ii++)
+						A[ii+lda*jj] = A[ii+lda*(jj+1)];
+				if(lq)
+					blasfeo_dgelqf_delete_col(m, n, pos, &sR, off+1, off, &sQ, off, 2, work);
+				else
+					blasfeo_dgeqrf_delete_col(m, n, pos, &sQ, off, 2, &sR, off+1, off, work);
+				n--;
+				}
+			else if(op==2)
+				{
+				// insert row
+				pos = pos==0 ? 0 : pos==1 ? m/2 : m;
+				for(jj=0; jj<n; jj++)
+					blasfeo_dvecin1(test_rnd(), &sx, 1+jj);
+				for(jj=0; jj<n; jj++)
+					{
+					for(ii=m; ii>pos; ii--)
+						A[ii+lda*jj] = A[ii-1+lda*jj];
+					A[pos+lda*jj] = blasfeo_dvecex1(&sx, 1+jj);
+					}
+				if(lq)
+					blasfeo_dgelqf_insert_row(m, n, pos, &sx, 1, &sR, off+1, off, &sQ, off, 2, work);
+				else
+					blasfeo_dgeqrf_insert_row(m, n, pos, &sx, 1, &sQ, off, 2, &sR, off+1, off, work);
+				m++;
+				}
+			else
+				{
+				// delete row
+				pos = pos==0 ? 0 : pos==1 ? m/2 : m-1;
+				for(jj=0; jj<n; jj++)
+					for(ii=pos; ii<m-1; ii++)
+						A[ii+lda*jj] = A[ii+1+lda*jj];
+				if(lq)
+					blasfeo_dgelqf_delete_row(m, n, pos, &sR, off+1, off, &sQ, off, 2, work);
+				else
+					blasfeo_dgeqrf_delete_row(m, n, pos, &sQ, off, 2, &sR, off+1, off, work);
+				m--;
+				}
+			mq = lq ? n : m;
+
+			// A = Q * R, R upper trapezoidal, or A = L * Q, L lower trapezoidal
+			res = 0.0;
+			for(jj=0; jj<n; jj++)
+				for(ii=0; ii<m; ii++)
+					{
+					tmp = -A[ii+lda*jj];
+					if(lq)
+						for(ll=0; ll<=ii & ll<n; ll++)
+							tmp += blasfeo_dgeex1(&sR, off+1+ii, off+ll) * blasfeo_dgeex1(&sQ, off+ll, 2+jj);
+					else
+						for(ll=0; ll<=jj & ll<m; ll++)
+							tmp += blasfeo_dgeex1(&sQ, off+ii, 2+ll) * blasfeo_dgeex1(&sR, off+1+ll, off+jj);
+					res = fmax(res, fabs(tmp));
+					}
+			// Q^T * Q = I
+			res_q = 0.0;
+			for(jj=0; jj<mq; jj++)
+				for(ii=0; ii<mq; ii++)
+					{
+					tmp = ii==jj ? -1.0 : 0.0;
+					for(ll=0; ll<mq; ll++)
+						tmp += blasfeo_dgeex1(&sQ, off+ll, 2+ii) * blasfeo_dgeex1(&sQ, off+ll, 2+jj);
+					res_q = fmax(res_q, fabs(tmp));
+					}
+			if(res>1e-13*(m+n) | res_q>1e-13*mq)
+				{
+				printf("\nd%s: step %d (op %d), m=%d, n=%d, offset=%d, residual %e, orthogonality %e\n", lq ? "gelqf" : "geqrf", iop, op, m, n, off, res, res_q);
+				n_fail++;
+				break;
+				}
+			}
+
+		free(A);
+		free(work);
+		blasfeo_free_dmat(&sQ);
+		blasfeo_free_dmat(&sR);
+		blasfeo_free_dvec(&sx);
+		}
+
+	return test_report("QR and LQ update", n_fail);
+
+	}
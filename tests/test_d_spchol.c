@@ -0,0 +1,169 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "../include/blasfeo_common.h"
+#include "../include/blasfeo_d_aux_ext_dep.h"
+#include "../include/blasfeo_d_aux.h"
+#include "../include/blasfeo_d_spchol.h"
+#include "../include/blasfeo_thread.h"
+
+#include "test_residual.h"
+
+
+
+// residual of the sparse Cholesky solve on 5-point grid matrices, optionally bordered by dense rows and columns, for
+// all orderings; with MULTI_THREAD=1 the factorization is repeated with the supernodes spread over the threads
+int main()
+	{
+
+	int gs[] = {1, 3, 10, 30, 17};
+	int nbs[] = {0, 0, 0, 0, 7};
+	int nts[] = {1, 4};
+
+	int ii, jj, pp, ig, order, it, nz, nc;
+	int g, nb, n, tmp;
+	int cand[16];
+	double res, b_nrm;
+	int n_fail = 0;
+
+	int *colptr, *rowind;
+	double *val, *r;
+	struct blasfeo_dspchol sp;
+	struct blasfeo_dvec sb, sx;
+
+	for(ig=0; ig<5; ig++)
+		{
+		g = gs[ig];
+		nb = nbs[ig];
+		n = g*g+nb;
+
+		// lower triangle in compressed sparse column format, diagonally dominant
+		colptr = malloc((n+1)*sizeof(int));
+		rowind = malloc(n*(3+nb)*sizeof(int));
+		val = malloc(n*(3+nb)*sizeof(double));
+		nz = 0;
+		for(jj=0; jj<n; jj++)
+			{
+			colptr[jj] = nz;
+			nc = 0;
+			cand[nc++] = jj;
+			if(jj<g*g)
+				{
+				if(jj%g+1<g)
+					cand[nc++] = jj+1;
+				if(jj/g+1<g)
+					cand[nc++] = jj+g;
+				}
+			for(ii=g*g; ii<n; ii++)
+				if(ii>jj)
+					cand[nc++] = ii;
+			for(ii=0; ii<nc; ii++)
+				for(pp=ii+1; pp<nc; pp++)
+					if(cand[pp]<cand[ii])
+						{
+						tmp = cand[ii];
+						cand[ii] = cand[pp];
+						cand[pp] = tmp;
+						}
+			for(ii=0; ii<nc; ii++)
+				{
+				rowind[nz] = cand[ii];
+				val[nz] = cand[ii]==jj ? 4.0+2.0*nb : test_rnd();
+				nz++;
+				}
+			}
+		colptr[n] = nz;
+
+		blasfeo_allocate_dvec(n, &sb);
+		blasfeo_allocate_dvec(n, &sx);
+		r = malloc(n*sizeof(double));
+
+		for(order=0; order<3; order++)
+		for(it=0; it<2; it++)
+			{
+			blasfeo_set_num_threads(nts[it]);
+
+			for(ii=0; ii<n; ii++)
+				blasfeo_dvecin1(test_rnd(), &sb, ii);
+
+			blasfeo_dspchol_analyze(n, colptr, rowind, order, &sp);
+			blasfeo_dspchol_factorize(val, &sp);
+			// a second factorization reuses the analysis
+			blasfeo_dspchol_factorize(val, &sp);
+			blasfeo_dspchol_solve(&sp, &sb, 0, &sx, 0);
+
+			// r = A x - b, with the symmetric matrix from its lower triangle
+			for(ii=0; ii<n; ii++)
+				r[ii] = - blasfeo_dvecex1(&sb, ii);
+			for(jj=0; jj<n; jj++)
+				for(pp=colptr[jj]; pp<colptr[jj+1]; pp++)
+					{
+					ii = rowind[pp];
+					r[ii] += val[pp] * blasfeo_dvecex1(&sx, jj);
+					if(ii!=jj)
+						r[jj] += val[pp] * blasfeo_dvecex1(&sx, ii);
+					}
+			res = 0.0;
+			b_nrm = 0.0;
+			for(ii=0; ii<n; ii++)
+				{
+				res = fmax(res, fabs(r[ii]));
+				b_nrm = fmax(b_nrm, fabs(blasfeo_dvecex1(&sb, ii)));
+				}
+			if(res>1e-12*b_nrm)
+				{
+				printf("\ndspchol: n=%d, order=%d, threads=%d, residual %e\n", n, order, nts[it], res);
+				n_fail++;
+				}
+
+			blasfeo_dspchol_free(&sp);
+			}
+
+		blasfeo_set_num_threads(1);
+		free(colptr);
+		free(rowind);
+		free(val);
+		free(r);
+		blasfeo_free_dvec(&sb);
+		blasfeo_free_dvec(&sx);
+		}
+
+	return test_report("sparse Cholesky", n_fail);
+
+	}
@@ -0,0 +1,125 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "../include/blasfeo_common.h"
+#include "../include/blasfeo_d_aux_ext_dep.h"
+#include "../include/blasfeo_d_aux.h"
+#include "../include/blasfeo_d_blas.h"
+
+#include "test_residual.h"
+
+
+
+// residual of dsyrk_ln against a naive triple loop, with all the matrices at row offsets in and out of the panel
+// boundaries; the entries of D out of the lower triangle must not be written
+int main()
+	{
+
+	int ms[] = {1, 3, 4, 5, 8, 11, 13, 24};
+	int ks[] = {1, 4, 7};
+	int offs[] = {0, 1, 2, 3, 4, 5};
+
+	int ii, jj, ll, im, ik, ia, ib, ic, id;
+	int m, k, ai, bi, ci, di, nm;
+	double res, tmp;
+	int n_fail = 0;
+
+	struct blasfeo_dmat sA, sB, sC, sD;
+
+	for(im=0; im<8; im++)
+	for(ik=0; ik<3; ik++)
+	for(ia=0; ia<6; ia++)
+	for(ib=0; ib<6; ib++)
+	for(ic=0; ic<6; ic+=3)
+	for(id=0; id<6; id++)
+		{
+		m = ms[im];
+		k = ks[ik];
+		ai = offs[ia];
+		bi = offs[ib];
+		ci = offs[ic];
+		di = offs[id];
+		nm = m+k+8;
+
+		blasfeo_allocate_dmat(nm, nm, &sA);
+		blasfeo_allocate_dmat(nm, nm, &sB);
+		blasfeo_allocate_dmat(nm, nm, &sC);
+		blasfeo_allocate_dmat(nm, nm, &sD);
+		for(jj=0; jj<nm; jj++)
+			for(ii=0; ii<nm; ii++)
+				{
+				blasfeo_dgein1(test_rnd(), &sA, ii, jj);
+				blasfeo_dgein1(test_rnd(), &sB, ii, jj);
+				blasfeo_dgein1(test_rnd(), &sC, ii, jj);
+				blasfeo_dgein1(7.0, &sD, ii, jj);
+				}
+
+		blasfeo_dsyrk_ln(m, k, -1.0, &sA, ai, 1, &sB, bi, 2, 0.5, &sC, ci, 3, &sD, di, 1);
+
+		res = 0.0;
+		for(jj=0; jj<nm; jj++)
+			for(ii=0; ii<nm; ii++)
+				{
+				if(ii>=di && ii<di+m && jj>=1 && jj<1+m && ii-di>=jj-1)
+					{
+					tmp = 0.5 * blasfeo_dgeex1(&sC, ci+ii-di, 3+jj-1);
+					for(ll=0; ll<k; ll++)
+						tmp -= blasfeo_dgeex1(&sA, ai+ii-di, 1+ll) * blasfeo_dgeex1(&sB, bi+jj-1, 2+ll);
+					}
+				else
+					{
+					tmp = 7.0;
+					}
+				res = fmax(res, fabs(tmp - blasfeo_dgeex1(&sD, ii, jj)));
+				}
+		if(res>1e-12*k)
+			{
+			printf("\ndsyrk_ln: m=%d, k=%d, ai=%d, bi=%d, ci=%d, di=%d, residual %e\n", m, k, ai, bi, ci, di, res);
+			n_fail++;
+			}
+
+		blasfeo_free_dmat(&sA);
+		blasfeo_free_dmat(&sB);
+		blasfeo_free_dmat(&sC);
+		blasfeo_free_dmat(&sD);
+		}
+
+	return test_report("dsyrk_ln", n_fail);
+
+	}
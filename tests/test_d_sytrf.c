@@ -0,0 +1,138 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "../include/blasfeo_common.h"
+#include "../include/blasfeo_d_aux_ext_dep.h"
+#include "../include/blasfeo_d_aux.h"
+#include "../include/blasfeo_d_blas.h"
+
+#include "test_residual.h"
+
+
+
+// residual of the symmetric indefinite factorization dsytrf_l and solve dsytrs_l: C * X = B for random symmetric
+// matrices, also with zero diagonal to force 2x2 pivots, factorized out of place and in place; matrices at row and
+// column offsets
+int main()
+	{
+
+	int ms[] = {1, 2, 3, 5, 8, 31, 70, 130};
+	int offs[] = {0, 1, 5};
+
+	int ii, jj, ll, im, io, zd, ip;
+	int m, n, off;
+	double res, tmp, c_max, x_max;
+	int *ipiv;
+	int n_fail = 0;
+
+	struct blasfeo_dmat sC, sD, sB, sX;
+	void *work;
+
+	n = 3;
+
+	for(zd=0; zd<2; zd++)
+	for(ip=0; ip<2; ip++)
+	for(im=0; im<8; im++)
+	for(io=0; io<3; io++)
+		{
+		m = ms[im];
+		off = offs[io];
+
+		blasfeo_allocate_dmat(off+m, off+m, &sC);
+		blasfeo_allocate_dmat(off+m, off+m, &sD);
+		blasfeo_allocate_dmat(off+m, off+n, &sB);
+		blasfeo_allocate_dmat(off+m, n, &sX);
+		for(jj=0; jj<m; jj++)
+			for(ii=jj; ii<m; ii++)
+				{
+				tmp = ii==jj & zd ? 0.0 : test_rnd();
+				blasfeo_dgein1(tmp, &sC, off+ii, off+jj);
+				blasfeo_dgein1(tmp, &sC, off+jj, off+ii);
+				}
+		test_d_rnd_mat(m, n, &sB, off, off);
+		// a single zero is singular
+		if(m==1 & zd)
+			blasfeo_dgein1(0.5, &sC, off, off);
+
+		ipiv = malloc(m*sizeof(int));
+		work = malloc(blasfeo_dsytrf_l_worksize(m));
+		if(ip)
+			{
+			// in place, the original matrix is kept in sD
+			blasfeo_dgecp(m, m, &sC, off, off, &sD, off, off);
+			blasfeo_dsytrf_l(m, &sC, off, off, &sC, off, off, ipiv, work);
+			blasfeo_dsytrs_l(m, n, &sC, off, off, ipiv, &sB, off, off, &sX, off, 0);
+			blasfeo_dgecp(m, m, &sD, off, off, &sC, off, off);
+			}
+		else
+			{
+			blasfeo_dsytrf_l(m, &sC, off, off, &sD, off, 0, ipiv, work);
+			blasfeo_dsytrs_l(m, n, &sD, off, 0, ipiv, &sB, off, off, &sX, off, 0);
+			}
+		free(work);
+
+		// relative residual of C * X - B
+		c_max = test_d_max_abs(m, m, &sC, off, off);
+		x_max = test_d_max_abs(m, n, &sX, off, 0);
+		res = 0.0;
+		for(jj=0; jj<n; jj++)
+			for(ii=0; ii<m; ii++)
+				{
+				tmp = -blasfeo_dgeex1(&sB, off+ii, off+jj);
+				for(ll=0; ll<m; ll++)
+					tmp += blasfeo_dgeex1(&sC, off+ii, off+ll) * blasfeo_dgeex1(&sX, off+ll, jj);
+				res = fmax(res, fabs(tmp));
+				}
+		res /= c_max*x_max*m;
+		if(res>1e-13)
+			{
+			printf("\ndsytrf_l: m=%d, offset=%d, zero diagonal=%d, in place=%d, residual %e\n", m, off, zd, ip, res);
+			n_fail++;
+			}
+
+		free(ipiv);
+		blasfeo_free_dmat(&sC);
+		blasfeo_free_dmat(&sD);
+		blasfeo_free_dmat(&sB);
+		blasfeo_free_dmat(&sX);
+		}
+
+	return test_report("symmetric indefinite", n_fail);
+
+	}
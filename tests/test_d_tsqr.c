@@ -0,0 +1,130 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "../include/blasfeo_common.h"
+#include "../include/blasfeo_d_aux_ext_dep.h"
+#include "../include/blasfeo_d_aux.h"
+#include "../include/blasfeo_d_blas.h"
+#include "../include/blasfeo_thread.h"
+
+#include "test_residual.h"
+
+
+
+// residual of the tall-skinny QR: Q^T * A must be the R factor in the top (n)x(n) upper triangle and zero below,
+// and Q * (Q^T * C) must give back C, applied both out of place and in place; matrices at row offsets, sizes up to a
+// few row blocks so that the reduction tree has pairs and a leftover block; with MULTI_THREAD=1 it is repeated on 4 threads
+int main()
+	{
+
+	int mns[][2] = {{1, 1}, {7, 3}, {5, 9}, {100, 10}, {1030, 5}, {2100, 8}, {3100, 40}, {4500, 17}};
+	int offs[] = {0, 1, 5};
+	int nts[] = {1, 4};
+	int nc = 7;
+
+	int ii, jj, imn, io, it;
+	int m, n, off;
+	double res, res_r, res_q, tmp;
+	int n_fail = 0;
+
+	struct blasfeo_dmat sA, sD, sC, sX;
+	struct blasfeo_dvec sT;
+	void *work;
+
+	for(imn=0; imn<8; imn++)
+	for(io=0; io<3; io++)
+	for(it=0; it<2; it++)
+		{
+		m = mns[imn][0];
+		n = mns[imn][1];
+		off = offs[io];
+		blasfeo_set_num_threads(nts[it]);
+
+		blasfeo_allocate_dmat(m, n, &sA);
+		blasfeo_allocate_dmat(off+m, n+2, &sD);
+		blasfeo_allocate_dmat(m, n>nc ? n : nc, &sC);
+		blasfeo_allocate_dmat(off+m, n>nc ? n : nc, &sX);
+		blasfeo_allocate_dvec(blasfeo_dgeqrf_tsqr_tausize(m, n), &sT);
+		ii = blasfeo_dgeqrf_tsqr_worksize(m, n);
+		jj = blasfeo_dormqr_tsqr_worksize(m, n>nc ? n : nc, n);
+		work = malloc(ii>jj ? ii : jj);
+
+		test_d_rnd_mat(m, n, &sA, 0, 0);
+		blasfeo_dgeqrf_tsqr(m, n, &sA, 0, 0, &sD, off, 2, &sT, 0, work);
+
+		// Q^T * A = [R; 0]
+		blasfeo_dormqr_tsqr_lt(m, n, n, &sD, off, 2, &sT, 0, &sA, 0, 0, &sX, off, 0, work);
+		res_r = 0.0;
+		for(jj=0; jj<n; jj++)
+			for(ii=0; ii<m; ii++)
+				{
+				tmp = blasfeo_dgeex1(&sX, off+ii, jj);
+				if(ii<=jj)
+					tmp -= blasfeo_dgeex1(&sD, off+ii, 2+jj);
+				res_r = fmax(res_r, fabs(tmp));
+				}
+
+		// Q * (Q^T * C) = C, the second product in place
+		test_d_rnd_mat(m, nc, &sC, 0, 0);
+		blasfeo_dormqr_tsqr_lt(m, nc, n, &sD, off, 2, &sT, 0, &sC, 0, 0, &sX, off, 0, work);
+		blasfeo_dormqr_tsqr_ln(m, nc, n, &sD, off, 2, &sT, 0, &sX, off, 0, &sX, off, 0, work);
+		res_q = 0.0;
+		for(jj=0; jj<nc; jj++)
+			for(ii=0; ii<m; ii++)
+				res_q = fmax(res_q, fabs(blasfeo_dgeex1(&sX, off+ii, jj) - blasfeo_dgeex1(&sC, ii, jj)));
+
+		res = fmax(res_r, res_q);
+		if(res>1e-15*(m+n))
+			{
+			printf("\ndgeqrf_tsqr: m=%d, n=%d, offset=%d, threads=%d, residual R %e, residual Q %e\n", m, n, off, nts[it], res_r, res_q);
+			n_fail++;
+			}
+
+		free(work);
+		blasfeo_free_dmat(&sA);
+		blasfeo_free_dmat(&sD);
+		blasfeo_free_dmat(&sC);
+		blasfeo_free_dmat(&sX);
+		blasfeo_free_dvec(&sT);
+		}
+	blasfeo_set_num_threads(1);
+
+	return test_report("tall-skinny QR", n_fail);
+
+	}
@@ -0,0 +1,308 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "../include/blasfeo_common.h"
+#include "../include/blasfeo_s_aux_ext_dep.h"
+#include "../include/blasfeo_s_aux.h"
+#include "../include/blasfeo_s_blas.h"
+#include "../include/blasfeo_h_aux.h"
+#include "../include/blasfeo_stdlib.h"
+
+#include "test_residual.h"
+
+
+
+static void allocate_hmat(int m, int n, struct blasfeo_hmat *sA, void **mem)
+	{
+	blasfeo_malloc_align(mem, blasfeo_memsize_hmat(m, n));
+	blasfeo_create_hmat(m, n, sA, *mem);
+	}
+
+
+
+// residual of the half precision storage routines: s2h/h2s round trip on all the finite half precision numbers,
+// pack_hmat/unpack_hmat and cvt_s2h_mat/cvt_h2s_mat against s2h/h2s on each element, shgemv_n, shgemv_t and shgemm_nt
+// against a naive loop on the stored half precision values, with row offsets at the top of a panel (the haswell
+// kernels) and in the panel (the generic loops), and k above K_MAX_STACK in shgemm_nt; the entries of z and D out of
+// the result must not be written
+int main()
+	{
+
+	int ms[] = {1, 5, 8, 9, 17, 24, 65};
+	int ns[] = {1, 4, 5, 8, 13};
+	int ks[] = {1, 7, 8, 33, 350};
+	int offs[] = {0, 3, 8};
+
+	int ii, jj, ll, im, in, ik, io;
+	int m, n, k, off, mm, nn;
+	unsigned int uu;
+	double ref, err, err_max;
+	float alpha = 1.5;
+	float beta = 0.5;
+	float tmp;
+	int n_fail = 0;
+
+	struct blasfeo_hmat sH, sH2;
+	struct blasfeo_smat sC, sD;
+	struct blasfeo_svec sx, sy, sz;
+	void *mem, *mem2;
+	float *A, *B;
+
+	// s2h(h2s(h)) == h for all the non inf/nan half precision numbers
+	for(uu=0; uu<0x10000; uu++)
+		{
+		if((uu&0x7c00)!=0x7c00 && blasfeo_s2h(blasfeo_h2s(uu))!=uu)
+			{
+			printf("\ns2h/h2s: round trip of 0x%04x\n", uu);
+			n_fail++;
+			}
+		}
+
+	// pack/unpack and cvt
+	for(io=0; io<3; io++)
+	for(im=0; im<7; im++)
+	for(in=0; in<5; in++)
+		{
+		m = ms[im];
+		n = ns[in];
+		off = offs[io];
+		mm = off+m+1;
+		nn = n+2;
+
+		A = malloc(mm*nn*sizeof(float));
+		B = malloc(mm*nn*sizeof(float));
+		for(ii=0; ii<mm*nn; ii++)
+			{
+			A[ii] = 10.0 * test_rnd();
+			B[ii] = -7.0;
+			}
+		allocate_hmat(mm, nn, &sH, &mem);
+		allocate_hmat(mm, nn, &sH2, &mem2);
+		blasfeo_allocate_smat(mm, nn, &sC);
+		for(jj=0; jj<nn; jj++)
+			for(ii=0; ii<mm; ii++)
+				{
+				blasfeo_hgein1(0.0, &sH, ii, jj);
+				blasfeo_hgein1(0.0, &sH2, ii, jj);
+				blasfeo_sgein1(-7.0, &sC, ii, jj);
+				}
+
+		blasfeo_pack_hmat(m, n, A, mm, &sH, off, 1);
+		blasfeo_unpack_hmat(m, n, &sH, off, 1, B, mm);
+		blasfeo_cvt_h2s_mat(m, n, &sH, off, 1, &sC, off, 1);
+		blasfeo_cvt_s2h_mat(m, n, &sC, off, 1, &sH2, off, 1);
+
+		err_max = 0.0;
+		for(jj=0; jj<nn; jj++)
+			{
+			for(ii=0; ii<mm; ii++)
+				{
+				if(ii>=off & ii<off+m & jj>=1 & jj<n+1)
+					{
+					tmp = blasfeo_h2s(blasfeo_s2h(A[(ii-off)+(jj-1)*mm]));
+					err = fabs(tmp - blasfeo_hgeex1(&sH, ii, jj));
+					err += fabs(tmp - blasfeo_sgeex1(&sC, ii, jj));
+					err += fabs(tmp - blasfeo_hgeex1(&sH2, ii, jj));
+					}
+				else
+					{
+					err = fabs(blasfeo_hgeex1(&sH, ii, jj)) + fabs(blasfeo_sgeex1(&sC, ii, jj)+7.0) + fabs(blasfeo_hgeex1(&sH2, ii, jj));
+					}
+				err_max = err>err_max ? err : err_max;
+				// B is unpacked at the top left corner with leading dimension mm
+				tmp = ii<m & jj<n ? blasfeo_h2s(blasfeo_s2h(A[ii+jj*mm])) : -7.0;
+				err = fabs(tmp - B[ii+jj*mm]);
+				err_max = err>err_max ? err : err_max;
+				}
+			}
+		if(err_max!=0.0)
+			{
+			printf("\npack/unpack/cvt hmat: m=%d, n=%d, offset=%d, residual %e\n", m, n, off, err_max);
+			n_fail++;
+			}
+
+		free(A);
+		free(B);
+		blasfeo_free_align(mem);
+		blasfeo_free_align(mem2);
+		blasfeo_free_smat(&sC);
+		}
+
+	// shgemv_n and shgemv_t
+	for(io=0; io<3; io++)
+	for(im=0; im<7; im++)
+	for(in=0; in<5; in++)
+		{
+		m = ms[im];
+		n = ns[in];
+		off = offs[io];
+		mm = off+m;
+		nn = m+n+2;
+
+		allocate_hmat(mm, n+1, &sH, &mem);
+		for(jj=0; jj<n+1; jj++)
+			for(ii=0; ii<mm; ii++)
+				blasfeo_hgein1(test_rnd(), &sH, ii, jj);
+		blasfeo_allocate_svec(nn, &sx);
+		blasfeo_allocate_svec(nn, &sy);
+		blasfeo_allocate_svec(nn, &sz);
+		for(ii=0; ii<nn; ii++)
+			{
+			blasfeo_svecin1(test_rnd(), &sx, ii);
+			blasfeo_svecin1(test_rnd(), &sy, ii);
+			}
+
+		// z[1:1+m] = beta*y[1:1+m] + alpha*A*x[2:2+n]
+		for(ii=0; ii<nn; ii++)
+			blasfeo_svecin1(-7.0, &sz, ii);
+		blasfeo_shgemv_n(m, n, alpha, &sH, off, 1, &sx, 2, beta, &sy, 1, &sz, 1);
+		err_max = 0.0;
+		for(ii=0; ii<nn; ii++)
+			{
+			ref = -7.0;
+			if(ii>=1 & ii<1+m)
+				{
+				ref = 0.0;
+				for(jj=0; jj<n; jj++)
+					ref += (double) blasfeo_hgeex1(&sH, off+ii-1, 1+jj) * blasfeo_svecex1(&sx, 2+jj);
+				ref = alpha*ref + beta*blasfeo_svecex1(&sy, ii);
+				}
+			err = fabs(ref - blasfeo_svecex1(&sz, ii));
+			err_max = err>err_max ? err : err_max;
+			}
+		if(err_max>1e-4)
+			{
+			printf("\nshgemv_n: m=%d, n=%d, offset=%d, residual %e\n", m, n, off, err_max);
+			n_fail++;
+			}
+
+		// z[1:1+n] = beta*y[1:1+n] + alpha*A'*x[2:2+m]
+		for(ii=0; ii<nn; ii++)
+			blasfeo_svecin1(-7.0, &sz, ii);
+		blasfeo_shgemv_t(m, n, alpha, &sH, off, 1, &sx, 2, beta, &sy, 1, &sz, 1);
+		err_max = 0.0;
+		for(jj=0; jj<nn; jj++)
+			{
+			ref = -7.0;
+			if(jj>=1 & jj<1+n)
+				{
+				ref = 0.0;
+				for(ii=0; ii<m; ii++)
+					ref += (double) blasfeo_hgeex1(&sH, off+ii, jj) * blasfeo_svecex1(&sx, 2+ii);
+				ref = alpha*ref + beta*blasfeo_svecex1(&sy, jj);
+				}
+			err = fabs(ref - blasfeo_svecex1(&sz, jj));
+			err_max = err>err_max ? err : err_max;
+			}
+		if(err_max>1e-4)
+			{
+			printf("\nshgemv_t: m=%d, n=%d, offset=%d, residual %e\n", m, n, off, err_max);
+			n_fail++;
+			}
+
+		blasfeo_free_align(mem);
+		blasfeo_free_svec(&sx);
+		blasfeo_free_svec(&sy);
+		blasfeo_free_svec(&sz);
+		}
+
+	// shgemm_nt
+	for(io=0; io<3; io++)
+	for(im=0; im<7; im++)
+	for(in=0; in<5; in++)
+	for(ik=0; ik<5; ik++)
+		{
+		m = ms[im];
+		n = ns[in];
+		k = ks[ik];
+		off = offs[io];
+		mm = off+m;
+
+		allocate_hmat(mm, k+1, &sH, &mem);
+		allocate_hmat(n+2, k, &sH2, &mem2);
+		for(jj=0; jj<k+1; jj++)
+			for(ii=0; ii<mm; ii++)
+				blasfeo_hgein1(test_rnd(), &sH, ii, jj);
+		for(jj=0; jj<k; jj++)
+			for(ii=0; ii<n+2; ii++)
+				blasfeo_hgein1(test_rnd(), &sH2, ii, jj);
+		blasfeo_allocate_smat(mm+1, n+2, &sC);
+		blasfeo_allocate_smat(mm+1, n+2, &sD);
+		for(jj=0; jj<n+2; jj++)
+			for(ii=0; ii<mm+1; ii++)
+				{
+				blasfeo_sgein1(test_rnd(), &sC, ii, jj);
+				blasfeo_sgein1(-7.0, &sD, ii, jj);
+				}
+
+		// D[off:off+m,1:1+n] = beta*C[off:off+m,1:1+n] + alpha*A[off:off+m,1:1+k]*B[2:2+n,0:k]'
+		blasfeo_shgemm_nt(m, n, k, alpha, &sH, off, 1, &sH2, 2, 0, beta, &sC, off, 1, &sD, off, 1);
+
+		err_max = 0.0;
+		for(jj=0; jj<n+2; jj++)
+			{
+			for(ii=0; ii<mm+1; ii++)
+				{
+				ref = -7.0;
+				if(ii>=off & ii<off+m & jj>=1 & jj<1+n)
+					{
+					ref = 0.0;
+					for(ll=0; ll<k; ll++)
+						ref += (double) blasfeo_hgeex1(&sH, ii, 1+ll) * blasfeo_hgeex1(&sH2, 2+jj-1, ll);
+					ref = alpha*ref + beta*blasfeo_sgeex1(&sC, ii, jj);
+					}
+				err = fabs(ref - blasfeo_sgeex1(&sD, ii, jj)) / (1.0+fabs(ref));
+				err_max = err>err_max ? err : err_max;
+				}
+			}
+		if(err_max>1e-4)
+			{
+			printf("\nshgemm_nt: m=%d, n=%d, k=%d, offset=%d, residual %e\n", m, n, k, off, err_max);
+			n_fail++;
+			}
+
+		blasfeo_free_align(mem);
+		blasfeo_free_align(mem2);
+		blasfeo_free_smat(&sC);
+		blasfeo_free_smat(&sD);
+		}
+
+	return test_report("half precision", n_fail);
+
+	}
@@ -0,0 +1,118 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "../include/blasfeo_common.h"
+#include "../include/blasfeo_d_aux_ext_dep.h"
+#include "../include/blasfeo_d_aux.h"
+#include "../include/blasfeo_d_blas.h"
+
+#include "test_residual.h"
+
+
+
+// residual of the mixed precision solvers dposv_mixed and dgesv_mixed, with the system matrix at row and column
+// offsets inside a larger matrix
+int main()
+	{
+
+	int ms[] = {1, 4, 7, 16, 33, 70};
+	int offs[] = {0, 1, 3, 4, 5};
+
+	int ii, jj, im, io, lu, it;
+	int m, off;
+	double res, b_nrm;
+	int n_fail = 0;
+
+	struct blasfeo_dmat sA;
+	struct blasfeo_dvec sb, sx, sr;
+	void *work;
+
+	for(lu=0; lu<2; lu++)
+	for(im=0; im<6; im++)
+	for(io=0; io<5; io++)
+		{
+		m = ms[im];
+		off = offs[io];
+
+		// well conditioned matrix: diagonally dominant, symmetric for dposv
+		blasfeo_allocate_dmat(off+m, off+m, &sA);
+		blasfeo_dgese(off+m, off+m, 0.0, &sA, 0, 0);
+		test_d_rnd_mat(m, m, &sA, off, off);
+		if(!lu)
+			for(jj=0; jj<m; jj++)
+				for(ii=0; ii<jj; ii++)
+					blasfeo_dgein1(blasfeo_dgeex1(&sA, off+ii, off+jj), &sA, off+jj, off+ii);
+		for(ii=0; ii<m; ii++)
+			blasfeo_dgein1(blasfeo_dgeex1(&sA, off+ii, off+ii)+m, &sA, off+ii, off+ii);
+
+		blasfeo_allocate_dvec(off+m, &sb);
+		blasfeo_allocate_dvec(off+m, &sx);
+		blasfeo_allocate_dvec(m, &sr);
+		for(ii=0; ii<off+m; ii++)
+			{
+			blasfeo_dvecin1(test_rnd(), &sb, ii);
+			blasfeo_dvecin1(0.0, &sx, ii);
+			}
+
+		work = malloc(lu ? blasfeo_dgesv_mixed_worksize(m) : blasfeo_dposv_mixed_worksize(m));
+		if(lu)
+			it = blasfeo_dgesv_mixed(m, &sA, off, off, &sb, off, &sx, off, work);
+		else
+			it = blasfeo_dposv_mixed(m, &sA, off, off, &sb, off, &sx, off, work);
+
+		// r = b - A x, with the full matrix
+		blasfeo_dgemv_n(m, m, -1.0, &sA, off, off, &sx, off, 1.0, &sb, off, &sr, 0);
+		blasfeo_dvecnrm_inf(m, &sr, 0, &res);
+		blasfeo_dvecnrm_inf(m, &sb, off, &b_nrm);
+		if(it<0 | res>1e-12*b_nrm)
+			{
+			printf("\nd%ssv_mixed: m=%d, offset=%d, iterations %d, residual %e\n", lu ? "ge" : "po", m, off, it, res);
+			n_fail++;
+			}
+
+		free(work);
+		blasfeo_free_dmat(&sA);
+		blasfeo_free_dvec(&sb);
+		blasfeo_free_dvec(&sx);
+		blasfeo_free_dvec(&sr);
+		}
+
+	return test_report("mixed precision solvers", n_fail);
+
+	}
@@ -0,0 +1,94 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#ifndef BLASFEO_TEST_RESIDUAL_H_
+#define BLASFEO_TEST_RESIDUAL_H_
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "../include/blasfeo_common.h"
+#include "../include/blasfeo_d_aux.h"
+
+
+
+// helpers of the residual tests run by ctest and by make residual run_residual
+
+
+
+// random number in [-0.5, 0.5]
+static inline double test_rnd()
+	{
+	return (double) rand() / RAND_MAX - 0.5;
+	}
+
+
+
+// set the m x n block of sA at (ai, aj) to random numbers
+static inline void test_d_rnd_mat(int m, int n, struct blasfeo_dmat *sA, int ai, int aj)
+	{
+	int ii, jj;
+	for(jj=0; jj<n; jj++)
+		for(ii=0; ii<m; ii++)
+			blasfeo_dgein1(test_rnd(), sA, ai+ii, aj+jj);
+	return;
+	}
+
+
+
+// max abs value in the m x n block of sA at (ai, aj)
+static inline double test_d_max_abs(int m, int n, struct blasfeo_dmat *sA, int ai, int aj)
+	{
+	int ii, jj;
+	double max = 0.0;
+	for(jj=0; jj<n; jj++)
+		for(ii=0; ii<m; ii++)
+			max = fmax(max, fabs(blasfeo_dgeex1(sA, ai+ii, aj+jj)));
+	return max;
+	}
+
+
+
+// print the number of failures of the residual test, and return the exit code of the test
+static inline int test_report(char *name, int n_fail)
+	{
+	printf("\n%s residual test: %d failures\n\n", name, n_fail);
+	return n_fail!=0;
+	}
+
+
+
+#endif  // BLASFEO_TEST_RESIDUAL_H_
@@ -0,0 +1,129 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "../include/blasfeo_common.h"
+#include "../include/blasfeo_s_aux_ext_dep.h"
+#include "../include/blasfeo_s_aux.h"
+#include "../include/blasfeo_s_blas.h"
+
+#include "test_residual.h"
+
+
+
+// residual of sgemm_nn and sgemm_nt against a naive triple loop, for sizes hitting the 24x4, 16x4, 8x8 and 4x8
+// kernels and their clean-up paths, with k below, at and above the 8x unrolling of the inner kernels
+static void rnd_smat(int m, int n, struct blasfeo_smat *sA)
+	{
+	int ii, jj;
+	blasfeo_allocate_smat(m, n, sA);
+	for(jj=0; jj<n; jj++)
+		for(ii=0; ii<m; ii++)
+			blasfeo_sgein1((float) test_rnd(), sA, ii, jj);
+	}
+
+
+
+int main()
+	{
+
+	int ms[] = {1, 3, 8, 13, 16, 24, 40, 50, 71};
+	int ns[] = {1, 4, 5, 8, 13, 21};
+	int ks[] = {1, 4, 7, 8, 9, 16, 17, 33, 64};
+	int offs[] = {0, 8};
+
+	int ii, jj, ll, im, in, ik, io, tran;
+	int m, n, k, off;
+	double ref, err, err_max;
+	float alpha = 1.0;
+	float beta = 0.5;
+	int n_fail = 0;
+
+	struct blasfeo_smat sA, sB, sC, sD;
+
+	for(tran=0; tran<2; tran++)
+	for(io=0; io<2; io++)
+	for(im=0; im<9; im++)
+	for(in=0; in<6; in++)
+	for(ik=0; ik<9; ik++)
+		{
+		m = ms[im];
+		n = ns[in];
+		k = ks[ik];
+		off = offs[io];
+
+		rnd_smat(off+m, k, &sA);
+		if(tran)
+			rnd_smat(n, k, &sB);
+		else
+			rnd_smat(k, n, &sB);
+		rnd_smat(off+m, n, &sC);
+		rnd_smat(off+m, n, &sD);
+
+		if(tran)
+			blasfeo_sgemm_nt(m, n, k, alpha, &sA, off, 0, &sB, 0, 0, beta, &sC, off, 0, &sD, off, 0);
+		else
+			blasfeo_sgemm_nn(m, n, k, alpha, &sA, off, 0, &sB, 0, 0, beta, &sC, off, 0, &sD, off, 0);
+
+		err_max = 0.0;
+		for(jj=0; jj<n; jj++)
+			{
+			for(ii=0; ii<m; ii++)
+				{
+				ref = beta * blasfeo_sgeex1(&sC, off+ii, jj);
+				for(ll=0; ll<k; ll++)
+					ref += alpha * blasfeo_sgeex1(&sA, off+ii, ll) * (tran ? blasfeo_sgeex1(&sB, jj, ll) : blasfeo_sgeex1(&sB, ll, jj));
+				err = fabs(ref - blasfeo_sgeex1(&sD, off+ii, jj));
+				err_max = err>err_max ? err : err_max;
+				}
+			}
+		if(err_max>1e-4)
+			{
+			printf("\nsgemm_%s: m=%d, n=%d, k=%d, offset=%d, residual %e\n", tran ? "nt" : "nn", m, n, k, off, err_max);
+			n_fail++;
+			}
+
+		blasfeo_free_smat(&sA);
+		blasfeo_free_smat(&sB);
+		blasfeo_free_smat(&sC);
+		blasfeo_free_smat(&sD);
+		}
+
+	return test_report("sgemm", n_fail);
+
+	}
@@ -0,0 +1,125 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "../include/blasfeo_common.h"
+#include "../include/blasfeo_s_aux_ext_dep.h"
+#include "../include/blasfeo_s_aux.h"
+#include "../include/blasfeo_s_blas.h"
+
+#include "test_residual.h"
+
+
+
+// residual of sgetrf_rp (trailing update reading U in place) and sgetrf_rp_ws (trailing update with a transposed copy
+// of U in the work space), by multiplying back the factors: P * C = L * U, for square and rectangular matrices below
+// and above the block size of the blocked factorization
+int main()
+	{
+
+	int ms[] = {1, 5, 8, 31, 33, 64, 70, 100};
+
+	int ii, jj, ll, im, in, ws;
+	int m, n, mn;
+	double ref, err, err_max, c_max;
+	int n_fail = 0;
+	int *ipiv;
+	void *work;
+
+	struct blasfeo_smat sC, sD, sP;
+
+	for(ws=0; ws<2; ws++)
+	for(im=0; im<8; im++)
+	for(in=0; in<8; in++)
+		{
+		m = ms[im];
+		n = ms[in];
+		mn = m<n ? m : n;
+
+		blasfeo_allocate_smat(m, n, &sC);
+		blasfeo_allocate_smat(m, n, &sD);
+		blasfeo_allocate_smat(m, n, &sP);
+		for(jj=0; jj<n; jj++)
+			for(ii=0; ii<m; ii++)
+				blasfeo_sgein1((float) test_rnd(), &sC, ii, jj);
+		ipiv = malloc(mn*sizeof(int));
+
+		if(ws)
+			{
+			work = malloc(blasfeo_sgetrf_rp_worksize(m, n));
+			blasfeo_sgetrf_rp_ws(m, n, &sC, 0, 0, &sD, 0, 0, ipiv, work);
+			free(work);
+			}
+		else
+			{
+			blasfeo_sgetrf_rp(m, n, &sC, 0, 0, &sD, 0, 0, ipiv);
+			}
+
+		// P * C
+		blasfeo_sgecp(m, n, &sC, 0, 0, &sP, 0, 0);
+		blasfeo_srowpe(mn, ipiv, &sP);
+
+		c_max = 0.0;
+		err_max = 0.0;
+		for(jj=0; jj<n; jj++)
+			{
+			for(ii=0; ii<m; ii++)
+				{
+				ref = 0.0;
+				for(ll=0; ll<=ii & ll<=jj & ll<mn; ll++)
+					ref += (ll==ii ? 1.0 : blasfeo_sgeex1(&sD, ii, ll)) * blasfeo_sgeex1(&sD, ll, jj);
+				err = fabs(ref - blasfeo_sgeex1(&sP, ii, jj));
+				err_max = err>err_max ? err : err_max;
+				c_max = fmax(c_max, fabs(blasfeo_sgeex1(&sC, ii, jj)));
+				}
+			}
+		if(err_max>1e-4*mn*c_max)
+			{
+			printf("\nsgetrf_rp%s: m=%d, n=%d, residual %e\n", ws ? "_ws" : "", m, n, err_max);
+			n_fail++;
+			}
+
+		free(ipiv);
+		blasfeo_free_smat(&sC);
+		blasfeo_free_smat(&sD);
+		blasfeo_free_smat(&sP);
+		}
+
+	return test_report("sgetrf_rp", n_fail);
+
+	}
@@ -0,0 +1,269 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <complex.h>
+
+#include "../include/blasfeo_common.h"
+#include "../include/blasfeo_stdlib.h"
+#include "../include/blasfeo_z_aux.h"
+#include "../include/blasfeo_z_blasfeo_api.h"
+
+#include "test_residual.h"
+
+
+
+// residuals of the double precision complex routines: zgemm against a naive triple loop, ztrsm by multiplying back
+// the solution, zpotrf_l and zgetrf_rp by multiplying back the factors; matrices at row and column offsets (at the
+// top of a panel for the kernels), and k above K_MAX_STACK
+static double _Complex rnd()
+	{
+	return test_rnd() + test_rnd() * I;
+	}
+
+
+
+static void allocate_zmat(int m, int n, struct blasfeo_zmat *sA)
+	{
+	void *mem;
+	blasfeo_malloc_align(&mem, blasfeo_memsize_zmat(m, n));
+	blasfeo_create_zmat(m, n, sA, mem);
+	}
+
+
+
+static void free_zmat(struct blasfeo_zmat *sA)
+	{
+	blasfeo_free_align(sA->pA);
+	}
+
+
+
+static void rnd_zmat(int m, int n, struct blasfeo_zmat *sA)
+	{
+	int ii, jj;
+	for(jj=0; jj<n; jj++)
+		for(ii=0; ii<m; ii++)
+			blasfeo_zgein1(rnd(), sA, ii, jj);
+	}
+
+
+
+// element (ii,jj) of op(A)
+static double _Complex op(int tran, struct blasfeo_zmat *sA, int ai, int aj, int ii, int jj)
+	{
+	if(tran==0)
+		return blasfeo_zgeex1(sA, ai+ii, aj+jj);
+	else if(tran==1)
+		return blasfeo_zgeex1(sA, ai+jj, aj+ii);
+	else
+		return conj(blasfeo_zgeex1(sA, ai+jj, aj+ii));
+	}
+
+
+
+static int check(char *name, int m, int n, int off, double res, double tol)
+	{
+	if(res>tol)
+		{
+		printf("\n%s: m=%d, n=%d, offset=%d, residual %e\n", name, m, n, off, res);
+		return 1;
+		}
+	return 0;
+	}
+
+
+
+int main()
+	{
+
+	int ms[] = {1, 3, 4, 9, 17};
+	int ks[] = {1, 3, 4, 9, 350};
+	int offs[] = {0, 1, 4};
+
+	int ii, jj, ll, im, in, io, tran;
+	int m, n, k, off;
+	double res;
+	double _Complex tmp;
+	double _Complex alpha = 0.5 - 1.0 * I;
+	double _Complex beta = -1.0 + 0.5 * I;
+	int n_fail = 0;
+	int *ipiv;
+
+	struct blasfeo_zmat sA, sB, sC, sD;
+
+	for(io=0; io<3; io++)
+	for(im=0; im<5; im++)
+	for(in=0; in<5; in++)
+		{
+		m = ms[im];
+		n = ms[in];
+		k = ks[(im+in)%5];
+		off = offs[io];
+
+		allocate_zmat(off+m+n+k, off+m+n+k, &sA);
+		allocate_zmat(off+m+n+k, off+m+n+k, &sB);
+		allocate_zmat(off+m+n+k, off+m+n+k, &sC);
+		allocate_zmat(off+m+n+k, off+m+n+k, &sD);
+
+		// zgemm_nn, zgemm_nt, zgemm_nc
+		for(tran=0; tran<3; tran++)
+			{
+			rnd_zmat(off+m+n+k, off+m+n+k, &sA);
+			rnd_zmat(off+m+n+k, off+m+n+k, &sB);
+			rnd_zmat(off+m+n+k, off+m+n+k, &sC);
+			if(tran==0)
+				blasfeo_zgemm_nn(m, n, k, alpha, &sA, off, 0, &sB, 0, off, beta, &sC, off, off, &sD, off, 0);
+			else if(tran==1)
+				blasfeo_zgemm_nt(m, n, k, alpha, &sA, off, 0, &sB, 0, off, beta, &sC, off, off, &sD, off, 0);
+			else
+				blasfeo_zgemm_nc(m, n, k, alpha, &sA, off, 0, &sB, 0, off, beta, &sC, off, off, &sD, off, 0);
+			res = 0.0;
+			for(jj=0; jj<n; jj++)
+				for(ii=0; ii<m; ii++)
+					{
+					tmp = beta * blasfeo_zgeex1(&sC, off+ii, off+jj);
+					for(ll=0; ll<k; ll++)
+						tmp += alpha * blasfeo_zgeex1(&sA, off+ii, ll) * op(tran, &sB, 0, off, ll, jj);
+					res = fmax(res, cabs(tmp - blasfeo_zgeex1(&sD, off+ii, jj)));
+					}
+			n_fail += check(tran==0 ? "zgemm_nn" : tran==1 ? "zgemm_nt" : "zgemm_nc", m, n, off, res, 1e-12);
+			}
+
+		// well conditioned triangular factors in A, right-hand sides in B
+		rnd_zmat(off+m+n+k, off+m+n+k, &sA);
+		rnd_zmat(off+m+n+k, off+m+n+k, &sB);
+		for(ii=0; ii<m+n; ii++)
+			blasfeo_zgein1(blasfeo_zgeex1(&sA, off+ii, off+ii) + 2.0*(m+n), &sA, off+ii, off+ii);
+
+		// ztrsm_llnu: A X = alpha B, A unit lower
+		blasfeo_ztrsm_llnu(m, n, alpha, &sA, off, off, &sB, off, 0, &sD, off, 0);
+		res = 0.0;
+		for(jj=0; jj<n; jj++)
+			for(ii=0; ii<m; ii++)
+				{
+				tmp = blasfeo_zgeex1(&sD, off+ii, jj);
+				for(ll=0; ll<ii; ll++)
+					tmp += blasfeo_zgeex1(&sA, off+ii, off+ll) * blasfeo_zgeex1(&sD, off+ll, jj);
+				res = fmax(res, cabs(tmp - alpha * blasfeo_zgeex1(&sB, off+ii, jj)));
+				}
+		n_fail += check("ztrsm_llnu", m, n, off, res, 1e-12);
+
+		// ztrsm_lunn: A X = alpha B, A upper
+		blasfeo_ztrsm_lunn(m, n, alpha, &sA, off, off, &sB, off, 0, &sD, off, 0);
+		res = 0.0;
+		for(jj=0; jj<n; jj++)
+			for(ii=0; ii<m; ii++)
+				{
+				tmp = 0.0;
+				for(ll=ii; ll<m; ll++)
+					tmp += blasfeo_zgeex1(&sA, off+ii, off+ll) * blasfeo_zgeex1(&sD, off+ll, jj);
+				res = fmax(res, cabs(tmp - alpha * blasfeo_zgeex1(&sB, off+ii, jj)));
+				}
+		n_fail += check("ztrsm_lunn", m, n, off, res, 1e-12);
+
+		// ztrsm_rlcn: X A^H = alpha B, A lower
+		blasfeo_ztrsm_rlcn(m, n, alpha, &sA, off, off, &sB, off, 0, &sD, off, 0);
+		res = 0.0;
+		for(jj=0; jj<n; jj++)
+			for(ii=0; ii<m; ii++)
+				{
+				tmp = 0.0;
+				for(ll=0; ll<=jj; ll++)
+					tmp += blasfeo_zgeex1(&sD, off+ii, ll) * conj(blasfeo_zgeex1(&sA, off+jj, off+ll));
+				res = fmax(res, cabs(tmp - alpha * blasfeo_zgeex1(&sB, off+ii, jj)));
+				}
+		n_fail += check("ztrsm_rlcn", m, n, off, res, 1e-12);
+
+		// ztrsm_runn: X A = alpha B, A upper
+		blasfeo_ztrsm_runn(m, n, alpha, &sA, off, off, &sB, off, 0, &sD, off, 0);
+		res = 0.0;
+		for(jj=0; jj<n; jj++)
+			for(ii=0; ii<m; ii++)
+				{
+				tmp = 0.0;
+				for(ll=0; ll<=jj; ll++)
+					tmp += blasfeo_zgeex1(&sD, off+ii, ll) * blasfeo_zgeex1(&sA, off+ll, off+jj);
+				res = fmax(res, cabs(tmp - alpha * blasfeo_zgeex1(&sB, off+ii, jj)));
+				}
+		n_fail += check("ztrsm_runn", m, n, off, res, 1e-12);
+
+		// zpotrf_l: C = B B^H + m I Hermitian positive definite, L L^H = C
+		blasfeo_zgemm_nc(m, m, k, 1.0, &sB, off, 0, &sB, off, 0, 0.0, &sC, off, off, &sC, off, off);
+		for(ii=0; ii<m; ii++)
+			blasfeo_zgein1(creal(blasfeo_zgeex1(&sC, off+ii, off+ii)) + m, &sC, off+ii, off+ii);
+		blasfeo_zpotrf_l(m, &sC, off, off, &sD, off, 0);
+		res = 0.0;
+		for(jj=0; jj<m; jj++)
+			for(ii=jj; ii<m; ii++)
+				{
+				tmp = 0.0;
+				for(ll=0; ll<=jj; ll++)
+					tmp += blasfeo_zgeex1(&sD, off+ii, ll) * conj(blasfeo_zgeex1(&sD, off+jj, ll));
+				res = fmax(res, cabs(tmp - blasfeo_zgeex1(&sC, off+ii, off+jj)));
+				}
+		n_fail += check("zpotrf_l", m, m, off, res, 1e-12*(m+k));
+
+		// zgetrf_rp: P C = L U, the row permutation applied to a copy of C at the origin
+		rnd_zmat(off+m+n+k, off+m+n+k, &sC);
+		ipiv = malloc(n*sizeof(int));
+		blasfeo_zgetrf_rp(m, n, &sC, off, off, &sD, off, 0, ipiv);
+		for(jj=0; jj<n; jj++)
+			for(ii=0; ii<m; ii++)
+				blasfeo_zgein1(blasfeo_zgeex1(&sC, off+ii, off+jj), &sB, ii, jj);
+		blasfeo_zrowpe(m<n ? m : n, ipiv, &sB);
+		res = 0.0;
+		for(jj=0; jj<n; jj++)
+			for(ii=0; ii<m; ii++)
+				{
+				tmp = 0.0;
+				for(ll=0; ll<=(ii<jj ? ii : jj) && ll<m && ll<n; ll++)
+					tmp += (ll==ii ? 1.0 : blasfeo_zgeex1(&sD, off+ii, ll)) * blasfeo_zgeex1(&sD, off+ll, jj);
+				res = fmax(res, cabs(tmp - blasfeo_zgeex1(&sB, ii, jj)));
+				}
+		n_fail += check("zgetrf_rp", m, n, off, res, 1e-12*(m+n));
+		free(ipiv);
+
+		free_zmat(&sA);
+		free_zmat(&sB);
+		free_zmat(&sC);
+		free_zmat(&sD);
+		}
+
+	return test_report("complex routines", n_fail);
+
+	}